@@ -4,6 +4,11 @@ let ws = null;
 let statusInterval = null;
 let healthInterval = null;
 
+// Metrics pushed over the WebSocket (see src/metrics_hub.h)
+const METRICS_INTERVAL_MS = 1000;
+let metrics = {};
+let metricsVersion = 0;
+
 // Initialize on page load
 document.addEventListener('DOMContentLoaded', () => {
     initTabs();
@@ -12,14 +17,13 @@ document.addEventListener('DOMContentLoaded', () => {
     loadStatus();
     loadConfigs();
 
-    // Start periodic status updates
-    statusInterval = setInterval(loadStatus, 5000);
+    // Status and health are pushed over the WebSocket; poll only without it
+    startStatusPolling();
 
-    // Start health status updates when on network tab
+    // Interface details when on network tab
     healthInterval = setInterval(() => {
         const networkTab = document.getElementById('network');
         if (networkTab && networkTab.classList.contains('active')) {
-            loadNetworkHealth();
             loadNetworkStatus();
         }
     }, 3000);
@@ -178,14 +182,18 @@ function toggleEthStaticFields() {
 function connectWebSocket() {
     const protocol = window.location.protocol === 'https:' ? 'wss:' : 'ws:';
     ws = new WebSocket(`${protocol}//${window.location.host}/ws`);
+    ws.binaryType = 'arraybuffer';
 
     ws.onopen = () => {
         console.log('WebSocket connected');
         addLog('WebSocket connected');
+        packetStreamNextSeq = null;
+        subscribeMetrics();
     };
 
     ws.onclose = () => {
         console.log('WebSocket disconnected');
+        startStatusPolling();
         setTimeout(connectWebSocket, 3000);
     };
 
@@ -194,10 +202,18 @@ function connectWebSocket() {
     };
 
     ws.onmessage = (event) => {
+        // Binary messages carry batches of received packets
+        if (event.data instanceof ArrayBuffer) {
+            handlePacketBatch(event.data);
+            return;
+        }
+
         try {
             const data = JSON.parse(event.data);
             if (data.type === 'log') {
                 addLog(data.message);
+            } else if (data.type === 'metrics') {
+                applyMetrics(data);
             }
         } catch (e) {
             console.error('Failed to parse WebSocket message:', e);
@@ -205,6 +221,151 @@ function connectWebSocket() {
     };
 }
 
+// Polling fallback while the WebSocket is down
+function startStatusPolling() {
+    if (statusInterval) return;
+    statusInterval = setInterval(() => {
+        loadStatus();
+        const networkTab = document.getElementById('network');
+        if (networkTab && networkTab.classList.contains('active')) {
+            loadNetworkHealth();
+        }
+    }, 5000);
+}
+
+function stopStatusPolling() {
+    clearInterval(statusInterval);
+    statusInterval = null;
+}
+
+function subscribeMetrics() {
+    metricsVersion = 0;
+    ws.send(JSON.stringify({ type: 'subscribe', topic: 'metrics', interval_ms: METRICS_INTERVAL_MS }));
+}
+
+// Apply a metrics delta; base 0 is a full snapshot
+function applyMetrics(data) {
+    if (data.base === 0) {
+        metrics = {};
+        loadStatus();       // Static fields (EUI, IP, chip) once per snapshot
+    } else if (data.base !== metricsVersion) {
+        // Missed a delta: start over from a full snapshot
+        subscribeMetrics();
+        return;
+    }
+
+    Object.assign(metrics, data.m);
+    metricsVersion = data.v;
+    stopStatusPolling();
+    renderMetrics(data.m);
+}
+
+function renderMetrics(changed) {
+    const m = metrics;
+
+    if ('wifi_connected' in changed) {
+        updateStatusIndicator('wifi-status',
+            m.wifi_connected ? 'WiFi: Connected' : 'WiFi: AP Mode', m.wifi_connected);
+    }
+    if ('server_connected' in changed) {
+        updateStatusIndicator('server-status',
+            m.server_connected ? 'Server: Connected' : 'Server: Disconnected', m.server_connected);
+    }
+    if ('lora_receiving' in changed || 'lora_available' in changed) {
+        updateStatusIndicator('lora-status',
+            m.lora_receiving ? 'LoRa: Active' : 'LoRa: Inactive', m.lora_available);
+    }
+
+    if ('uptime' in changed) {
+        document.getElementById('uptime').textContent = formatUptime(m.uptime);
+    }
+    if ('heap_free' in changed) {
+        document.getElementById('free-memory').textContent = formatBytes(m.heap_free);
+    }
+    if ('rx_received' in changed) {
+        document.getElementById('rx-packets').textContent = m.rx_received;
+    }
+    if ('tx_sent' in changed) {
+        document.getElementById('tx-packets').textContent = m.tx_sent;
+    }
+    if ('rx_forwarded' in changed) {
+        document.getElementById('rx-forwarded').textContent = m.rx_forwarded;
+    }
+    if ('rx_crc_error' in changed) {
+        document.getElementById('crc-errors').textContent = m.rx_crc_error;
+    }
+    if ('last_rssi' in changed) {
+        document.getElementById('last-rssi').textContent = `${m.last_rssi || '--'} dBm`;
+    }
+    if ('last_snr' in changed) {
+        document.getElementById('last-snr').textContent = `${m.last_snr || '--'} dB`;
+    }
+
+    // Network health, in the shape /api/network/health returns
+    if (!m.net_available) return;
+    const health = {
+        healthy: m.net_healthy,
+        failoverActive: m.net_failover_active,
+        stabilityPeriod: m.net_stability_period_ms,
+        primaryStableFor: m.net_primary_stable_ms
+    };
+    if (m.net_last_ack_ms === 0) {
+        health.lastAckTime = 0;
+    } else {
+        health.lastAckAgo = m.uptime * 1000 - m.net_last_ack_ms;
+    }
+    renderNetworkHealth(health);
+}
+
+// Packet stream batch (see src/packet_stream.h for the layout)
+const PACKET_STREAM_MSG_PACKETS = 0x01;
+const PACKET_STREAM_HEADER_SIZE = 8;
+
+// Sequence number expected next; a gap is packets this page missed
+let packetStreamNextSeq = null;
+
+function handlePacketBatch(buffer) {
+    if (buffer.byteLength < PACKET_STREAM_HEADER_SIZE) return;
+    const view = new DataView(buffer);
+    if (view.getUint8(0) !== PACKET_STREAM_MSG_PACKETS) return;
+
+    const recordSize = view.getUint8(2);
+    const count = view.getUint8(3);
+    const firstSeq = view.getUint32(4, true);
+
+    if (packetStreamNextSeq !== null) {
+        const dropped = (firstSeq - packetStreamNextSeq) >>> 0;
+        if (dropped > 0 && dropped < 0x80000000) {
+            addLog(`${dropped} packets not shown (connection too slow)`);
+        }
+    }
+    packetStreamNextSeq = (firstSeq + count) >>> 0;
+
+    for (let i = 0; i < count; i++) {
+        const offset = PACKET_STREAM_HEADER_SIZE + i * recordSize;
+        if (offset + 16 > buffer.byteLength) break;
+
+        const rssi = view.getInt16(offset + 4, true) / 10;
+        const snr = view.getInt8(offset + 6) / 4;
+        const sf = view.getUint8(offset + 7);
+        const length = view.getUint8(offset + 8);
+        const flags = view.getUint8(offset + 9);
+        const devAddr = view.getUint32(offset + 12, true);
+
+        let message = `Packet received: ${length} bytes, RSSI: ${rssi.toFixed(1)} dBm, ` +
+                      `SNR: ${snr.toFixed(1)} dB, SF${sf}`;
+        if (devAddr !== 0) {
+            message += `, DevAddr ${devAddr.toString(16).toUpperCase().padStart(8, '0')}`;
+        }
+        if (!(flags & 0x01)) {
+            message += ' (CRC error)';
+        } else if (!(flags & 0x04)) {
+            message += ' (filtered)';
+        }
+        addLog(message);
+    }
+}
+
 // Load status
 async function loadStatus() {
     try {
@@ -302,6 +463,12 @@ async function loadServerConfig() {
         document.getElementById('server-port-down').value = data.port_down;
         document.getElementById('server-eui').value = data.gateway_eui;
         document.getElementById('server-description').value = data.description || '';
+        // Only the regions compiled into the firmware can be selected
+        if (data.regions) {
+            for (const option of document.getElementById('server-region').options) {
+                option.disabled = !data.regions.includes(option.value);
+            }
+        }
         document.getElementById('server-region').value = data.region || 'US915';
         document.getElementById('server-lat').value = data.latitude || '';
         document.getElementById('server-lon').value = data.longitude || '';
@@ -357,9 +524,6 @@ async function loadLCDConfig() {
         const response = await fetch('/api/lcd/config');
         const data = await response.json();
 
-        // Update status display
-        document.getElementById('lcd-status').textContent = data.available ? 'Active' : (data.enabled ? 'Enabled (Disconnected)' : 'Disabled');
-        document.getElementById('lcd-status').className = data.available ? 'status-ok' : 'status-warn';
         document.getElementById('lcd-address-display').textContent = data.address_hex || ('0x' + data.address.toString(16).toUpperCase());
         document.getElementById('lcd-dimensions').textContent = data.cols + 'x' + data.rows;
         document.getElementById('lcd-pins').textContent = 'SDA=' + data.sda + ', SCL=' + data.scl;
@@ -373,11 +537,27 @@ async function loadLCDConfig() {
         document.getElementById('lcd-scl').value = data.scl;
         document.getElementById('lcd-backlight').checked = data.backlight;
         document.getElementById('lcd-rotation').value = data.rotation_interval || 5;
+
+        // Load status
+        await loadLCDStatus();
     } catch (error) {
         console.error('Failed to load LCD config:', error);
     }
 }
 
+async function loadLCDStatus() {
+    try {
+        const response = await fetch('/api/lcd/status');
+        const data = await response.json();
+
+        // Update status display
+        document.getElementById('lcd-status').textContent = data.available ? 'Active' : (data.enabled ? 'Enabled (Disconnected)' : 'Disabled');
+        document.getElementById('lcd-status').className = data.available ? 'status-ok' : 'status-warn';
+    } catch (error) {
+        console.error('Failed to load LCD status:', error);
+    }
+}
+
 // Save configurations
 async function saveLoRaConfig() {
     const config = {
@@ -1532,58 +1712,7 @@ async function loadNetworkHealth() {
             return;
         }
 
-        // Health status
-        const healthStatusEl = document.getElementById('net-health-status');
-        if (data.healthy) {
-            healthStatusEl.textContent = 'Healthy';
-            healthStatusEl.className = 'healthy';
-        } else {
-            healthStatusEl.textContent = 'Unhealthy';
-            healthStatusEl.className = 'unhealthy';
-        }
-
-        // Last ACK time
-        const lastAckEl = document.getElementById('net-last-ack');
-        if (data.lastAckTime !== undefined) {
-            if (data.lastAckTime === 0) {
-                lastAckEl.textContent = 'Never';
-            } else {
-                const agoMs = Date.now() - data.lastAckTime;
-                lastAckEl.textContent = formatUptime(Math.floor(agoMs / 1000)) + ' ago';
-            }
-        } else if (data.lastAckAgo !== undefined) {
-            lastAckEl.textContent = formatUptime(Math.floor(data.lastAckAgo / 1000)) + ' ago';
-        } else {
-            lastAckEl.textContent = '--';
-        }
-
-        // Failover state
-        const failoverStateEl = document.getElementById('net-failover-state');
-        if (data.failoverActive) {
-            failoverStateEl.textContent = 'Active (on backup)';
-            failoverStateEl.className = 'status-warn';
-        } else {
-            failoverStateEl.textContent = 'Inactive';
-            failoverStateEl.className = 'status-ok';
-        }
-
-        // Stability timer countdown
-        const stabilityTimerEl = document.getElementById('net-stability-timer');
-        if (data.failoverActive && data.primaryStableFor !== undefined) {
-            const stabilityPeriod = data.stabilityPeriod || 60000;
-            const remaining = Math.max(0, stabilityPeriod - data.primaryStableFor);
-            if (remaining > 0) {
-                stabilityTimerEl.textContent = formatUptime(Math.ceil(remaining / 1000)) + ' remaining';
-                stabilityTimerEl.className = 'status-warn';
-            } else {
-                stabilityTimerEl.textContent = 'Ready to switch back';
-                stabilityTimerEl.className = 'status-ok';
-            }
-        } else {
-            stabilityTimerEl.textContent = '--';
-            stabilityTimerEl.className = '';
-        }
-
+        renderNetworkHealth(data);
     } catch (error) {
         console.error('Failed to load Network health:', error);
         // Set defaults for missing endpoint
@@ -1594,6 +1723,63 @@ async function loadNetworkHealth() {
     }
 }
 
+/**
+ * Display health check status (polled or pushed)
+ */
+function renderNetworkHealth(data) {
+    // Health status
+    const healthStatusEl = document.getElementById('net-health-status');
+    if (data.healthy) {
+        healthStatusEl.textContent = 'Healthy';
+        healthStatusEl.className = 'healthy';
+    } else {
+        healthStatusEl.textContent = 'Unhealthy';
+        healthStatusEl.className = 'unhealthy';
+    }
+
+    // Last ACK time
+    const lastAckEl = document.getElementById('net-last-ack');
+    if (data.lastAckTime !== undefined) {
+        if (data.lastAckTime === 0) {
+            lastAckEl.textContent = 'Never';
+        } else {
+            const agoMs = Date.now() - data.lastAckTime;
+            lastAckEl.textContent = formatUptime(Math.floor(agoMs / 1000)) + ' ago';
+        }
+    } else if (data.lastAckAgo !== undefined) {
+        lastAckEl.textContent = formatUptime(Math.floor(data.lastAckAgo / 1000)) + ' ago';
+    } else {
+        lastAckEl.textContent = '--';
+    }
+
+    // Failover state
+    const failoverStateEl = document.getElementById('net-failover-state');
+    if (data.failoverActive) {
+        failoverStateEl.textContent = 'Active (on backup)';
+        failoverStateEl.className = 'status-warn';
+    } else {
+        failoverStateEl.textContent = 'Inactive';
+        failoverStateEl.className = 'status-ok';
+    }
+
+    // Stability timer countdown
+    const stabilityTimerEl = document.getElementById('net-stability-timer');
+    if (data.failoverActive && data.primaryStableFor !== undefined) {
+        const stabilityPeriod = data.stabilityPeriod || 60000;
+        const remaining = Math.max(0, stabilityPeriod - data.primaryStableFor);
+        if (remaining > 0) {
+            stabilityTimerEl.textContent = formatUptime(Math.ceil(remaining / 1000)) + ' remaining';
+            stabilityTimerEl.className = 'status-warn';
+        } else {
+            stabilityTimerEl.textContent = 'Ready to switch back';
+            stabilityTimerEl.className = 'status-ok';
+        }
+    } else {
+        stabilityTimerEl.textContent = '--';
+        stabilityTimerEl.className = '';
+    }
+}
+
 /**
  * Update interface indicator visual state
  */
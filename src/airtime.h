@@ -0,0 +1,50 @@
+#ifndef AIRTIME_H
+#define AIRTIME_H
+
+#include <stdint.h>
+
+// =============================================================================
+// LoRa Time on Air
+// =============================================================================
+// Semtech SX1276 datasheet, section 4.1.1.7 (and AN1200.13):
+//
+//   Tsym      = 2^SF / BW
+//   Tpreamble = (Npreamble + 4.25) * Tsym
+//   Npayload  = 8 + max(ceil((8*PL - 4*SF + 28 + 16*CRC - 20*IH) /
+//                            (4*(SF - 2*DE))) * CR, 0)
+//
+// with CR = 5..8 for 4/5..4/8, IH = 1 for implicit header and DE = 1 when
+// low data rate optimization is on (symbol time above 16 ms, as the radio
+// profiles set it).
+
+#define LORA_PREAMBLE_SYMBOLS       8       // LoRaWAN preamble
+#define LORA_LDRO_SYMBOL_US         16000   // Low data rate optimization threshold
+
+// Symbol time in microseconds
+inline uint32_t loraSymbolTimeUs(uint8_t sf, float bwKhz) {
+    if (bwKhz <= 0) return 0;
+    return (uint32_t)((float)(1UL << sf) * 1000.0f / bwKhz + 0.5f);
+}
+
+// Time on air of a frame in microseconds (0 for invalid parameters)
+inline uint32_t loraTimeOnAirUs(uint8_t sf, float bwKhz, uint8_t cr, uint16_t payloadLength,
+                                uint16_t preambleSymbols = LORA_PREAMBLE_SYMBOLS,
+                                bool explicitHeader = true, bool crc = true) {
+    if (sf < 6 || sf > 12 || cr < 5 || cr > 8 || bwKhz <= 0) return 0;
+
+    float symbolUs = (float)(1UL << sf) * 1000.0f / bwKhz;
+    int32_t de = symbolUs > LORA_LDRO_SYMBOL_US ? 1 : 0;
+    int32_t ih = explicitHeader ? 0 : 1;
+
+    int32_t numerator = 8 * (int32_t)payloadLength - 4 * sf + 28 + (crc ? 16 : 0) - 20 * ih;
+    int32_t denominator = 4 * (sf - 2 * de);
+    int32_t blocks = numerator > 0 ? (numerator + denominator - 1) / denominator : 0;
+    int32_t payloadSymbols = 8 + blocks * cr;
+
+    // Preamble in quarter symbols to keep the 4.25
+    float preambleUs = (preambleSymbols * 4 + 17) * symbolUs / 4.0f;
+
+    return (uint32_t)(preambleUs + payloadSymbols * symbolUs + 0.5f);
+}
+
+#endif // AIRTIME_H
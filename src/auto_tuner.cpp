@@ -0,0 +1,584 @@
+#include "auto_tuner.h"
+#include "config_store.h"
+#include "ntp_manager.h"
+#include <time.h>
+
+// Global instance
+AutoTuner autoTuner;
+
+#define TUNER_PUBLISH_INTERVAL_MS   1000
+#define TUNER_CHANNEL_TOLERANCE_HZ  1000
+
+AutoTuner::AutoTuner()
+    : windowStart(0)
+    , lastTick(0)
+    , lastSweep(0)
+    , sweepStart(0)
+    , trialStart(0)
+    , lastPublish(0)
+    , dirty(false)
+    , trialFromFrequency(0)
+    , trialFromSf(0)
+    , trialToFrequency(0)
+    , trialToSf(0)
+    , trialRateBefore(0)
+{
+    memset(&status, 0, sizeof(status));
+    status.state = TunerState::IDLE;
+    setDefaultConfig();
+}
+
+void AutoTuner::setDefaultConfig() {
+    config.enabled = TUNER_ENABLED_DEFAULT;
+    config.autoApply = TUNER_AUTO_APPLY_DEFAULT;
+    config.evalIntervalS = TUNER_EVAL_INTERVAL_DEFAULT;
+    config.minDwellS = TUNER_MIN_DWELL_DEFAULT;
+    config.sweepIntervalS = TUNER_SWEEP_INTERVAL_DEFAULT;
+    config.sweepDurationS = TUNER_SWEEP_DURATION_DEFAULT;
+    config.minPackets = TUNER_MIN_PACKETS_DEFAULT;
+    config.minGainPct = TUNER_MIN_GAIN_DEFAULT;
+    config.regressionPct = TUNER_REGRESSION_DEFAULT;
+    config.windowStartHour = 0;
+    config.windowEndHour = 0;
+}
+
+void AutoTuner::loadConfig(const JsonDocument& doc) {
+    JsonObjectConst tuner = doc["lora"]["autotune"];
+    if (tuner.isNull()) return;
+
+    config.enabled = tuner["enabled"] | TUNER_ENABLED_DEFAULT;
+    config.autoApply = tuner["auto_apply"] | TUNER_AUTO_APPLY_DEFAULT;
+    config.evalIntervalS = tuner["eval_interval_s"] | TUNER_EVAL_INTERVAL_DEFAULT;
+    config.minDwellS = tuner["min_dwell_s"] | TUNER_MIN_DWELL_DEFAULT;
+    config.sweepIntervalS = tuner["sweep_interval_s"] | TUNER_SWEEP_INTERVAL_DEFAULT;
+    config.sweepDurationS = tuner["sweep_duration_s"] | TUNER_SWEEP_DURATION_DEFAULT;
+    config.minPackets = tuner["min_packets"] | TUNER_MIN_PACKETS_DEFAULT;
+    config.minGainPct = tuner["min_gain_pct"] | TUNER_MIN_GAIN_DEFAULT;
+    config.regressionPct = tuner["regression_pct"] | TUNER_REGRESSION_DEFAULT;
+    config.windowStartHour = (tuner["window_start_hour"] | 0) % 24;
+    config.windowEndHour = (tuner["window_end_hour"] | 0) % 24;
+
+    if (config.evalIntervalS < 60) config.evalIntervalS = 60;
+    // A sweep in every observation window
+    if (config.sweepIntervalS > config.evalIntervalS) config.sweepIntervalS = config.evalIntervalS;
+
+    Serial.printf("[Tuner] Config loaded: enabled=%d, auto_apply=%d\n",
+                  config.enabled, config.autoApply);
+}
+
+bool AutoTuner::saveConfig() {
+    ConfigSectionView section = configStore.edit(ConfigSection::LORA);
+    if (!section.isValid()) {
+        Serial.println("[Tuner] Config store not available");
+        return false;
+    }
+
+    JsonObject lora = section.obj();
+    JsonObject tuner = lora["autotune"].is<JsonObject>() ? lora["autotune"].as<JsonObject>()
+                                                         : lora.createNestedObject("autotune");
+    tuner["enabled"] = config.enabled;
+    tuner["auto_apply"] = config.autoApply;
+    tuner["eval_interval_s"] = config.evalIntervalS;
+    tuner["min_dwell_s"] = config.minDwellS;
+    tuner["sweep_interval_s"] = config.sweepIntervalS;
+    tuner["sweep_duration_s"] = config.sweepDurationS;
+    tuner["min_packets"] = config.minPackets;
+    tuner["min_gain_pct"] = config.minGainPct;
+    tuner["regression_pct"] = config.regressionPct;
+    tuner["window_start_hour"] = config.windowStartHour;
+    tuner["window_end_hour"] = config.windowEndHour;
+
+    return true;
+}
+
+// ================== Loop ==================
+
+void AutoTuner::update() {
+    unsigned long now = millis();
+    uint32_t elapsed = now - lastTick;
+    lastTick = now;
+
+    GatewayConfig& lora = loraGateway.getConfig();
+
+    // Nothing to choose when the receiver already covers every SF and channel
+    bool coversAll = lora.scanEnabled && (lora.hopEnabled || lora.hopChannelCount == 0);
+
+    if (!config.enabled || !loraGateway.isAvailable() || !lora.enabled || coversAll) {
+        if (status.state != TunerState::IDLE) {
+            if (status.state == TunerState::SWEEPING) loraGateway.sweep(0);
+            status.state = TunerState::IDLE;
+            snapshot.publish(status);
+        }
+        return;
+    }
+
+    if (status.state == TunerState::IDLE) {
+        status.state = TunerState::OBSERVING;
+        resetWindow();
+        dirty = true;
+        return;
+    }
+
+    accountExposure(elapsed);
+
+    switch (status.state) {
+        case TunerState::SWEEPING:
+            if (now - sweepStart >= (uint32_t)config.sweepDurationS * 1000UL + 1000UL ||
+                (now - sweepStart >= 1000 && !loraGateway.isSweeping())) {
+                // The interval runs from the sweep start, in step with the window
+                status.state = TunerState::OBSERVING;
+                dirty = true;
+            }
+            break;
+
+        case TunerState::OBSERVING:
+            if (now - windowStart >= config.evalIntervalS * 1000UL) {
+                evaluate();
+                break;
+            }
+            // At least one sweep per window, the first one right away
+            if (config.sweepIntervalS > 0 &&
+                (status.sweeps == 0 || (long)(lastSweep - windowStart) < 0 ||
+                 now - lastSweep >= config.sweepIntervalS * 1000UL)) {
+                if (loraGateway.sweep((uint32_t)config.sweepDurationS * 1000UL)) {
+                    status.state = TunerState::SWEEPING;
+                    status.sweeps++;
+                    sweepStart = now;
+                    Serial.printf("[Tuner] Sweep %u started (%u s)\n",
+                                  status.sweeps, config.sweepDurationS);
+                }
+                lastSweep = now;
+                dirty = true;
+            }
+            break;
+
+        case TunerState::TRIAL:
+            // Changed by hand meanwhile: the trial no longer applies
+            if (lora.frequency != trialToFrequency || lora.spreadingFactor != trialToSf) {
+                logDecision(TunerAction::ABORT, trialToFrequency, trialToSf,
+                            lora.frequency, lora.spreadingFactor, trialRateBefore, 0);
+                status.state = TunerState::OBSERVING;
+                resetWindow();
+                break;
+            }
+            if (now - trialStart >= config.evalIntervalS * 1000UL) {
+                finishTrial();
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (dirty && now - lastPublish >= TUNER_PUBLISH_INTERVAL_MS) {
+        dirty = false;
+        lastPublish = now;
+        snapshot.publish(status);
+    }
+}
+
+void AutoTuner::recordPacket(const LoRaPacket& packet) {
+    if (status.state == TunerState::IDLE) return;
+
+    GatewayConfig& lora = loraGateway.getConfig();
+
+    if (loraGateway.isScanning()) {
+        int8_t ch = channelIndex(packet.frequency);
+        if (ch < 0) return;
+        if (packet.spreadingFactor < LORA_SCAN_SF_MIN || packet.spreadingFactor > LORA_SCAN_SF_MAX) {
+            return;
+        }
+        status.grid[ch][packet.spreadingFactor - LORA_SCAN_SF_MIN].packets++;
+    } else if (packet.frequency == lora.frequency &&
+               packet.spreadingFactor == lora.spreadingFactor) {
+        status.baselinePackets++;
+    }
+
+    dirty = true;
+}
+
+void AutoTuner::resetWindow() {
+    GatewayConfig& lora = loraGateway.getConfig();
+
+    // Candidate channels: the plan, or the configured frequency alone
+    if (lora.hopChannelCount > 0) {
+        status.channelCount = lora.hopChannelCount;
+        memcpy(status.channels, lora.hopChannels, sizeof(status.channels));
+    } else {
+        status.channelCount = 1;
+        memset(status.channels, 0, sizeof(status.channels));
+        status.channels[0] = lora.frequency;
+    }
+
+    memset(status.grid, 0, sizeof(status.grid));
+    status.baselinePackets = 0;
+    status.baselineMs = 0;
+    windowStart = millis();
+    dirty = true;
+}
+
+void AutoTuner::decayWindow() {
+    GatewayConfig& lora = loraGateway.getConfig();
+
+    // A different channel plan or setting starts over
+    bool samePlan = lora.hopChannelCount > 0
+        ? status.channelCount == lora.hopChannelCount &&
+          memcmp(status.channels, lora.hopChannels, sizeof(status.channels)) == 0
+        : status.channelCount == 1 && status.channels[0] == lora.frequency;
+    if (!samePlan) {
+        resetWindow();
+        return;
+    }
+
+    for (uint8_t ch = 0; ch < status.channelCount; ch++) {
+        for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) {
+            tunerDecayCell(status.grid[ch][i]);
+        }
+    }
+    TunerCell baseline = { status.baselinePackets, status.baselineMs };
+    tunerDecayCell(baseline);
+    status.baselinePackets = baseline.packets;
+    status.baselineMs = baseline.exposureMs;
+
+    windowStart = millis();
+    dirty = true;
+}
+
+void AutoTuner::accountExposure(uint32_t elapsedMs) {
+    if (!loraGateway.isScanning()) {
+        status.baselineMs += elapsedMs;
+        return;
+    }
+
+    GatewayConfig& lora = loraGateway.getConfig();
+    bool sweeping = loraGateway.isSweeping();
+
+    // SFs being cycled; a step lasts about as long as its symbol time, so the
+    // chance of catching a preamble at SF n scales with 2^n
+    uint32_t weights[LORA_SCAN_SF_COUNT] = {0};
+    uint32_t totalWeight = 0;
+    if (sweeping) {
+        for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) weights[i] = tunerSfWeight(i);
+    } else if (lora.scanEnabled) {
+        for (uint8_t i = 0; i < lora.scanSfCount; i++) {
+            uint8_t index = lora.scanSfList[i] - LORA_SCAN_SF_MIN;
+            weights[index] += tunerSfWeight(index);
+        }
+    } else if (lora.spreadingFactor >= LORA_SCAN_SF_MIN && lora.spreadingFactor <= LORA_SCAN_SF_MAX) {
+        weights[lora.spreadingFactor - LORA_SCAN_SF_MIN] = 1;
+    }
+    for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) totalWeight += weights[i];
+    if (totalWeight == 0) return;
+
+    // Channels being cycled
+    uint8_t firstChannel = 0;
+    uint8_t channelCount = status.channelCount;
+    if (!loraGateway.isHopping()) {
+        int8_t ch = channelIndex(lora.frequency);
+        if (ch < 0) return;
+        firstChannel = ch;
+        channelCount = 1;
+    }
+
+    for (uint8_t ch = firstChannel; ch < firstChannel + channelCount; ch++) {
+        for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) {
+            if (weights[i] == 0) continue;
+            status.grid[ch][i].exposureMs +=
+                tunerCellExposureMs(elapsedMs, weights[i], totalWeight, channelCount);
+        }
+    }
+}
+
+// ================== Decisions ==================
+
+void AutoTuner::evaluate() {
+    GatewayConfig& lora = loraGateway.getConfig();
+    status.evaluations++;
+
+    // Only what the receiver mode lets a fixed setting change
+    bool tuneFrequency = !(lora.hopEnabled && lora.hopChannelCount > 0);
+    bool tuneSf = !lora.scanEnabled;
+
+    uint8_t rows = tuneFrequency ? status.channelCount : 1;
+    uint8_t cols = tuneSf ? LORA_SCAN_SF_COUNT : 1;
+
+    int8_t currentChannel = channelIndex(lora.frequency);
+    float currentRate = -1;
+    float bestRate = -1;
+    uint32_t bestFrequency = 0;
+    uint8_t bestSf = 0;
+
+    for (uint8_t r = 0; r < rows; r++) {
+        for (uint8_t c = 0; c < cols; c++) {
+            // Aggregate over whatever the receiver cycles anyway
+            TunerCell total = {0, 0};
+            uint32_t minExposure = 0;
+            for (uint8_t ch = 0; ch < status.channelCount; ch++) {
+                if (tuneFrequency && ch != r) continue;
+                for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) {
+                    if (tuneSf && i != c) continue;
+                    total.packets += status.grid[ch][i].packets;
+                    total.exposureMs += status.grid[ch][i].exposureMs;
+                    minExposure += minExposureMs(i);
+                }
+            }
+
+            uint32_t frequency = tuneFrequency ? status.channels[r] : lora.frequency;
+            uint8_t sf = tuneSf ? LORA_SCAN_SF_MIN + c : lora.spreadingFactor;
+            float rate = cellRate(total);
+
+            bool isCurrent = (!tuneFrequency || (int8_t)r == currentChannel) &&
+                             (!tuneSf || sf == lora.spreadingFactor);
+            if (isCurrent && total.exposureMs >= minExposure) {
+                currentRate = rate;
+            }
+
+            if (total.exposureMs < minExposure || total.packets < config.minPackets) {
+                continue;
+            }
+            if (rate > bestRate) {
+                bestRate = rate;
+                bestFrequency = frequency;
+                bestSf = sf;
+            }
+        }
+    }
+
+    // Same measurement for the current setting where possible, else the
+    // time spent listening on it
+    if (currentRate < 0) currentRate = baselineRate();
+
+    Serial.printf("[Tuner] Window %u: current %.1f pkt/h, best %.3f MHz SF%d %.1f pkt/h\n",
+                  status.evaluations, currentRate, bestFrequency / 1000000.0, bestSf,
+                  bestRate < 0 ? 0 : bestRate);
+
+    bool better = bestRate >= 0 &&
+                  !(bestFrequency == lora.frequency && bestSf == lora.spreadingFactor) &&
+                  bestRate >= currentRate * (1.0f + config.minGainPct / 100.0f) &&
+                  bestRate > currentRate;
+
+    if (!better) {
+        status.hasRecommendation = false;
+        decayWindow();
+        return;
+    }
+
+    status.hasRecommendation = true;
+    status.recommendedFrequency = bestFrequency;
+    status.recommendedSf = bestSf;
+
+    uint32_t uptime = millis() / 1000;
+    bool dwellOk = status.lastChangeS == 0 || uptime - status.lastChangeS >= config.minDwellS;
+
+    if (!config.autoApply || !dwellOk || !inScheduleWindow()) {
+        logDecision(TunerAction::RECOMMEND, lora.frequency, lora.spreadingFactor,
+                    bestFrequency, bestSf, currentRate, bestRate);
+        decayWindow();
+        return;
+    }
+
+    uint32_t fromFrequency = lora.frequency;
+    uint8_t fromSf = lora.spreadingFactor;
+
+    if (!applySetting(bestFrequency, bestSf)) {
+        Serial.println("[Tuner] Failed to apply recommendation");
+        resetWindow();
+        return;
+    }
+
+    logDecision(TunerAction::APPLY, fromFrequency, fromSf, bestFrequency, bestSf,
+                currentRate, bestRate);
+
+    trialFromFrequency = fromFrequency;
+    trialFromSf = fromSf;
+    trialToFrequency = bestFrequency;
+    trialToSf = bestSf;
+    trialRateBefore = currentRate;
+    trialStart = millis();
+    status.lastChangeS = uptime;
+    status.hasRecommendation = false;
+    status.state = TunerState::TRIAL;
+    resetWindow();
+}
+
+void AutoTuner::finishTrial() {
+    GatewayConfig& lora = loraGateway.getConfig();
+
+    // Measured the same way as before the change
+    float rateAfter = baselineRate();
+    if (loraGateway.isScanning()) {
+        TunerCell total = {0, 0};
+        int8_t ch = channelIndex(lora.frequency);
+        for (uint8_t c = 0; c < status.channelCount; c++) {
+            if (!loraGateway.isHopping() && c != ch) continue;
+            for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) {
+                total.packets += status.grid[c][i].packets;
+                total.exposureMs += status.grid[c][i].exposureMs;
+            }
+        }
+        rateAfter = cellRate(total);
+    }
+
+    float limit = trialRateBefore * (1.0f - config.regressionPct / 100.0f);
+
+    if (rateAfter < limit) {
+        applySetting(trialFromFrequency, trialFromSf);
+        logDecision(TunerAction::REVERT, trialToFrequency, trialToSf,
+                    trialFromFrequency, trialFromSf, trialRateBefore, rateAfter);
+    } else {
+        // Keep it across reboots
+        loraGateway.saveConfig();
+        logDecision(TunerAction::CONFIRM, trialFromFrequency, trialFromSf,
+                    trialToFrequency, trialToSf, trialRateBefore, rateAfter);
+    }
+
+    status.state = TunerState::OBSERVING;
+    resetWindow();
+}
+
+bool AutoTuner::applySetting(uint32_t frequency, uint8_t sf) {
+    GatewayConfig cfg = loraGateway.getConfig();
+    cfg.frequency = frequency;
+    cfg.spreadingFactor = sf;
+    return loraGateway.reconfigure(cfg);
+}
+
+bool AutoTuner::inScheduleWindow() const {
+    if (config.windowStartHour == config.windowEndHour) return true;
+
+    // A restricted window needs the local time
+    if (!ntpManager.isSynced()) return false;
+
+    time_t now = ntpManager.getEpochTime();
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+    uint8_t hour = timeinfo.tm_hour;
+
+    if (config.windowStartHour < config.windowEndHour) {
+        return hour >= config.windowStartHour && hour < config.windowEndHour;
+    }
+    return hour >= config.windowStartHour || hour < config.windowEndHour;
+}
+
+int8_t AutoTuner::channelIndex(uint32_t frequency) const {
+    for (uint8_t i = 0; i < status.channelCount; i++) {
+        uint32_t diff = frequency > status.channels[i] ? frequency - status.channels[i]
+                                                       : status.channels[i] - frequency;
+        if (diff <= TUNER_CHANNEL_TOLERANCE_HZ) return i;
+    }
+    return -1;
+}
+
+float AutoTuner::cellRate(const TunerCell& cell) const {
+    if (cell.exposureMs == 0) return 0;
+    return cell.packets * 3600000.0f / cell.exposureMs;
+}
+
+uint32_t AutoTuner::minExposureMs(uint8_t sfIndex) const {
+    uint32_t sweepMs = config.sweepIntervalS > 0 ? (uint32_t)config.sweepDurationS * 1000UL : 0;
+    return tunerMinExposureMs(sweepMs, sfIndex, LORA_SCAN_SF_COUNT, status.channelCount);
+}
+
+float AutoTuner::baselineRate() const {
+    if (status.baselineMs == 0) return 0;
+    return status.baselinePackets * 3600000.0f / status.baselineMs;
+}
+
+void AutoTuner::logDecision(TunerAction action, uint32_t fromFrequency, uint8_t fromSf,
+                            uint32_t toFrequency, uint8_t toSf, float rateBefore, float rateAfter) {
+    TunerDecision& d = status.decisions[status.decisionHead];
+    d.uptimeS = millis() / 1000;
+    d.action = action;
+    d.fromFrequency = fromFrequency;
+    d.fromSf = fromSf;
+    d.toFrequency = toFrequency;
+    d.toSf = toSf;
+    d.rateBefore = rateBefore;
+    d.rateAfter = rateAfter;
+
+    status.decisionHead = (status.decisionHead + 1) % TUNER_MAX_DECISIONS;
+    if (status.decisionCount < TUNER_MAX_DECISIONS) status.decisionCount++;
+
+    Serial.printf("[Tuner] %s: %.3f MHz SF%d -> %.3f MHz SF%d (%.1f -> %.1f pkt/h)\n",
+                  actionName(action), fromFrequency / 1000000.0, fromSf,
+                  toFrequency / 1000000.0, toSf, rateBefore, rateAfter);
+
+    // Decisions are published right away
+    dirty = false;
+    lastPublish = millis();
+    snapshot.publish(status);
+}
+
+// ================== Status ==================
+
+void AutoTuner::getStatusJson(JsonObject obj) const {
+    TunerStatus st = snapshot.read();
+
+    obj["enabled"] = config.enabled;
+    obj["auto_apply"] = config.autoApply;
+    obj["state"] = stateName(st.state);
+    obj["sweeps"] = st.sweeps;
+    obj["evaluations"] = st.evaluations;
+    obj["last_change_s"] = st.lastChangeS;
+
+    JsonObject baseline = obj.createNestedObject("baseline");
+    baseline["packets"] = st.baselinePackets;
+    baseline["listen_s"] = st.baselineMs / 1000;
+
+    if (st.hasRecommendation) {
+        JsonObject rec = obj.createNestedObject("recommendation");
+        rec["frequency"] = st.recommendedFrequency;
+        rec["spreading_factor"] = st.recommendedSf;
+    }
+
+    // Candidate grid: one row per channel, one column per SF7..SF12
+    JsonArray channels = obj.createNestedArray("channels");
+    JsonArray packets = obj.createNestedArray("packets");
+    JsonArray exposure = obj.createNestedArray("listen_s");
+    for (uint8_t ch = 0; ch < st.channelCount; ch++) {
+        channels.add(st.channels[ch]);
+        JsonArray p = packets.createNestedArray();
+        JsonArray e = exposure.createNestedArray();
+        for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) {
+            p.add(st.grid[ch][i].packets);
+            e.add(st.grid[ch][i].exposureMs / 1000);
+        }
+    }
+
+    // Newest first
+    JsonArray decisions = obj.createNestedArray("decisions");
+    for (uint8_t n = 0; n < st.decisionCount; n++) {
+        const TunerDecision& d =
+            st.decisions[(st.decisionHead + TUNER_MAX_DECISIONS - 1 - n) % TUNER_MAX_DECISIONS];
+        JsonObject entry = decisions.createNestedObject();
+        entry["uptime_s"] = d.uptimeS;
+        entry["action"] = actionName(d.action);
+        entry["from_frequency"] = d.fromFrequency;
+        entry["from_sf"] = d.fromSf;
+        entry["to_frequency"] = d.toFrequency;
+        entry["to_sf"] = d.toSf;
+        entry["rate_before"] = d.rateBefore;
+        entry["rate_after"] = d.rateAfter;
+    }
+}
+
+const char* AutoTuner::actionName(TunerAction action) {
+    switch (action) {
+        case TunerAction::RECOMMEND: return "recommend";
+        case TunerAction::APPLY:     return "apply";
+        case TunerAction::CONFIRM:   return "confirm";
+        case TunerAction::REVERT:    return "revert";
+        case TunerAction::ABORT:     return "abort";
+    }
+    return "unknown";
+}
+
+const char* AutoTuner::stateName(TunerState state) {
+    switch (state) {
+        case TunerState::IDLE:      return "idle";
+        case TunerState::OBSERVING: return "observing";
+        case TunerState::SWEEPING:  return "sweeping";
+        case TunerState::TRIAL:     return "trial";
+    }
+    return "unknown";
+}
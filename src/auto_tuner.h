@@ -0,0 +1,157 @@
+#ifndef AUTO_TUNER_H
+#define AUTO_TUNER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "config.h"
+#include "stats_snapshot.h"
+#include "lora_gateway.h"
+#include "auto_tuner_model.h"
+
+// =============================================================================
+// LoRa Auto Tuner
+// =============================================================================
+// Learns which channel/SF combinations carry uplinks and recommends (or
+// applies) the fixed frequency and spreading factor that captures the most.
+//
+// Candidates are the channel plan (lora.hop.channels, or the configured
+// frequency when there is none) at SF7..SF12. Periodic CAD sweeps spread the
+// receiver over all candidates; packets received while the receiver cycles
+// are counted per candidate together with the listening time each one got,
+// giving a packets/hour rate per candidate (see auto_tuner_model.h). The
+// grid carries over between observation windows with a decay, and a sweep
+// starts in every window. Packets received on the fixed configuration give
+// the baseline rate.
+//
+// Guard rails: a change needs a minimum number of packets and gain, is only
+// applied inside the schedule window and after the minimum dwell since the
+// last change, and is reverted when the next observation window shows a
+// regression. Every decision is logged with the rates it was based on.
+// Runs on the loop task; status is published through a seqlock snapshot.
+
+#define TUNER_MAX_DECISIONS         8
+
+struct AutoTunerConfig {
+    bool enabled;
+    bool autoApply;
+    uint32_t evalIntervalS;
+    uint32_t minDwellS;
+    uint32_t sweepIntervalS;
+    uint16_t sweepDurationS;
+    uint16_t minPackets;
+    uint8_t minGainPct;
+    uint8_t regressionPct;
+    uint8_t windowStartHour;    // Local time; start == end means always
+    uint8_t windowEndHour;
+};
+
+enum class TunerState : uint8_t {
+    IDLE = 0,       // Disabled or nothing to tune
+    OBSERVING,
+    SWEEPING,
+    TRIAL           // Change applied, checking for regression
+};
+
+enum class TunerAction : uint8_t {
+    RECOMMEND = 0,
+    APPLY,
+    CONFIRM,
+    REVERT,
+    ABORT           // Configuration changed by hand during a trial
+};
+
+struct TunerDecision {
+    uint32_t uptimeS;
+    TunerAction action;
+    uint32_t fromFrequency;
+    uint8_t fromSf;
+    uint32_t toFrequency;
+    uint8_t toSf;
+    float rateBefore;           // packets/hour
+    float rateAfter;            // Candidate estimate, or measured after a trial
+};
+
+// Published state (read by the web task)
+struct TunerStatus {
+    TunerState state;
+    uint8_t channelCount;
+    uint32_t channels[LORA_HOP_MAX_CHANNELS];
+    TunerCell grid[LORA_HOP_MAX_CHANNELS][LORA_SCAN_SF_COUNT];
+
+    uint32_t baselinePackets;   // Fixed configuration, decayed like the grid
+    uint32_t baselineMs;
+
+    uint32_t sweeps;
+    uint32_t evaluations;
+    uint32_t lastChangeS;       // Uptime of the last applied change (0 = none)
+
+    bool hasRecommendation;
+    uint32_t recommendedFrequency;
+    uint8_t recommendedSf;
+
+    uint8_t decisionCount;
+    uint8_t decisionHead;
+    TunerDecision decisions[TUNER_MAX_DECISIONS];
+};
+
+class AutoTuner {
+public:
+    AutoTuner();
+
+    void loadConfig(const JsonDocument& doc);
+    bool saveConfig();
+    AutoTunerConfig& getConfig() { return config; }
+
+    // Loop task
+    void update();
+    void recordPacket(const LoRaPacket& packet);
+
+    // Any task
+    TunerStatus getStatusSnapshot() const { return snapshot.read(); }
+    void getStatusJson(JsonObject obj) const;
+
+private:
+    AutoTunerConfig config;
+    TunerStatus status;
+    StatsSnapshot<TunerStatus> snapshot;
+
+    unsigned long windowStart;
+    unsigned long lastTick;
+    unsigned long lastSweep;
+    unsigned long sweepStart;
+    unsigned long trialStart;
+    unsigned long lastPublish;
+    bool dirty;
+
+    // Configuration before the change under trial
+    uint32_t trialFromFrequency;
+    uint8_t trialFromSf;
+    uint32_t trialToFrequency;
+    uint8_t trialToSf;
+    float trialRateBefore;
+
+    void setDefaultConfig();
+    void resetWindow();
+    void decayWindow();
+    void accountExposure(uint32_t elapsedMs);
+    void evaluate();
+    void finishTrial();
+
+    bool applySetting(uint32_t frequency, uint8_t sf);
+    bool inScheduleWindow() const;
+    int8_t channelIndex(uint32_t frequency) const;
+    float cellRate(const TunerCell& cell) const;
+    uint32_t minExposureMs(uint8_t sfIndex) const;
+    float baselineRate() const;
+
+    void logDecision(TunerAction action, uint32_t fromFrequency, uint8_t fromSf,
+                     uint32_t toFrequency, uint8_t toSf, float rateBefore, float rateAfter);
+
+    static const char* actionName(TunerAction action);
+    static const char* stateName(TunerState state);
+};
+
+// Global instance
+extern AutoTuner autoTuner;
+
+#endif // AUTO_TUNER_H
@@ -0,0 +1,75 @@
+#ifndef AUTO_TUNER_MODEL_H
+#define AUTO_TUNER_MODEL_H
+
+#include <stdint.h>
+
+// =============================================================================
+// Auto Tuner Exposure Model
+// =============================================================================
+// How listening time is credited to the channel/SF candidates, and how much
+// of it a candidate needs before it is rated.
+//
+// A receiver cycling SFs spends about as long on each step as its symbol
+// time, so the chance of catching a preamble at the n-th SF scales with 2^n;
+// cycled channels share the time evenly. A sweep over the whole grid gives
+// the SF7 cells 1/63 of its time split over the channels, so a fixed floor
+// would keep them unrated for good. The floor is half of what one sweep
+// gives a cell, capped at TUNER_MIN_EXPOSURE_MS (reached by the configured
+// scan mode, which listens for the whole window).
+//
+// The grid is not cleared between observation windows: packets and listening
+// time decay by TUNER_DECAY_NUM/TUNER_DECAY_DEN, so the few sweeps of each
+// window add up while old traffic fades out. Rates are unaffected, as both
+// decay alike.
+
+#define TUNER_MIN_EXPOSURE_MS       5000    // Listening time before a candidate is rated
+#define TUNER_DECAY_NUM             3       // Kept from the last window
+#define TUNER_DECAY_DEN             4
+
+// Defaults (lora.autotune)
+#define TUNER_ENABLED_DEFAULT       false
+#define TUNER_AUTO_APPLY_DEFAULT    false   // Recommend only
+#define TUNER_EVAL_INTERVAL_DEFAULT 900     // s, observation window
+#define TUNER_MIN_DWELL_DEFAULT     3600    // s between applied changes
+#define TUNER_SWEEP_INTERVAL_DEFAULT 900    // s between sweep starts, at most one window (0 = no sweeps)
+#define TUNER_SWEEP_DURATION_DEFAULT 60     // s per sweep
+#define TUNER_MIN_PACKETS_DEFAULT   5
+#define TUNER_MIN_GAIN_DEFAULT      25      // % better than the current setting
+#define TUNER_REGRESSION_DEFAULT    30      // % worse than before: revert
+
+struct TunerCell {
+    uint32_t packets;
+    uint32_t exposureMs;
+};
+
+// Weight of the SF at sfIndex (0 = lowest) in an SF cycle
+inline uint32_t tunerSfWeight(uint8_t sfIndex) {
+    return 1UL << sfIndex;
+}
+
+// Listening time one cell gets out of elapsedMs
+inline uint32_t tunerCellExposureMs(uint32_t elapsedMs, uint32_t weight, uint32_t totalWeight,
+                                    uint8_t channelCount) {
+    if (totalWeight == 0 || channelCount == 0) return 0;
+    return (uint32_t)((uint64_t)elapsedMs * weight / totalWeight / channelCount);
+}
+
+// Listening time a cell needs before it is rated, for sweeps of sweepMs over
+// sfCount SFs and channelCount channels (sweepMs 0 = no sweeps)
+inline uint32_t tunerMinExposureMs(uint32_t sweepMs, uint8_t sfIndex, uint8_t sfCount,
+                                   uint8_t channelCount) {
+    uint32_t totalWeight = (1UL << sfCount) - 1;
+    uint32_t perSweep = tunerCellExposureMs(sweepMs, tunerSfWeight(sfIndex), totalWeight,
+                                            channelCount);
+    uint32_t floor = perSweep / 2;
+    if (sweepMs == 0 || floor > TUNER_MIN_EXPOSURE_MS) return TUNER_MIN_EXPOSURE_MS;
+    return floor > 0 ? floor : 1;
+}
+
+// Carry a cell over to the next observation window
+inline void tunerDecayCell(TunerCell& cell) {
+    cell.packets = cell.packets * TUNER_DECAY_NUM / TUNER_DECAY_DEN;
+    cell.exposureMs = (uint32_t)((uint64_t)cell.exposureMs * TUNER_DECAY_NUM / TUNER_DECAY_DEN);
+}
+
+#endif // AUTO_TUNER_MODEL_H
@@ -0,0 +1,60 @@
+#include "bad_frame_log.h"
+
+// Global instance
+BadFrameLog badFrameLog;
+
+BadFrameLog::BadFrameLog()
+    : total(0)
+    , mux(portMUX_INITIALIZER_UNLOCKED)
+{
+    memset(frames, 0, sizeof(frames));
+}
+
+void BadFrameLog::record(const LoRaPacket& packet) {
+    uint32_t now = millis();
+
+    portENTER_CRITICAL(&mux);
+    total++;
+    BadFrame& frame = frames[(total - 1) % BAD_FRAME_LOG_SIZE];
+    frame.seq = total;
+    frame.uptimeMs = now;
+    frame.packet = packet;
+    portEXIT_CRITICAL(&mux);
+}
+
+bool BadFrameLog::get(uint32_t seq, BadFrame& frame) {
+    if (seq == 0) return false;
+
+    bool found = false;
+
+    portENTER_CRITICAL(&mux);
+    const BadFrame& slot = frames[(seq - 1) % BAD_FRAME_LOG_SIZE];
+    if (slot.seq == seq) {
+        frame = slot;
+        found = true;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return found;
+}
+
+uint32_t BadFrameLog::firstSeq() {
+    portENTER_CRITICAL(&mux);
+    uint32_t first = total > BAD_FRAME_LOG_SIZE ? total - BAD_FRAME_LOG_SIZE + 1 : 1;
+    portEXIT_CRITICAL(&mux);
+    return first;
+}
+
+uint32_t BadFrameLog::lastSeq() {
+    portENTER_CRITICAL(&mux);
+    uint32_t last = total;
+    portEXIT_CRITICAL(&mux);
+    return last;
+}
+
+void BadFrameLog::clear() {
+    portENTER_CRITICAL(&mux);
+    memset(frames, 0, sizeof(frames));
+    total = 0;
+    portEXIT_CRITICAL(&mux);
+}
@@ -0,0 +1,56 @@
+#ifndef BAD_FRAME_LOG_H
+#define BAD_FRAME_LOG_H
+
+#include <Arduino.h>
+#include "lora_gateway.h"
+
+// =============================================================================
+// Bad Frame Log
+// =============================================================================
+// The last BAD_FRAME_LOG_SIZE frames received with a payload CRC error, with
+// their RF metadata, for offline interference analysis (/api/lora/badframes).
+// A corrupted frame still tells where and how strong the interferer or the
+// colliding device was, and which bytes were hit.
+//
+// Fixed ring, the oldest frame is overwritten. Every frame gets a sequence
+// number so a reader walking the ring while the radio task writes can tell
+// an overwritten slot from the frame it asked for.
+//
+// Written by the radio task, only on the CRC error path; readers copy one
+// frame at a time under a short critical section.
+
+#define BAD_FRAME_LOG_SIZE      16      // Frames kept (about 290 bytes each)
+
+struct BadFrame {
+    uint32_t seq;               // 1 for the first frame since boot/clear
+    uint32_t uptimeMs;          // millis() at reception
+    LoRaPacket packet;          // crcOk = false
+};
+
+class BadFrameLog {
+public:
+    BadFrameLog();
+
+    // Radio task
+    void record(const LoRaPacket& packet);
+
+    // Any task: copy the frame with this sequence number; false once it has
+    // been overwritten (or was never recorded)
+    bool get(uint32_t seq, BadFrame& frame);
+
+    // Sequence numbers still in the ring: first..last (empty when last < first)
+    uint32_t firstSeq();
+    uint32_t lastSeq();
+
+    void clear();
+
+private:
+    BadFrame frames[BAD_FRAME_LOG_SIZE];
+    uint32_t total;             // Frames recorded, also the last sequence number
+    portMUX_TYPE mux;
+};
+
+// Global instance
+extern BadFrameLog badFrameLog;
+
+#endif // BAD_FRAME_LOG_H
@@ -0,0 +1,90 @@
+#include "boot_profiler.h"
+#include <esp_timer.h>
+
+// Global instance
+BootProfiler bootProfiler;
+
+BootProfiler::BootProfiler()
+    : stageCount(0)
+    , loraRxUs(0)
+    , completeUs(0)
+    , mux(portMUX_INITIALIZER_UNLOCKED)
+{
+}
+
+int BootProfiler::beginStage(const char* name) {
+    int64_t now = esp_timer_get_time();
+    int handle = -1;
+
+    portENTER_CRITICAL(&mux);
+    if (stageCount < BOOT_PROFILER_MAX_STAGES) {
+        handle = stageCount++;
+        stages[handle].name = name;
+        stages[handle].startUs = now;
+        stages[handle].endUs = 0;
+        stages[handle].core = xPortGetCoreID();
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return handle;
+}
+
+void BootProfiler::endStage(int handle) {
+    if (handle < 0 || handle >= BOOT_PROFILER_MAX_STAGES) return;
+
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&mux);
+    stages[handle].endUs = now;
+    portEXIT_CRITICAL(&mux);
+}
+
+void BootProfiler::markLoraReceiving() {
+    if (loraRxUs != 0) return;
+    loraRxUs = esp_timer_get_time();
+    Serial.printf("[Boot] LoRa receiving %lu ms after reset%s\n",
+                  (unsigned long)(loraRxUs / 1000),
+                  loraRxUs / 1000 <= BOOT_LORA_RX_TARGET_MS ? "" : " (over target)");
+}
+
+void BootProfiler::markComplete() {
+    completeUs = esp_timer_get_time();
+}
+
+void BootProfiler::toJson(JsonObject obj) const {
+    obj["lora_rx_ms"] = getLoraRxMs();
+    obj["lora_rx_target_ms"] = BOOT_LORA_RX_TARGET_MS;
+    obj["lora_rx_on_target"] = loraRxUs != 0 && getLoraRxMs() <= BOOT_LORA_RX_TARGET_MS;
+    obj["complete"] = isComplete();
+    obj["total_ms"] = getTotalMs();
+
+    JsonArray arr = obj.createNestedArray("stages");
+    for (uint8_t i = 0; i < stageCount; i++) {
+        const Stage& s = stages[i];
+        JsonObject stage = arr.createNestedObject();
+        stage["name"] = s.name;
+        stage["core"] = s.core;
+        stage["start_ms"] = (uint32_t)(s.startUs / 1000);
+        if (s.endUs != 0) {
+            stage["duration_ms"] = (float)(s.endUs - s.startUs) / 1000.0f;
+        } else {
+            stage["duration_ms"] = nullptr;   // Still running
+        }
+    }
+}
+
+void BootProfiler::printSummary() const {
+    Serial.println("[Boot] Stage                 Core  Start(ms)  Duration(ms)");
+    for (uint8_t i = 0; i < stageCount; i++) {
+        const Stage& s = stages[i];
+        if (s.endUs != 0) {
+            Serial.printf("[Boot] %-20s  %u     %7lu    %9.1f\n", s.name, s.core,
+                          (unsigned long)(s.startUs / 1000),
+                          (float)(s.endUs - s.startUs) / 1000.0f);
+        } else {
+            Serial.printf("[Boot] %-20s  %u     %7lu    (running)\n", s.name, s.core,
+                          (unsigned long)(s.startUs / 1000));
+        }
+    }
+    Serial.printf("[Boot] LoRa RX at %lu ms, boot complete at %lu ms\n",
+                  (unsigned long)getLoraRxMs(), (unsigned long)getTotalMs());
+}
@@ -0,0 +1,60 @@
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// =============================================================================
+// Boot Profiler
+// =============================================================================
+// Records per-stage durations of the boot sequence (setup() and the
+// peripheral boot task) relative to reset, so slow stages show up in
+// /api/status. Stages may be recorded from both cores.
+
+#define BOOT_PROFILER_MAX_STAGES    24
+#define BOOT_LORA_RX_TARGET_MS      1000    // Target: radio receiving < 1s after reset
+
+class BootProfiler {
+public:
+    BootProfiler();
+
+    // Start a stage; returns handle for endStage() (-1 if table is full)
+    int beginStage(const char* name);
+
+    // Finish a stage started with beginStage()
+    void endStage(int handle);
+
+    // Milestones
+    void markLoraReceiving();
+    void markComplete();
+
+    // Status
+    bool isComplete() const { return completeUs != 0; }
+    uint32_t getLoraRxMs() const { return (uint32_t)(loraRxUs / 1000); }
+    uint32_t getTotalMs() const { return (uint32_t)(completeUs / 1000); }
+
+    // Fill JSON object for /api/status
+    void toJson(JsonObject obj) const;
+
+    // Print stage table to Serial
+    void printSummary() const;
+
+private:
+    struct Stage {
+        const char* name;   // Must be a string literal
+        int64_t startUs;    // Since reset (esp_timer)
+        int64_t endUs;      // 0 while running
+        uint8_t core;
+    };
+
+    Stage stages[BOOT_PROFILER_MAX_STAGES];
+    uint8_t stageCount;
+    int64_t loraRxUs;
+    int64_t completeUs;
+    portMUX_TYPE mux;
+};
+
+// Global instance
+extern BootProfiler bootProfiler;
+
+#endif // BOOT_PROFILER_H
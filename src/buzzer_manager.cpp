@@ -6,7 +6,7 @@
  */
 
 #include "buzzer_manager.h"
-#include <LittleFS.h>
+#include "config_store.h"
 
 // Global instance
 BuzzerManager buzzer;
@@ -229,41 +229,20 @@ void BuzzerManager::loadConfig(const JsonDocument& doc) {
 
 bool BuzzerManager::saveConfig() {
 #if BUZZER_ENABLED
-    // Read existing config
-    File file = LittleFS.open("/config.json", "r");
-    if (!file) {
-        Serial.println(F("[BUZZER] Cannot read config file"));
+    ConfigSectionView section = configStore.edit(ConfigSection::BUZZER);
+    if (!section.isValid()) {
+        Serial.println(F("[BUZZER] Config store not available"));
         return false;
     }
 
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
-
-    if (error) {
-        Serial.print(F("[BUZZER] JSON parse error: "));
-        Serial.println(error.c_str());
-        return false;
-    }
-
-    // Update buzzer section
-    JsonObject buzzerCfg = doc.createNestedObject("buzzer");
+    // Update buzzer section (written by configStore after debounce)
+    JsonObject buzzerCfg = section.obj();
     buzzerCfg["enabled"] = _config.enabled;
     buzzerCfg["startup_sound"] = _config.startupSound;
     buzzerCfg["packet_rx_sound"] = _config.packetRxSound;
     buzzerCfg["packet_tx_sound"] = _config.packetTxSound;
     buzzerCfg["volume"] = _config.volume;
 
-    // Write back
-    file = LittleFS.open("/config.json", "w");
-    if (!file) {
-        Serial.println(F("[BUZZER] Cannot write config file"));
-        return false;
-    }
-
-    serializeJsonPretty(doc, file);
-    file.close();
-
     Serial.println(F("[BUZZER] Config saved"));
     return true;
 #else
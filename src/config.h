@@ -28,6 +28,26 @@
 #define LORA_SYNC_WORD_DEFAULT 0x34        // LoRaWAN public sync word
 #define LORA_POWER_DEFAULT 14              // TX power in dBm
 
+// CAD multi-SF scanning (off: fixed spreading factor)
+#define LORA_SCAN_ENABLED_DEFAULT false
+#define LORA_SCAN_DWELL_DEFAULT 0          // ms locked after detection, 0 = automatic per SF
+
+// Channel hopping receiver (off: single fixed frequency)
+#define LORA_HOP_ENABLED_DEFAULT false
+
+// Noise-floor sampler (RSSI while the receiver is idle)
+#define LORA_NOISE_ENABLED_DEFAULT true
+#define LORA_NOISE_SWEEP_DEFAULT 0         // s between channel plan sweeps, 0 = no sweeps
+
+// Crystal drift compensation (FRF trimmed from the per-frame frequency error)
+#define LORA_DRIFT_CORRECTION_DEFAULT true
+
+// Receiver watchdog (radio polled after a period without DIO0 interrupts)
+#define LORA_WATCHDOG_TIMEOUT_DEFAULT 120  // s, 0 = off
+
+// Frames with a payload CRC error (off: counted and logged, not forwarded)
+#define LORA_FORWARD_CRC_ERRORS_DEFAULT false
+
 // I2C Clock Speed
 #define I2C_CLOCK_SPEED 100000
 
@@ -0,0 +1,260 @@
+#include "config_snapshot.h"
+#include "config_store.h"
+#include "wifi_connector.h"
+#include <LittleFS.h>
+#include <stddef.h>
+#include <vector>
+
+// Global instance
+ConfigSnapshot configSnapshot;
+
+// External references (main.cpp)
+extern String wifiHostname;
+extern String wifiSSID;
+extern String wifiPassword;
+extern bool wifiAPMode;
+extern std::vector<WiFiNetwork> wifiNetworks;
+
+ConfigSnapshot::ConfigSnapshot()
+    : usedSnapshot(false)
+    , loadUs(0)
+    , jsonLoadUs(0)
+{
+}
+
+// FNV-1a over the size and offset of every field group; a field added,
+// removed, resized or moved changes it even when the total size does not
+uint32_t ConfigSnapshot::layoutHash() {
+    const uint32_t layout[] = {
+        sizeof(ConfigSnapshotData),
+        offsetof(ConfigSnapshotData, wifi),     sizeof(SnapshotWiFiConfig),
+        offsetof(ConfigSnapshotData, lora),     sizeof(GatewayConfig),
+        offsetof(GatewayConfig, frequency),     offsetof(GatewayConfig, syncWord),
+        offsetof(GatewayConfig, scanSfList),    offsetof(GatewayConfig, hopChannels),
+        offsetof(GatewayConfig, noiseEnabled),  offsetof(GatewayConfig, driftCorrection),
+        offsetof(GatewayConfig, watchdogTimeoutS), offsetof(GatewayConfig, forwardCrcErrors),
+        offsetof(ConfigSnapshotData, tuner),    sizeof(AutoTunerConfig),
+        offsetof(ConfigSnapshotData, server),   sizeof(ForwarderConfig),
+        offsetof(ForwarderConfig, region),
+        offsetof(ConfigSnapshotData, filter),   sizeof(FilterConfig),
+        offsetof(ConfigSnapshotData, ntp),      sizeof(NTPConfig),
+        offsetof(ConfigSnapshotData, lcd),      sizeof(LCDConfig),
+        offsetof(ConfigSnapshotData, buzzer),   sizeof(BuzzerConfig),
+        offsetof(ConfigSnapshotData, gps),      sizeof(GPSConfig),
+        offsetof(ConfigSnapshotData, rtc),      sizeof(RTCConfig),
+        offsetof(ConfigSnapshotData, network),  sizeof(SnapshotNetworkConfig),
+    };
+
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < sizeof(layout) / sizeof(layout[0]); i++) {
+        hash = (hash ^ layout[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+bool ConfigSnapshot::load(uint32_t sourceCrc, uint32_t sourceLength) {
+    File file = LittleFS.open(CONFIG_SNAPSHOT_PATH, "r");
+    if (!file) {
+        return false;
+    }
+
+    // Header and payload in a single read
+    uint8_t buffer[sizeof(ConfigSnapshotHeader) + sizeof(ConfigSnapshotData)];
+    size_t bytesRead = file.read(buffer, sizeof(buffer));
+    file.close();
+
+    if (bytesRead != sizeof(buffer)) {
+        Serial.println("[Config] Snapshot size mismatch, using JSON");
+        return false;
+    }
+
+    ConfigSnapshotHeader header;
+    memcpy(&header, buffer, sizeof(header));
+
+    if (header.magic != CONFIG_SNAPSHOT_MAGIC ||
+        header.version != CONFIG_SNAPSHOT_VERSION ||
+        header.dataSize != sizeof(ConfigSnapshotData) ||
+        header.layoutHash != layoutHash()) {
+        Serial.println("[Config] Snapshot version mismatch, using JSON");
+        return false;
+    }
+
+    if (header.sourceCrc != sourceCrc || header.sourceLength != sourceLength) {
+        Serial.println("[Config] Snapshot is older than config.json, using JSON");
+        return false;
+    }
+
+    const uint8_t* payload = buffer + sizeof(header);
+    if (ConfigStore::crc32(payload, sizeof(ConfigSnapshotData)) != header.dataCrc) {
+        Serial.println("[Config] Snapshot CRC error, using JSON");
+        return false;
+    }
+
+    ConfigSnapshotData data;
+    memcpy(&data, payload, sizeof(data));
+    apply(data);
+
+    jsonLoadUs = header.jsonLoadUs;
+    return true;
+}
+
+bool ConfigSnapshot::save(uint32_t sourceCrc, uint32_t sourceLength) {
+    ConfigSnapshotData data;
+    memset(&data, 0, sizeof(data));
+    capture(data);
+
+    ConfigSnapshotHeader header;
+    header.magic = CONFIG_SNAPSHOT_MAGIC;
+    header.version = CONFIG_SNAPSHOT_VERSION;
+    header.dataSize = sizeof(ConfigSnapshotData);
+    header.layoutHash = layoutHash();
+    header.sourceCrc = sourceCrc;
+    header.sourceLength = sourceLength;
+    header.jsonLoadUs = jsonLoadUs;
+    header.dataCrc = ConfigStore::crc32((const uint8_t*)&data, sizeof(data));
+
+    File file = LittleFS.open(CONFIG_SNAPSHOT_PATH, "w");
+    if (!file) {
+        Serial.println("[Config] Cannot write snapshot");
+        return false;
+    }
+
+    size_t written = file.write((const uint8_t*)&header, sizeof(header));
+    written += file.write((const uint8_t*)&data, sizeof(data));
+    file.close();
+
+    if (written != sizeof(header) + sizeof(data)) {
+        Serial.println("[Config] Short write, removing snapshot");
+        LittleFS.remove(CONFIG_SNAPSHOT_PATH);
+        return false;
+    }
+
+    Serial.printf("[Config] Snapshot saved (%u bytes)\n", (unsigned)written);
+    return true;
+}
+
+void ConfigSnapshot::setLoadTime(bool fromSnapshot, uint32_t us) {
+    usedSnapshot = fromSnapshot;
+    loadUs = us;
+    if (!fromSnapshot) {
+        jsonLoadUs = us;
+    }
+
+    Serial.printf("[Config] Loaded from %s in %.1f ms\n",
+                  fromSnapshot ? "snapshot" : "JSON", us / 1000.0f);
+}
+
+void ConfigSnapshot::getStatusJson(JsonObject obj) const {
+    obj["source"] = usedSnapshot ? "snapshot" : "json";
+    obj["load_ms"] = loadUs / 1000.0f;
+    obj["json_load_ms"] = jsonLoadUs / 1000.0f;
+}
+
+void ConfigSnapshot::capture(ConfigSnapshotData& data) {
+    // WiFi
+    strlcpy(data.wifi.hostname, wifiHostname.c_str(), sizeof(data.wifi.hostname));
+    data.wifi.apMode = wifiAPMode;
+    data.wifi.networkCount = 0;
+    for (const WiFiNetwork& network : wifiNetworks) {
+        if (data.wifi.networkCount >= WIFI_MAX_NETWORKS) break;
+        strlcpy(data.wifi.networks[data.wifi.networkCount].ssid, network.ssid.c_str(),
+                sizeof(data.wifi.networks[0].ssid));
+        strlcpy(data.wifi.networks[data.wifi.networkCount].password, network.password.c_str(),
+                sizeof(data.wifi.networks[0].password));
+        data.wifi.networkCount++;
+    }
+
+    // Modules
+    data.lora = loraGateway.getConfig();
+    data.tuner = autoTuner.getConfig();
+    data.server = udpForwarder.getConfig();
+    data.filter = packetFilter.getConfig();
+    data.ntp = ntpManager.getConfig();
+    data.lcd = lcdManager.getConfig();
+    data.buzzer = buzzer.getConfig();
+    data.gps = gpsManager.getConfig();
+    data.rtc = rtcManager.getConfig();
+
+    // Network
+    if (networkManager) {
+        data.network.manager = networkManager->getConfig();
+
+        EthernetConfig& eth = networkManager->getEthernet()->getConfig();
+        data.network.ethEnabled = eth.enabled;
+        data.network.ethDhcp = eth.useDHCP;
+        data.network.ethStaticIP = (uint32_t)eth.staticIP;
+        data.network.ethGateway = (uint32_t)eth.gateway;
+        data.network.ethSubnet = (uint32_t)eth.subnet;
+        data.network.ethDns = (uint32_t)eth.dns;
+        data.network.ethDhcpTimeout = eth.dhcpTimeout;
+
+        WiFiConfig& wifi = networkManager->getWiFi()->getConfig();
+        data.network.wifiDhcp = wifi.useDHCP;
+        data.network.wifiStaticIP = (uint32_t)wifi.staticIP;
+        data.network.wifiGateway = (uint32_t)wifi.gateway;
+        data.network.wifiSubnet = (uint32_t)wifi.subnet;
+        data.network.wifiDns = (uint32_t)wifi.dns;
+    }
+}
+
+void ConfigSnapshot::apply(const ConfigSnapshotData& data) {
+    // WiFi (same rules as loadConfig in main.cpp)
+    wifiHostname = data.wifi.hostname;
+    wifiAPMode = data.wifi.apMode;
+    wifiNetworks.clear();
+    for (uint8_t i = 0; i < data.wifi.networkCount && i < WIFI_MAX_NETWORKS; i++) {
+        WiFiNetwork wn;
+        wn.ssid = data.wifi.networks[i].ssid;
+        wn.password = data.wifi.networks[i].password;
+        wifiNetworks.push_back(wn);
+    }
+    if (!wifiNetworks.empty()) {
+        wifiSSID = wifiNetworks[0].ssid;
+        wifiPassword = wifiNetworks[0].password;
+    } else {
+        wifiSSID = WIFI_SSID_DEFAULT;
+        wifiPassword = WIFI_PASS_DEFAULT;
+    }
+
+    // Modules
+    loraGateway.getConfig() = data.lora;
+    autoTuner.getConfig() = data.tuner;
+    udpForwarder.setConfig(data.server);
+    packetFilter.setConfig(data.filter);
+    ntpManager.getConfig() = data.ntp;
+    lcdManager.getConfig() = data.lcd;
+    buzzer.getConfig() = data.buzzer;
+    gpsManager.getConfig() = data.gps;
+    rtcManager.getConfig() = data.rtc;
+
+    // Network
+    if (networkManager) {
+        networkManager->getConfig() = data.network.manager;
+
+        EthernetConfig& eth = networkManager->getEthernet()->getConfig();
+        eth.enabled = data.network.ethEnabled;
+        eth.useDHCP = data.network.ethDhcp;
+        eth.staticIP = IPAddress(data.network.ethStaticIP);
+        eth.gateway = IPAddress(data.network.ethGateway);
+        eth.subnet = IPAddress(data.network.ethSubnet);
+        eth.dns = IPAddress(data.network.ethDns);
+        eth.dhcpTimeout = data.network.ethDhcpTimeout;
+
+        WiFiAdapter* wifiAdapter = networkManager->getWiFi();
+        WiFiConfig& wifi = wifiAdapter->getConfig();
+        wifi.useDHCP = data.network.wifiDhcp;
+        wifi.staticIP = IPAddress(data.network.wifiStaticIP);
+        wifi.gateway = IPAddress(data.network.wifiGateway);
+        wifi.subnet = IPAddress(data.network.wifiSubnet);
+        wifi.dns = IPAddress(data.network.wifiDns);
+
+        // Same side effect as NetworkManager::loadConfig()
+        if (!wifi.useDHCP) {
+            wifiAdapter->applyStaticIPConfig();
+        }
+    }
+
+    Serial.printf("[Config] Snapshot applied: %u network(s), LoRa %.2f MHz SF%d\n",
+                  data.wifi.networkCount, data.lora.frequency / 1000000.0,
+                  data.lora.spreadingFactor);
+}
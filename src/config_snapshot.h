@@ -0,0 +1,117 @@
+#ifndef CONFIG_SNAPSHOT_H
+#define CONFIG_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "config.h"
+#include "lora_gateway.h"
+#include "udp_forwarder.h"
+#include "ntp_manager.h"
+#include "lcd_manager.h"
+#include "buzzer_manager.h"
+#include "gps_manager.h"
+#include "rtc_manager.h"
+#include "network_manager.h"
+#include "auto_tuner.h"
+#include "packet_filter.h"
+
+// =============================================================================
+// Config Snapshot
+// =============================================================================
+// Binary image of every module config struct, written after a boot that had
+// to parse /config.json. It is keyed on the CRC/length of that JSON file (from
+// the config store sidecar), so any change to the JSON invalidates it and the
+// next boot parses the JSON once more and regenerates it. A valid snapshot is
+// applied with a single file read and no JSON parsing.
+
+#define CONFIG_SNAPSHOT_PATH        "/config.bin"
+#define CONFIG_SNAPSHOT_MAGIC       0x50534643  // "CFSP"
+#define CONFIG_SNAPSHOT_VERSION     2           // Bump when a config struct changes (layout or meaning)
+
+// WiFi station settings (main.cpp globals)
+struct SnapshotWiFiConfig {
+    char hostname[33];
+    bool apMode;
+    uint8_t networkCount;
+    struct {
+        char ssid[33];
+        char password[65];
+    } networks[WIFI_MAX_NETWORKS];
+};
+
+// NetworkManager settings (IPAddress stored as uint32_t)
+struct SnapshotNetworkConfig {
+    NetworkManagerConfig manager;
+
+    bool ethEnabled;
+    bool ethDhcp;
+    uint32_t ethStaticIP;
+    uint32_t ethGateway;
+    uint32_t ethSubnet;
+    uint32_t ethDns;
+    uint16_t ethDhcpTimeout;
+
+    bool wifiDhcp;
+    uint32_t wifiStaticIP;
+    uint32_t wifiGateway;
+    uint32_t wifiSubnet;
+    uint32_t wifiDns;
+};
+
+// Snapshot payload (all module configs)
+struct ConfigSnapshotData {
+    SnapshotWiFiConfig wifi;
+    GatewayConfig lora;
+    AutoTunerConfig tuner;
+    ForwarderConfig server;
+    FilterConfig filter;
+    NTPConfig ntp;
+    LCDConfig lcd;
+    BuzzerConfig buzzer;
+    GPSConfig gps;
+    RTCConfig rtc;
+    SnapshotNetworkConfig network;
+};
+
+// File header
+struct ConfigSnapshotHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t dataSize;          // sizeof(ConfigSnapshotData)
+    uint32_t layoutHash;        // Struct sizes and field offsets - catches same-size layout changes
+    uint32_t sourceCrc;         // CRC32 of /config.json the snapshot was built from
+    uint32_t sourceLength;
+    uint32_t jsonLoadUs;        // JSON load time measured when the snapshot was built
+    uint32_t dataCrc;           // CRC32 of the payload
+};
+
+class ConfigSnapshot {
+public:
+    ConfigSnapshot();
+
+    // Apply snapshot to modules if it matches the given JSON CRC/length
+    bool load(uint32_t sourceCrc, uint32_t sourceLength);
+
+    // Capture current module configs (after a JSON load)
+    bool save(uint32_t sourceCrc, uint32_t sourceLength);
+
+    // Record how long config loading took this boot
+    void setLoadTime(bool fromSnapshot, uint32_t loadUs);
+
+    // Status for /api/status
+    void getStatusJson(JsonObject obj) const;
+
+private:
+    bool usedSnapshot;
+    uint32_t loadUs;            // This boot
+    uint32_t jsonLoadUs;        // Last measured JSON path (this boot or when snapshot was built)
+
+    static uint32_t layoutHash();
+    void capture(ConfigSnapshotData& data);
+    void apply(const ConfigSnapshotData& data);
+};
+
+// Global instance
+extern ConfigSnapshot configSnapshot;
+
+#endif // CONFIG_SNAPSHOT_H
@@ -0,0 +1,461 @@
+#include "config_store.h"
+#include <LittleFS.h>
+
+// Global instance
+ConfigStore configStore;
+
+static const char* const SECTION_NAMES[(uint8_t)ConfigSection::COUNT] = {
+    "wifi", "lora", "server", "ntp", "lcd", "buzzer", "gps", "rtc", "network"
+};
+
+// CRC sidecar layout: magic, CRC32 and length of /config.json
+struct ConfigCrcRecord {
+    uint32_t magic;
+    uint32_t crc;
+    uint32_t length;
+};
+
+static const uint32_t CONFIG_CRC_MAGIC = 0x43464743;  // "CFGC"
+
+// ============================================================================
+// ConfigSectionView
+// ============================================================================
+
+ConfigSectionView::ConfigSectionView(ConfigStore* store, ConfigSection section,
+                                     JsonObject object, bool writable)
+    : store(store)
+    , section(section)
+    , object(object)
+    , writable(writable)
+{
+}
+
+ConfigSectionView::ConfigSectionView(ConfigSectionView&& other)
+    : store(other.store)
+    , section(other.section)
+    , object(other.object)
+    , writable(other.writable)
+{
+    other.store = nullptr;
+}
+
+ConfigSectionView::~ConfigSectionView() {
+    if (!store) return;
+
+    if (writable) {
+        store->markDirty(section);
+    }
+    store->unlock();
+}
+
+// ============================================================================
+// ConfigStore
+// ============================================================================
+
+ConfigStore::ConfigStore()
+    : doc(JSON_BUFFER_SIZE)
+    , mutex(nullptr)
+    , loaded(false)
+    , dirtyMask(0)
+    , firstDirtyAt(0)
+    , lastDirtyAt(0)
+    , generation(0)
+{
+    memset(sectionGeneration, 0, sizeof(sectionGeneration));
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool ConfigStore::begin(bool deferParse) {
+    if (!mutex) {
+        mutex = xSemaphoreCreateRecursiveMutex();
+    }
+
+    if (deferParse) {
+        return true;
+    }
+
+    lock();
+    loaded = false;
+
+    uint32_t expectedCrc = 0;
+    size_t expectedLength = 0;
+    bool haveCrc = readCrcFile(expectedCrc, expectedLength);
+
+    uint32_t crc = 0;
+    size_t length = 0;
+    bool parsed = parseFile(CONFIG_FILE_PATH, crc, length);
+
+    if (parsed && haveCrc && (crc != expectedCrc || length != expectedLength)) {
+        // Either a write was interrupted after the temp file was complete,
+        // or the file was edited outside the store
+        stats.crcMismatches++;
+        Serial.printf("[Config] CRC mismatch (file %08X, expected %08X)\n", crc, expectedCrc);
+
+        uint32_t tmpCrc = 0;
+        size_t tmpLength = 0;
+        if (LittleFS.exists(CONFIG_TMP_PATH) &&
+            parseFile(CONFIG_TMP_PATH, tmpCrc, tmpLength) &&
+            tmpCrc == expectedCrc && tmpLength == expectedLength) {
+            LittleFS.rename(CONFIG_TMP_PATH, CONFIG_FILE_PATH);
+            stats.recoveries++;
+            Serial.println("[Config] Recovered config from interrupted write");
+        } else {
+            // Keep /config.json as-is (external edit) and re-anchor the CRC
+            parseFile(CONFIG_FILE_PATH, crc, length);
+            writeCrcFile(crc, length);
+        }
+    } else if (!parsed) {
+        // Main file missing or corrupt: a complete temp file may remain
+        uint32_t tmpCrc = 0;
+        size_t tmpLength = 0;
+        if (LittleFS.exists(CONFIG_TMP_PATH) && parseFile(CONFIG_TMP_PATH, tmpCrc, tmpLength) &&
+            (!haveCrc || (tmpCrc == expectedCrc && tmpLength == expectedLength))) {
+            LittleFS.rename(CONFIG_TMP_PATH, CONFIG_FILE_PATH);
+            stats.recoveries++;
+            parsed = true;
+            Serial.println("[Config] Recovered config from temp file");
+        }
+    } else if (!haveCrc) {
+        writeCrcFile(crc, length);
+    }
+
+    if (LittleFS.exists(CONFIG_TMP_PATH)) {
+        LittleFS.remove(CONFIG_TMP_PATH);
+    }
+
+    if (parsed) {
+        loaded = true;
+        generation++;
+        for (uint8_t i = 0; i < (uint8_t)ConfigSection::COUNT; i++) {
+            sectionGeneration[i] = generation;
+        }
+    } else {
+        doc.clear();
+    }
+
+    unlock();
+    return loaded;
+}
+
+void ConfigStore::lock() {
+    if (mutex) {
+        xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    }
+}
+
+void ConfigStore::unlock() {
+    if (mutex) {
+        xSemaphoreGiveRecursive(mutex);
+    }
+}
+
+ConfigSectionView ConfigStore::edit(ConfigSection section) {
+    return openSection(section, true);
+}
+
+ConfigSectionView ConfigStore::read(ConfigSection section) {
+    return openSection(section, false);
+}
+
+bool ConfigStore::getFileCrc(uint32_t& crc, size_t& length) {
+    if (!readCrcFile(crc, length)) {
+        return false;
+    }
+
+    File file = LittleFS.open(CONFIG_FILE_PATH, "r");
+    if (!file) {
+        return false;
+    }
+    size_t size = file.size();
+    file.close();
+
+    return size == length;
+}
+
+bool ConfigStore::ensureLoaded() {
+    if (loaded) return true;
+
+    // Deferred parse: first access after a snapshot boot
+    lock();
+    bool ok = loaded || begin();
+    unlock();
+    return ok;
+}
+
+ConfigSectionView ConfigStore::openSection(ConfigSection section, bool writable) {
+    if (!mutex || section >= ConfigSection::COUNT || !ensureLoaded()) {
+        return ConfigSectionView(nullptr, section, JsonObject(), false);
+    }
+
+    lock();
+
+    const char* name = sectionName(section);
+    JsonObject object;
+    if (doc[name].is<JsonObject>()) {
+        object = doc[name].as<JsonObject>();
+    } else if (writable) {
+        object = doc.createNestedObject(name);
+    }
+
+    return ConfigSectionView(this, section, object, writable);
+}
+
+void ConfigStore::markDirty(ConfigSection section) {
+    unsigned long now = millis();
+    if (dirtyMask == 0) {
+        firstDirtyAt = now;
+    }
+    lastDirtyAt = now;
+    dirtyMask |= (1 << (uint8_t)section);
+
+    generation++;
+    sectionGeneration[(uint8_t)section] = generation;
+    stats.edits++;
+}
+
+bool ConfigStore::replaceDocument(const JsonDocument& source) {
+    if (!mutex) {
+        mutex = xSemaphoreCreateRecursiveMutex();
+    }
+
+    lock();
+    doc.set(source);
+    loaded = true;
+    for (uint8_t i = 0; i < (uint8_t)ConfigSection::COUNT; i++) {
+        markDirty((ConfigSection)i);
+    }
+    bool ok = flush();
+    unlock();
+
+    return ok;
+}
+
+bool ConfigStore::reloadFromFile() {
+    lock();
+
+    uint32_t crc = 0;
+    size_t length = 0;
+    bool ok = parseFile(CONFIG_FILE_PATH, crc, length);
+    if (ok) {
+        // An external edit wins over edits not yet written; on a failed
+        // parse they stay pending and are written as usual
+        dirtyMask = 0;
+        writeCrcFile(crc, length);
+        generation++;
+        for (uint8_t i = 0; i < (uint8_t)ConfigSection::COUNT; i++) {
+            sectionGeneration[i] = generation;
+        }
+        Serial.println("[Config] Reloaded after external edit");
+    } else {
+        Serial.println("[Config] External edit is not valid JSON, keeping memory copy");
+    }
+
+    unlock();
+    return ok;
+}
+
+void ConfigStore::update() {
+    if (dirtyMask == 0) return;
+
+    unsigned long now = millis();
+    if (now - lastDirtyAt >= CONFIG_SAVE_DEBOUNCE_MS ||
+        now - firstDirtyAt >= CONFIG_SAVE_MAX_DELAY_MS) {
+        flush();
+    }
+}
+
+bool ConfigStore::flush() {
+    if (dirtyMask == 0) return true;
+
+    lock();
+
+    uint16_t flushing = dirtyMask;
+    unsigned long start = micros();
+
+    String content;
+    serializeJsonPretty(doc, content);
+    bool ok = writeAtomic(content);
+
+    uint32_t elapsed = micros() - start;
+
+    if (ok) {
+        dirtyMask = 0;
+        stats.flashWrites++;
+        stats.lastSaveUs = elapsed;
+        stats.totalSaveUs += elapsed;
+        if (elapsed > stats.maxSaveUs) stats.maxSaveUs = elapsed;
+        stats.lastSaveBytes = content.length();
+
+        String sections;
+        for (uint8_t i = 0; i < (uint8_t)ConfigSection::COUNT; i++) {
+            if (flushing & (1 << i)) {
+                if (sections.length() > 0) sections += ",";
+                sections += SECTION_NAMES[i];
+            }
+        }
+        Serial.printf("[Config] Saved %u bytes in %.1f ms (%s)\n",
+                      content.length(), elapsed / 1000.0f, sections.c_str());
+    } else {
+        // Keep sections dirty and retry after another debounce period
+        stats.writeErrors++;
+        lastDirtyAt = millis();
+        Serial.println("[Config] Save failed, will retry");
+    }
+
+    unlock();
+    return ok;
+}
+
+void ConfigStore::touch(ConfigSection section) {
+    if (section >= ConfigSection::COUNT) return;
+
+    lock();
+    generation++;
+    sectionGeneration[(uint8_t)section] = generation;
+    unlock();
+}
+
+uint32_t ConfigStore::getSectionGeneration(ConfigSection section) const {
+    if (section >= ConfigSection::COUNT) return generation;
+    return sectionGeneration[(uint8_t)section];
+}
+
+void ConfigStore::getStatusJson(JsonObject obj) const {
+    obj["generation"] = generation;
+    obj["pending"] = dirtyMask != 0;
+    obj["edits"] = stats.edits;
+    obj["flash_writes"] = stats.flashWrites;
+    obj["write_errors"] = stats.writeErrors;
+    obj["crc_mismatches"] = stats.crcMismatches;
+    obj["recoveries"] = stats.recoveries;
+    obj["last_save_ms"] = stats.lastSaveUs / 1000.0f;
+    obj["max_save_ms"] = stats.maxSaveUs / 1000.0f;
+    obj["avg_save_ms"] = stats.flashWrites > 0 ?
+        (float)(stats.totalSaveUs / stats.flashWrites) / 1000.0f : 0.0f;
+    obj["last_save_bytes"] = stats.lastSaveBytes;
+}
+
+const char* ConfigStore::sectionName(ConfigSection section) {
+    if (section >= ConfigSection::COUNT) return "";
+    return SECTION_NAMES[(uint8_t)section];
+}
+
+uint32_t ConfigStore::crc32(const uint8_t* data, size_t length, uint32_t crc) {
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// ============================================================================
+// File helpers
+// ============================================================================
+
+bool ConfigStore::parseFile(const char* path, uint32_t& crc, size_t& length) {
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        Serial.printf("[Config] %s not found\n", path);
+        return false;
+    }
+
+    length = file.size();
+    if (length == 0) {
+        file.close();
+        return false;
+    }
+
+    uint8_t* buffer = (uint8_t*)malloc(length);
+    if (!buffer) {
+        file.close();
+        Serial.println("[Config] Out of memory reading config");
+        return false;
+    }
+
+    size_t bytesRead = file.read(buffer, length);
+    file.close();
+
+    if (bytesRead != length) {
+        free(buffer);
+        return false;
+    }
+
+    crc = crc32(buffer, length);
+
+    DynamicJsonDocument parsed(JSON_BUFFER_SIZE);
+    DeserializationError error = deserializeJson(parsed, (const char*)buffer, length);
+    free(buffer);
+
+    if (error) {
+        Serial.printf("[Config] Parse error in %s: %s\n", path, error.c_str());
+        return false;
+    }
+
+    doc.set(parsed);
+    return true;
+}
+
+bool ConfigStore::readCrcFile(uint32_t& crc, size_t& length) {
+    File file = LittleFS.open(CONFIG_CRC_PATH, "r");
+    if (!file) return false;
+
+    ConfigCrcRecord record;
+    size_t bytesRead = file.read((uint8_t*)&record, sizeof(record));
+    file.close();
+
+    if (bytesRead != sizeof(record) || record.magic != CONFIG_CRC_MAGIC) {
+        return false;
+    }
+
+    crc = record.crc;
+    length = record.length;
+    return true;
+}
+
+bool ConfigStore::writeCrcFile(uint32_t crc, size_t length) {
+    File file = LittleFS.open(CONFIG_CRC_PATH, "w");
+    if (!file) return false;
+
+    ConfigCrcRecord record = { CONFIG_CRC_MAGIC, crc, (uint32_t)length };
+    size_t written = file.write((const uint8_t*)&record, sizeof(record));
+    file.close();
+
+    return written == sizeof(record);
+}
+
+bool ConfigStore::writeAtomic(const String& content) {
+    // 1. Complete copy in the temp file
+    File file = LittleFS.open(CONFIG_TMP_PATH, "w");
+    if (!file) {
+        Serial.println("[Config] Cannot open temp file for writing");
+        return false;
+    }
+
+    size_t written = file.write((const uint8_t*)content.c_str(), content.length());
+    file.close();
+
+    if (written != content.length()) {
+        Serial.println("[Config] Short write to temp file");
+        LittleFS.remove(CONFIG_TMP_PATH);
+        return false;
+    }
+
+    // 2. CRC of the new content; from here on boot recovers from the temp file
+    if (!writeCrcFile(crc32((const uint8_t*)content.c_str(), content.length()),
+                      content.length())) {
+        Serial.println("[Config] Cannot write CRC file");
+        LittleFS.remove(CONFIG_TMP_PATH);
+        return false;
+    }
+
+    // 3. Atomic replace (LittleFS rename overwrites the destination)
+    if (!LittleFS.rename(CONFIG_TMP_PATH, CONFIG_FILE_PATH)) {
+        Serial.println("[Config] Rename failed");
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,158 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "config.h"
+
+// =============================================================================
+// Config Store
+// =============================================================================
+// Owns the single parsed copy of /config.json. Modules read and patch their
+// section through locked section views; edits mark the section dirty and are
+// coalesced into one write after a debounce period. Writes go to a temporary
+// file that is atomically renamed over /config.json, with a CRC sidecar so a
+// torn write is detected (and recovered from the temp file) on the next boot.
+
+#define CONFIG_FILE_PATH            "/config.json"
+#define CONFIG_TMP_PATH             "/config.json.tmp"
+#define CONFIG_CRC_PATH             "/config.crc"
+
+#define CONFIG_SAVE_DEBOUNCE_MS     2000    // Quiet time before writing
+#define CONFIG_SAVE_MAX_DELAY_MS    10000   // Upper bound while edits keep coming
+
+// Top-level config sections (one JSON object each)
+enum class ConfigSection : uint8_t {
+    WIFI = 0,
+    LORA,
+    SERVER,
+    NTP,
+    LCD,
+    BUZZER,
+    GPS,
+    RTC,
+    NETWORK,
+    COUNT
+};
+
+// Persistence statistics
+struct ConfigStoreStats {
+    uint32_t edits;             // Section views released as dirty
+    uint32_t flashWrites;       // Config files committed to flash
+    uint32_t writeErrors;
+    uint32_t crcMismatches;     // Load-time CRC mismatches (torn/external writes)
+    uint32_t recoveries;        // Loads recovered from the temp file
+    uint32_t lastSaveUs;        // Duration of last write (serialize + write + rename)
+    uint32_t maxSaveUs;
+    uint64_t totalSaveUs;
+    uint32_t lastSaveBytes;
+};
+
+class ConfigStore;
+
+// Locked access to one config section. The store mutex is held for the
+// lifetime of the view; writable views mark the section dirty on release.
+class ConfigSectionView {
+public:
+    ConfigSectionView(ConfigSectionView&& other);
+    ~ConfigSectionView();
+
+    bool isValid() const { return store != nullptr && !object.isNull(); }
+    JsonObject obj() const { return object; }
+
+    // Release without marking the section dirty (e.g. request rejected)
+    void discard() { writable = false; }
+
+private:
+    friend class ConfigStore;
+    ConfigSectionView(ConfigStore* store, ConfigSection section, JsonObject object, bool writable);
+    ConfigSectionView(const ConfigSectionView&) = delete;
+    ConfigSectionView& operator=(const ConfigSectionView&) = delete;
+
+    ConfigStore* store;
+    ConfigSection section;
+    JsonObject object;
+    bool writable;
+};
+
+class ConfigStore {
+public:
+    ConfigStore();
+
+    // Load /config.json (CRC checked, recovers from temp file). With
+    // deferParse only the lock is created and the JSON is parsed on first
+    // section access (boot from binary snapshot, see config_snapshot.h)
+    bool begin(bool deferParse = false);
+    bool isLoaded() const { return loaded; }
+
+    // CRC/length of /config.json as recorded in the sidecar; false if the
+    // sidecar is missing or the file size no longer matches it
+    bool getFileCrc(uint32_t& crc, size_t& length);
+
+    // Section access (blocks while another task holds the store)
+    ConfigSectionView edit(ConfigSection section);
+    ConfigSectionView read(ConfigSection section);
+
+    // Whole-document access for module loadConfig(); hold lock() around use
+    const JsonDocument& document() const { return doc; }
+    void lock();
+    void unlock();
+
+    // Replace the whole document (defaults) and write it immediately
+    bool replaceDocument(const JsonDocument& source);
+
+    // Re-read /config.json after it was written outside the store (file manager)
+    bool reloadFromFile();
+
+    // Debounced persistence (call from loop)
+    void update();
+
+    // Write pending edits now (before restart / OTA)
+    bool flush();
+
+    // Bump a section's generation without writing it, when a module fills in
+    // a value at runtime that the section's GET reports (cached responses)
+    void touch(ConfigSection section);
+
+    // Status
+    bool hasPendingWrites() const { return dirtyMask != 0; }
+    uint32_t getGeneration() const { return generation; }
+    uint32_t getSectionGeneration(ConfigSection section) const;
+    const ConfigStoreStats& getStats() const { return stats; }
+    void getStatusJson(JsonObject obj) const;
+
+    static const char* sectionName(ConfigSection section);
+    static uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0);
+
+private:
+    friend class ConfigSectionView;
+
+    DynamicJsonDocument doc;
+    SemaphoreHandle_t mutex;
+    bool loaded;
+
+    volatile uint16_t dirtyMask;
+    unsigned long firstDirtyAt;
+    unsigned long lastDirtyAt;
+
+    volatile uint32_t generation;
+    uint32_t sectionGeneration[(uint8_t)ConfigSection::COUNT];
+
+    ConfigStoreStats stats;
+
+    bool ensureLoaded();
+    ConfigSectionView openSection(ConfigSection section, bool writable);
+    void markDirty(ConfigSection section);
+
+    bool parseFile(const char* path, uint32_t& crc, size_t& length);
+    bool readCrcFile(uint32_t& crc, size_t& length);
+    bool writeCrcFile(uint32_t crc, size_t length);
+    bool writeAtomic(const String& content);
+};
+
+// Global instance
+extern ConfigStore configStore;
+
+#endif // CONFIG_STORE_H
@@ -0,0 +1,219 @@
+#include "device_table.h"
+#include <math.h>
+
+// Global instance
+DeviceTable deviceTable;
+
+#define DEVICE_TABLE_MASK   (DEVICE_TABLE_SLOTS - 1)
+
+DeviceTable::DeviceTable()
+    : mux(portMUX_INITIALIZER_UNLOCKED)
+{
+    memset(slots, 0, sizeof(slots));
+    memset(&stats, 0, sizeof(stats));
+}
+
+// ================== Hash Table ==================
+
+uint16_t DeviceTable::hash(uint64_t key, DeviceKeyType type) {
+    // Fibonacci hashing; DevAddrs of one network share their high bits
+    uint64_t mixed = (key ^ ((uint64_t)type << 63)) * 0x9E3779B97F4A7C15ULL;
+    return (uint16_t)(mixed >> 32) & DEVICE_TABLE_MASK;
+}
+
+int16_t DeviceTable::find(uint64_t key, DeviceKeyType type) const {
+    uint16_t slot = hash(key, type);
+    for (uint16_t probe = 0; probe < DEVICE_TABLE_SLOTS; probe++) {
+        const DeviceEntry& entry = slots[slot];
+        if (!entry.used) return -1;
+        if (entry.key == key && entry.keyType == type) return slot;
+        slot = (slot + 1) & DEVICE_TABLE_MASK;
+    }
+    return -1;
+}
+
+int16_t DeviceTable::insert(uint64_t key, DeviceKeyType type, uint32_t now) {
+    if (stats.entries >= DEVICE_TABLE_MAX_ENTRIES) {
+        evictOldest(now);
+    }
+
+    uint16_t slot = hash(key, type);
+    uint8_t probe = 0;
+    while (slots[slot].used) {
+        slot = (slot + 1) & DEVICE_TABLE_MASK;
+        probe++;
+    }
+    if (probe > stats.maxProbe) stats.maxProbe = probe;
+
+    DeviceEntry& entry = slots[slot];
+    memset(&entry, 0, sizeof(entry));
+    entry.used = true;
+    entry.key = key;
+    entry.keyType = type;
+    entry.firstSeen = now;
+
+    stats.entries++;
+    stats.inserts++;
+    return slot;
+}
+
+void DeviceTable::remove(uint16_t slot) {
+    // Backward shift: pull later entries of the probe run into the hole
+    // unless their home slot lies between the hole and their position
+    uint16_t hole = slot;
+    uint16_t next = slot;
+    while (true) {
+        next = (next + 1) & DEVICE_TABLE_MASK;
+        if (!slots[next].used) break;
+
+        uint16_t home = hash(slots[next].key, slots[next].keyType);
+        bool stays = hole <= next ? (home > hole && home <= next)
+                                  : (home > hole || home <= next);
+        if (!stays) {
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+    slots[hole].used = false;
+    stats.entries--;
+}
+
+void DeviceTable::evictOldest(uint32_t now) {
+    int16_t oldest = -1;
+    uint32_t oldestAge = 0;
+    for (uint16_t i = 0; i < DEVICE_TABLE_SLOTS; i++) {
+        if (!slots[i].used) continue;
+        uint32_t age = now - slots[i].lastSeen;
+        if (oldest < 0 || age > oldestAge) {
+            oldest = i;
+            oldestAge = age;
+        }
+    }
+    if (oldest < 0) return;
+
+    remove(oldest);
+    stats.evictions++;
+}
+
+// ================== Recording ==================
+
+void DeviceTable::record(const LoRaWANHeader& header, const LoRaPacket& packet) {
+    if (!header.valid) return;
+
+    uint64_t key;
+    DeviceKeyType type;
+    switch (header.mtype) {
+        case LoRaWANMType::UNCONFIRMED_UP:
+        case LoRaWANMType::CONFIRMED_UP:
+            key = header.devAddr;
+            type = DeviceKeyType::DEVADDR;
+            break;
+        case LoRaWANMType::JOIN_REQUEST:
+        case LoRaWANMType::REJOIN_REQUEST:
+            key = header.devEui;
+            type = DeviceKeyType::DEVEUI;
+            break;
+        default:
+            // Downlinks of other gateways, join-accepts, proprietary
+            return;
+    }
+
+    uint32_t now = millis();
+
+    portENTER_CRITICAL(&mux);
+    int16_t slot = find(key, type);
+    if (slot < 0) slot = insert(key, type, now);
+    update(slots[slot], header, packet, now);
+    portEXIT_CRITICAL(&mux);
+}
+
+void DeviceTable::update(DeviceEntry& entry, const LoRaWANHeader& header,
+                         const LoRaPacket& packet, uint32_t now) {
+    int16_t rssi = (int16_t)lroundf(packet.rssi);
+    int8_t snrLow = (int8_t)floorf(packet.snr);
+    int8_t snrHigh = (int8_t)ceilf(packet.snr);
+
+    if (entry.packets == 0) {
+        entry.rssiAvg = packet.rssi;
+        entry.snrAvg = packet.snr;
+        entry.rssiMin = entry.rssiMax = rssi;
+        entry.snrMin = snrLow;
+        entry.snrMax = snrHigh;
+    } else {
+        entry.rssiAvg += DEVICE_EWMA_ALPHA * (packet.rssi - entry.rssiAvg);
+        entry.snrAvg += DEVICE_EWMA_ALPHA * (packet.snr - entry.snrAvg);
+        if (rssi < entry.rssiMin) entry.rssiMin = rssi;
+        if (rssi > entry.rssiMax) entry.rssiMax = rssi;
+        if (snrLow < entry.snrMin) entry.snrMin = snrLow;
+        if (snrHigh > entry.snrMax) entry.snrMax = snrHigh;
+    }
+
+    entry.packets++;
+    entry.lastSeen = now;
+    entry.lastFrequency = packet.frequency;
+    entry.lastSf = packet.spreadingFactor;
+
+    uint8_t sfIndex = packet.spreadingFactor - DEVICE_SF_MIN;
+    if (sfIndex < DEVICE_SF_COUNT && entry.sfCount[sfIndex] < UINT16_MAX) {
+        entry.sfCount[sfIndex]++;
+    }
+
+    if (entry.keyType != DeviceKeyType::DEVADDR) return;
+
+    // FCnt is 16 bits on air; the gap wraps with it
+    uint16_t gap = header.fcnt - entry.lastFcnt;
+    if (!entry.fcntValid) {
+        entry.fcntValid = true;
+        entry.fcntFrames = 1;
+    } else if (gap == 0) {
+        if (entry.duplicates < UINT16_MAX) entry.duplicates++;
+    } else if (gap <= DEVICE_FCNT_MAX_GAP) {
+        entry.lost += gap - 1;
+        entry.fcntFrames++;
+    } else {
+        // Counter reset: start over from this frame
+        if (entry.fcntResets < UINT16_MAX) entry.fcntResets++;
+        entry.fcntFrames = 1;
+        entry.lost = 0;
+    }
+    entry.lastFcnt = header.fcnt;
+}
+
+// ================== Readers ==================
+
+bool DeviceTable::next(uint16_t& slot, DeviceEntry& entry) {
+    bool found = false;
+
+    portENTER_CRITICAL(&mux);
+    while (slot < DEVICE_TABLE_SLOTS) {
+        if (slots[slot].used) {
+            entry = slots[slot];
+            found = true;
+            break;
+        }
+        slot++;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return found;
+}
+
+DeviceTableStats DeviceTable::getStats() {
+    portENTER_CRITICAL(&mux);
+    DeviceTableStats copy = stats;
+    portEXIT_CRITICAL(&mux);
+    return copy;
+}
+
+void DeviceTable::clear() {
+    portENTER_CRITICAL(&mux);
+    memset(slots, 0, sizeof(slots));
+    memset(&stats, 0, sizeof(stats));
+    portEXIT_CRITICAL(&mux);
+}
+
+float DeviceTable::lossPercent(const DeviceEntry& entry) {
+    uint32_t expected = entry.fcntFrames + entry.lost;
+    if (expected == 0) return 0;
+    return 100.0f * entry.lost / expected;
+}
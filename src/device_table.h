@@ -0,0 +1,112 @@
+#ifndef DEVICE_TABLE_H
+#define DEVICE_TABLE_H
+
+#include <Arduino.h>
+#include "lora_gateway.h"
+#include "lorawan_frame.h"
+
+// =============================================================================
+// Device Table
+// =============================================================================
+// Per-device RF statistics for the end devices the gateway hears. Data
+// frames are keyed by DevAddr, join/rejoin-requests by DevEUI (a device
+// shows up under both once it has joined).
+//
+// Fixed memory: an open-addressing hash table (linear probing, backward
+// shift on removal, so there are no tombstones) kept at most 75% full.
+// When it is full the device heard least recently is evicted.
+//
+// FCnt loss: the gap between consecutive frame counters of a DevAddr counts
+// the frames this gateway missed; a repeated FCnt is a retransmission (or
+// the same frame heard twice), a jump back or beyond DEVICE_FCNT_MAX_GAP is
+// taken as a counter reset (rejoin, ABP reboot) and restarts the tracking.
+//
+// Written by the loop task; web handlers copy entries one at a time under
+// a short critical section.
+
+#define DEVICE_TABLE_SLOTS          64      // Power of two
+#define DEVICE_TABLE_MAX_ENTRIES    48      // 75% load
+#define DEVICE_EWMA_ALPHA           0.125f  // Weight of a new RSSI/SNR sample
+#define DEVICE_FCNT_MAX_GAP         16384   // Larger gaps are counter resets
+#define DEVICE_SF_MIN               7
+#define DEVICE_SF_COUNT             6       // SF7..SF12
+
+// /api/devices pages
+#define DEVICE_PAGE_DEFAULT         16
+#define DEVICE_PAGE_MAX             32
+
+enum class DeviceKeyType : uint8_t {
+    DEVADDR = 0,
+    DEVEUI
+};
+
+struct DeviceEntry {
+    uint64_t key;
+    DeviceKeyType keyType;
+    bool used;
+    bool fcntValid;
+    uint8_t lastSf;
+
+    uint32_t firstSeen;         // millis()
+    uint32_t lastSeen;
+    uint32_t lastFrequency;
+    uint32_t packets;
+
+    float rssiAvg;              // Exponential averages
+    float snrAvg;
+    int16_t rssiMin;            // dBm
+    int16_t rssiMax;
+    int8_t snrMin;              // dB, rounded down/up
+    int8_t snrMax;
+    uint16_t sfCount[DEVICE_SF_COUNT];
+
+    // Frame counter tracking (data frames)
+    uint16_t lastFcnt;
+    uint16_t duplicates;        // Same FCnt again
+    uint16_t fcntResets;
+    uint32_t fcntFrames;        // Frames with a new FCnt since tracking started
+    uint32_t lost;              // Sum of FCnt gaps
+};
+
+struct DeviceTableStats {
+    uint16_t entries;
+    uint32_t inserts;
+    uint32_t evictions;
+    uint8_t maxProbe;           // Longest probe sequence seen on insert
+};
+
+class DeviceTable {
+public:
+    DeviceTable();
+
+    // Loop task: account a received frame (ignored when it does not decode
+    // to a frame with a DevAddr or DevEUI)
+    void record(const LoRaWANHeader& header, const LoRaPacket& packet);
+
+    // Any task: copy the next used entry at or after slot; slot is left at
+    // that entry's position. Returns false when there are no more.
+    bool next(uint16_t& slot, DeviceEntry& entry);
+
+    DeviceTableStats getStats();
+    void clear();
+
+    // Loss percentage of an entry (0 when nothing was tracked)
+    static float lossPercent(const DeviceEntry& entry);
+
+private:
+    DeviceEntry slots[DEVICE_TABLE_SLOTS];
+    DeviceTableStats stats;
+    portMUX_TYPE mux;
+
+    static uint16_t hash(uint64_t key, DeviceKeyType type);
+    int16_t find(uint64_t key, DeviceKeyType type) const;
+    int16_t insert(uint64_t key, DeviceKeyType type, uint32_t now);
+    void remove(uint16_t slot);
+    void evictOldest(uint32_t now);
+    void update(DeviceEntry& entry, const LoRaWANHeader& header, const LoRaPacket& packet, uint32_t now);
+};
+
+// Global instance
+extern DeviceTable deviceTable;
+
+#endif // DEVICE_TABLE_H
@@ -0,0 +1,62 @@
+#include "duty_cycle.h"
+
+DutyCycleLedger::DutyCycleLedger()
+    : bands(nullptr)
+    , bandCount(0)
+{
+    memset(windows, 0, sizeof(windows));
+    memset(rejected, 0, sizeof(rejected));
+}
+
+void DutyCycleLedger::setRegion(const LoRaRegion* region) {
+    bands = region ? region->dutyBands : nullptr;
+    bandCount = region ? region->dutyBandCount : 0;
+    if (bandCount > DUTY_MAX_BANDS) bandCount = DUTY_MAX_BANDS;
+
+    memset(windows, 0, sizeof(windows));
+    memset(rejected, 0, sizeof(rejected));
+    uint32_t now = millis();
+    for (uint8_t b = 0; b < bandCount; b++) {
+        windows[b].reset(now, bands[b].dutyBp);
+    }
+
+    Serial.printf("[Duty] Region %s: %u duty-cycle band(s)\n",
+                  region ? region->name : "none", bandCount);
+}
+
+bool DutyCycleLedger::check(uint32_t frequency, uint32_t airtimeUs) {
+    int8_t band = findBand(frequency);
+    if (band < 0) return true;
+
+    if (windows[band].check(millis(), airtimeUs)) return true;
+
+    rejected[band]++;
+    return false;
+}
+
+void DutyCycleLedger::record(uint32_t frequency, uint32_t airtimeUs) {
+    int8_t band = findBand(frequency);
+    if (band < 0) return;
+
+    windows[band].record(millis(), airtimeUs);
+}
+
+void DutyCycleLedger::getUsage(uint8_t band, DutyBandUsage& usage) {
+    memset(&usage, 0, sizeof(usage));
+    if (band >= bandCount) return;
+
+    windows[band].advance(millis());
+    usage.name = bands[band].name;
+    usage.usedUs = windows[band].used;
+    usage.budgetUs = windows[band].budgetUs();
+    usage.rejected = rejected[band];
+}
+
+int8_t DutyCycleLedger::findBand(uint32_t frequency) const {
+    for (uint8_t i = 0; i < bandCount; i++) {
+        if (frequency >= bands[i].minFrequency && frequency <= bands[i].maxFrequency) {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,51 @@
+#ifndef DUTY_CYCLE_H
+#define DUTY_CYCLE_H
+
+#include <Arduino.h>
+#include "lorawan_region.h"
+#include "duty_window.h"
+
+// =============================================================================
+// Duty Cycle Ledger
+// =============================================================================
+// Rolling one-hour record of transmit time per regulatory sub-band. Airtime
+// is accumulated in one-minute buckets per band (duty_window.h), so checking
+// a new transmission against the band budget is a constant-time lookup in
+// fixed memory. Regions without duty-cycle limits have no bands and every
+// transmission fits. Band tables come from the regional parameters.
+
+#define DUTY_MAX_BANDS          6
+
+// Usage of one band over the window
+struct DutyBandUsage {
+    const char* name;
+    uint32_t usedUs;
+    uint32_t budgetUs;
+    uint32_t rejected;
+};
+
+class DutyCycleLedger {
+public:
+    DutyCycleLedger();
+
+    // Select the band table of a LoRaWAN region (clears the ledger)
+    void setRegion(const LoRaRegion* region);
+
+    // true when airtimeUs on this frequency stays within the band budget
+    bool check(uint32_t frequency, uint32_t airtimeUs);
+    void record(uint32_t frequency, uint32_t airtimeUs);
+
+    uint8_t getBandCount() const { return bandCount; }
+    void getUsage(uint8_t band, DutyBandUsage& usage);
+
+private:
+    const DutyBand* bands;
+    uint8_t bandCount;
+
+    DutyWindow windows[DUTY_MAX_BANDS];
+    uint32_t rejected[DUTY_MAX_BANDS];
+
+    int8_t findBand(uint32_t frequency) const;
+};
+
+#endif // DUTY_CYCLE_H
@@ -0,0 +1,64 @@
+#ifndef DUTY_WINDOW_H
+#define DUTY_WINDOW_H
+
+#include <stdint.h>
+#include <string.h>
+
+// =============================================================================
+// Duty Cycle Window
+// =============================================================================
+// Airtime of one sub-band over the last DUTY_WINDOW_S, in one-minute buckets:
+// a ring of DUTY_BUCKETS counters and their running sum. The caller passes
+// the clock, so the ring has no platform dependency.
+
+#define DUTY_WINDOW_S           3600    // ETSI EN 300 220 observation period
+#define DUTY_BUCKET_S           60
+#define DUTY_BUCKETS            (DUTY_WINDOW_S / DUTY_BUCKET_S)
+
+struct DutyWindow {
+    uint32_t buckets[DUTY_BUCKETS];
+    uint32_t used;                  // Sum of the buckets
+    uint32_t currentBucket;         // Minutes since boot of buckets[current % N]
+    uint16_t dutyBp;                // Limit in basis points (100 = 1%)
+
+    void reset(uint32_t nowMs, uint16_t bp) {
+        memset(buckets, 0, sizeof(buckets));
+        used = 0;
+        currentBucket = nowMs / (DUTY_BUCKET_S * 1000UL);
+        dutyBp = bp;
+    }
+
+    // Window (us) * duty / 10000
+    uint32_t budgetUs() const {
+        return (uint32_t)((uint64_t)DUTY_WINDOW_S * 1000000ULL * dutyBp / 10000);
+    }
+
+    // Drop the buckets that left the window
+    void advance(uint32_t nowMs) {
+        uint32_t now = nowMs / (DUTY_BUCKET_S * 1000UL);
+        if (now == currentBucket) return;
+
+        uint32_t steps = now - currentBucket;
+        if (steps > DUTY_BUCKETS) steps = DUTY_BUCKETS;
+
+        for (uint32_t s = 1; s <= steps; s++) {
+            uint8_t slot = (currentBucket + s) % DUTY_BUCKETS;
+            used -= buckets[slot];
+            buckets[slot] = 0;
+        }
+        currentBucket = now;
+    }
+
+    bool check(uint32_t nowMs, uint32_t airtimeUs) {
+        advance(nowMs);
+        return used + airtimeUs <= budgetUs();
+    }
+
+    void record(uint32_t nowMs, uint32_t airtimeUs) {
+        advance(nowMs);
+        buckets[currentBucket % DUTY_BUCKETS] += airtimeUs;
+        used += airtimeUs;
+    }
+};
+
+#endif // DUTY_WINDOW_H
@@ -0,0 +1,110 @@
+#include "freq_drift.h"
+
+FrequencyDrift::FrequencyDrift() {
+    memset(&stats, 0, sizeof(stats));
+    clearTrim();
+}
+
+void FrequencyDrift::record(uint32_t frequency, int32_t offsetHz, float snr) {
+    stats.lastOffsetHz = offsetHz;
+    if (frequency == 0) return;
+
+    int32_t offsetPpb = (int32_t)((int64_t)offsetHz * 1000000000LL / frequency);
+
+    // Weak frames and offsets no crystal drift can explain (another
+    // transmitter, a bad node) stay out of the window
+    if (snr < DRIFT_MIN_SNR_DB || abs(offsetPpb) > 2 * DRIFT_MAX_TRIM_PPB) {
+        stats.rejected++;
+        return;
+    }
+
+    window[windowHead] = offsetPpb;
+    windowHead = (windowHead + 1) % DRIFT_WINDOW;
+    if (windowCount < DRIFT_WINDOW) windowCount++;
+    stats.frames++;
+}
+
+bool FrequencyDrift::evaluate(uint32_t uptimeS, bool autoCorrect) {
+    if (windowCount < DRIFT_MIN_SAMPLES) return false;
+
+    int32_t sorted[DRIFT_WINDOW];
+    memcpy(sorted, window, windowCount * sizeof(int32_t));
+    int32_t estimate = median(sorted, windowCount);
+    stats.estimatePpb = estimate;
+
+    DriftSample& sample = stats.history[stats.historyHead];
+    sample.uptimeS = uptimeS;
+    sample.offsetPpb = estimate;
+    sample.trimPpb = stats.trimPpb;
+    sample.samples = windowCount;
+    stats.historyHead = (stats.historyHead + 1) % DRIFT_HISTORY;
+    if (stats.historyCount < DRIFT_HISTORY) stats.historyCount++;
+
+    // The previous step should have shrunk the offset; if it grew, the step
+    // went the wrong way (or the offset is not ours): undo it and stop
+    if (stepPending) {
+        stepPending = false;
+        if (abs(estimate) > abs(stepEstimatePpb)) {
+            stats.trimPpb -= stepPpb;
+            stats.reverted++;
+            stats.diverged = true;
+            windowHead = 0;
+            windowCount = 0;
+            return true;
+        }
+    }
+
+    if (!autoCorrect || stats.diverged || abs(estimate) < DRIFT_DEADBAND_PPB) return false;
+
+    int32_t step = constrain(estimate, -DRIFT_MAX_STEP_PPB, DRIFT_MAX_STEP_PPB);
+    int32_t trim = constrain(stats.trimPpb + step, -DRIFT_MAX_TRIM_PPB, DRIFT_MAX_TRIM_PPB);
+    if (trim == stats.trimPpb) return false;
+
+    stepPending = true;
+    stepPpb = trim - stats.trimPpb;
+    stepEstimatePpb = estimate;
+    stats.trimPpb = trim;
+    stats.corrections++;
+
+    // Offsets measured against the old trim no longer apply
+    windowHead = 0;
+    windowCount = 0;
+    return true;
+}
+
+void FrequencyDrift::clearTrim() {
+    stats.trimPpb = 0;
+    stats.diverged = false;
+    windowHead = 0;
+    windowCount = 0;
+    stepPending = false;
+    stepPpb = 0;
+    stepEstimatePpb = 0;
+}
+
+void FrequencyDrift::resetCounters() {
+    stats.frames = 0;
+    stats.rejected = 0;
+    stats.corrections = 0;
+    stats.reverted = 0;
+    stats.historyCount = 0;
+    stats.historyHead = 0;
+}
+
+int32_t FrequencyDrift::median(int32_t* values, uint8_t count) {
+    if (count == 0) return 0;
+
+    // Insertion sort: at most DRIFT_WINDOW entries
+    for (uint8_t i = 1; i < count; i++) {
+        int32_t value = values[i];
+        int8_t j = i - 1;
+        while (j >= 0 && values[j] > value) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = value;
+    }
+
+    if (count & 1) return values[count / 2];
+    return (int32_t)(((int64_t)values[count / 2 - 1] + values[count / 2]) / 2);
+}
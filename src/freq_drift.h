@@ -0,0 +1,84 @@
+#ifndef FREQ_DRIFT_H
+#define FREQ_DRIFT_H
+
+#include <Arduino.h>
+
+// =============================================================================
+// Frequency Drift Estimator
+// =============================================================================
+// Each received frame reports its frequency error (SX1276 FEI): the offset of
+// the signal from the receiver. Node crystals err in both directions, so the
+// median over many frames from many nodes is the gateway's own offset. The
+// estimator keeps that median in parts per billion (crystal error scales
+// with frequency) and, when allowed, moves a trim applied to FRF so the
+// receiver follows its crystal. Guard rails: a minimum number of frames per
+// evaluation, a deadband, a maximum step and a maximum total trim. A step
+// that makes the measured offset worse is undone and correction stops until
+// the trim is cleared. Written by the radio task only.
+
+#define DRIFT_WINDOW            16      // Most recent offsets kept for the median
+#define DRIFT_HISTORY           48      // Evaluations kept for the status API
+#define DRIFT_MIN_SAMPLES       8       // Frames needed before an evaluation
+#define DRIFT_MIN_SNR_DB        -10.0f  // FEI of weaker frames is too noisy
+#define DRIFT_DEADBAND_PPB      1000    // Offsets below 1 ppm are left alone
+#define DRIFT_MAX_STEP_PPB      5000    // Largest change per evaluation
+#define DRIFT_MAX_TRIM_PPB      25000   // Crystal tolerance plus temperature range
+
+struct DriftSample {
+    uint32_t uptimeS;
+    int32_t offsetPpb;              // Median offset measured
+    int32_t trimPpb;                // Trim in effect while it was measured
+    uint8_t samples;
+};
+
+struct DriftStats {
+    uint32_t frames;                // FEI readings used
+    uint32_t rejected;              // Low SNR or implausible offset
+    uint32_t corrections;
+    uint32_t reverted;              // Steps undone because the offset grew
+    bool diverged;                  // Correction stopped after a revert
+    int32_t lastOffsetHz;           // Last frame
+    int32_t estimatePpb;            // Last evaluation
+    int32_t trimPpb;
+    uint8_t historyCount;
+    uint8_t historyHead;            // Next slot to write
+    DriftSample history[DRIFT_HISTORY];
+};
+
+class FrequencyDrift {
+public:
+    FrequencyDrift();
+
+    // Frequency error of one received frame (signal minus receiver, Hz)
+    void record(uint32_t frequency, int32_t offsetHz, float snr);
+
+    // Median of the window into the history; moves the trim when autoCorrect
+    // is set. Returns true when the trim changed.
+    bool evaluate(uint32_t uptimeS, bool autoCorrect);
+
+    // Back to the nominal frequency, correction allowed again
+    void clearTrim();
+
+    // Counters and history only; the trim stays
+    void resetCounters();
+
+    int32_t getTrimPpb() const { return stats.trimPpb; }
+    const DriftStats& getStats() const { return stats; }
+
+    // Median of values (reordered in place)
+    static int32_t median(int32_t* values, uint8_t count);
+
+private:
+    DriftStats stats;
+
+    int32_t window[DRIFT_WINDOW];
+    uint8_t windowHead;
+    uint8_t windowCount;
+
+    // Last step, checked on the next evaluation
+    bool stepPending;
+    int32_t stepPpb;
+    int32_t stepEstimatePpb;
+};
+
+#endif // FREQ_DRIFT_H
@@ -6,7 +6,7 @@
  */
 
 #include "gps_manager.h"
-#include <LittleFS.h>
+#include "config_store.h"
 
 // Global instance
 GPSManager gpsManager;
@@ -356,25 +356,14 @@ void GPSManager::loadConfig(const JsonDocument& doc) {
 
 bool GPSManager::saveConfig() {
 #if GPS_ENABLED
-    // Read existing config
-    File file = LittleFS.open("/config.json", "r");
-    if (!file) {
-        Serial.println(F("[GPS] Cannot read config file"));
+    ConfigSectionView section = configStore.edit(ConfigSection::GPS);
+    if (!section.isValid()) {
+        Serial.println(F("[GPS] Config store not available"));
         return false;
     }
 
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
-
-    if (error) {
-        Serial.print(F("[GPS] JSON parse error: "));
-        Serial.println(error.c_str());
-        return false;
-    }
-
-    // Update GPS section
-    JsonObject gpsCfg = doc.createNestedObject("gps");
+    // Update GPS section (written by configStore after debounce)
+    JsonObject gpsCfg = section.obj();
     gpsCfg["enabled"] = _config.enabled;
     gpsCfg["use_fixed"] = _config.useFixedLocation;
     gpsCfg["rx_pin"] = _config.rxPin;
@@ -387,16 +376,6 @@ bool GPSManager::saveConfig() {
     gpsCfg["altitude"] = _config.fixedAltitude;
     gpsCfg["update_interval"] = _config.updateInterval;
 
-    // Write back
-    file = LittleFS.open("/config.json", "w");
-    if (!file) {
-        Serial.println(F("[GPS] Cannot write config file"));
-        return false;
-    }
-
-    serializeJsonPretty(doc, file);
-    file.close();
-
     Serial.println(F("[GPS] Config saved"));
     return true;
 #else
@@ -2,7 +2,7 @@
 #include "network_manager.h"
 #include "i2c_bus.h"
 #include <WiFi.h>
-#include <LittleFS.h>
+#include "config_store.h"
 
 // Global instance
 LCDManager lcdManager;
@@ -383,24 +383,14 @@ void LCDManager::loadConfig(const JsonDocument& doc) {
 }
 
 bool LCDManager::saveConfig() {
-    // Read existing config
-    File file = LittleFS.open("/config.json", "r");
-    if (!file) {
-        Serial.println("[LCD] Cannot read config file");
+    ConfigSectionView section = configStore.edit(ConfigSection::LCD);
+    if (!section.isValid()) {
+        Serial.println("[LCD] Config store not available");
         return false;
     }
 
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
-
-    if (error) {
-        Serial.printf("[LCD] JSON parse error: %s\n", error.c_str());
-        return false;
-    }
-
-    // Update LCD section
-    JsonObject lcdCfg = doc.createNestedObject("lcd");
+    // Update LCD section (written by configStore after debounce)
+    JsonObject lcdCfg = section.obj();
     lcdCfg["enabled"] = config.enabled;
     lcdCfg["address"] = config.address;
     lcdCfg["cols"] = config.cols;
@@ -410,16 +400,6 @@ bool LCDManager::saveConfig() {
     lcdCfg["backlight"] = config.backlightOn;
     lcdCfg["rotation_interval"] = config.rotationInterval;
 
-    // Write back
-    file = LittleFS.open("/config.json", "w");
-    if (!file) {
-        Serial.println("[LCD] Cannot write config file");
-        return false;
-    }
-
-    serializeJsonPretty(doc, file);
-    file.close();
-
     Serial.println("[LCD] Config saved");
     return true;
 }
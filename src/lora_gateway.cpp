@@ -1,26 +1,89 @@
 #include "lora_gateway.h"
-#include <LittleFS.h>
+#include "bad_frame_log.h"
+#include "airtime.h"
+#include "config_store.h"
 
 // Global instance
 LoRaGateway loraGateway;
 
 // Static interrupt flag
 volatile bool LoRaGateway::dio0Flag = false;
+volatile uint32_t LoRaGateway::dio0Micros = 0;
+TaskHandle_t LoRaGateway::dio0NotifyTask = nullptr;
 
 // Interrupt handler
 void IRAM_ATTR LoRaGateway::onDio0Rise() {
+    dio0Micros = micros();
     dio0Flag = true;
+
+    // Wake the radio task
+    if (dio0NotifyTask) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(dio0NotifyTask, &woken);
+        if (woken) portYIELD_FROM_ISR();
+    }
 }
 
 LoRaGateway::LoRaGateway()
     : radio(nullptr)
     , spi(nullptr)
+    , configRevision(0)
     , available(false)
     , receiving(false)
     , queueHead(0)
-    , queueTail(0) {
+    , queueTail(0)
+    , statsResetRequested(false)
+    , forwardResetRequested(false)
+    , radioTaskHandle(nullptr)
+    , commandQueue(nullptr)
+    , nextCommandId(1)
+    , rejectedCommands(0)
+    , deferring(false)
+    , deferStart(0)
+    , rx2Frequency(0)
+    , rx2SpreadingFactor(0)
+    , rx2Bandwidth(0)
+    , region(nullptr) {
 
     memset(&stats, 0, sizeof(stats));
+    memset(&forwardStats, 0, sizeof(forwardStats));
+    memset(completions, 0, sizeof(completions));
+    memset(&rxProfile, 0, sizeof(rxProfile));
+    memset(&rx1Profile, 0, sizeof(rx1Profile));
+    memset(&rx2Profile, 0, sizeof(rx2Profile));
+    memset(&txProfile, 0, sizeof(txProfile));
+    memset(scanProfiles, 0, sizeof(scanProfiles));
+    memset(hopProfiles, 0, sizeof(hopProfiles));
+    memset(occupancySamples, 0, sizeof(occupancySamples));
+    occupancyHead = 0;
+    occupancyCount = 0;
+    lastOccupancySample = 0;
+    lastNoiseSample = 0;
+    lastNoisePublish = 0;
+    lastNoiseSweep = 0;
+    noiseDirty = false;
+    lastDriftEval = 0;
+    driftTrimPending = false;
+    lastRadioActivity = 0;
+    lastRecoveryTime = 0;
+    lastRecovery = RadioRecovery::REARM;
+    activeRxProfile = &rxProfile;
+    activeRxChannel = 0;
+
+    scanActive = false;
+    hopActive = false;
+    sweepActive = false;
+    sweepEnd = 0;
+    scanLockedProfile = nullptr;
+    scanLocked = false;
+    scanSynced = false;
+    scanStep = 0;
+    hopIndex = 0;
+    scanLockedSf = 0;
+    scanLockedChannel = 0;
+    scanLockStart = 0;
+    scanLockTimeoutMs = 0;
+    scanCycleStart = 0;
     setDefaultConfig();
 }
 
@@ -39,6 +102,28 @@ void LoRaGateway::setDefaultConfig() {
     config.pinNss = LORA_NSS;
     config.pinRst = LORA_RST;
     config.pinDio0 = LORA_DIO0;
+
+    // Scan SF7..SF12, fastest first
+    config.scanEnabled = LORA_SCAN_ENABLED_DEFAULT;
+    config.scanDwellMs = LORA_SCAN_DWELL_DEFAULT;
+    config.scanSfCount = LORA_SCAN_SF_COUNT;
+    for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) {
+        config.scanSfList[i] = LORA_SCAN_SF_MIN + i;
+    }
+
+    // No channel plan until one is configured
+    config.hopEnabled = LORA_HOP_ENABLED_DEFAULT;
+    config.hopChannelCount = 0;
+    memset(config.hopChannels, 0, sizeof(config.hopChannels));
+
+    config.noiseEnabled = LORA_NOISE_ENABLED_DEFAULT;
+    config.noiseSweepIntervalS = LORA_NOISE_SWEEP_DEFAULT;
+
+    config.driftCorrection = LORA_DRIFT_CORRECTION_DEFAULT;
+
+    config.watchdogTimeoutS = LORA_WATCHDOG_TIMEOUT_DEFAULT;
+
+    config.forwardCrcErrors = LORA_FORWARD_CRC_ERRORS_DEFAULT;
 }
 
 bool LoRaGateway::begin() {
@@ -189,7 +274,15 @@ bool LoRaGateway::initRadio() {
     // Enable CRC checking
     radio->setCRC(true);
 
+    // Register-level access from here on (profiles, RX/TX, CAD)
+    shadow.begin(spi, config.pinNss);
+
     available = true;
+    if (!applyConfig()) {
+        available = false;
+        return false;
+    }
+
     Serial.println("[LoRa] Radio initialized successfully");
 
     return true;
@@ -198,51 +291,143 @@ bool LoRaGateway::initRadio() {
 bool LoRaGateway::applyConfig() {
     if (!available || !radio) return false;
 
+    RadioProfile profile;
+    if (!SX1276Shadow::buildProfile(profile, config.frequency, config.spreadingFactor,
+                                    config.bandwidth, config.codingRate, config.txPower,
+                                    config.syncWord, false, true)) {
+        Serial.printf("[LoRa] Invalid radio parameters: %.2f MHz, SF%d, BW%.1f kHz, CR4/%d, %d dBm\n",
+                      config.frequency / 1000000.0, config.spreadingFactor,
+                      config.bandwidth, config.codingRate, config.txPower);
+        return false;
+    }
+
     // Stop receiving before reconfiguration
-    radio->standby();
+    shadow.setMode(SX1276_MODE_STANDBY);
     receiving = false;
 
-    int state = radio->setFrequency(config.frequency / 1000000.0);
-    if (state != RADIOLIB_ERR_NONE) {
-        Serial.printf("[LoRa] setFrequency failed: %d\n", state);
-        return false;
-    }
+    rxProfile = profile;
+    activeRxProfile = &rxProfile;
+    buildDownlinkProfiles();
 
-    state = radio->setBandwidth(config.bandwidth);
-    if (state != RADIOLIB_ERR_NONE) {
-        Serial.printf("[LoRa] setBandwidth failed: %d\n", state);
-        return false;
+    // Configured channel and every channel of the plan at every scannable SF
+    for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) {
+        SX1276Shadow::buildProfile(scanProfiles[i], config.frequency, LORA_SCAN_SF_MIN + i,
+                                   config.bandwidth, config.codingRate, config.txPower,
+                                   config.syncWord, false, true);
     }
+    for (uint8_t ch = 0; ch < config.hopChannelCount; ch++) {
+        for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) {
+            SX1276Shadow::buildProfile(hopProfiles[ch][i], config.hopChannels[ch],
+                                       LORA_SCAN_SF_MIN + i, config.bandwidth, config.codingRate,
+                                       config.txPower, config.syncWord, false, true);
+        }
+    }
+    trimProfiles();
+    scanLocked = false;
+    scanStep = 0;
+    hopIndex = 0;
 
-    state = radio->setSpreadingFactor(config.spreadingFactor);
-    if (state != RADIOLIB_ERR_NONE) {
-        Serial.printf("[LoRa] setSpreadingFactor failed: %d\n", state);
-        return false;
+    uint8_t written = shadow.applyProfile(rxProfile);
+
+    Serial.printf("[LoRa] Config applied: %.2f MHz, SF%d, BW%.0f kHz, CR4/%d, %d dBm (%u register bytes)\n",
+                  config.frequency / 1000000.0, config.spreadingFactor,
+                  config.bandwidth, config.codingRate, config.txPower, written);
+
+    return true;
+}
+
+void LoRaGateway::buildDownlinkProfiles() {
+    // Precomputed with the payload CRC on, the txpk default; a downlink with
+    // "ncrc" set goes through txProfile instead
+    // RX1: same channel and data rate as the uplink
+    SX1276Shadow::buildProfile(rx1Profile, config.frequency, config.spreadingFactor,
+                               config.bandwidth, config.codingRate, config.txPower,
+                               config.syncWord, true, true);
+
+    if (rx2Frequency != 0) {
+        SX1276Shadow::buildProfile(rx2Profile, rx2Frequency, rx2SpreadingFactor,
+                                   rx2Bandwidth, config.codingRate, config.txPower,
+                                   config.syncWord, true, true);
     }
+}
 
-    state = radio->setCodingRate(config.codingRate);
-    if (state != RADIOLIB_ERR_NONE) {
-        Serial.printf("[LoRa] setCodingRate failed: %d\n", state);
-        return false;
+void LoRaGateway::setRx2Window(uint32_t frequency, uint8_t sf, float bw) {
+    rx2Frequency = frequency;
+    rx2SpreadingFactor = sf;
+    rx2Bandwidth = bw;
+    buildDownlinkProfiles();
+
+    Serial.printf("[LoRa] RX2 window: %.3f MHz, SF%d, BW%.0f kHz\n",
+                  frequency / 1000000.0, sf, bw);
+}
+
+void LoRaGateway::setRegion(const LoRaRegion* newRegion) {
+    static_assert(LORAWAN_MAX_DEFAULT_CHANNELS <= LORA_HOP_MAX_CHANNELS,
+                  "Region default plan must fit the hop channel list");
+
+    region = newRegion;
+    if (region == nullptr) return;
+
+    const RegionDataRate& rx2 = region->dataRates[region->rx2DataRate];
+    setRx2Window(region->rx2Frequency, rx2.sf, rx2.bwKhz);
+
+    // No channel plan configured: the region's default channels
+    if (config.hopChannelCount == 0) {
+        memcpy(config.hopChannels, region->defaultChannels,
+               region->defaultChannelCount * sizeof(uint32_t));
+        config.hopChannelCount = region->defaultChannelCount;
     }
 
-    state = radio->setSyncWord(config.syncWord);
-    if (state != RADIOLIB_ERR_NONE) {
-        Serial.printf("[LoRa] setSyncWord failed: %d\n", state);
-        return false;
+    // Channels outside the regional band are never hopped to
+    uint8_t channels = 0;
+    for (uint8_t i = 0; i < config.hopChannelCount; i++) {
+        if (lorawanRegionContains(region, config.hopChannels[i])) {
+            config.hopChannels[channels++] = config.hopChannels[i];
+        } else {
+            Serial.printf("[LoRa] Hop channel %.3f MHz outside %s, dropped\n",
+                          config.hopChannels[i] / 1000000.0, region->name);
+        }
     }
+    config.hopChannelCount = channels;
 
-    state = radio->setOutputPower(config.txPower);
-    if (state != RADIOLIB_ERR_NONE) {
-        Serial.printf("[LoRa] setOutputPower failed: %d\n", state);
-        return false;
+    // Only SFs that are uplink data rates at the configured bandwidth are scanned
+    uint8_t sfCount = 0;
+    for (uint8_t i = 0; i < config.scanSfCount; i++) {
+        if (lorawanUplinkSf(region, config.scanSfList[i], (uint16_t)config.bandwidth)) {
+            config.scanSfList[sfCount++] = config.scanSfList[i];
+        }
     }
+    if (sfCount > 0) config.scanSfCount = sfCount;
 
-    Serial.printf("[LoRa] Config applied: %.2f MHz, SF%d, BW%.0f kHz, CR4/%d, %d dBm\n",
-                  config.frequency / 1000000.0, config.spreadingFactor,
-                  config.bandwidth, config.codingRate, config.txPower);
+    Serial.printf("[LoRa] Region %s: %u hop channel(s), %u scan SF(s)\n",
+                  region->name, config.hopChannelCount, config.scanSfCount);
+}
 
-    return true;
+const RadioProfile* LoRaGateway::selectTxProfile(uint32_t frequency, uint8_t sf, float bw,
+                                                 uint8_t cr, int8_t power, bool invertIq,
+                                                 bool crc) {
+    // Unspecified parameters follow the receive configuration; the configured
+    // TX power is the upper limit
+    if (frequency == 0) frequency = config.frequency;
+    if (sf == 0) sf = config.spreadingFactor;
+    if (bw == 0) bw = config.bandwidth;
+    if (cr == 0) cr = config.codingRate;
+    if (power == 0 || power > config.txPower) power = config.txPower;
+
+    if (SX1276Shadow::sameParameters(rx1Profile, frequency, sf, bw, cr, power, invertIq, crc)) {
+        return &rx1Profile;
+    }
+    if (SX1276Shadow::sameParameters(rx2Profile, frequency, sf, bw, cr, power, invertIq, crc)) {
+        return &rx2Profile;
+    }
+    if (!SX1276Shadow::sameParameters(txProfile, frequency, sf, bw, cr, power, invertIq, crc)) {
+        if (!SX1276Shadow::buildProfile(txProfile, frequency, sf, bw, cr, power,
+                                        config.syncWord, invertIq, crc)) {
+            return nullptr;
+        }
+        SX1276Shadow::trimProfile(txProfile, drift.getTrimPpb());
+    }
+    return &txProfile;
 }
 
 void LoRaGateway::loadConfig(const JsonDocument& doc) {
@@ -272,36 +457,74 @@ void LoRaGateway::loadConfig(const JsonDocument& doc) {
         config.pinDio0 = pins["dio0"] | LORA_DIO0;
     }
 
-    Serial.printf("[LoRa] Config loaded: enabled=%d, freq=%.2f MHz, SF%d\n",
-                  config.enabled, config.frequency / 1000000.0, config.spreadingFactor);
-}
+    // CAD multi-SF scanning (optional)
+    if (lora.containsKey("scan")) {
+        JsonObjectConst scan = lora["scan"];
+        config.scanEnabled = scan["enabled"] | LORA_SCAN_ENABLED_DEFAULT;
+        config.scanDwellMs = scan["dwell_ms"] | LORA_SCAN_DWELL_DEFAULT;
+
+        JsonArrayConst sfList = scan["sf_priority"];
+        if (!sfList.isNull()) {
+            uint8_t count = 0;
+            for (JsonVariantConst sf : sfList) {
+                uint8_t value = sf | 0;
+                if (count >= LORA_SCAN_MAX_STEPS) break;
+                if (value < LORA_SCAN_SF_MIN || value > LORA_SCAN_SF_MAX) continue;
+                config.scanSfList[count++] = value;
+            }
+            if (count > 0) config.scanSfCount = count;
+        }
+    }
 
-bool LoRaGateway::saveConfig() {
-    File file = LittleFS.open("/config.json", "r");
-    if (!file) {
-        Serial.println("[LoRa] Cannot open config for reading");
-        return false;
+    // Channel hopping (optional)
+    if (lora.containsKey("hop")) {
+        JsonObjectConst hop = lora["hop"];
+        config.hopEnabled = hop["enabled"] | LORA_HOP_ENABLED_DEFAULT;
+
+        uint8_t count = 0;
+        for (JsonVariantConst channel : hop["channels"].as<JsonArrayConst>()) {
+            if (count >= LORA_HOP_MAX_CHANNELS) break;
+            uint32_t frequency = channel | 0UL;
+            if (frequency == 0) continue;
+            config.hopChannels[count++] = frequency;
+        }
+        config.hopChannelCount = count;
     }
 
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
+    // Noise-floor sampler (optional)
+    if (lora.containsKey("noise")) {
+        JsonObjectConst noise = lora["noise"];
+        config.noiseEnabled = noise["enabled"] | LORA_NOISE_ENABLED_DEFAULT;
+        config.noiseSweepIntervalS = noise["sweep_interval_s"] | LORA_NOISE_SWEEP_DEFAULT;
+    }
 
-    if (error) {
-        Serial.println("[LoRa] Failed to parse config");
-        return false;
+    // Crystal drift compensation (optional)
+    if (lora.containsKey("drift")) {
+        config.driftCorrection = lora["drift"]["auto_correct"] | LORA_DRIFT_CORRECTION_DEFAULT;
+    }
+
+    // Receiver watchdog (optional)
+    if (lora.containsKey("watchdog")) {
+        uint16_t timeout = lora["watchdog"]["timeout_s"] | LORA_WATCHDOG_TIMEOUT_DEFAULT;
+        config.watchdogTimeoutS = (timeout > 0 && timeout < LORA_WATCHDOG_MIN_TIMEOUT_S)
+                                  ? LORA_WATCHDOG_MIN_TIMEOUT_S : timeout;
     }
 
-    // Preserve existing pin configuration before updating
-    JsonObject existingPins;
-    bool hasPins = false;
-    if (doc.containsKey("lora") && doc["lora"].containsKey("pins")) {
-        hasPins = true;
-        existingPins = doc["lora"]["pins"];
+    config.forwardCrcErrors = lora["forward_crc_errors"] | LORA_FORWARD_CRC_ERRORS_DEFAULT;
+
+    Serial.printf("[LoRa] Config loaded: enabled=%d, freq=%.2f MHz, SF%d\n",
+                  config.enabled, config.frequency / 1000000.0, config.spreadingFactor);
+}
+
+bool LoRaGateway::saveConfig() {
+    ConfigSectionView section = configStore.edit(ConfigSection::LORA);
+    if (!section.isValid()) {
+        Serial.println("[LoRa] Config store not available");
+        return false;
     }
 
     // Update LoRa section (only radio parameters, not pins)
-    JsonObject lora = doc.createNestedObject("lora");
+    JsonObject lora = section.obj();
     lora["enabled"] = config.enabled;
     lora["frequency"] = config.frequency;
     lora["spreading_factor"] = config.spreadingFactor;
@@ -310,18 +533,10 @@ bool LoRaGateway::saveConfig() {
     lora["tx_power"] = config.txPower;
     lora["sync_word"] = config.syncWord;
 
-    // Restore pin configuration from file (not from memory defaults)
-    JsonObject pins = lora.createNestedObject("pins");
-    if (hasPins) {
-        // Preserve existing pins from config file
-        pins["miso"] = existingPins["miso"] | LORA_MISO;
-        pins["mosi"] = existingPins["mosi"] | LORA_MOSI;
-        pins["sck"] = existingPins["sck"] | LORA_SCK;
-        pins["nss"] = existingPins["nss"] | LORA_NSS;
-        pins["rst"] = existingPins["rst"] | LORA_RST;
-        pins["dio0"] = existingPins["dio0"] | LORA_DIO0;
-    } else {
-        // No existing pins, use current config values
+    // Existing pin configuration is left untouched; only fill it in when
+    // the file has none yet
+    if (!lora.containsKey("pins")) {
+        JsonObject pins = lora.createNestedObject("pins");
         pins["miso"] = config.pinMiso;
         pins["mosi"] = config.pinMosi;
         pins["sck"] = config.pinSck;
@@ -330,14 +545,37 @@ bool LoRaGateway::saveConfig() {
         pins["dio0"] = config.pinDio0;
     }
 
-    file = LittleFS.open("/config.json", "w");
-    if (!file) {
-        Serial.println("[LoRa] Cannot open config for writing");
-        return false;
+    JsonObject scan = lora["scan"].is<JsonObject>() ? lora["scan"].as<JsonObject>()
+                                                     : lora.createNestedObject("scan");
+    scan["enabled"] = config.scanEnabled;
+    scan["dwell_ms"] = config.scanDwellMs;
+    JsonArray sfList = scan.createNestedArray("sf_priority");
+    for (uint8_t i = 0; i < config.scanSfCount; i++) {
+        sfList.add(config.scanSfList[i]);
+    }
+
+    JsonObject hop = lora["hop"].is<JsonObject>() ? lora["hop"].as<JsonObject>()
+                                                   : lora.createNestedObject("hop");
+    hop["enabled"] = config.hopEnabled;
+    JsonArray channels = hop.createNestedArray("channels");
+    for (uint8_t i = 0; i < config.hopChannelCount; i++) {
+        channels.add(config.hopChannels[i]);
     }
 
-    serializeJsonPretty(doc, file);
-    file.close();
+    JsonObject noise = lora["noise"].is<JsonObject>() ? lora["noise"].as<JsonObject>()
+                                                       : lora.createNestedObject("noise");
+    noise["enabled"] = config.noiseEnabled;
+    noise["sweep_interval_s"] = config.noiseSweepIntervalS;
+
+    JsonObject drift = lora["drift"].is<JsonObject>() ? lora["drift"].as<JsonObject>()
+                                                       : lora.createNestedObject("drift");
+    drift["auto_correct"] = config.driftCorrection;
+
+    JsonObject watchdog = lora["watchdog"].is<JsonObject>() ? lora["watchdog"].as<JsonObject>()
+                                                             : lora.createNestedObject("watchdog");
+    watchdog["timeout_s"] = config.watchdogTimeoutS;
+
+    lora["forward_crc_errors"] = config.forwardCrcErrors;
 
     return true;
 }
@@ -345,18 +583,50 @@ bool LoRaGateway::saveConfig() {
 bool LoRaGateway::startReceive() {
     if (!available || !config.enabled) return false;
 
-    int state = radio->startReceive();
-    if (state != RADIOLIB_ERR_NONE) {
-        Serial.printf("[LoRa] startReceive failed: %d\n", state);
-        return false;
-    }
+    return armReceive(rxProfile);
+}
+
+bool LoRaGateway::armReceive(const RadioProfile& profile, uint8_t channel) {
+    // Only registers that differ from the profile are written
+    shadow.setMode(SX1276_MODE_STANDBY);
+    shadow.applyProfile(profile);
+    activeRxProfile = &profile;
+    activeRxChannel = channel;
+    shadow.writeCached(SX1276_REG_DIO_MAPPING1, SX1276_DIO0_RX_DONE);
+    shadow.writeCached(SX1276_REG_FIFO_RX_BASE_ADDR, 0x00);
+    shadow.writeRegister(SX1276_REG_FIFO_ADDR_PTR, 0x00);
+    shadow.writeRegister(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_ALL);
+    shadow.setMode(SX1276_MODE_RX_CONTINUOUS);
 
     receiving = true;
     dio0Flag = false;
+    lastRadioActivity = millis();
     return true;
 }
 
 void LoRaGateway::update() {
+    // Resets requested from the web task are applied by each owner
+    if (forwardResetRequested) {
+        forwardResetRequested = false;
+        memset(&forwardStats, 0, sizeof(forwardStats));
+        forwardSnapshot.publish(forwardStats);
+        occupancyCount = 0;
+    }
+
+    if (occupancyCount == 0 || millis() - lastOccupancySample >= LORA_OCCUPANCY_SAMPLE_MS) {
+        updateOccupancy();
+    }
+
+    // The radio task owns the radio once started
+    if (radioTaskHandle) return;
+
+    if (statsResetRequested) {
+        statsResetRequested = false;
+        memset(&stats, 0, sizeof(stats));
+        shadow.resetStats();
+        publishStats();
+    }
+
     if (!available || !config.enabled || !receiving) return;
 
     // Check if a packet was received (via interrupt)
@@ -364,64 +634,408 @@ void LoRaGateway::update() {
         dio0Flag = false;
         processReceivedPacket();
     }
+
+    watchdogUpdate();
 }
 
-void LoRaGateway::processReceivedPacket() {
-    // Create packet structure
-    LoRaPacket packet;
-    memset(&packet, 0, sizeof(packet));
+// ================== Radio Task ==================
 
-    // Read the data
-    int state = radio->readData(packet.data, MAX_PACKET_SIZE);
-    packet.length = radio->getPacketLength();
+bool LoRaGateway::startTask() {
+    if (radioTaskHandle) return true;
+    if (!available) return false;
 
-    if (state == RADIOLIB_ERR_NONE) {
-        // Packet received successfully
-        packet.rssi = radio->getRSSI();
-        packet.snr = radio->getSNR();
-        packet.frequency = config.frequency;
-        packet.spreadingFactor = config.spreadingFactor;
-        packet.bandwidth = config.bandwidth;
-        packet.codingRate = config.codingRate;
-        packet.timestamp = micros();
-        packet.valid = true;
-
-        // Update statistics
-        stats.rxPacketsReceived++;
-        stats.lastPacketTime = millis();
-        stats.lastRssi = packet.rssi;
-        stats.lastSnr = packet.snr;
-
-        Serial.printf("[LoRa] RX: %d bytes, RSSI: %.1f dBm, SNR: %.1f dB\n",
-                      packet.length, packet.rssi, packet.snr);
-
-        // Queue the packet
-        if (queuePacket(packet)) {
-            Serial.println("[LoRa] Packet queued for forwarding");
+    commandQueue = xQueueCreate(RADIO_COMMAND_QUEUE_SIZE, sizeof(RadioCommand));
+    if (!commandQueue) {
+        Serial.println("[LoRa] Cannot create radio command queue");
+        return false;
+    }
+
+    if (xTaskCreatePinnedToCore(radioTask, "radio", RADIO_TASK_STACK_SIZE, this,
+                                RADIO_TASK_PRIORITY, &radioTaskHandle,
+                                RADIO_TASK_CORE) != pdPASS) {
+        radioTaskHandle = nullptr;
+        Serial.println("[LoRa] Cannot start radio task, radio stays on loop()");
+        return false;
+    }
+
+    dio0NotifyTask = radioTaskHandle;
+
+    // A packet may have arrived before the task existed
+    if (dio0Flag) {
+        xTaskNotifyGive(radioTaskHandle);
+    }
+
+    Serial.println("[LoRa] Radio task started");
+    return true;
+}
+
+void LoRaGateway::radioTask(void* param) {
+    static_cast<LoRaGateway*>(param)->radioLoop();
+}
+
+void LoRaGateway::radioLoop() {
+    while (true) {
+        // Woken by DIO0 or a submitted command; poll while a command is
+        // deferred or a scan lock is pending, run straight on while scanning
+        TickType_t wait;
+        if (scanActive && !scanLocked) {
+            wait = 0;
+        } else if (scanLocked) {
+            wait = 1;
+        } else if (uxQueueMessagesWaiting(commandQueue) > 0) {
+            wait = pdMS_TO_TICKS(RADIO_TASK_IDLE_MS);
+        } else if (config.noiseEnabled) {
+            wait = pdMS_TO_TICKS(LORA_NOISE_SAMPLE_MS);
+        } else if (config.watchdogTimeoutS > 0) {
+            wait = pdMS_TO_TICKS(LORA_WATCHDOG_POLL_MS);
         } else {
-            Serial.println("[LoRa] Queue full, packet dropped!");
+            wait = portMAX_DELAY;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        if (statsResetRequested) {
+            statsResetRequested = false;
+            memset(&stats, 0, sizeof(stats));
+            publishStats();
+            noiseFloor.reset();
+            noiseSnapshot.publish(noiseFloor.getStats());
+            drift.resetCounters();
+            driftSnapshot.publish(drift.getStats());
         }
 
-    } else if (state == RADIOLIB_ERR_CRC_MISMATCH) {
-        stats.rxPacketsCrcError++;
-        Serial.println("[LoRa] CRC error");
-    } else {
-        Serial.printf("[LoRa] Receive error: %d\n", state);
+        if (dio0Flag && receiving) {
+            dio0Flag = false;
+            bool received = processReceivedPacket();
+            if (scanLocked) scanRecordFrame(received);
+        }
+
+        processCommands();
+        scanUpdate();
+        noiseUpdate();
+        driftUpdate();
+        watchdogUpdate();
     }
+}
 
-    // Restart receiving
-    startReceive();
+void LoRaGateway::processCommands() {
+    RadioCommand cmd;
+
+    while (xQueuePeek(commandQueue, &cmd, 0) == pdTRUE) {
+        // Reconfigure only between packets
+        if (cmd.type == RadioCommandType::RECONFIGURE && receiving && isRxInProgress()) {
+            if (!deferring) {
+                deferring = true;
+                deferStart = millis();
+            }
+            if (millis() - deferStart < RADIO_RECONFIG_MAX_DEFER_MS) {
+                return;
+            }
+            Serial.println("[LoRa] RX still in progress, reconfiguring anyway");
+        }
+
+        xQueueReceive(commandQueue, &cmd, 0);
+        executeCommand(cmd);
+
+        // The command left the radio on the configured SF: drop a scan lock
+        scanLocked = false;
+
+        // A packet that completed meanwhile goes before the next command
+        if (dio0Flag && receiving) {
+            dio0Flag = false;
+            processReceivedPacket();
+        }
+    }
 }
 
-bool LoRaGateway::queuePacket(const LoRaPacket& packet) {
+void LoRaGateway::executeCommand(const RadioCommand& cmd) {
+    RadioCompletion result;
+    memset(&result, 0, sizeof(result));
+
+    if (deferring) {
+        result.deferMs = millis() - deferStart;
+        deferring = false;
+    }
+
+    uint32_t start = micros();
+
+    switch (cmd.type) {
+        case RadioCommandType::RECONFIGURE:
+            result.state = doReconfigure(cmd.config, result);
+            break;
+
+        case RadioCommandType::TRANSMIT:
+            result.state = doTransmit(cmd.data, cmd.length, cmd.frequency,
+                                      cmd.spreadingFactor, cmd.bandwidth, cmd.codingRate,
+                                      cmd.txPower, cmd.invertIq, cmd.crc);
+            result.rxGapUs = micros() - start;
+            break;
+
+        case RadioCommandType::STANDBY:
+            shadow.setMode(SX1276_MODE_STANDBY);
+            receiving = false;
+            result.state = RADIOLIB_ERR_NONE;
+            break;
+
+        case RadioCommandType::RECEIVE:
+            result.state = startReceive() ? RADIOLIB_ERR_NONE : RADIOLIB_ERR_UNKNOWN;
+            break;
+
+        case RadioCommandType::CAD:
+            result.state = doChannelScan(rxProfile);
+            startReceive();
+            result.rxGapUs = micros() - start;
+            break;
+
+        case RadioCommandType::SWEEP:
+            sweepActive = cmd.durationMs > 0;
+            sweepEnd = millis() + cmd.durationMs;
+            scanStep = 0;
+            hopIndex = 0;
+            result.state = RADIOLIB_ERR_NONE;
+            break;
+    }
+
+    result.durationUs = micros() - start;
+
+    stats.radioCommands++;
+    publishStats();
+
+    // Hand the result back to the waiting task
+    if (cmd.notifyTask) {
+        completions[cmd.id % RADIO_COMPLETION_SLOTS] = result;
+        xTaskNotify(cmd.notifyTask, cmd.id, eSetValueWithOverwrite);
+    }
+}
+
+int16_t LoRaGateway::submitCommand(RadioCommand& cmd, uint32_t timeoutMs, RadioCompletion* result) {
+    if (!radioTaskHandle || !commandQueue) return RADIO_CMD_ERR_NOT_RUNNING;
+
+    cmd.id = nextCommandId.fetch_add(1);
+    cmd.notifyTask = xTaskGetCurrentTaskHandle();
+
+    if (xQueueSend(commandQueue, &cmd, 0) != pdTRUE) {
+        rejectedCommands++;
+        Serial.println("[LoRa] Radio command queue full");
+        return RADIO_CMD_ERR_QUEUE_FULL;
+    }
+    xTaskNotifyGive(radioTaskHandle);
+
+    // Wait for this command's completion (ignores stale ones from timed-out calls)
+    unsigned long start = millis();
+    while (true) {
+        unsigned long elapsed = millis() - start;
+        if (elapsed >= timeoutMs) {
+            rejectedCommands++;
+            Serial.printf("[LoRa] Radio command %u timed out\n", cmd.id);
+            return RADIO_CMD_ERR_TIMEOUT;
+        }
+
+        uint32_t value = 0;
+        if (xTaskNotifyWait(0, 0xFFFFFFFF, &value, pdMS_TO_TICKS(timeoutMs - elapsed)) == pdTRUE &&
+            value == cmd.id) {
+            break;
+        }
+    }
+
+    RadioCompletion completion = completions[cmd.id % RADIO_COMPLETION_SLOTS];
+    if (result) *result = completion;
+    return completion.state;
+}
+
+bool LoRaGateway::isRxInProgress() {
+    // RegModemStat: signal synchronized (bit 1) or header info valid (bit 3)
+    return (shadow.readRegister(SX1276_REG_MODEM_STAT) & 0x0A) != 0;
+}
+
+void LoRaGateway::setRadioParameters(const GatewayConfig& newConfig) {
+    // Pins are fixed once the radio is initialized
+    config.enabled = newConfig.enabled;
+    config.frequency = newConfig.frequency;
+    config.spreadingFactor = newConfig.spreadingFactor;
+    config.bandwidth = newConfig.bandwidth;
+    config.codingRate = newConfig.codingRate;
+    config.txPower = newConfig.txPower;
+    config.syncWord = newConfig.syncWord;
+
+    config.scanEnabled = newConfig.scanEnabled;
+    config.scanDwellMs = newConfig.scanDwellMs;
+    config.scanSfCount = newConfig.scanSfCount;
+    memcpy(config.scanSfList, newConfig.scanSfList, sizeof(config.scanSfList));
+
+    config.hopEnabled = newConfig.hopEnabled;
+    config.hopChannelCount = newConfig.hopChannelCount;
+    memcpy(config.hopChannels, newConfig.hopChannels, sizeof(config.hopChannels));
+
+    config.noiseEnabled = newConfig.noiseEnabled;
+    config.noiseSweepIntervalS = newConfig.noiseSweepIntervalS;
+
+    config.driftCorrection = newConfig.driftCorrection;
+
+    config.watchdogTimeoutS = newConfig.watchdogTimeoutS;
+
+    config.forwardCrcErrors = newConfig.forwardCrcErrors;
+
+    // Also covers changes that are not saved (auto-tuner trials)
+    configRevision++;
+}
+
+int16_t LoRaGateway::doReconfigure(const GatewayConfig& newConfig, RadioCompletion& result) {
+    GatewayConfig previous = config;
+    setRadioParameters(newConfig);
+
+    // Correction turned off: back to the nominal FRF (applyConfig re-trims)
+    if (previous.driftCorrection && !config.driftCorrection) {
+        drift.clearTrim();
+        driftTrimPending = false;
+        driftSnapshot.publish(drift.getStats());
+    }
+
+    uint32_t gapStart = micros();
+
+    bool ok = applyConfig();
+    if (!ok) {
+        Serial.println("[LoRa] Reconfigure failed, restoring previous config");
+        config = previous;
+        applyConfig();
+    }
+
+    if (config.enabled) {
+        startReceive();
+    }
+
+    result.rxGapUs = micros() - gapStart;
+
+    stats.reconfigCount++;
+    stats.reconfigGapLastUs = result.rxGapUs;
+    if (result.rxGapUs > stats.reconfigGapMaxUs) stats.reconfigGapMaxUs = result.rxGapUs;
+    stats.reconfigDeferLastMs = result.deferMs;
+
+    Serial.printf("[LoRa] Reconfigured (RX gap %u us, deferred %u ms)\n",
+                  result.rxGapUs, result.deferMs);
+
+    return ok ? RADIOLIB_ERR_NONE : RADIOLIB_ERR_UNKNOWN;
+}
+
+bool LoRaGateway::processReceivedPacket() {
+    // RegFifoRxCurrentAddr .. RegPktRssiValue in one burst: FIFO address,
+    // IRQ flags, length, modem status, SNR and RSSI of the packet
+    uint8_t regs[SX1276_REG_PKT_RSSI_VALUE - SX1276_REG_FIFO_RX_CURRENT_ADDR + 1];
+    shadow.readBurst(SX1276_REG_FIFO_RX_CURRENT_ADDR, regs, sizeof(regs));
+
+    uint8_t fifoAddr = regs[SX1276_REG_FIFO_RX_CURRENT_ADDR - SX1276_REG_FIFO_RX_CURRENT_ADDR];
+    uint8_t irqFlags = regs[SX1276_REG_IRQ_FLAGS - SX1276_REG_FIFO_RX_CURRENT_ADDR];
+    uint8_t length = regs[SX1276_REG_RX_NB_BYTES - SX1276_REG_FIFO_RX_CURRENT_ADDR];
+    uint8_t modemStat = regs[SX1276_REG_MODEM_STAT - SX1276_REG_FIFO_RX_CURRENT_ADDR];
+    int8_t pktSnr = (int8_t)regs[SX1276_REG_PKT_SNR_VALUE - SX1276_REG_FIFO_RX_CURRENT_ADDR];
+    uint8_t pktRssi = regs[SX1276_REG_PKT_RSSI_VALUE - SX1276_REG_FIFO_RX_CURRENT_ADDR];
+
+    // Any interrupt shows the chip is alive
+    lastRadioActivity = millis();
+
+    // Not an RX done (late TX/CAD interrupt): just clear
+    if (!(irqFlags & SX1276_IRQ_RX_DONE)) {
+        shadow.writeRegister(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_ALL);
+        return false;
+    }
+
+    // The channel was busy for the whole frame, CRC error or not
+    stats.rxAirtimeUs += loraTimeOnAirUs(activeRxProfile->spreadingFactor,
+                                         activeRxProfile->bandwidth,
+                                         (modemStat >> 5) + 4, length);
+
+    // Good frames are read straight into the next queue slot. A CRC-failed
+    // one only goes there when it is forwarded; otherwise it is read into
+    // the scratch frame, just for the bad frame log.
+    bool crcOk = !(irqFlags & SX1276_IRQ_PAYLOAD_CRC_ERROR);
     uint8_t nextHead = (queueHead + 1) % MAX_PACKET_QUEUE;
-    if (nextHead == queueTail) {
-        // Queue is full
+    bool queueFull = (nextHead == queueTail);
+    bool queued = !queueFull && length > 0 && (crcOk || config.forwardCrcErrors);
+
+    LoRaPacket* packet = nullptr;
+    if (queued) {
+        packet = &packetQueue[queueHead];
+    } else if (!crcOk && length > 0) {
+        packet = &badFrame;
+    }
+
+    if (packet) {
+        shadow.writeRegister(SX1276_REG_FIFO_ADDR_PTR, fifoAddr);
+        shadow.readBurst(SX1276_REG_FIFO, packet->data, length);
+        packet->length = length;
+    }
+
+    // The modem stays in RX continuous: clearing the flags re-arms it
+    shadow.writeRegister(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_ALL);
+    uint32_t rearmUs = micros() - dio0Micros;
+
+    // Frequency error of this frame; read after re-arming (the next frame
+    // only updates it once its header is in, a preamble later)
+    uint8_t fei[3];
+    shadow.readBurst(SX1276_REG_FEI_MSB, fei, sizeof(fei));
+    int32_t freqOffset = SX1276Shadow::feiToHz(fei, activeRxProfile->bandwidth);
+
+    // Packet strength per the SX1276 datasheet (section 5.5.5)
+    float snr = pktSnr / 4.0f;
+    int16_t rssiOffset = (activeRxProfile->frequency < SX1276_HF_THRESHOLD)
+                         ? SX1276_RSSI_OFFSET_LF : SX1276_RSSI_OFFSET_HF;
+    float rssi = rssiOffset + pktRssi + (pktRssi >> 4) + (snr < 0 ? snr : 0);
+
+    if (packet) {
+        packet->rssi = rssi;
+        packet->snr = snr;
+        packet->frequency = activeRxProfile->frequency;
+        packet->spreadingFactor = activeRxProfile->spreadingFactor;
+        packet->bandwidth = activeRxProfile->bandwidth;
+        packet->codingRate = (modemStat >> 5) + 4;     // Coding rate from the frame header
+        packet->channel = activeRxChannel;
+        packet->freqOffset = freqOffset;
+        packet->timestamp = dio0Micros;
+        packet->crcOk = crcOk;
+        packet->valid = true;
+    }
+
+    if (!crcOk) {
+        stats.rxPacketsCrcError++;
+        if (packet) badFrameLog.record(*packet);
+        if (queued) {
+            std::atomic_thread_fence(std::memory_order_release);
+            queueHead = nextHead;
+        }
+        publishStats();
+
+        Serial.printf("[LoRa] CRC error: %d bytes, RSSI: %.1f dBm, SNR: %.1f dB%s\n",
+                      length, rssi, snr, queued ? " (forwarded as stat -1)" : "");
         return false;
     }
 
-    packetQueue[queueHead] = packet;
-    queueHead = nextHead;
+    stats.rxPacketsReceived++;
+    stats.lastPacketTime = millis();
+    stats.lastRssi = rssi;
+    stats.lastSnr = snr;
+
+    drift.record(activeRxProfile->frequency, freqOffset, snr);
+
+    stats.rxRearmLastUs = rearmUs;
+    if (rearmUs > stats.rxRearmMaxUs) stats.rxRearmMaxUs = rearmUs;
+    stats.rxRearmSamples++;
+    stats.rxRearmTotalUs += rearmUs;
+
+    if (queued) {
+        std::atomic_thread_fence(std::memory_order_release);
+        queueHead = nextHead;
+    }
+
+    publishStats();
+
+    Serial.printf("[LoRa] RX: %d bytes, RSSI: %.1f dBm, SNR: %.1f dB, offset %d Hz (re-armed in %u us)\n",
+                  length, rssi, snr, freqOffset, rearmUs);
+
+    if (queueFull) {
+        Serial.println("[LoRa] Queue full, packet dropped!");
+    } else {
+        Serial.println("[LoRa] Packet queued for forwarding");
+    }
+
     return true;
 }
 
@@ -438,57 +1052,743 @@ LoRaPacket LoRaGateway::getPacket() {
         return packet;  // Queue empty
     }
 
+    std::atomic_thread_fence(std::memory_order_acquire);
     packet = packetQueue[queueTail];
+    std::atomic_thread_fence(std::memory_order_release);
     queueTail = (queueTail + 1) % MAX_PACKET_QUEUE;
     return packet;
 }
 
-bool LoRaGateway::transmit(const uint8_t* data, size_t length, uint32_t frequency,
-                           uint8_t sf, float bw, uint8_t cr) {
-    if (!available || !config.enabled) return false;
+int16_t LoRaGateway::transmit(const uint8_t* data, size_t length, uint32_t frequency,
+                              uint8_t sf, float bw, uint8_t cr, int8_t power, bool invertIq,
+                              bool crc) {
+    if (!available || !config.enabled) return RADIOLIB_ERR_CHIP_NOT_FOUND;
+    if (length > MAX_PACKET_SIZE) return RADIO_CMD_ERR_INVALID_PARAM;
 
-    // Stop receiving
-    radio->standby();
-    receiving = false;
+    // Before the radio task starts the caller owns the radio
+    if (!radioTaskHandle) {
+        return doTransmit(data, length, frequency, sf, bw, cr, power, invertIq, crc);
+    }
+
+    RadioCommand cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.type = RadioCommandType::TRANSMIT;
+    memcpy(cmd.data, data, length);
+    cmd.length = length;
+    cmd.frequency = frequency;
+    cmd.spreadingFactor = sf;
+    cmd.bandwidth = bw;
+    cmd.codingRate = cr;
+    cmd.txPower = power;
+    cmd.invertIq = invertIq;
+    cmd.crc = crc;
+
+    return submitCommand(cmd, RADIO_TX_TIMEOUT_MS, nullptr);
+}
 
-    // Apply temporary settings if specified
-    bool tempSettings = (frequency != 0 || sf != 0 || bw != 0 || cr != 0);
-    if (tempSettings) {
-        if (frequency != 0) radio->setFrequency(frequency / 1000000.0);
-        if (sf != 0) radio->setSpreadingFactor(sf);
-        if (bw != 0) radio->setBandwidth(bw);
-        if (cr != 0) radio->setCodingRate(cr);
+bool LoRaGateway::reconfigure(const GatewayConfig& newConfig, RadioCompletion* result) {
+    // No radio: nothing to race with, just keep the settings
+    if (!available) {
+        setRadioParameters(newConfig);
+        if (result) memset(result, 0, sizeof(RadioCompletion));
+        return true;
+    }
+
+    RadioCommand cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.type = RadioCommandType::RECONFIGURE;
+    cmd.config = newConfig;
+
+    int16_t state = submitCommand(cmd, RADIO_RECONFIG_TIMEOUT_MS, result);
+    if (state != RADIOLIB_ERR_NONE) {
+        Serial.printf("[LoRa] Reconfigure failed: %d\n", state);
+    }
+    return state == RADIOLIB_ERR_NONE;
+}
+
+bool LoRaGateway::standby() {
+    if (!available) return false;
+
+    RadioCommand cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.type = RadioCommandType::STANDBY;
+
+    return submitCommand(cmd, RADIO_STANDBY_TIMEOUT_MS, nullptr) == RADIOLIB_ERR_NONE;
+}
+
+bool LoRaGateway::sweep(uint32_t durationMs) {
+    if (!available) return false;
+
+    RadioCommand cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.type = RadioCommandType::SWEEP;
+    cmd.durationMs = durationMs;
+
+    return submitCommand(cmd, RADIO_STANDBY_TIMEOUT_MS, nullptr) == RADIOLIB_ERR_NONE;
+}
+
+int16_t LoRaGateway::scanChannel() {
+    if (!available) return RADIOLIB_ERR_CHIP_NOT_FOUND;
+
+    RadioCommand cmd;
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.type = RadioCommandType::CAD;
+
+    return submitCommand(cmd, RADIO_CAD_TIMEOUT_MS, nullptr);
+}
+
+int16_t LoRaGateway::doTransmit(const uint8_t* data, size_t length, uint32_t frequency,
+                                uint8_t sf, float bw, uint8_t cr, int8_t power, bool invertIq,
+                                bool crc) {
+    if (!available || !config.enabled) return RADIOLIB_ERR_CHIP_NOT_FOUND;
+
+    const RadioProfile* profile = selectTxProfile(frequency, sf, bw, cr, power, invertIq, crc);
+    if (!profile) {
+        Serial.println("[LoRa] TX failed: invalid parameters");
+        stats.txPacketsFailed++;
+        publishStats();
+        return RADIO_CMD_ERR_INVALID_PARAM;
     }
 
     Serial.printf("[LoRa] TX: %d bytes\n", length);
 
-    // Transmit
-    int state = radio->transmit(const_cast<uint8_t*>(data), length);
+    // Regions with LBT: the channel must be clear before the PA is keyed
+    if (region && region->lbtSenseUs > 0) {
+        uint32_t lbtStart = micros();
+        int16_t lbtState = listenBeforeTalk(profile->frequency, profile->spreadingFactor,
+                                            profile->bandwidth);
+        stats.lbtDelayLastUs = micros() - lbtStart;
+        if (stats.lbtDelayLastUs > stats.lbtDelayMaxUs) stats.lbtDelayMaxUs = stats.lbtDelayLastUs;
+
+        if (lbtState != RADIOLIB_CHANNEL_FREE) {
+            stats.txPacketsFailed++;
+            Serial.printf("[LoRa] TX dropped: %.3f MHz busy after %u us of LBT\n",
+                          profile->frequency / 1000000.0, stats.lbtDelayLastUs);
+            startReceive();
+            publishStats();
+            return lbtState;
+        }
+    }
 
-    // Restore original settings if temporary were used
-    if (tempSettings) {
-        applyConfig();
+    // RX -> TX: profile delta, FIFO and mode
+    uint32_t setupStart = micros();
+    shadow.setMode(SX1276_MODE_STANDBY);
+    receiving = false;
+
+    shadow.applyProfile(*profile);
+    shadow.writeCached(SX1276_REG_DIO_MAPPING1, SX1276_DIO0_TX_DONE);
+    shadow.writeCached(SX1276_REG_FIFO_TX_BASE_ADDR, 0x00);
+    shadow.writeRegister(SX1276_REG_FIFO_ADDR_PTR, 0x00);
+    shadow.writeBurst(SX1276_REG_FIFO, data, length);
+    shadow.writeCached(SX1276_REG_PAYLOAD_LENGTH, length);
+    shadow.writeRegister(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_ALL);
+    shadow.setMode(SX1276_MODE_TX);
+
+    uint32_t txStart = micros();
+    uint32_t setupUs = txStart - setupStart;
+
+    // Wait for TX done (DIO0 wakes the radio task; poll as a fallback)
+    int16_t state = RADIOLIB_ERR_NONE;
+    while (!(shadow.readRegister(SX1276_REG_IRQ_FLAGS) & SX1276_IRQ_TX_DONE)) {
+        if (micros() - txStart >= RADIO_TX_DONE_TIMEOUT_MS * 1000UL) {
+            state = RADIOLIB_ERR_TX_TIMEOUT;
+            break;
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RADIO_TX_POLL_MS));
     }
 
+    // TX -> RX: back to the receive profile
+    uint32_t restoreStart = micros();
+    startReceive();
+    uint32_t restoreUs = micros() - restoreStart;
+
+    stats.txSetupLastUs = setupUs;
+    if (setupUs > stats.txSetupMaxUs) stats.txSetupMaxUs = setupUs;
+    stats.rxRestoreLastUs = restoreUs;
+    if (restoreUs > stats.rxRestoreMaxUs) stats.rxRestoreMaxUs = restoreUs;
+
     if (state == RADIOLIB_ERR_NONE) {
         stats.txPacketsSent++;
-        Serial.println("[LoRa] TX success");
-
-        // Restart receiving
-        startReceive();
-        return true;
+        stats.txAirtimeUs += loraTimeOnAirUs(profile->spreadingFactor, profile->bandwidth,
+                                             profile->codingRate, length);
+        Serial.printf("[LoRa] TX success (RX->TX %u us, TX->RX %u us)\n", setupUs, restoreUs);
     } else {
         stats.txPacketsFailed++;
         Serial.printf("[LoRa] TX failed: %d\n", state);
+    }
+    publishStats();
 
-        // Restart receiving anyway
-        startReceive();
+    return state;
+}
+
+int16_t LoRaGateway::doChannelScan(const RadioProfile& profile) {
+    shadow.setMode(SX1276_MODE_STANDBY);
+    receiving = false;
+
+    shadow.applyProfile(profile);
+    shadow.writeCached(SX1276_REG_DIO_MAPPING1, SX1276_DIO0_CAD_DONE);
+    shadow.writeRegister(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_ALL);
+    shadow.setMode(SX1276_MODE_CAD);
+
+    // CAD takes about two symbols
+    unsigned long start = millis();
+    uint8_t flags = 0;
+    while (!((flags = shadow.readRegister(SX1276_REG_IRQ_FLAGS)) & SX1276_IRQ_CAD_DONE)) {
+        if (millis() - start >= RADIO_CAD_DONE_TIMEOUT_MS) {
+            shadow.setMode(SX1276_MODE_STANDBY);
+            return RADIOLIB_ERR_RX_TIMEOUT;
+        }
+        ulTaskNotifyTake(pdTRUE, 1);
+    }
+
+    shadow.writeRegister(SX1276_REG_IRQ_FLAGS, SX1276_IRQ_ALL);
+    dio0Flag = false;
+
+    return (flags & SX1276_IRQ_CAD_DETECTED) ? RADIOLIB_PREAMBLE_DETECTED : RADIOLIB_CHANNEL_FREE;
+}
+
+// ================== Listen Before Talk ==================
+
+uint8_t LoRaGateway::lbtChannelSlot(uint32_t frequency) {
+    for (uint8_t i = 0; i < LORA_LBT_MAX_CHANNELS; i++) {
+        if (stats.lbt[i].frequency == frequency) return i;
+        if (stats.lbt[i].frequency == 0) {
+            stats.lbt[i].frequency = frequency;
+            return i;
+        }
+    }
+
+    // Table full: the last slot is recycled
+    uint8_t last = LORA_LBT_MAX_CHANNELS - 1;
+    memset(&stats.lbt[last], 0, sizeof(stats.lbt[last]));
+    stats.lbt[last].frequency = frequency;
+    return last;
+}
+
+int16_t LoRaGateway::senseChannel(const RadioProfile& profile, uint32_t senseUs) {
+    shadow.setMode(SX1276_MODE_STANDBY);
+    receiving = false;
+
+    // Receive on the downlink channel without an RX done interrupt
+    shadow.applyProfile(profile);
+    shadow.writeCached(SX1276_REG_DIO_MAPPING1, SX1276_DIO0_CAD_DONE);
+    shadow.setMode(SX1276_MODE_RX_CONTINUOUS);
+    delayMicroseconds(LORA_LBT_SETTLE_US);
+
+    int16_t maxRssi = INT16_MIN;
+    uint32_t start = micros();
+    do {
+        int16_t rssi = readRssi(profile.frequency);
+        if (rssi > maxRssi) maxRssi = rssi;
+    } while (micros() - start < senseUs);
+
+    shadow.setMode(SX1276_MODE_STANDBY);
+    return maxRssi;
+}
+
+int16_t LoRaGateway::listenBeforeTalk(uint32_t frequency, uint8_t sf, float bw) {
+    RadioProfile senseProfile;
+    if (!SX1276Shadow::buildProfile(senseProfile, frequency, sf, bw, config.codingRate,
+                                    config.txPower, config.syncWord, false, true)) {
+        return RADIO_CMD_ERR_INVALID_PARAM;
+    }
+    SX1276Shadow::trimProfile(senseProfile, drift.getTrimPpb());
+
+    // Energy detection for the regional sense time, then CAD for a LoRa
+    // preamble below the threshold when it is short enough
+    bool useCad = symbolsToMs(senseProfile, 2) <= LORA_LBT_CAD_MAX_MS;
+    uint8_t slot = lbtChannelSlot(frequency);
+    unsigned long windowStart = millis();
+
+    for (uint8_t attempt = 0; attempt < LORA_LBT_MAX_ATTEMPTS; attempt++) {
+        if (attempt > 0) {
+            uint32_t backoff = random(LORA_LBT_BACKOFF_MIN_MS, LORA_LBT_BACKOFF_MAX_MS + 1);
+            if (millis() - windowStart + backoff > LORA_LBT_WINDOW_MS) break;
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(backoff));
+        }
+
+        int16_t rssi = senseChannel(senseProfile, region->lbtSenseUs);
+        stats.lbt[slot].checks++;
+        stats.lbt[slot].lastRssi = rssi;
+
+        bool busy = rssi >= region->lbtThresholdDbm;
+        if (!busy && useCad) {
+            busy = doChannelScan(senseProfile) == RADIOLIB_PREAMBLE_DETECTED;
+        }
+        dio0Flag = false;
+
+        if (!busy) return RADIOLIB_CHANNEL_FREE;
+        stats.lbt[slot].busy++;
+    }
+
+    stats.lbt[slot].blocked++;
+    return RADIO_CMD_ERR_CHANNEL_BUSY;
+}
+
+// ================== Noise Floor ==================
+
+int16_t LoRaGateway::readRssi(uint32_t frequency) {
+    // RegRssiValue: instantaneous RSSI in RX mode
+    int16_t offset = frequency < SX1276_HF_THRESHOLD ? SX1276_RSSI_OFFSET_LF : SX1276_RSSI_OFFSET_HF;
+    return offset + shadow.readRegister(SX1276_REG_RSSI_VALUE);
+}
+
+void LoRaGateway::noiseUpdate() {
+    if (!available || !config.enabled || !config.noiseEnabled) return;
+
+    unsigned long now = millis();
+
+    // Sweep over the channel plan between frames (never during a scan lock)
+    if (config.noiseSweepIntervalS > 0 && !scanLocked &&
+        now - lastNoiseSweep >= config.noiseSweepIntervalS * 1000UL &&
+        !(receiving && isRxInProgress())) {
+        lastNoiseSweep = now;
+        noiseSweep();
+    }
+
+    // Background sample on the fixed receiver; CAD scanning keeps the radio
+    // out of RX and a frame being received is not noise
+    if (now - lastNoiseSample >= LORA_NOISE_SAMPLE_MS && receiving && !scanActive) {
+        lastNoiseSample = now;
+        if (isRxInProgress()) {
+            noiseFloor.getStats().skipped++;
+        } else {
+            noiseFloor.record(activeRxProfile->frequency, readRssi(activeRxProfile->frequency));
+        }
+        noiseDirty = true;
+    }
+
+    if (noiseDirty && now - lastNoisePublish >= LORA_NOISE_PUBLISH_MS) {
+        lastNoisePublish = now;
+        noiseDirty = false;
+        noiseSnapshot.publish(noiseFloor.getStats());
+    }
+}
+
+void LoRaGateway::noiseSweep() {
+    // One RSSI reading per channel at the configured bandwidth; the SF does
+    // not matter for RSSI, so the SF7 profiles are reused
+    if (config.hopChannelCount > 0) {
+        for (uint8_t ch = 0; ch < config.hopChannelCount; ch++) {
+            noiseFloor.record(config.hopChannels[ch], senseChannel(hopProfiles[ch][0], 0));
+        }
+    } else {
+        noiseFloor.record(config.frequency, senseChannel(scanProfiles[0], 0));
+    }
+    noiseFloor.getStats().sweeps++;
+    noiseDirty = true;
+    dio0Flag = false;
+
+    // Scanning re-arms on its next step; the fixed receiver is restored here
+    if (!scanActive) startReceive();
+}
+
+// ================== Crystal Drift ==================
+
+void LoRaGateway::driftUpdate() {
+    if (!available) return;
+
+    unsigned long now = millis();
+    if (now - lastDriftEval >= LORA_DRIFT_EVAL_MS) {
+        lastDriftEval = now;
+        int32_t previous = drift.getTrimPpb();
+        if (drift.evaluate(now / 1000, config.driftCorrection)) {
+            driftTrimPending = true;
+            Serial.printf("[LoRa] Drift %+.2f ppm, FRF trim %+.2f -> %+.2f ppm%s\n",
+                          drift.getStats().estimatePpb / 1000.0f, previous / 1000.0f,
+                          drift.getTrimPpb() / 1000.0f,
+                          drift.getStats().diverged ? " (reverted, correction stopped)" : "");
+        }
+        driftSnapshot.publish(drift.getStats());
+    }
+
+    // FRF only changes between frames
+    if (driftTrimPending && !scanLocked && !(receiving && isRxInProgress())) {
+        driftTrimPending = false;
+        trimProfiles();
+
+        // Scanning re-arms on its next step; the fixed receiver is re-armed
+        // here (only the FRF bytes differ)
+        if (receiving && !scanActive) armReceive(*activeRxProfile, activeRxChannel);
+    }
+}
+
+void LoRaGateway::trimProfiles() {
+    int32_t trim = drift.getTrimPpb();
+
+    SX1276Shadow::trimProfile(rxProfile, trim);
+    SX1276Shadow::trimProfile(rx1Profile, trim);
+    SX1276Shadow::trimProfile(rx2Profile, trim);
+    SX1276Shadow::trimProfile(txProfile, trim);
+    for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) {
+        SX1276Shadow::trimProfile(scanProfiles[i], trim);
+    }
+    for (uint8_t ch = 0; ch < config.hopChannelCount; ch++) {
+        for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) {
+            SX1276Shadow::trimProfile(hopProfiles[ch][i], trim);
+        }
+    }
+}
+
+// ================== Receiver Watchdog ==================
+
+static const char* const STALL_CAUSE_NAMES[] = {
+    "none",
+    "missed_irq",
+    "rx_mode_lost",
+    "registers",
+    "lora_mode_lost",
+    "spi_fault"
+};
+
+static const char* const RECOVERY_NAMES[RADIO_RECOVERY_COUNT] = {
+    "re-arm",
+    "register reload",
+    "hardware reset"
+};
+
+const char* LoRaGateway::stallCauseName(RadioStallCause cause) {
+    uint8_t index = (uint8_t)cause;
+    return index < sizeof(STALL_CAUSE_NAMES) / sizeof(STALL_CAUSE_NAMES[0])
+           ? STALL_CAUSE_NAMES[index] : "unknown";
+}
+
+void LoRaGateway::watchdogUpdate() {
+    // Plain RX only: scanning and sweeps poll the radio on every step
+    if (!available || !receiving || config.watchdogTimeoutS == 0 ||
+        scanActive || sweepActive) {
+        return;
+    }
+
+    unsigned long now = millis();
+    if (now - lastRadioActivity < config.watchdogTimeoutS * 1000UL) return;
+
+    // A quiet channel is normal: poll the chip before doing anything
+    stats.wdChecks++;
+    RadioStallCause cause = watchdogCheck();
+    if (cause == RadioStallCause::NONE) {
+        lastRadioActivity = now;
+        publishStats();
+        return;
+    }
+
+    stats.wdStalls++;
+    stats.wdLastCause = cause;
+    stats.wdLastStallTime = now;
+
+    // Draining the FIFO below counts as activity: keep the last real one
+    unsigned long quietSince = lastRadioActivity;
+
+    if (cause == RadioStallCause::MISSED_IRQ) {
+        // The frame behind the lost edge is still in the FIFO
+        stats.wdMissedIrq++;
+        dio0Micros = micros();
+        processReceivedPacket();
+    }
+
+    // Lowest step that can fix the cause; one step higher when the last
+    // recovery did not hold
+    RadioRecovery level;
+    switch (cause) {
+        case RadioStallCause::REGISTERS:
+            level = RadioRecovery::RELOAD;
+            break;
+        case RadioStallCause::LORA_MODE_LOST:
+        case RadioStallCause::SPI_FAULT:
+            level = RadioRecovery::HARDWARE_RESET;
+            break;
+        default:
+            level = RadioRecovery::REARM;
+            break;
+    }
+    if (lastRecoveryTime != 0 && now - lastRecoveryTime < LORA_WATCHDOG_ESCALATE_MS &&
+        lastRecovery >= level) {
+        level = lastRecovery < RadioRecovery::HARDWARE_RESET
+                ? (RadioRecovery)((uint8_t)lastRecovery + 1) : RadioRecovery::HARDWARE_RESET;
+    }
+
+    Serial.printf("[LoRa] Watchdog: receiver stalled (%s) after %lu s quiet\n",
+                  stallCauseName(cause), (unsigned long)((now - quietSince) / 1000));
+
+    bool recovered = false;
+    while (true) {
+        Serial.printf("[LoRa] Watchdog: %s\n", RECOVERY_NAMES[(uint8_t)level]);
+        if (watchdogRecover(level)) {
+            recovered = true;
+            break;
+        }
+        if (level == RadioRecovery::HARDWARE_RESET) break;
+        level = (RadioRecovery)((uint8_t)level + 1);
+    }
+
+    // Downtime is counted from the last sign of life, so it is an upper bound
+    uint32_t downtime = millis() - quietSince;
+    stats.wdDowntimeLastMs = downtime;
+    stats.wdDowntimeTotalMs += downtime;
+
+    if (recovered) {
+        stats.wdRecoveries[(uint8_t)level]++;
+        Serial.printf("[LoRa] Watchdog: receiver back after %s (down up to %lu ms)\n",
+                      RECOVERY_NAMES[(uint8_t)level], (unsigned long)downtime);
+    } else {
+        stats.wdFailures++;
+        Serial.println("[LoRa] Watchdog: radio still not responding after reset");
+    }
+
+    lastRecovery = level;
+    lastRecoveryTime = millis();
+    lastRadioActivity = lastRecoveryTime;
+    publishStats();
+}
+
+RadioStallCause LoRaGateway::watchdogCheck() {
+    uint8_t version = shadow.readRegister(SX1276_REG_VERSION);
+    if (version == 0x00 || version == 0xFF) return RadioStallCause::SPI_FAULT;
+
+    uint8_t opMode = shadow.readRegister(SX1276_REG_OP_MODE);
+    if (!(opMode & SX1276_MODE_LONG_RANGE)) return RadioStallCause::LORA_MODE_LOST;
+
+    // RX done without its DIO0 edge (an edge just in flight sets dio0Flag)
+    uint8_t irqFlags = shadow.readRegister(SX1276_REG_IRQ_FLAGS);
+    if ((irqFlags & SX1276_IRQ_RX_DONE) && !dio0Flag) return RadioStallCause::MISSED_IRQ;
+
+    if ((opMode & SX1276_MODE_MASK) != SX1276_MODE_RX_CONTINUOUS) return RadioStallCause::RX_MODE_LOST;
+
+    if (shadow.verify() > 0) return RadioStallCause::REGISTERS;
+
+    return RadioStallCause::NONE;
+}
+
+bool LoRaGateway::watchdogRecover(RadioRecovery level) {
+    switch (level) {
+        case RadioRecovery::REARM:
+            armReceive(*activeRxProfile, activeRxChannel);
+            break;
+
+        case RadioRecovery::RELOAD:
+            // Cache from the chip, then every byte that differs is rewritten
+            shadow.sync();
+            armReceive(*activeRxProfile, activeRxChannel);
+            break;
+
+        case RadioRecovery::HARDWARE_RESET:
+            if (!resetRadio()) return false;
+            break;
+
+        default:
+            return false;
+    }
+
+    return watchdogCheck() == RadioStallCause::NONE;
+}
+
+bool LoRaGateway::resetRadio() {
+    if (config.pinRst < 0) return false;
+
+    // The chip boots in FSK standby with default registers
+    digitalWrite(config.pinRst, LOW);
+    delayMicroseconds(LORA_WATCHDOG_RESET_PULSE_US);
+    digitalWrite(config.pinRst, HIGH);
+    delay(LORA_WATCHDOG_RESET_WAIT_MS);
+
+    // Same chip setup as initRadio(): LoRa mode, CRC on
+    int state = radio->begin(config.frequency / 1000000.0, config.bandwidth,
+                             config.spreadingFactor, config.codingRate,
+                             config.syncWord, config.txPower, 8, 0);
+    if (state != RADIOLIB_ERR_NONE) {
+        Serial.printf("[LoRa] Watchdog: init after reset failed, code: %d\n", state);
         return false;
     }
+    radio->setCRC(true);
+
+    shadow.sync();
+    if (!applyConfig()) return false;
+
+    return startReceive();
+}
+
+// ================== CAD Scanning / Channel Hopping ==================
+
+uint32_t LoRaGateway::symbolsToMs(const RadioProfile& profile, uint32_t symbols) {
+    // Symbol time = 2^SF / BW
+    uint32_t symbolUs = (uint32_t)((1UL << profile.spreadingFactor) * 1000.0f / profile.bandwidth);
+    return (symbols * symbolUs + 999) / 1000;
+}
+
+void LoRaGateway::scanUpdate() {
+    if (sweepActive && (long)(millis() - sweepEnd) >= 0) {
+        sweepActive = false;
+        Serial.println("[LoRa] Sweep finished");
+    }
+
+    // A sweep covers every SF and the whole channel plan
+    bool sfScan = sweepActive || (config.scanEnabled && config.scanSfCount > 0);
+    bool hopping = config.hopChannelCount > 0 && (sweepActive || config.hopEnabled);
+    bool fixedSfValid = config.spreadingFactor >= LORA_SCAN_SF_MIN &&
+                        config.spreadingFactor <= LORA_SCAN_SF_MAX;
+
+    if (!available || !config.enabled || (!sfScan && !(hopping && fixedSfValid))) {
+        if (scanActive) {
+            // Scanning switched off: back to the configured channel and SF
+            scanActive = false;
+            hopActive = false;
+            scanLocked = false;
+            startReceive();
+        }
+        return;
+    }
+    scanActive = true;
+    hopActive = hopping;
+
+    if (scanLocked) {
+        // Preamble synchronized: keep the lock for the longest frame
+        if (!scanSynced && (shadow.readRegister(SX1276_REG_MODEM_STAT) & 0x0A)) {
+            scanSynced = true;
+            scanLockStart = millis();
+            scanLockTimeoutMs = symbolsToMs(*scanLockedProfile, LORA_SCAN_FRAME_SYMBOLS);
+        }
+
+        if (millis() - scanLockStart < scanLockTimeoutMs) return;
+
+        // Lock expired without a frame
+        scanRecordFrame(false);
+    }
+
+    // Next (channel, SF): every SF of the list on a channel, then the next channel
+    uint8_t sfCount = sweepActive ? LORA_SCAN_SF_COUNT : (sfScan ? config.scanSfCount : 1);
+    uint8_t channels = hopping ? config.hopChannelCount : 1;
+    if (scanStep >= sfCount) scanStep = 0;
+    if (hopIndex >= channels) hopIndex = 0;
+
+    if (scanStep == 0 && hopIndex == 0) {
+        stats.scanCycleUs = micros() - scanCycleStart;
+        scanCycleStart = micros();
+    }
+
+    uint8_t channel = hopIndex;
+    uint8_t sf;
+    if (sweepActive) {
+        sf = LORA_SCAN_SF_MIN + scanStep;
+    } else {
+        sf = sfScan ? config.scanSfList[scanStep] : config.spreadingFactor;
+    }
+    if (++scanStep >= sfCount) {
+        scanStep = 0;
+        hopIndex = (hopIndex + 1) % channels;
+    }
+
+    uint8_t index = sf - LORA_SCAN_SF_MIN;
+    const RadioProfile& profile = hopping ? hopProfiles[channel][index] : scanProfiles[index];
+    stats.scan[index].cadRuns++;
+    if (hopping) stats.hop[channel].cadRuns++;
+
+    if (doChannelScan(profile) != RADIOLIB_PREAMBLE_DETECTED) return;
+
+    // Activity: stay on this channel/SF in RX until the frame arrives or the
+    // lock expires
+    stats.scan[index].detections++;
+    if (hopping) stats.hop[channel].detections++;
+    armReceive(profile, channel);
+
+    scanLocked = true;
+    scanSynced = false;
+    scanLockedProfile = &profile;
+    scanLockedSf = sf;
+    scanLockedChannel = hopping ? channel : LORA_HOP_MAX_CHANNELS;
+    scanLockStart = millis();
+    scanLockTimeoutMs = config.scanDwellMs > 0 ? config.scanDwellMs
+                                               : symbolsToMs(profile, LORA_SCAN_DWELL_SYMBOLS);
+}
+
+void LoRaGateway::scanRecordFrame(bool received) {
+    uint8_t index = scanLockedSf - LORA_SCAN_SF_MIN;
+
+    if (received) {
+        stats.scan[index].packets++;
+        if (scanLockedChannel < LORA_HOP_MAX_CHANNELS) stats.hop[scanLockedChannel].packets++;
+    } else if (scanSynced) {
+        stats.scan[index].misses++;         // Preamble seen, frame lost (CRC or timeout)
+    } else {
+        stats.scan[index].falsePositives++;
+    }
+
+    scanLocked = false;
+    publishStats();
+}
+
+void LoRaGateway::updateOccupancy() {
+    GatewayStats radioStats = statsSnapshot.read();
+    unsigned long now = millis();
+    lastOccupancySample = now;
+
+    // Radio stats were reset: start a new window
+    if (occupancyCount > 0) {
+        uint8_t newest = (occupancyHead + LORA_OCCUPANCY_SAMPLES - 1) % LORA_OCCUPANCY_SAMPLES;
+        if (radioStats.rxAirtimeUs < occupancySamples[newest].rxAirtimeUs ||
+            radioStats.txAirtimeUs < occupancySamples[newest].txAirtimeUs) {
+            occupancyCount = 0;
+        }
+    }
+
+    occupancySamples[occupancyHead].time = now;
+    occupancySamples[occupancyHead].rxAirtimeUs = radioStats.rxAirtimeUs;
+    occupancySamples[occupancyHead].txAirtimeUs = radioStats.txAirtimeUs;
+    occupancyHead = (occupancyHead + 1) % LORA_OCCUPANCY_SAMPLES;
+    if (occupancyCount < LORA_OCCUPANCY_SAMPLES) occupancyCount++;
+    if (occupancyCount < 2) return;
+
+    // Oldest sample still in the ring against the newest
+    uint8_t oldest = (occupancyHead + LORA_OCCUPANCY_SAMPLES - occupancyCount) % LORA_OCCUPANCY_SAMPLES;
+    uint32_t windowMs = now - occupancySamples[oldest].time;
+    if (windowMs == 0) return;
+
+    uint64_t rxUs = radioStats.rxAirtimeUs - occupancySamples[oldest].rxAirtimeUs;
+    uint64_t txUs = radioStats.txAirtimeUs - occupancySamples[oldest].txAirtimeUs;
+    forwardStats.rxOccupancyPct = rxUs / (windowMs * 10.0f);
+    forwardStats.txOccupancyPct = txUs / (windowMs * 10.0f);
+    forwardSnapshot.publish(forwardStats);
+}
+
+void LoRaGateway::recordForwarded(uint32_t rxTimestamp) {
+    uint32_t latency = micros() - rxTimestamp;
+
+    forwardStats.rxPacketsForwarded++;
+    forwardStats.fwdLatencyLastUs = latency;
+    if (latency > forwardStats.fwdLatencyMaxUs) forwardStats.fwdLatencyMaxUs = latency;
+    forwardStats.fwdLatencySamples++;
+    forwardStats.fwdLatencyTotalUs += latency;
+
+    forwardSnapshot.publish(forwardStats);
+}
+
+void LoRaGateway::publishStats() {
+    const SX1276ShadowStats& regs = shadow.getStats();
+    stats.regBytesWritten = regs.bytesWritten;
+    stats.regBytesSkipped = regs.bytesSkipped;
+    stats.spiTransactions = regs.transactions;
+
+    statsSnapshot.publish(stats);
+}
+
+GatewayStats LoRaGateway::getStatsSnapshot() const {
+    GatewayStats result = statsSnapshot.read();
+    GatewayStats forward = forwardSnapshot.read();
+
+    result.rxPacketsForwarded = forward.rxPacketsForwarded;
+    result.fwdLatencyLastUs = forward.fwdLatencyLastUs;
+    result.fwdLatencyMaxUs = forward.fwdLatencyMaxUs;
+    result.fwdLatencySamples = forward.fwdLatencySamples;
+    result.fwdLatencyTotalUs = forward.fwdLatencyTotalUs;
+    result.rxOccupancyPct = forward.rxOccupancyPct;
+    result.txOccupancyPct = forward.txOccupancyPct;
+    result.radioCommandsRejected = rejectedCommands.load();
+
+    return result;
 }
 
 String LoRaGateway::getStatusJson() {
-    DynamicJsonDocument doc(1024);
+    GatewayStats stats = getStatsSnapshot();
+    DynamicJsonDocument doc(1536);
 
     doc["available"] = available;
     doc["enabled"] = config.enabled;
@@ -516,11 +1816,43 @@ String LoRaGateway::getStatusJson() {
         st["last_packet_ago"] = ago;
     }
 
+    // Time on air and channel occupancy over the last 15 minutes
+    JsonObject airtime = doc.createNestedObject("airtime");
+    airtime["rx_ms"] = (uint32_t)(stats.rxAirtimeUs / 1000);
+    airtime["tx_ms"] = (uint32_t)(stats.txAirtimeUs / 1000);
+    airtime["rx_occupancy_pct"] = stats.rxOccupancyPct;
+    airtime["tx_occupancy_pct"] = stats.txOccupancyPct;
+
+    doc["scanning"] = isScanning();
+
+    JsonObject task = doc.createNestedObject("radio_task");
+    task["running"] = isTaskRunning();
+    task["commands"] = stats.radioCommands;
+    task["rejected"] = stats.radioCommandsRejected;
+    task["reconfigs"] = stats.reconfigCount;
+    task["reconfig_gap_us"] = stats.reconfigGapLastUs;
+    task["reconfig_gap_max_us"] = stats.reconfigGapMaxUs;
+    task["reconfig_defer_ms"] = stats.reconfigDeferLastMs;
+
+    JsonObject watchdog = doc.createNestedObject("watchdog");
+    watchdog["timeout_s"] = config.watchdogTimeoutS;
+    watchdog["checks"] = stats.wdChecks;
+    watchdog["stalls"] = stats.wdStalls;
+    watchdog["missed_irq"] = stats.wdMissedIrq;
+    watchdog["failures"] = stats.wdFailures;
+    watchdog["downtime_ms"] = stats.wdDowntimeTotalMs;
+
     String output;
     serializeJson(doc, output);
     return output;
 }
 
 void LoRaGateway::resetStats() {
-    memset(&stats, 0, sizeof(stats));
+    statsResetRequested = true;
+    forwardResetRequested = true;
+    rejectedCommands = 0;
+
+    if (radioTaskHandle) {
+        xTaskNotifyGive(radioTaskHandle);
+    }
 }
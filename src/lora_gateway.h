@@ -4,12 +4,100 @@
 #include <Arduino.h>
 #include <RadioLib.h>
 #include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
 #include "config.h"
+#include "stats_snapshot.h"
+#include "sx1276_shadow.h"
+#include "lorawan_region.h"
+#include "noise_floor.h"
+#include "freq_drift.h"
 
 // Maximum packets to queue
 #define MAX_PACKET_QUEUE 8
 #define MAX_PACKET_SIZE 256
 
+// Radio owner task (all SPI access to the SX1276 happens on this task)
+#define RADIO_TASK_STACK_SIZE       6144
+#define RADIO_TASK_PRIORITY         3       // Above loop() (1)
+#define RADIO_TASK_CORE             1       // Same core as loop(), AsyncTCP runs on 0
+#define RADIO_TASK_IDLE_MS          10      // Wake-up period while a command is deferred
+#define RADIO_COMMAND_QUEUE_SIZE    4
+#define RADIO_COMPLETION_SLOTS      8
+
+#define RADIO_RECONFIG_MAX_DEFER_MS 3000    // Longest wait for an RX in progress (SF12, 255 bytes)
+#define RADIO_RECONFIG_TIMEOUT_MS   (RADIO_RECONFIG_MAX_DEFER_MS + 1000)
+#define RADIO_TX_DONE_TIMEOUT_MS    10000   // Longest LoRaWAN frame (SF12/BW125, 255 bytes) is ~9 s
+#define RADIO_TX_POLL_MS            5       // IRQ flag poll while waiting for TX done
+#define RADIO_CAD_DONE_TIMEOUT_MS   100
+#define RADIO_TX_TIMEOUT_MS         (RADIO_RECONFIG_MAX_DEFER_MS + LORA_LBT_WINDOW_MS + \
+                                     RADIO_TX_DONE_TIMEOUT_MS + 1000)
+#define RADIO_CAD_TIMEOUT_MS        1000
+#define RADIO_STANDBY_TIMEOUT_MS    1000
+
+// CAD multi-SF scanning
+#define LORA_SCAN_SF_MIN            7
+#define LORA_SCAN_SF_MAX            12
+#define LORA_SCAN_SF_COUNT          (LORA_SCAN_SF_MAX - LORA_SCAN_SF_MIN + 1)
+#define LORA_SCAN_MAX_STEPS         12      // Priority list length (SFs may repeat)
+#define LORA_SCAN_DWELL_SYMBOLS     16      // Automatic dwell: rest of preamble + header
+#define LORA_SCAN_FRAME_SYMBOLS     300     // Upper bound for a frame once synchronized
+#define LORA_HOP_MAX_CHANNELS       8       // One US915/AU915 sub-band
+
+// Listen-before-talk for downlinks (regions with an LBT sense time)
+#define LORA_LBT_MAX_ATTEMPTS       5
+#define LORA_LBT_WINDOW_MS          200     // Longest TX delay from sensing and backoff
+#define LORA_LBT_BACKOFF_MIN_MS     5       // Random backoff after a busy channel
+#define LORA_LBT_BACKOFF_MAX_MS     40
+#define LORA_LBT_SETTLE_US          250     // RX entry until RegRssiValue is valid
+#define LORA_LBT_CAD_MAX_MS         20      // CAD also runs when two symbols fit (SF7-SF10/125)
+#define LORA_LBT_MAX_CHANNELS       8       // Per-frequency statistics
+
+// Noise-floor sampler (radio task)
+#define LORA_NOISE_SAMPLE_MS        100     // RSSI read period while the receiver is idle
+#define LORA_NOISE_PUBLISH_MS       1000
+
+// Crystal drift estimator (radio task)
+#define LORA_DRIFT_EVAL_MS          300000  // One evaluation (and at most one step) per 5 min
+
+// Receiver watchdog (radio task)
+#define LORA_WATCHDOG_POLL_MS       1000    // Radio task wake-up while otherwise idle
+#define LORA_WATCHDOG_MIN_TIMEOUT_S 10
+#define LORA_WATCHDOG_ESCALATE_MS   600000  // A stall this soon after a recovery starts one level up
+#define LORA_WATCHDOG_RESET_PULSE_US 200    // NRESET low (datasheet: > 100 us)
+#define LORA_WATCHDOG_RESET_WAIT_MS 10      // Chip ready after reset (datasheet: 5 ms)
+
+// Channel occupancy (time on air over a rolling window, sampled by the loop)
+#define LORA_OCCUPANCY_SAMPLE_MS    60000
+#define LORA_OCCUPANCY_SAMPLES      16      // 15 minute window
+
+// Command errors (RadioLib codes are used for everything else)
+#define RADIO_CMD_ERR_NOT_RUNNING   -2001
+#define RADIO_CMD_ERR_QUEUE_FULL    -2002
+#define RADIO_CMD_ERR_TIMEOUT       -2003
+#define RADIO_CMD_ERR_INVALID_PARAM -2004
+#define RADIO_CMD_ERR_CHANNEL_BUSY  -2005   // LBT found the channel busy on every attempt
+
+// Receiver watchdog: what a poll found, and the recovery steps in order
+enum class RadioStallCause : uint8_t {
+    NONE = 0,
+    MISSED_IRQ,         // RX done flag set without a DIO0 edge
+    RX_MODE_LOST,       // Left RX continuous (standby, sleep)
+    REGISTERS,          // Register contents differ from the shadow cache
+    LORA_MODE_LOST,     // Back in FSK mode (chip reset by a glitch)
+    SPI_FAULT           // RegVersion unreadable (bus or chip)
+};
+
+enum class RadioRecovery : uint8_t {
+    REARM = 0,          // Re-arm RX from the cached profile
+    RELOAD,             // Rewrite every register of the profile
+    HARDWARE_RESET,     // Pulse NRESET and initialize the chip again
+    COUNT
+};
+
+#define RADIO_RECOVERY_COUNT    ((uint8_t)RadioRecovery::COUNT)
+
 // LoRa packet structure
 struct LoRaPacket {
     uint8_t data[MAX_PACKET_SIZE];
@@ -20,7 +108,10 @@ struct LoRaPacket {
     uint8_t spreadingFactor;
     float bandwidth;
     uint8_t codingRate;
-    uint32_t timestamp;  // Internal timestamp (microseconds)
+    uint8_t channel;     // Index in the hopping channel plan (0 on a fixed frequency)
+    int32_t freqOffset;  // Frequency error from FEI (Hz, signal minus receiver)
+    uint32_t timestamp;  // Internal timestamp (microseconds, at DIO0 interrupt)
+    bool crcOk;          // false: payload CRC failed (forwarded with stat -1)
     bool valid;
 };
 
@@ -35,6 +126,82 @@ struct GatewayStats {
     unsigned long lastPacketTime;
     float lastRssi;
     float lastSnr;
+
+    // RX (DIO0 interrupt) to PUSH_DATA sent latency
+    uint32_t fwdLatencyLastUs;
+    uint32_t fwdLatencyMaxUs;
+    uint32_t fwdLatencySamples;
+    uint64_t fwdLatencyTotalUs;
+
+    // Time on air (radio task) and occupancy over the rolling window (loop)
+    uint64_t rxAirtimeUs;
+    uint64_t txAirtimeUs;
+    float rxOccupancyPct;
+    float txOccupancyPct;
+
+    // CAD scanning, per spreading factor (index SF - LORA_SCAN_SF_MIN)
+    struct {
+        uint32_t cadRuns;
+        uint32_t detections;          // CAD reported activity
+        uint32_t packets;             // Frame received after locking
+        uint32_t misses;              // Synchronized but no valid frame (CRC error / cut off)
+        uint32_t falsePositives;      // Locked but never synchronized
+    } scan[LORA_SCAN_SF_COUNT];
+    uint32_t scanCycleUs;             // Last full pass over channels and SFs
+
+    // Channel hopping, per channel plan entry
+    struct {
+        uint32_t cadRuns;
+        uint32_t detections;
+        uint32_t packets;
+    } hop[LORA_HOP_MAX_CHANNELS];
+
+    // Radio command queue
+    uint32_t radioCommands;
+    uint32_t radioCommandsRejected;   // Queue full or caller timed out
+    uint32_t reconfigCount;
+    uint32_t reconfigGapLastUs;       // RX stopped -> RX re-armed
+    uint32_t reconfigGapMaxUs;
+    uint32_t reconfigDeferLastMs;     // Wait for an RX in progress to finish
+
+    // DIO0 (RX done) -> packet read and receiver re-armed
+    uint32_t rxRearmLastUs;
+    uint32_t rxRearmMaxUs;
+    uint32_t rxRearmSamples;
+    uint64_t rxRearmTotalUs;
+
+    // Downlink turnaround
+    uint32_t txSetupLastUs;           // RX stopped -> TX started
+    uint32_t txSetupMaxUs;
+    uint32_t rxRestoreLastUs;         // TX done -> RX re-armed
+    uint32_t rxRestoreMaxUs;
+
+    // Listen-before-talk, per downlink frequency
+    struct {
+        uint32_t frequency;           // 0 = unused slot
+        uint32_t checks;              // Carrier sense runs
+        uint32_t busy;                // Runs that found the channel busy
+        uint32_t blocked;             // Downlinks dropped after the last attempt
+        int16_t lastRssi;             // dBm, highest sample of the last run
+    } lbt[LORA_LBT_MAX_CHANNELS];
+    uint32_t lbtDelayLastUs;          // Sensing and backoff before the last TX
+    uint32_t lbtDelayMaxUs;
+
+    // Receiver watchdog
+    uint32_t wdChecks;                // Polls after a quiet period
+    uint32_t wdStalls;
+    uint32_t wdMissedIrq;
+    uint32_t wdRecoveries[RADIO_RECOVERY_COUNT];  // Per level that brought RX back
+    uint32_t wdFailures;              // Still stalled after a hardware reset
+    uint32_t wdDowntimeLastMs;        // Last sign of life to recovered (upper bound)
+    uint32_t wdDowntimeTotalMs;
+    unsigned long wdLastStallTime;
+    RadioStallCause wdLastCause;
+
+    // Register shadow (see sx1276_shadow.h)
+    uint32_t regBytesWritten;
+    uint32_t regBytesSkipped;
+    uint32_t spiTransactions;
 };
 
 // Gateway configuration
@@ -54,6 +221,68 @@ struct GatewayConfig {
     int8_t pinNss;
     int8_t pinRst;
     int8_t pinDio0;
+
+    // CAD multi-SF scanning
+    bool scanEnabled;
+    uint16_t scanDwellMs;                       // Lock time after a detection (0 = automatic)
+    uint8_t scanSfCount;
+    uint8_t scanSfList[LORA_SCAN_MAX_STEPS];    // Scan order, highest priority first
+
+    // Channel hopping (CAD on each channel of the plan)
+    bool hopEnabled;
+    uint8_t hopChannelCount;
+    uint32_t hopChannels[LORA_HOP_MAX_CHANNELS]; // Hz, reported as rxpk chan 0..n-1
+
+    // Noise-floor sampler
+    bool noiseEnabled;
+    uint32_t noiseSweepIntervalS;   // Sweep over the channel plan, 0 = off
+
+    // Crystal drift compensation
+    bool driftCorrection;           // Trim FRF to the measured offset
+
+    // Receiver watchdog
+    uint16_t watchdogTimeoutS;      // Poll the radio after this long without DIO0, 0 = off
+
+    // CRC-failed frames (always kept in the bad frame log)
+    bool forwardCrcErrors;          // Also queue them for the server as stat -1
+};
+
+// Commands executed by the radio owner task
+enum class RadioCommandType : uint8_t {
+    RECONFIGURE = 0,    // Apply a new GatewayConfig between packets
+    TRANSMIT,           // Downlink, then back to RX
+    STANDBY,            // Stop receiving
+    RECEIVE,            // (Re)start receiving
+    CAD,                // Channel activity detection, then back to RX
+    SWEEP               // Scan every channel of the plan at every SF for a while
+};
+
+// Result of a command, returned to the submitting task
+struct RadioCompletion {
+    int16_t state;          // RadioLib status or RADIO_CMD_ERR_*
+    uint32_t durationUs;    // Execution time on the radio task
+    uint32_t rxGapUs;       // Time the receiver was not armed
+    uint32_t deferMs;       // Time spent waiting for an RX in progress
+};
+
+struct RadioCommand {
+    RadioCommandType type;
+    uint32_t id;
+    TaskHandle_t notifyTask;    // Task waiting for completion (nullptr = none)
+
+    GatewayConfig config;       // RECONFIGURE
+
+    uint8_t data[MAX_PACKET_SIZE];  // TRANSMIT
+    uint16_t length;
+    uint32_t frequency;
+    uint8_t spreadingFactor;
+    float bandwidth;
+    uint8_t codingRate;
+    int8_t txPower;
+    bool invertIq;
+    bool crc;
+
+    uint32_t durationMs;        // SWEEP
 };
 
 class LoRaGateway {
@@ -65,25 +294,61 @@ public:
     void loadConfig(const JsonDocument& doc);
     bool saveConfig();
 
-    // Operation
+    // Start the radio owner task (after begin/startReceive in setup)
+    bool startTask();
+    bool isTaskRunning() const { return radioTaskHandle != nullptr; }
+
+    // Operation (loop task)
     void update();
     bool startReceive();
     bool hasPacket();
     LoRaPacket getPacket();
 
-    // Transmission (for downlinks)
-    bool transmit(const uint8_t* data, size_t length, uint32_t frequency = 0,
-                  uint8_t sf = 0, float bw = 0, uint8_t cr = 0);
+    // Radio commands (any task except the radio task; block until done)
+    // transmit() returns RADIOLIB_ERR_NONE or the failure (RADIO_CMD_ERR_CHANNEL_BUSY
+    // when listen-before-talk found the channel busy); crc sets the payload
+    // CRC bit (txpk "ncrc" clears it)
+    int16_t transmit(const uint8_t* data, size_t length, uint32_t frequency = 0,
+                  uint8_t sf = 0, float bw = 0, uint8_t cr = 0,
+                  int8_t power = 0, bool invertIq = false, bool crc = true);
+    bool reconfigure(const GatewayConfig& newConfig, RadioCompletion* result = nullptr);
+    bool standby();
+    int16_t scanChannel();
+
+    // Scan every channel of the plan (or the configured channel) at SF7..SF12
+    // for a while, regardless of the scan/hop settings (0 ends a sweep)
+    bool sweep(uint32_t durationMs);
 
-    // Configuration
+    // RX2 downlink window of the region, precomputed as a TX profile
+    // (call before startTask())
+    void setRx2Window(uint32_t frequency, uint8_t sf, float bw);
+
+    // Regional parameters: RX2 window, default channel plan for hopping and
+    // uplink data rates for scanning (call before begin())
+    void setRegion(const LoRaRegion* region);
+    const LoRaRegion* getRegion() const { return region; }
+
+    // Configuration (changes go through reconfigure())
     GatewayConfig& getConfig() { return config; }
-    GatewayStats& getStats() { return stats; }
+    uint32_t getConfigRevision() const { return configRevision; }     // Bumped by every applied change
     bool isAvailable() const { return available; }
-    bool isReceiving() const { return receiving; }
+    bool isReceiving() const { return receiving || scanActive; }
+    bool isScanning() const { return scanActive; }
+    bool isHopping() const { return hopActive; }
+    bool isSweeping() const { return sweepActive; }
+
+    // Forwarding statistics (loop task)
+    void recordForwarded(uint32_t rxTimestamp);
+
+    // Statistics (any task, consistent copy)
+    GatewayStats getStatsSnapshot() const;
+    NoiseFloorStats getNoiseSnapshot() const { return noiseSnapshot.read(); }
+    static const char* stallCauseName(RadioStallCause cause);
+    DriftStats getDriftSnapshot() const { return driftSnapshot.read(); }
 
     // Status
     String getStatusJson();
-    void resetStats();
+    void resetStats();      // Applied by the owning tasks on their next pass
 
     // Interrupt handler
     static void onDio0Rise();
@@ -91,24 +356,141 @@ public:
 private:
     SX1276* radio;
     SPIClass* spi;
+    SX1276Shadow shadow;
     GatewayConfig config;
+    volatile uint32_t configRevision;
+
+    // Precomputed register images
+    RadioProfile rxProfile;         // Uplink receive (config)
+    RadioProfile rx1Profile;        // RX1 downlink: uplink channel, inverted IQ
+    RadioProfile rx2Profile;        // RX2 downlink: region default
+    RadioProfile txProfile;         // Last other downlink
+    RadioProfile scanProfiles[LORA_SCAN_SF_COUNT];                         // Config channel, SF7..SF12
+    RadioProfile hopProfiles[LORA_HOP_MAX_CHANNELS][LORA_SCAN_SF_COUNT];   // Channel plan x SF7..SF12
+    const RadioProfile* activeRxProfile;            // Profile the receiver is armed with
+    uint8_t activeRxChannel;
+    uint32_t rx2Frequency;
+    uint8_t rx2SpreadingFactor;
+    float rx2Bandwidth;
+    const LoRaRegion* region;
+
+    // Radio counters (radio task) and forward counters (loop task), each
+    // with a single writer and published separately
     GatewayStats stats;
+    StatsSnapshot<GatewayStats> statsSnapshot;
+    volatile bool statsResetRequested;
+
+    GatewayStats forwardStats;
+    StatsSnapshot<GatewayStats> forwardSnapshot;
+    volatile bool forwardResetRequested;
+
+    // Noise floor per frequency (radio task), published at most once a second
+    NoiseFloorTable noiseFloor;
+    StatsSnapshot<NoiseFloorStats> noiseSnapshot;
+    unsigned long lastNoiseSample;
+    unsigned long lastNoisePublish;
+    unsigned long lastNoiseSweep;
+    bool noiseDirty;
+
+    // Crystal drift from the FEI of received frames (radio task)
+    FrequencyDrift drift;
+    StatsSnapshot<DriftStats> driftSnapshot;
+    unsigned long lastDriftEval;
+    bool driftTrimPending;          // New trim waiting for the receiver to be idle
+
+    // Receiver watchdog (radio task)
+    unsigned long lastRadioActivity;    // DIO0 edge, RX armed or healthy poll
+    unsigned long lastRecoveryTime;     // 0 = none yet
+    RadioRecovery lastRecovery;
+
+    // Airtime totals sampled for the occupancy window (loop task)
+    struct {
+        unsigned long time;
+        uint64_t rxAirtimeUs;
+        uint64_t txAirtimeUs;
+    } occupancySamples[LORA_OCCUPANCY_SAMPLES];
+    uint8_t occupancyHead;
+    uint8_t occupancyCount;
+    unsigned long lastOccupancySample;
+
+    // Radio owner task
+    TaskHandle_t radioTaskHandle;
+    QueueHandle_t commandQueue;
+    std::atomic<uint32_t> nextCommandId;
+    RadioCompletion completions[RADIO_COMPLETION_SLOTS];
+    std::atomic<uint32_t> rejectedCommands;
+    bool deferring;                 // Queued reconfigure waiting for an RX to finish
+    unsigned long deferStart;
 
     bool available;
     bool receiving;
 
+    // Scan state (radio task)
+    volatile bool scanActive;
+    volatile bool hopActive;
+    volatile bool sweepActive;      // Temporary full scan (SWEEP command)
+    unsigned long sweepEnd;
+    const RadioProfile* scanLockedProfile;
+    bool scanLocked;                // Receiving on a detected SF
+    bool scanSynced;                // Preamble synchronized while locked
+    uint8_t scanStep;               // Position in the SF list
+    uint8_t hopIndex;               // Position in the channel plan
+    uint8_t scanLockedSf;
+    uint8_t scanLockedChannel;      // LORA_HOP_MAX_CHANNELS when not hopping
+    unsigned long scanLockStart;
+    uint32_t scanLockTimeoutMs;
+    uint32_t scanCycleStart;
+
     // Packet queue (circular buffer)
     LoRaPacket packetQueue[MAX_PACKET_QUEUE];
     volatile uint8_t queueHead;
     volatile uint8_t queueTail;
+    LoRaPacket badFrame;            // CRC-failed frame that is not queued
 
-    // Interrupt flag
+    // Interrupt flag, time of last DIO0 edge and task woken by it
     static volatile bool dio0Flag;
+    static volatile uint32_t dio0Micros;
+    static TaskHandle_t dio0NotifyTask;
 
     // Internal methods
     bool initRadio();
-    void processReceivedPacket();
-    bool queuePacket(const LoRaPacket& packet);
+    bool processReceivedPacket();
+    bool armReceive(const RadioProfile& profile, uint8_t channel = 0);
+    void scanUpdate();
+    void scanRecordFrame(bool received);
+    static uint32_t symbolsToMs(const RadioProfile& profile, uint32_t symbols);
+    void publishStats();
+    void updateOccupancy();
+
+    // Radio task
+    static void radioTask(void* param);
+    void radioLoop();
+    void processCommands();
+    void executeCommand(const RadioCommand& cmd);
+    int16_t submitCommand(RadioCommand& cmd, uint32_t timeoutMs, RadioCompletion* result);
+    bool isRxInProgress();
+
+    void setRadioParameters(const GatewayConfig& newConfig);
+    void buildDownlinkProfiles();
+    const RadioProfile* selectTxProfile(uint32_t frequency, uint8_t sf, float bw,
+                                        uint8_t cr, int8_t power, bool invertIq, bool crc);
+    int16_t doReconfigure(const GatewayConfig& newConfig, RadioCompletion& result);
+    int16_t doTransmit(const uint8_t* data, size_t length, uint32_t frequency,
+                       uint8_t sf, float bw, uint8_t cr, int8_t power, bool invertIq,
+                       bool crc);
+    int16_t doChannelScan(const RadioProfile& profile);
+    int16_t listenBeforeTalk(uint32_t frequency, uint8_t sf, float bw);
+    int16_t senseChannel(const RadioProfile& profile, uint32_t senseUs);
+    int16_t readRssi(uint32_t frequency);
+    void noiseUpdate();
+    void noiseSweep();
+    void driftUpdate();
+    void trimProfiles();
+    void watchdogUpdate();
+    RadioStallCause watchdogCheck();
+    bool watchdogRecover(RadioRecovery level);
+    bool resetRadio();
+    uint8_t lbtChannelSlot(uint32_t frequency);
 
     // Configuration helpers
     void setDefaultConfig();
@@ -0,0 +1,125 @@
+#include "lorawan_frame.h"
+#include <string.h>
+
+static const char* const MTYPE_NAMES[LORAWAN_MTYPE_COUNT] = {
+    "join_request",
+    "join_accept",
+    "unconfirmed_up",
+    "unconfirmed_down",
+    "confirmed_up",
+    "confirmed_down",
+    "rejoin_request",
+    "proprietary"
+};
+
+// NwkID length per NetID type (LoRaWAN Backend Interfaces, DevAddr format)
+static const uint8_t NWKID_BITS[8] = { 6, 6, 9, 11, 12, 13, 15, 17 };
+
+// Multi-byte fields are little-endian
+static uint16_t readLe16(const uint8_t* p) {
+    return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static uint32_t readLe32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t readLe64(const uint8_t* p) {
+    return (uint64_t)readLe32(p) | ((uint64_t)readLe32(p + 4) << 32);
+}
+
+bool lorawanDecodeHeader(const uint8_t* data, uint8_t length, LoRaWANHeader& header) {
+    memset(&header, 0, sizeof(header));
+    header.fport = -1;
+
+    if (data == nullptr || length < 1) return false;
+
+    header.mtype = (LoRaWANMType)(data[0] >> 5);
+    header.major = data[0] & 0x03;
+
+    // Proprietary frames only share the MHDR
+    if (header.mtype == LoRaWANMType::PROPRIETARY) {
+        header.valid = true;
+        return true;
+    }
+    if (header.major != 0) return false;
+
+    switch (header.mtype) {
+        case LoRaWANMType::JOIN_REQUEST:
+            if (length != LORAWAN_JOIN_REQUEST_SIZE) return false;
+            header.joinEui = readLe64(data + 1);
+            header.devEui = readLe64(data + 9);
+            header.devNonce = readLe16(data + 17);
+            break;
+
+        case LoRaWANMType::JOIN_ACCEPT:
+            // Encrypted: 16 or 32 bytes after the MHDR
+            if (length != 17 && length != 33) return false;
+            break;
+
+        case LoRaWANMType::REJOIN_REQUEST:
+            // Type 0/2: NetID DevEUI RJcount0; type 1: JoinEUI DevEUI RJcount1
+            if (length == 19 && (data[1] == 0 || data[1] == 2)) {
+                header.devEui = readLe64(data + 5);
+                header.devNonce = readLe16(data + 13);
+            } else if (length == 24 && data[1] == 1) {
+                header.joinEui = readLe64(data + 2);
+                header.devEui = readLe64(data + 10);
+                header.devNonce = readLe16(data + 18);
+            } else {
+                return false;
+            }
+            break;
+
+        default: {
+            // Data frame: DevAddr FCtrl FCnt FOpts [FPort FRMPayload]
+            if (length < LORAWAN_DATA_MIN_SIZE) return false;
+
+            header.devAddr = readLe32(data + 1);
+            header.fctrl = data[5];
+            header.fcnt = readLe16(data + 6);
+            header.foptsLength = data[5] & 0x0F;
+
+            uint8_t offset = 8 + header.foptsLength;
+            uint8_t end = length - LORAWAN_MIC_SIZE;
+            if (offset > end) return false;
+
+            if (offset < end) {
+                header.fport = data[offset];
+                header.payload = data + offset + 1;
+                header.payloadLength = end - offset - 1;
+            }
+            break;
+        }
+    }
+
+    header.valid = true;
+    return true;
+}
+
+void lorawanNetIdPrefix(uint32_t netId, uint32_t& prefix, uint8_t& prefixLength) {
+    // Type t: t ones and a zero, then the NwkID (NetID LSBs)
+    uint8_t type = (netId >> 21) & 0x07;
+    uint8_t bits = NWKID_BITS[type];
+    uint32_t nwkId = netId & ((1UL << bits) - 1);
+
+    prefixLength = type + 1 + bits;
+    prefix = (((1UL << (type + 1)) - 2) << (32 - (type + 1))) | (nwkId << (32 - prefixLength));
+}
+
+const char* lorawanMTypeName(LoRaWANMType mtype) {
+    uint8_t index = (uint8_t)mtype;
+    return index < LORAWAN_MTYPE_COUNT ? MTYPE_NAMES[index] : nullptr;
+}
+
+bool lorawanMTypeFromName(const char* name, LoRaWANMType& mtype) {
+    if (name == nullptr) return false;
+
+    for (uint8_t i = 0; i < LORAWAN_MTYPE_COUNT; i++) {
+        if (strcmp(name, MTYPE_NAMES[i]) == 0) {
+            mtype = (LoRaWANMType)i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,64 @@
+#ifndef LORAWAN_FRAME_H
+#define LORAWAN_FRAME_H
+
+#include <stdint.h>
+
+// =============================================================================
+// LoRaWAN Frame Header Decoder
+// =============================================================================
+// Decodes the clear-text part of a PHYPayload in place: MHDR, the FHDR of
+// data frames (DevAddr, FCtrl, FCnt, FOpts length, FPort) and the EUIs of
+// join/rejoin requests. Nothing is copied or decrypted; FRMPayload is a
+// pointer into the frame buffer, valid as long as that buffer is.
+
+// MHDR MType
+enum class LoRaWANMType : uint8_t {
+    JOIN_REQUEST = 0,
+    JOIN_ACCEPT,
+    UNCONFIRMED_UP,
+    UNCONFIRMED_DOWN,
+    CONFIRMED_UP,
+    CONFIRMED_DOWN,
+    REJOIN_REQUEST,
+    PROPRIETARY
+};
+
+#define LORAWAN_MTYPE_COUNT         8
+#define LORAWAN_MTYPE_BIT(mtype)    (1U << (uint8_t)(mtype))
+
+#define LORAWAN_MIC_SIZE            4
+#define LORAWAN_JOIN_REQUEST_SIZE   23      // MHDR JoinEUI DevEUI DevNonce MIC
+#define LORAWAN_DATA_MIN_SIZE       12      // MHDR FHDR(7) MIC
+
+struct LoRaWANHeader {
+    bool valid;                 // LoRaWAN R1 frame with every field of its MType
+    LoRaWANMType mtype;
+    uint8_t major;
+
+    // Data frames
+    uint32_t devAddr;
+    uint8_t fctrl;
+    uint16_t fcnt;              // 16 LSBs as transmitted
+    uint8_t foptsLength;
+    int16_t fport;              // -1 when absent
+    const uint8_t* payload;     // FRMPayload inside the frame buffer
+    uint8_t payloadLength;
+
+    // Join-request and rejoin-request (JoinEUI: join and rejoin type 1)
+    uint64_t joinEui;
+    uint64_t devEui;
+    uint16_t devNonce;          // DevNonce or RJcount
+};
+
+// Decode the header of a PHYPayload; header.valid is false for frames too
+// short for their MType or with an unknown major version
+bool lorawanDecodeHeader(const uint8_t* data, uint8_t length, LoRaWANHeader& header);
+
+// DevAddr prefix (type prefix + NwkID) that a NetID assigns, MSB aligned
+void lorawanNetIdPrefix(uint32_t netId, uint32_t& prefix, uint8_t& prefixLength);
+
+// Short name of an MType ("join_request", ...); nullptr when unknown
+const char* lorawanMTypeName(LoRaWANMType mtype);
+bool lorawanMTypeFromName(const char* name, LoRaWANMType& mtype);
+
+#endif // LORAWAN_FRAME_H
@@ -0,0 +1,282 @@
+#include "lorawan_region.h"
+#include <string.h>
+
+#if defined(LORAWAN_SINGLE_REGION) && \
+    (LORAWAN_SINGLE_REGION < LORAWAN_REGION_ID_EU868 || LORAWAN_SINGLE_REGION > LORAWAN_REGION_ID_RU864)
+#error "LORAWAN_SINGLE_REGION must be one of the LORAWAN_REGION_ID_* values"
+#endif
+
+// Compile-time checks of the tables below
+static constexpr bool isLoRaRate(const RegionDataRate* rates, uint8_t dr) {
+    return dr < LORAWAN_DATA_RATES && rates[dr].sf >= 7 && rates[dr].sf <= 12;
+}
+
+static constexpr bool channelsInBand(const uint32_t* channels, uint8_t count,
+                                     uint32_t minFrequency, uint32_t maxFrequency) {
+    return count == 0 ||
+           (channels[count - 1] >= minFrequency && channels[count - 1] <= maxFrequency &&
+            channelsInBand(channels, count - 1, minFrequency, maxFrequency));
+}
+
+#define REGION_CHANNELS(table)  table, (uint8_t)(sizeof(table) / sizeof(table[0]))
+
+// ================== EU868 ==================
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_EU868)
+static constexpr uint32_t EU868_CHANNELS[] = { 868100000, 868300000, 868500000 };
+
+static constexpr RegionDataRate EU868_DATA_RATES[LORAWAN_DATA_RATES] = {
+    { 12, 125,  59, 0 }, { 11, 125,  59, 0 }, { 10, 125,  59, 0 }, {  9, 125, 123, 0 },
+    {  8, 125, 230, 0 }, {  7, 125, 230, 0 }, {  7, 250, 230, 0 },  // DR7: FSK
+};
+
+// ETSI EN 300 220-2 sub-bands
+static constexpr DutyBand EU868_DUTY_BANDS[] = {
+    { "863.0-865.0",  863000000, 864999999,   10 },
+    { "865.0-868.0",  865000000, 867999999,  100 },
+    { "868.0-868.6",  868000000, 868600000,  100 },
+    { "868.7-869.2",  868700000, 869200000,   10 },
+    { "869.4-869.65", 869400000, 869650000, 1000 },
+    { "869.7-870.0",  869700000, 870000000,  100 },
+};
+
+static_assert(channelsInBand(EU868_CHANNELS, 3, 863000000, 870000000), "EU868 channel plan");
+static_assert(isLoRaRate(EU868_DATA_RATES, 0), "EU868 RX2 data rate");
+#endif
+
+// ================== US915 ==================
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_US915)
+static constexpr uint32_t US915_CHANNELS[] = {
+    903900000, 904100000, 904300000, 904500000, 904700000, 904900000, 905100000, 905300000
+};
+
+// DR5-6: LR-FHSS, DR7: RFU; DR8-13: downlink only
+static constexpr RegionDataRate US915_DATA_RATES[LORAWAN_DATA_RATES] = {
+    { 10, 125,  19,  19 }, {  9, 125,  61,  61 }, {  8, 125, 133, 133 }, {  7, 125, 250, 250 },
+    {  8, 500, 250, 250 }, {  0,   0,   0,   0 }, {  0,   0,   0,   0 }, {  0,   0,   0,   0 },
+    { 12, 500,  61,  61 }, { 11, 500, 137, 137 }, { 10, 500, 250, 250 }, {  9, 500, 250, 250 },
+    {  8, 500, 250, 250 }, {  7, 500, 250, 250 },
+};
+
+static_assert(channelsInBand(US915_CHANNELS, 8, 902000000, 928000000), "US915 channel plan");
+static_assert(isLoRaRate(US915_DATA_RATES, 8), "US915 RX2 data rate");
+#endif
+
+// ================== AU915 ==================
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_AU915)
+static constexpr uint32_t AU915_CHANNELS[] = {
+    916800000, 917000000, 917200000, 917400000, 917600000, 917800000, 918000000, 918200000
+};
+
+// DR7: LR-FHSS; DR8-13: downlink only
+static constexpr RegionDataRate AU915_DATA_RATES[LORAWAN_DATA_RATES] = {
+    { 12, 125,  59,   0 }, { 11, 125,  59,   0 }, { 10, 125,  59,  19 }, {  9, 125, 123,  61 },
+    {  8, 125, 230, 133 }, {  7, 125, 230, 230 }, {  8, 500, 230, 230 }, {  0,   0,   0,   0 },
+    { 12, 500,  61,  61 }, { 11, 500, 137, 137 }, { 10, 500, 250, 250 }, {  9, 500, 250, 250 },
+    {  8, 500, 250, 250 }, {  7, 500, 250, 250 },
+};
+
+static_assert(channelsInBand(AU915_CHANNELS, 8, 915000000, 928000000), "AU915 channel plan");
+static_assert(isLoRaRate(AU915_DATA_RATES, 8), "AU915 RX2 data rate");
+#endif
+
+// ================== AS923 ==================
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_AS923)
+static constexpr uint32_t AS923_CHANNELS[] = { 923200000, 923400000 };
+
+// Dwell time applies by default (until TxParamSetupReq); DR7: FSK.
+// LBT as required in Japan (ARIB STD-T108).
+static constexpr RegionDataRate AS923_DATA_RATES[LORAWAN_DATA_RATES] = {
+    { 12, 125,  59,   0 }, { 11, 125,  59,   0 }, { 10, 125, 123,  19 }, {  9, 125, 123,  61 },
+    {  8, 125, 230, 133 }, {  7, 125, 230, 230 }, {  7, 250, 230, 230 },
+};
+
+static_assert(channelsInBand(AS923_CHANNELS, 2, 915000000, 928000000), "AS923 channel plan");
+static_assert(isLoRaRate(AS923_DATA_RATES, 2), "AS923 RX2 data rate");
+#endif
+
+// ================== KR920 ==================
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_KR920)
+// LBT mandatory (-65 dBm)
+static constexpr uint32_t KR920_CHANNELS[] = { 922100000, 922300000, 922500000 };
+
+static constexpr RegionDataRate KR920_DATA_RATES[LORAWAN_DATA_RATES] = {
+    { 12, 125,  59, 0 }, { 11, 125,  59, 0 }, { 10, 125,  59, 0 }, {  9, 125, 123, 0 },
+    {  8, 125, 230, 0 }, {  7, 125, 230, 0 },
+};
+
+static_assert(channelsInBand(KR920_CHANNELS, 3, 920900000, 923300000), "KR920 channel plan");
+static_assert(isLoRaRate(KR920_DATA_RATES, 0), "KR920 RX2 data rate");
+#endif
+
+// ================== IN865 ==================
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_IN865)
+static constexpr uint32_t IN865_CHANNELS[] = { 865062500, 865402500, 865985000 };
+
+// DR6: RFU, DR7: FSK
+static constexpr RegionDataRate IN865_DATA_RATES[LORAWAN_DATA_RATES] = {
+    { 12, 125,  59, 0 }, { 11, 125,  59, 0 }, { 10, 125,  59, 0 }, {  9, 125, 123, 0 },
+    {  8, 125, 230, 0 }, {  7, 125, 230, 0 },
+};
+
+static_assert(channelsInBand(IN865_CHANNELS, 3, 865000000, 867000000), "IN865 channel plan");
+static_assert(isLoRaRate(IN865_DATA_RATES, 2), "IN865 RX2 data rate");
+#endif
+
+// ================== RU864 ==================
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_RU864)
+static constexpr uint32_t RU864_CHANNELS[] = { 868900000, 869100000 };
+
+static constexpr RegionDataRate RU864_DATA_RATES[LORAWAN_DATA_RATES] = {
+    { 12, 125,  59, 0 }, { 11, 125,  59, 0 }, { 10, 125,  59, 0 }, {  9, 125, 123, 0 },
+    {  8, 125, 230, 0 }, {  7, 125, 230, 0 }, {  7, 250, 230, 0 },  // DR7: FSK
+};
+
+// 1% on the whole band (default channels and RX2)
+static constexpr DutyBand RU864_DUTY_BANDS[] = {
+    { "864.0-870.0", 864000000, 870000000, 100 },
+};
+
+static_assert(channelsInBand(RU864_CHANNELS, 2, 864000000, 870000000), "RU864 channel plan");
+static_assert(isLoRaRate(RU864_DATA_RATES, 0), "RU864 RX2 data rate");
+#endif
+
+// ================== Region Table ==================
+//  id, name, band, uplink grid (first, step, count), default channels,
+//  data rates, uplink DR max, downlink DR range, RX2, EIRP, dwell (up/down),
+//  LBT (sense time, threshold), duty-cycle bands
+static constexpr LoRaRegion REGIONS[] = {
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_EU868)
+    { LORAWAN_REGION_ID_EU868, "EU868", 863000000, 870000000,
+      0, 0, 0, REGION_CHANNELS(EU868_CHANNELS),
+      EU868_DATA_RATES, 7, 0, 7, 869525000, 0, 16, 0, 0,
+      0, 0,
+      REGION_CHANNELS(EU868_DUTY_BANDS) },
+#endif
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_US915)
+    { LORAWAN_REGION_ID_US915, "US915", 902000000, 928000000,
+      902300000, 200000, 64, REGION_CHANNELS(US915_CHANNELS),
+      US915_DATA_RATES, 4, 8, 13, 923300000, 8, 30, 400, 0,
+      0, 0,
+      nullptr, 0 },
+#endif
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_AU915)
+    { LORAWAN_REGION_ID_AU915, "AU915", 915000000, 928000000,
+      915200000, 200000, 64, REGION_CHANNELS(AU915_CHANNELS),
+      AU915_DATA_RATES, 6, 8, 13, 923300000, 8, 30, 0, 0,
+      0, 0,
+      nullptr, 0 },
+#endif
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_AS923)
+    { LORAWAN_REGION_ID_AS923, "AS923", 915000000, 928000000,
+      0, 0, 0, REGION_CHANNELS(AS923_CHANNELS),
+      AS923_DATA_RATES, 7, 0, 7, 923200000, 2, 16, 400, 400,
+      5000, -80,
+      nullptr, 0 },
+#endif
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_KR920)
+    { LORAWAN_REGION_ID_KR920, "KR920", 920900000, 923300000,
+      0, 0, 0, REGION_CHANNELS(KR920_CHANNELS),
+      KR920_DATA_RATES, 5, 0, 5, 921900000, 0, 14, 0, 0,
+      5000, -65,
+      nullptr, 0 },
+#endif
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_IN865)
+    { LORAWAN_REGION_ID_IN865, "IN865", 865000000, 867000000,
+      0, 0, 0, REGION_CHANNELS(IN865_CHANNELS),
+      IN865_DATA_RATES, 7, 0, 7, 866550000, 2, 30, 0, 0,
+      0, 0,
+      nullptr, 0 },
+#endif
+#if LORAWAN_REGION_ENABLED(LORAWAN_REGION_ID_RU864)
+    { LORAWAN_REGION_ID_RU864, "RU864", 864000000, 870000000,
+      0, 0, 0, REGION_CHANNELS(RU864_CHANNELS),
+      RU864_DATA_RATES, 7, 0, 7, 869100000, 0, 16, 0, 0,
+      0, 0,
+      REGION_CHANNELS(RU864_DUTY_BANDS) },
+#endif
+};
+
+static constexpr uint8_t REGION_COUNT = sizeof(REGIONS) / sizeof(REGIONS[0]);
+
+// ================== Lookups ==================
+
+const LoRaRegion* lorawanRegionFind(const char* name) {
+    if (name == nullptr) return nullptr;
+    for (uint8_t i = 0; i < REGION_COUNT; i++) {
+        if (strcmp(REGIONS[i].name, name) == 0) return &REGIONS[i];
+    }
+    return nullptr;
+}
+
+const LoRaRegion* lorawanRegionDefault() {
+    for (uint8_t i = 0; i < REGION_COUNT; i++) {
+        if (REGIONS[i].id == LORAWAN_REGION_ID_DEFAULT) return &REGIONS[i];
+    }
+    return &REGIONS[0];
+}
+
+uint8_t lorawanRegionCount() {
+    return REGION_COUNT;
+}
+
+const LoRaRegion* lorawanRegionAt(uint8_t index) {
+    return index < REGION_COUNT ? &REGIONS[index] : nullptr;
+}
+
+bool lorawanRegionContains(const LoRaRegion* region, uint32_t frequency) {
+    return region != nullptr &&
+           frequency >= region->minFrequency && frequency <= region->maxFrequency;
+}
+
+int8_t lorawanFindDataRate(const LoRaRegion* region, uint8_t sf, uint16_t bwKhz, bool downlink) {
+    if (region == nullptr) return -1;
+
+    uint8_t first = downlink ? region->downlinkDrMin : 0;
+    uint8_t last = downlink ? region->downlinkDrMax : region->uplinkDrMax;
+    for (uint8_t dr = first; dr <= last && dr < LORAWAN_DATA_RATES; dr++) {
+        const RegionDataRate& rate = region->dataRates[dr];
+        if (rate.sf == sf && rate.bwKhz == bwKhz) return dr;
+    }
+    return -1;
+}
+
+uint16_t lorawanMaxPhyPayload(const LoRaRegion* region, uint8_t dataRate, bool dwellLimited) {
+    if (region == nullptr || dataRate >= LORAWAN_DATA_RATES) return 0;
+
+    const RegionDataRate& rate = region->dataRates[dataRate];
+    uint8_t maxPayload = dwellLimited ? rate.maxPayloadDwell : rate.maxPayload;
+    return maxPayload > 0 ? maxPayload + LORAWAN_PHY_OVERHEAD : 0;
+}
+
+bool lorawanUplinkSf(const LoRaRegion* region, uint8_t sf, uint16_t bwKhz) {
+    return lorawanFindDataRate(region, sf, bwKhz, false) >= 0;
+}
+
+// Decimal digits at *p (at most maxDigits); returns the count read
+static uint8_t parseDigits(const char*& p, uint8_t maxDigits, uint16_t& value) {
+    uint8_t digits = 0;
+    value = 0;
+    while (digits < maxDigits && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p++ - '0');
+        digits++;
+    }
+    return digits;
+}
+
+bool lorawanParseDatr(const char* datr, uint8_t& sf, uint16_t& bwKhz) {
+    if (datr == nullptr || datr[0] != 'S' || datr[1] != 'F') return false;
+
+    const char* p = datr + 2;
+    uint16_t spreading;
+    if (parseDigits(p, 2, spreading) == 0 || p[0] != 'B' || p[1] != 'W') return false;
+
+    p += 2;
+    uint16_t bandwidth;
+    if (parseDigits(p, 3, bandwidth) == 0 || *p != '\0') return false;
+
+    if (spreading < 6 || spreading > 12 || bandwidth == 0) return false;
+
+    sf = spreading;
+    bwKhz = bandwidth;
+    return true;
+}
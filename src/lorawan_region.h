@@ -0,0 +1,117 @@
+#ifndef LORAWAN_REGION_H
+#define LORAWAN_REGION_H
+
+#include <stdint.h>
+
+// =============================================================================
+// LoRaWAN Regional Parameters
+// =============================================================================
+// Compile-time tables (RP002-1.0.3) for every supported region: frequency
+// band, uplink channel plan, data rate <-> SF/BW mapping with the maximum
+// MACPayload per data rate, RX2 defaults, duty-cycle sub-bands, maximum
+// EIRP, dwell-time limits and listen-before-talk. The tables live in lorawan_region.cpp and are
+// checked there with static_assert.
+//
+// Building with -DLORAWAN_SINGLE_REGION=LORAWAN_REGION_ID_<name> keeps only
+// that region; the other tables are not referenced and the linker drops
+// them. A configured region that is not compiled in falls back to it.
+
+#define LORAWAN_REGION_ID_EU868     1
+#define LORAWAN_REGION_ID_US915     2
+#define LORAWAN_REGION_ID_AU915     3
+#define LORAWAN_REGION_ID_AS923     4
+#define LORAWAN_REGION_ID_KR920     5
+#define LORAWAN_REGION_ID_IN865     6
+#define LORAWAN_REGION_ID_RU864     7
+
+#define LORAWAN_REGION_ID_DEFAULT   LORAWAN_REGION_ID_US915     // REGION_DEFAULT
+
+#ifdef LORAWAN_SINGLE_REGION
+#define LORAWAN_REGION_ENABLED(id)  (LORAWAN_SINGLE_REGION == (id))
+#else
+#define LORAWAN_REGION_ENABLED(id)  1
+#endif
+
+#define LORAWAN_DATA_RATES          16
+#define LORAWAN_MAX_DEFAULT_CHANNELS 8
+#define LORAWAN_PHY_OVERHEAD        5       // MHDR + MIC around the MACPayload
+
+// Sub-band with a duty-cycle limit
+struct DutyBand {
+    const char* name;
+    uint32_t minFrequency;      // Hz, inclusive
+    uint32_t maxFrequency;      // Hz, inclusive
+    uint16_t dutyBp;            // Limit in basis points (100 = 1%)
+};
+
+// LoRa data rate; sf == 0 marks RFU, FSK and LR-FHSS rates
+struct RegionDataRate {
+    uint8_t sf;
+    uint16_t bwKhz;
+    uint8_t maxPayload;         // M: maximum MACPayload (bytes)
+    uint8_t maxPayloadDwell;    // M with the 400 ms dwell limit (0 = not allowed)
+};
+
+struct LoRaRegion {
+    uint8_t id;
+    const char* name;
+    uint32_t minFrequency;      // Hz, band edges
+    uint32_t maxFrequency;
+
+    // Fixed 125 kHz uplink grid (US915/AU915): first + n * step, n < count.
+    // Zero where the network server assigns the channels.
+    uint32_t uplinkFirst;
+    uint32_t uplinkStep;
+    uint8_t uplinkCount;
+
+    // Default channels of a fresh device (sub-band 2 on US915/AU915)
+    const uint32_t* defaultChannels;
+    uint8_t defaultChannelCount;
+
+    const RegionDataRate* dataRates;        // LORAWAN_DATA_RATES entries
+    uint8_t uplinkDrMax;                    // Uplink DR0..uplinkDrMax
+    uint8_t downlinkDrMin;
+    uint8_t downlinkDrMax;
+
+    uint32_t rx2Frequency;
+    uint8_t rx2DataRate;
+
+    int8_t maxEirpDbm;
+    uint16_t uplinkDwellMs;                 // 0 = no dwell-time limit
+    uint16_t downlinkDwellMs;
+
+    // Listen-before-talk: carrier sense time and busy threshold (0 = no LBT)
+    uint16_t lbtSenseUs;
+    int8_t lbtThresholdDbm;
+
+    const DutyBand* dutyBands;
+    uint8_t dutyBandCount;
+};
+
+// Region by name ("EU868", ...); nullptr when unknown or not compiled in
+const LoRaRegion* lorawanRegionFind(const char* name);
+
+// Region used when the configured one is unavailable: the default region,
+// or the only one compiled in
+const LoRaRegion* lorawanRegionDefault();
+
+// Compiled-in regions, for listing
+uint8_t lorawanRegionCount();
+const LoRaRegion* lorawanRegionAt(uint8_t index);
+
+// Frequency inside the regional band
+bool lorawanRegionContains(const LoRaRegion* region, uint32_t frequency);
+
+// Data rate index of a LoRa SF/BW pair in the uplink or downlink range, -1 if none
+int8_t lorawanFindDataRate(const LoRaRegion* region, uint8_t sf, uint16_t bwKhz, bool downlink);
+
+// Largest PHYPayload allowed at a data rate (0 = data rate not allowed)
+uint16_t lorawanMaxPhyPayload(const LoRaRegion* region, uint8_t dataRate, bool dwellLimited);
+
+// true when the SF is an uplink data rate of the region at this bandwidth
+bool lorawanUplinkSf(const LoRaRegion* region, uint8_t sf, uint16_t bwKhz);
+
+// Parse a Semtech datr string ("SF7BW125"); false when malformed
+bool lorawanParseDatr(const char* datr, uint8_t& sf, uint16_t& bwKhz);
+
+#endif // LORAWAN_REGION_H
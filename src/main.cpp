@@ -38,12 +38,22 @@
 #include "atmega_bridge.h"
 #include "network_manager.h"
 #include "i2c_bus.h"
-
-// WiFi network structure
-struct WiFiNetwork {
-    String ssid;
-    String password;
-};
+#include "wifi_connector.h"
+#include "boot_profiler.h"
+#include "config_store.h"
+#include "config_snapshot.h"
+#include "auto_tuner.h"
+#include "packet_filter.h"
+#include "lorawan_frame.h"
+#include "device_table.h"
+#include "uplink_scheduler.h"
+#include "packet_capture.h"
+#include "packet_stream.h"
+
+// Peripheral boot task (runs on the core not used by loop())
+#define BOOT_TASK_STACK_SIZE    8192
+#define BOOT_TASK_PRIORITY      1
+#define BOOT_TASK_CORE          0
 
 // WiFi configuration (global for web server access)
 String wifiHostname = WIFI_HOSTNAME_DEFAULT;
@@ -67,6 +77,17 @@ const unsigned long STATS_UPDATE_INTERVAL = 5000;
 unsigned long lastLedBlink = 0;
 bool ledState = false;
 
+// Deferred start of network-dependent services (WiFi connects in background)
+unsigned long lastForwarderAttempt = 0;
+const unsigned long FORWARDER_RETRY_INTERVAL = 10000;
+bool mdnsStarted = false;
+#if RTC_ENABLED
+bool rtcSyncPending = false;
+#endif
+
+// Set by the boot task once displays, sensors and NetworkManager are up
+volatile bool peripheralsReady = false;
+
 // ATmega Bridge and Network Manager instances
 #if ATMEGA_ENABLED
 // Use Serial2 (UART2) for ATmega bridge on GPIO16/GPIO17
@@ -75,14 +96,19 @@ ATmegaBridge atmegaBridge(Serial2, ATMEGA_RX_PIN, ATMEGA_TX_PIN);
 #endif
 
 // Function declarations
+void bootTask(void* param);
+void initPeripherals();
 void setupWiFi();
+void onWiFiConnected(const char* ssid);
+void onWiFiFallback();
+void startMDNS();
 bool loadConfig();
 void setDefaultConfig();
 void log(const String& msg);
 
 void setup() {
+    int stage = bootProfiler.beginStage("serial");
     Serial.begin(SERIAL_BAUD_RATE);
-    delay(100);
 
     // CRITICAL: Disable WiFi at boot to prevent auto-connect issues
     // This must be done BEFORE any other WiFi operations
@@ -91,7 +117,6 @@ void setup() {
     WiFi.setAutoReconnect(false);     // Don't auto-reconnect if disconnected
     WiFi.mode(WIFI_OFF);              // Turn off WiFi completely
     WiFi.disconnect(true, true);      // Disconnect and erase stored credentials
-    delay(100);                       // Allow WiFi to stabilize
 
     Serial.println();
     Serial.println("========================================");
@@ -103,11 +128,12 @@ void setup() {
     #if VEXT_PIN >= 0
     pinMode(VEXT_PIN, OUTPUT);
     digitalWrite(VEXT_PIN, LOW);  // Enable Vext (active LOW)
-    delay(100);
     Serial.println("[Main] Vext enabled");
     #endif
+    bootProfiler.endStage(stage);
 
     // Initialize LittleFS
+    stage = bootProfiler.beginStage("littlefs");
     Serial.println("[Main] Initializing LittleFS...");
     if (!LittleFS.begin(true)) {  // true = format if mount fails
         Serial.println("[Main] LittleFS initialization failed!");
@@ -117,32 +143,107 @@ void setup() {
         }
     }
     Serial.println("[Main] LittleFS initialized");
+    bootProfiler.endStage(stage);
+
+    // Create NetworkManager before loading configuration so a single
+    // parse of /config.json also fills its settings. The bridge itself
+    // is started later by the boot task.
+    #if ATMEGA_ENABLED
+    networkManager = new NetworkManager(atmegaBridge);
+    #else
+    // ATmega disabled - create dummy bridge for NetworkManager (using Serial2)
+    static ATmegaBridge dummyBridge(Serial2, ATMEGA_RX_PIN, ATMEGA_TX_PIN);
+    networkManager = new NetworkManager(dummyBridge);
+    #endif
 
     // Load configuration
+    stage = bootProfiler.beginStage("config");
     if (!loadConfig()) {
         Serial.println("[Main] Using default configuration");
         setDefaultConfig();
     }
+    #if !ATMEGA_ENABLED
+    networkManager->getConfig().ethernetEnabled = false;
+    #endif
+    bootProfiler.endStage(stage);
+
+    // Initialize LoRa gateway first so reception starts as early as possible
+    stage = bootProfiler.beginStage("lora");
+    // Regional RX2 window and channel plan go into the profiles built by begin()
+    loraGateway.setRegion(udpForwarder.getRegion());
+    if (loraGateway.begin()) {
+        Serial.println("[Main] LoRa radio initialized");
+
+        // Start receiving
+        if (loraGateway.startReceive()) {
+            bootProfiler.markLoraReceiving();
+            Serial.println("[Main] LoRa receiving started");
+        }
 
+        // From here on only the radio task touches the SX1276
+        loraGateway.startTask();
+    } else {
+        Serial.println("[Main] LoRa initialization failed!");
+    }
+    bootProfiler.endStage(stage);
+
+    // Setup WiFi (non-blocking in station mode, see wifiConnector)
+    stage = bootProfiler.beginStage("wifi_start");
+    setupWiFi();
+    bootProfiler.endStage(stage);
+
+    // Initialize web server
+    stage = bootProfiler.beginStage("web_server");
+    webServer.begin();
+    bootProfiler.endStage(stage);
+
+    // Bring up displays, sensors, ATmega bridge and NetworkManager on the
+    // other core while loop() already services the radio
+    if (xTaskCreatePinnedToCore(bootTask, "boot", BOOT_TASK_STACK_SIZE, NULL,
+                                BOOT_TASK_PRIORITY, NULL, BOOT_TASK_CORE) != pdPASS) {
+        Serial.println("[Main] Boot task creation failed, initializing inline");
+        initPeripherals();
+    }
+}
+
+void bootTask(void* param) {
+    initPeripherals();
+    vTaskDelete(NULL);
+}
+
+void initPeripherals() {
     // Initialize I2C bus (shared by LCD, RTC, and other I2C devices)
+    int stage = bootProfiler.beginStage("i2c");
     if (!i2cBus.begin(I2C_SDA_PIN, I2C_SCL_PIN)) {
         Serial.println("[Main] Warning: I2C bus initialization failed!");
     }
+    bootProfiler.endStage(stage);
 
-    // Initialize OLED display
+    // Initialize OLED display (logo stays up until boot completes)
     #if OLED_ENABLED
+    stage = bootProfiler.beginStage("oled");
     if (oledManager.begin()) {
         Serial.println("[Main] OLED display ready");
         oledManager.showLogo();
-        delay(2000);
     }
+    bootProfiler.endStage(stage);
     #endif
 
     // Initialize LCD display
     if (lcdManager.getConfig().enabled) {
+        stage = bootProfiler.beginStage("lcd");
         if (lcdManager.begin()) {
             Serial.println("[Main] LCD display ready");
-            delay(2000);
+        }
+        bootProfiler.endStage(stage);
+    }
+
+    if (!loraGateway.isAvailable()) {
+        #if OLED_ENABLED
+        oledManager.showError("LoRa Init Failed!");
+        #endif
+        if (lcdManager.isAvailable()) {
+            lcdManager.showError("LoRa Init Failed!");
         }
     }
 
@@ -162,20 +263,25 @@ void setup() {
 
     // Initialize GPS
     #if GPS_ENABLED
+    stage = bootProfiler.beginStage("gps");
     if (gpsManager.begin()) {
         Serial.println("[Main] GPS module initialized");
     }
+    bootProfiler.endStage(stage);
     #endif
 
     // Initialize RTC (DS1307)
     #if RTC_ENABLED
+    stage = bootProfiler.beginStage("rtc");
     if (rtcManager.begin()) {
         Serial.println("[Main] RTC DS1307 initialized");
     }
+    bootProfiler.endStage(stage);
     #endif
 
     // Initialize ATmega Bridge (for Ethernet W5500 and RTC via ATmega)
     #if ATMEGA_ENABLED
+    stage = bootProfiler.beginStage("atmega");
     Serial.println("[Main] Initializing ATmega Bridge...");
     if (atmegaBridge.begin(ATMEGA_BAUD_RATE)) {
         Serial.println("[Main] ATmega Bridge ready");
@@ -185,88 +291,24 @@ void setup() {
         if (atmegaBridge.getVersion(major, minor, patch)) {
             Serial.printf("[Main] ATmega firmware: v%d.%d.%d\n", major, minor, patch);
         }
-
-        // Create NetworkManager with bridge reference
-        networkManager = new NetworkManager(atmegaBridge);
     } else {
         Serial.println("[Main] ATmega Bridge not responding - Ethernet disabled");
-        // Create NetworkManager anyway but without functional Ethernet
-        networkManager = new NetworkManager(atmegaBridge);
         networkManager->getConfig().ethernetEnabled = false;
     }
-    #else
-    // ATmega disabled - create dummy bridge for NetworkManager (using Serial2)
-    static ATmegaBridge dummyBridge(Serial2, ATMEGA_RX_PIN, ATMEGA_TX_PIN);
-    networkManager = new NetworkManager(dummyBridge);
-    networkManager->getConfig().ethernetEnabled = false;
+    bootProfiler.endStage(stage);
     #endif
 
-    // Setup WiFi
-    setupWiFi();
-
-    // Initialize NetworkManager (after WiFi is setup)
-    if (networkManager) {
-        Serial.println("[Main] Initializing Network Manager...");
-
-        // Reload configuration for NetworkManager to ensure it has the latest settings
-        // This is necessary because NetworkManager was created after the initial loadConfig() call
-        File file = LittleFS.open("/config.json", "r");
-        if (file) {
-            DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-            DeserializationError error = deserializeJson(doc, file);
-            file.close();
-            if (!error) {
-                networkManager->loadConfig(doc);
-                Serial.println("[Main] Network Manager config reloaded");
-            } else {
-                Serial.println("[Main] Failed to reload config for Network Manager");
-            }
-        }
-
-        if (networkManager->begin()) {
-            Serial.printf("[Main] Network Manager ready, active: %s\n",
-                         networkManager->getActiveInterface() ?
-                         networkManager->getActiveInterface()->getName() : "none");
-        } else {
-            Serial.println("[Main] Network Manager - no interfaces available");
-        }
-    }
-
-    // Initialize LoRa gateway
-    if (loraGateway.begin()) {
-        Serial.println("[Main] LoRa radio initialized");
-
-        // Start receiving
-        if (loraGateway.startReceive()) {
-            Serial.println("[Main] LoRa receiving started");
-        }
-    } else {
-        Serial.println("[Main] LoRa initialization failed!");
-        #if OLED_ENABLED
-        oledManager.showError("LoRa Init Failed!");
-        #endif
-        if (lcdManager.isAvailable()) {
-            lcdManager.showError("LoRa Init Failed!");
-        }
-    }
-
-    // Initialize UDP forwarder (only if connected to internet)
-    // Check both legacy WiFi connection and NetworkManager
-    bool hasNetwork = wifiConnectedToInternet ||
-                     (networkManager && networkManager->isConnected());
-
-    if (hasNetwork) {
-        if (udpForwarder.begin()) {
-            Serial.println("[Main] UDP forwarder initialized");
-        } else {
-            Serial.println("[Main] UDP forwarder initialization failed!");
-        }
+    // Initialize NetworkManager
+    stage = bootProfiler.beginStage("network");
+    Serial.println("[Main] Initializing Network Manager...");
+    if (networkManager->begin()) {
+        Serial.printf("[Main] Network Manager ready, active: %s\n",
+                     networkManager->getActiveInterface() ?
+                     networkManager->getActiveInterface()->getName() : "none");
     } else {
-        Serial.println("[Main] UDP forwarder skipped (no internet)");
+        Serial.println("[Main] Network Manager - no interfaces available");
     }
-
-    // Initialize web server
-    webServer.begin();
+    bootProfiler.endStage(stage);
 
     // Show initial status on display
     #if OLED_ENABLED
@@ -287,39 +329,64 @@ void setup() {
         );
     }
 
+    bootProfiler.markComplete();
+
+    // The interfaces behind /api/network/config exist now, and the boot may
+    // have changed its settings (Ethernet off without the ATmega bridge)
+    configStore.touch(ConfigSection::NETWORK);
+    peripheralsReady = true;
+
     Serial.println();
     Serial.println("========================================");
-    Serial.printf("  Gateway EUI: %s\n", udpForwarder.getGatewayEuiString().c_str());
     Serial.printf("  Web interface: http://%s/\n",
-                  wifiAPMode ? WiFi.softAPIP().toString().c_str()
+                  wifiAPMode || wifiConnector.isFallbackActive()
+                             ? WiFi.softAPIP().toString().c_str()
                              : WiFi.localIP().toString().c_str());
     Serial.printf("  mDNS hostname: http://%s.local/\n", wifiHostname.c_str());
 
     // Network Manager status
-    if (networkManager) {
-        Serial.println("  Network:");
-        Serial.printf("    Active: %s\n",
-                     networkManager->getActiveInterface() ?
-                     networkManager->getActiveInterface()->getName() : "none");
-        Serial.printf("    WiFi: %s\n",
-                     networkManager->getWiFi()->isConnected() ? "Connected" : "Disconnected");
-        #if ATMEGA_ENABLED
-        Serial.printf("    Ethernet: %s\n",
-                     networkManager->getEthernet()->isConnected() ? "Connected" :
-                     (networkManager->getEthernet()->isLinkUp() ? "Link Up" : "No Cable"));
-        #endif
-        Serial.printf("    Failover: %s\n",
-                     networkManager->getConfig().failoverEnabled ? "Enabled" : "Disabled");
-    }
-
+    Serial.println("  Network:");
+    Serial.printf("    Active: %s\n",
+                 networkManager->getActiveInterface() ?
+                 networkManager->getActiveInterface()->getName() : "none");
+    Serial.printf("    WiFi: %s\n",
+                 networkManager->getWiFi()->isConnected() ? "Connected" : "Disconnected");
+    #if ATMEGA_ENABLED
+    Serial.printf("    Ethernet: %s\n",
+                 networkManager->getEthernet()->isConnected() ? "Connected" :
+                 (networkManager->getEthernet()->isLinkUp() ? "Link Up" : "No Cable"));
+    #endif
+    Serial.printf("    Failover: %s\n",
+                 networkManager->getConfig().failoverEnabled ? "Enabled" : "Disabled");
     Serial.println("========================================");
+    bootProfiler.printSummary();
     Serial.println();
 }
 
 void loop() {
-    // Update LoRa gateway (process interrupts)
+    // Update LoRa gateway (forward stats; radio work runs on the radio task)
     loraGateway.update();
 
+    // Channel/SF auto-tuning from observed traffic
+    autoTuner.update();
+
+    // Forwarding rules changed from the web interface
+    packetFilter.update();
+
+    // Drive background WiFi connection (station mode only)
+    if (!wifiAPMode) {
+        wifiConnector.update();
+        wifiConnectedToInternet = wifiConnector.isConnected();
+    }
+
+    // Until the boot task is done only the radio, WiFi and web server run;
+    // received packets stay queued in the gateway until forwarding is possible
+    if (!peripheralsReady) {
+        webServer.loop();
+        delay(10);
+        return;
+    }
+
     // Update buzzer (for non-blocking beeps)
     #if BUZZER_ENABLED
     buzzer.update();
@@ -358,6 +425,18 @@ void loop() {
     while (loraGateway.hasPacket()) {
         LoRaPacket packet = loraGateway.getPacket();
 
+        if (packet.valid && !packet.crcOk) {
+            // CRC-failed frame (forward_crc_errors): nothing in it can be
+            // trusted, so it skips decoding and filtering and goes to the
+            // server as stat -1 at the lowest priority
+            LoRaWANHeader header;
+            memset(&header, 0, sizeof(header));
+            packetCapture.recordUplink(packet, header);
+            packetStream.record(packet, header, true);
+            uplinkScheduler.enqueue(packet, header);
+            continue;
+        }
+
         if (packet.valid) {
             Serial.printf("[Main] Packet received: %d bytes, RSSI: %.1f, SNR: %.1f\n",
                           packet.length, packet.rssi, packet.snr);
@@ -388,33 +467,59 @@ void loop() {
                 );
             }
 
-            // Forward to network server
-            bool networkAvailable = wifiConnectedToInternet ||
-                                   (networkManager && networkManager->isConnected());
-            if (networkAvailable && udpForwarder.isConnected()) {
-                if (udpForwarder.forwardPacket(packet)) {
-                    GatewayStats& stats = loraGateway.getStats();
-                    stats.rxPacketsForwarded++;
-                    Serial.println("[Main] Packet forwarded to server");
-                } else {
-                    Serial.println("[Main] Failed to forward packet");
-                }
+            autoTuner.recordPacket(packet);
+
+            // LoRaWAN header read in place; other networks' traffic is
+            // counted but not forwarded
+            LoRaWANHeader header;
+            lorawanDecodeHeader(packet.data, packet.length, header);
+            packetCapture.recordUplink(packet, header);
+            deviceTable.record(header, packet);
+            bool accepted = packetFilter.accept(header);
+            if (!accepted) {
+                Serial.printf("[Main] Packet dropped by filter (DevAddr %08X)\n", header.devAddr);
             }
 
-            // Broadcast to WebSocket clients
-            webServer.broadcastLog("Packet received: " + String(packet.length) +
-                                   " bytes, RSSI: " + String(packet.rssi, 1) + " dBm");
+            // Queue for the network server (sent below, by priority)
+            if (accepted) {
+                uplinkScheduler.enqueue(packet, header);
+            }
+
+            // Live view in the web interface (batched, sent by the web server loop)
+            packetStream.record(packet, header, accepted);
         }
     }
 
-    // Update UDP forwarder (send keep-alive, receive downlinks)
+    // Forward queued uplinks: joins and confirmed frames first, stale ones dropped
     bool hasNetworkConnection = wifiConnectedToInternet ||
                                (networkManager && networkManager->isConnected());
+    uplinkScheduler.service(hasNetworkConnection && udpForwarder.isConnected());
+
+    // Update UDP forwarder (send keep-alive, receive downlinks)
     if (hasNetworkConnection) {
+        // Start forwarder once the network comes up (or retry a failed start)
+        if (!udpForwarder.isConnected() &&
+            (lastForwarderAttempt == 0 || millis() - lastForwarderAttempt >= FORWARDER_RETRY_INTERVAL)) {
+            lastForwarderAttempt = millis();
+            if (udpForwarder.begin()) {
+                Serial.println("[Main] UDP forwarder initialized");
+            }
+        }
+
         udpForwarder.update();
         ntpManager.update();
     }
 
+    // Sync RTC once NTP has completed in the background
+    #if RTC_ENABLED
+    if (rtcSyncPending && ntpManager.isSynced() && rtcManager.isAvailable()) {
+        rtcSyncPending = false;
+        if (rtcManager.setTimeFromNTP()) {
+            Serial.println("[WiFi] RTC synchronized with NTP");
+        }
+    }
+    #endif
+
     // Update RTC
     #if RTC_ENABLED
     rtcManager.update();
@@ -423,6 +528,9 @@ void loop() {
     // Update web server
     webServer.loop();
 
+    // Write debounced config changes
+    configStore.update();
+
     // Update OLED display periodically
     #if OLED_ENABLED
     unsigned long now = millis();
@@ -459,7 +567,7 @@ void loop() {
                     loraGateway.isReceiving()
                 );
             } else {
-                GatewayStats& stats = loraGateway.getStats();
+                GatewayStats stats = loraGateway.getStatsSnapshot();
                 oledManager.showStats(
                     stats.rxPacketsReceived,
                     stats.txPacketsSent,
@@ -477,7 +585,7 @@ void loop() {
                     loraGateway.isReceiving()
                 );
             } else {
-                GatewayStats& stats = loraGateway.getStats();
+                GatewayStats stats = loraGateway.getStatsSnapshot();
                 lcdManager.showStats(
                     stats.rxPacketsReceived,
                     stats.txPacketsSent,
@@ -499,11 +607,6 @@ void setupWiFi() {
     WiFi.setAutoConnect(false);
     WiFi.setAutoReconnect(false);
 
-    // Ensure clean start - disconnect and erase any stored credentials
-    WiFi.disconnect(true, true);  // disconnect=true, eraseap=true
-    WiFi.mode(WIFI_OFF);
-    delay(300);  // Delay for hardware stability
-
     if (wifiAPMode) {
         // Access Point mode
         Serial.println("[WiFi] Starting in AP mode");
@@ -514,183 +617,132 @@ void setupWiFi() {
         wifiConnectedToInternet = false;
 
         // Initialize mDNS for .local domain resolution (AP mode)
-        if (MDNS.begin(wifiHostname.c_str())) {
-            MDNS.addService("http", "tcp", 80);
-            Serial.printf("[WiFi] mDNS started: %s.local\n", wifiHostname.c_str());
-        }
-
-        #if OLED_ENABLED
-        if (oledManager.isAvailable()) {
-            oledManager.showWiFiInfo(wifiSSID.c_str(), 0, WiFi.softAPIP().toString().c_str());
-        }
-        #endif
-
-        if (lcdManager.isAvailable()) {
-            lcdManager.showWiFiInfo(wifiSSID.c_str(), 0, WiFi.softAPIP().toString().c_str());
-        }
+        startMDNS();
     } else {
-        // Station mode - try multiple networks in sequence
+        // Station mode - connect in background (cached BSSID, then ranked scan)
         Serial.printf("[WiFi] %d network(s) configured\n", wifiNetworks.size());
 
-        bool connected = false;
-
-        // Try each configured network in sequence
-        for (size_t i = 0; i < wifiNetworks.size() && !connected; i++) {
-            WiFiNetwork& network = wifiNetworks[i];
-
-            Serial.printf("[WiFi] Trying network %d/%d: %s",
-                          i + 1, wifiNetworks.size(), network.ssid.c_str());
-
-            #if OLED_ENABLED
-            if (oledManager.isAvailable()) {
-                char msg[64];
-                snprintf(msg, sizeof(msg), "WiFi %d/%d: %s",
-                         i + 1, wifiNetworks.size(), network.ssid.c_str());
-                oledManager.showError(msg);
-            }
-            #endif
+        wifiConnector.setConnectedCallback(onWiFiConnected);
+        wifiConnector.setFallbackCallback(onWiFiFallback);
+        wifiConnector.begin(&wifiNetworks, wifiHostname.c_str());
+    }
+}
 
-            if (lcdManager.isAvailable()) {
-                char msg[17];
-                snprintf(msg, sizeof(msg), "WiFi %d/%d", i + 1, wifiNetworks.size());
-                lcdManager.showError(msg);
-            }
+void onWiFiConnected(const char* ssid) {
+    Serial.printf("[WiFi] Connected to %s\n", ssid);
+    Serial.printf("[WiFi] IP: %s\n", WiFi.localIP().toString().c_str());
+    Serial.printf("[WiFi] RSSI: %d dBm\n", WiFi.RSSI());
+
+    // Update current SSID/password for web interface
+    for (const WiFiNetwork& network : wifiNetworks) {
+        if (network.ssid == ssid) {
+            wifiSSID = network.ssid;
+            wifiPassword = network.password;
+            break;
+        }
+    }
+    wifiConnectedToInternet = true;
 
-            // Clean WiFi state before each attempt - critical for avoiding AUTH_FAIL
-            WiFi.disconnect(true, true);  // Disconnect and erase credentials from NVS
-            WiFi.mode(WIFI_OFF);
-            delay(200);
+    // Back from the fallback AP: station only again
+    if (wifiConnector.isFallbackActive()) {
+        WiFi.softAPdisconnect(true);
+        Serial.println("[WiFi] Fallback AP stopped");
+    }
 
-            // Configure and start connection
-            WiFi.mode(WIFI_STA);
-            WiFi.setHostname(wifiHostname.c_str());
-            WiFi.setSleep(false);
-            delay(100);
+    // Initialize NTP time synchronization (completes in background)
+    ntpManager.begin();
 
-            // Start connection
-            WiFi.begin(network.ssid.c_str(), network.password.c_str());
+    // Sync RTC with NTP time once NTP reports synced (see loop); the RTC
+    // may not be initialized yet, availability is checked at sync time
+    #if RTC_ENABLED
+    if (rtcManager.getConfig().syncWithNTP) {
+        rtcSyncPending = true;
+    }
+    #endif
 
-            int attempts = 0;
-            const int maxAttempts = 30;  // 15 seconds per network
+    // Initialize mDNS for .local domain resolution
+    startMDNS();
 
-            while (WiFi.status() != WL_CONNECTED && attempts < maxAttempts) {
-                delay(500);
-                Serial.print(".");
-                attempts++;
+    // Displays are still owned by the boot task until peripheralsReady
+    if (!peripheralsReady) return;
 
-                // Check for definitive failure states
-                wl_status_t status = WiFi.status();
-                if (status == WL_NO_SSID_AVAIL || status == WL_CONNECT_FAILED) {
-                    break;
-                }
-            }
+    #if OLED_ENABLED
+    if (oledManager.isAvailable()) {
+        oledManager.showWiFiInfo(ssid, WiFi.RSSI(), WiFi.localIP().toString().c_str());
+    }
+    #endif
 
-            if (WiFi.status() == WL_CONNECTED) {
-                Serial.println();
-                Serial.printf("[WiFi] Connected to %s\n", network.ssid.c_str());
-                Serial.printf("[WiFi] IP: %s\n", WiFi.localIP().toString().c_str());
-                Serial.printf("[WiFi] RSSI: %d dBm\n", WiFi.RSSI());
-
-                // Update current SSID/password for web interface
-                wifiSSID = network.ssid;
-                wifiPassword = network.password;
-                wifiConnectedToInternet = true;
-                connected = true;
-
-                // Initialize NTP time synchronization
-                ntpManager.begin();
-
-                // Sync RTC with NTP time after connection
-                #if RTC_ENABLED
-                if (rtcManager.isAvailable() && rtcManager.getConfig().syncWithNTP) {
-                    delay(2000);  // Wait for NTP to sync
-                    if (rtcManager.setTimeFromNTP()) {
-                        Serial.println("[WiFi] RTC synchronized with NTP");
-                    }
-                }
-                #endif
-
-                // Initialize mDNS for .local domain resolution
-                if (MDNS.begin(wifiHostname.c_str())) {
-                    MDNS.addService("http", "tcp", 80);
-                    Serial.printf("[WiFi] mDNS started: %s.local\n", wifiHostname.c_str());
-                } else {
-                    Serial.println("[WiFi] mDNS failed to start");
-                }
+    if (lcdManager.isAvailable()) {
+        lcdManager.showWiFiInfo(ssid, WiFi.RSSI(), WiFi.localIP().toString().c_str());
+    }
+}
 
-                #if OLED_ENABLED
-                if (oledManager.isAvailable()) {
-                    oledManager.showWiFiInfo(network.ssid.c_str(), WiFi.RSSI(),
-                                              WiFi.localIP().toString().c_str());
-                }
-                #endif
+void onWiFiFallback() {
+    Serial.println("[WiFi] All networks failed, starting fallback AP");
 
-                if (lcdManager.isAvailable()) {
-                    lcdManager.showWiFiInfo(network.ssid.c_str(), WiFi.RSSI(),
-                                             WiFi.localIP().toString().c_str());
-                }
-            } else {
-                Serial.printf(" Failed (status: %d)\n", WiFi.status());
-            }
-        }
+    // AP+STA: the connector keeps rescanning for the configured networks
+    WiFi.disconnect();
+    WiFi.mode(WIFI_AP_STA);
+    WiFi.softAP(WIFI_SSID_DEFAULT, WIFI_PASS_DEFAULT);
+    Serial.printf("[WiFi] Fallback AP SSID: %s\n", WIFI_SSID_DEFAULT);
+    Serial.printf("[WiFi] Fallback AP IP: %s\n", WiFi.softAPIP().toString().c_str());
+    wifiConnectedToInternet = false;
+    wifiSSID = WIFI_SSID_DEFAULT;
+    wifiPassword = WIFI_PASS_DEFAULT;
 
-        // If no network connected, switch to AP mode
-        if (!connected) {
-            Serial.println("[WiFi] All networks failed, switching to AP mode");
+    // Initialize mDNS for .local domain resolution (fallback AP)
+    startMDNS();
 
-            WiFi.disconnect(true);
-            delay(100);
+    if (!peripheralsReady) return;
 
-            WiFi.mode(WIFI_AP);
-            WiFi.softAP(WIFI_SSID_DEFAULT, WIFI_PASS_DEFAULT);
-            Serial.printf("[WiFi] Fallback AP SSID: %s\n", WIFI_SSID_DEFAULT);
-            Serial.printf("[WiFi] Fallback AP IP: %s\n", WiFi.softAPIP().toString().c_str());
-            wifiConnectedToInternet = false;
-            wifiAPMode = true;
-            wifiSSID = WIFI_SSID_DEFAULT;
-            wifiPassword = WIFI_PASS_DEFAULT;
+    #if OLED_ENABLED
+    if (oledManager.isAvailable()) {
+        oledManager.showWiFiInfo(WIFI_SSID_DEFAULT, 0,
+                                  WiFi.softAPIP().toString().c_str());
+    }
+    #endif
 
-            // Initialize mDNS for .local domain resolution (fallback AP)
-            if (MDNS.begin(wifiHostname.c_str())) {
-                MDNS.addService("http", "tcp", 80);
-                Serial.printf("[WiFi] mDNS started: %s.local\n", wifiHostname.c_str());
-            }
+    if (lcdManager.isAvailable()) {
+        lcdManager.showWiFiInfo(WIFI_SSID_DEFAULT, 0,
+                                 WiFi.softAPIP().toString().c_str());
+    }
+}
 
-            #if OLED_ENABLED
-            if (oledManager.isAvailable()) {
-                oledManager.showError("WiFi Failed - AP Mode");
-                delay(2000);
-                oledManager.showWiFiInfo(WIFI_SSID_DEFAULT, 0,
-                                          WiFi.softAPIP().toString().c_str());
-            }
-            #endif
+void startMDNS() {
+    // Connected callback runs again after every reconnect
+    if (mdnsStarted) return;
 
-            if (lcdManager.isAvailable()) {
-                lcdManager.showError("WiFi Failed");
-                delay(2000);
-                lcdManager.showWiFiInfo(WIFI_SSID_DEFAULT, 0,
-                                         WiFi.softAPIP().toString().c_str());
-            }
-        }
+    if (MDNS.begin(wifiHostname.c_str())) {
+        MDNS.addService("http", "tcp", 80);
+        mdnsStarted = true;
+        Serial.printf("[WiFi] mDNS started: %s.local\n", wifiHostname.c_str());
+    } else {
+        Serial.println("[WiFi] mDNS failed to start");
     }
 }
 
 bool loadConfig() {
-    File file = LittleFS.open("/config.json", "r");
-    if (!file) {
-        Serial.println("[Config] Config file not found");
-        return false;
+    unsigned long start = micros();
+
+    // Fast path: binary snapshot built from the current /config.json. The
+    // JSON itself is then only parsed when a section is first edited.
+    configStore.begin(true);
+    uint32_t crc = 0;
+    size_t length = 0;
+    if (configStore.getFileCrc(crc, length) && configSnapshot.load(crc, length)) {
+        configSnapshot.setLoadTime(true, micros() - start);
+        return true;
     }
 
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
-
-    if (error) {
-        Serial.printf("[Config] Parse error: %s\n", error.c_str());
+    // Single parse of /config.json, shared by all modules via configStore
+    if (!configStore.begin()) {
+        Serial.println("[Config] Config file not found or invalid");
         return false;
     }
 
+    configStore.lock();
+    const JsonDocument& doc = configStore.document();
+
     // Load WiFi configuration
     if (doc.containsKey("wifi")) {
         wifiAPMode = doc["wifi"]["ap_mode"] | WIFI_AP_MODE_DEFAULT;
@@ -701,8 +753,8 @@ bool loadConfig() {
 
         // Load networks array
         if (doc["wifi"].containsKey("networks") && doc["wifi"]["networks"].is<JsonArray>()) {
-            JsonArray networks = doc["wifi"]["networks"].as<JsonArray>();
-            for (JsonObject network : networks) {
+            JsonArrayConst networks = doc["wifi"]["networks"].as<JsonArrayConst>();
+            for (JsonObjectConst network : networks) {
                 if (wifiNetworks.size() >= WIFI_MAX_NETWORKS) break;
 
                 WiFiNetwork wn;
@@ -730,9 +782,11 @@ bool loadConfig() {
 
     // Load LoRa configuration
     loraGateway.loadConfig(doc);
+    autoTuner.loadConfig(doc);
 
     // Load server configuration
     udpForwarder.loadConfig(doc);
+    packetFilter.loadConfig(doc);
 
     // Load NTP configuration
     ntpManager.loadConfig(doc);
@@ -754,6 +808,14 @@ bool loadConfig() {
         networkManager->loadConfig(doc);
     }
 
+    configStore.unlock();
+    configSnapshot.setLoadTime(false, micros() - start);
+
+    // Regenerate the snapshot for the next boot
+    if (configStore.getFileCrc(crc, length)) {
+        configSnapshot.save(crc, length);
+    }
+
     Serial.println("[Config] Configuration loaded");
     return true;
 }
@@ -842,11 +904,8 @@ void setDefaultConfig() {
     doc["network"]["ethernet"]["dns"] = ETH_DNS_DEFAULT;
     doc["network"]["ethernet"]["dhcp_timeout"] = ETH_DHCP_TIMEOUT_DEFAULT;
 
-    // Save default config
-    File file = LittleFS.open("/config.json", "w");
-    if (file) {
-        serializeJsonPretty(doc, file);
-        file.close();
+    // Save default config (becomes the in-memory document as well)
+    if (configStore.replaceDocument(doc)) {
         Serial.println("[Config] Default configuration saved");
     }
 }
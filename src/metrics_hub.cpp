@@ -0,0 +1,307 @@
+#include "metrics_hub.h"
+#include <WiFi.h>
+#include <math.h>
+#include <memory>
+#include <vector>
+#include "lora_gateway.h"
+#include "udp_forwarder.h"
+#include "network_manager.h"
+
+// Global instance
+MetricsHub metricsHub;
+
+// External variables from main.cpp
+extern bool wifiConnectedToInternet;
+extern volatile bool peripheralsReady;
+
+struct MetricInfo {
+    const char* key;
+    MetricType type;
+};
+
+// Indexed by Metric
+static const MetricInfo METRIC_INFO[METRIC_COUNT] = {
+    { "uptime",                  MetricType::UINT  },
+    { "heap_free",               MetricType::UINT  },
+    { "wifi_connected",          MetricType::BOOL  },
+    { "wifi_rssi",               MetricType::INT   },
+    { "server_connected",        MetricType::BOOL  },
+    { "lora_available",          MetricType::BOOL  },
+    { "lora_receiving",          MetricType::BOOL  },
+    { "rx_received",             MetricType::UINT  },
+    { "rx_forwarded",            MetricType::UINT  },
+    { "rx_crc_error",            MetricType::UINT  },
+    { "tx_sent",                 MetricType::UINT  },
+    { "last_rssi",               MetricType::FLOAT },
+    { "last_snr",                MetricType::FLOAT },
+    { "rx_occupancy_pct",        MetricType::FLOAT },
+    { "net_available",           MetricType::BOOL  },
+    { "net_healthy",             MetricType::BOOL  },
+    { "net_last_ack_ms",         MetricType::UINT  },
+    { "net_failover_active",     MetricType::BOOL  },
+    { "net_stability_period_ms", MetricType::UINT  },
+    { "net_primary_stable_ms",   MetricType::UINT  },
+};
+
+MetricsHub::MetricsHub()
+    : version(0)
+    , sampled(false)
+    , mux(portMUX_INITIALIZER_UNLOCKED)
+{
+    memset(entries, 0, sizeof(entries));
+    memset(subscribers, 0, sizeof(subscribers));
+    memset(&stats, 0, sizeof(stats));
+}
+
+const char* MetricsHub::metricKey(Metric metric) {
+    return (uint8_t)metric < METRIC_COUNT ? METRIC_INFO[(uint8_t)metric].key : "unknown";
+}
+
+// ================== Subscriptions ==================
+
+void MetricsHub::subscribe(uint32_t clientId, uint32_t intervalMs) {
+    intervalMs = constrain(intervalMs, (uint32_t)METRICS_PUSH_MIN_MS, (uint32_t)METRICS_PUSH_MAX_MS);
+
+    int8_t slot = -1;
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < METRICS_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].id == clientId) {
+            slot = i;
+            break;
+        }
+        if (subscribers[i].id == 0 && slot < 0) slot = i;
+    }
+    if (slot >= 0) {
+        // Resubscribing starts over with a full snapshot, sent right away
+        subscribers[slot].id = clientId;
+        subscribers[slot].intervalMs = intervalMs;
+        subscribers[slot].lastPush = millis() - intervalMs;
+        subscribers[slot].version = 0;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (slot < 0) {
+        Serial.printf("[Metrics] Client #%u not subscribed: %d subscribers\n",
+                      clientId, METRICS_MAX_SUBSCRIBERS);
+    }
+}
+
+void MetricsHub::unsubscribe(uint32_t clientId) {
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < METRICS_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].id == clientId) {
+            subscribers[i].id = 0;
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+void MetricsHub::handleMessage(uint32_t clientId, const uint8_t* data, size_t len) {
+    DynamicJsonDocument doc(256);
+    if (deserializeJson(doc, data, len)) return;
+
+    const char* type = doc["type"] | "";
+    const char* topic = doc["topic"] | "";
+    if (strcmp(topic, "metrics") != 0) return;
+
+    if (strcmp(type, "subscribe") == 0) {
+        subscribe(clientId, doc["interval_ms"] | METRICS_PUSH_INTERVAL_MS);
+    } else if (strcmp(type, "unsubscribe") == 0) {
+        unsubscribe(clientId);
+    }
+}
+
+// ================== Sampling ==================
+
+void MetricsHub::set(Metric metric, Value value) {
+    Entry& entry = entries[(uint8_t)metric];
+    if (sampled && entry.value.u == value.u) return;
+
+    // All metrics changed in one round share the next version
+    entry.value = value;
+    entry.version = version + 1;
+    stats.changes++;
+}
+
+void MetricsHub::setUint(Metric metric, uint32_t value) {
+    Value v;
+    v.u = value;
+    set(metric, v);
+}
+
+void MetricsHub::setInt(Metric metric, int32_t value) {
+    Value v;
+    v.i = value;
+    set(metric, v);
+}
+
+void MetricsHub::setBool(Metric metric, bool value) {
+    setUint(metric, value ? 1 : 0);
+}
+
+void MetricsHub::setFloat(Metric metric, float value) {
+    // Rounded so noise below the displayed precision is not a change
+    Value v;
+    v.f = roundf(value * 10.0f) / 10.0f;
+    set(metric, v);
+}
+
+void MetricsHub::sample() {
+    uint32_t changesBefore = stats.changes;
+    stats.samples++;
+
+    setUint(Metric::UPTIME, millis() / 1000);
+    setUint(Metric::HEAP_FREE, ESP.getFreeHeap());
+    setBool(Metric::WIFI_CONNECTED, wifiConnectedToInternet);
+    setInt(Metric::WIFI_RSSI, wifiConnectedToInternet ? WiFi.RSSI() : 0);
+    setBool(Metric::SERVER_CONNECTED, udpForwarder.isConnected());
+
+    GatewayStats lora = loraGateway.getStatsSnapshot();
+    setBool(Metric::LORA_AVAILABLE, loraGateway.isAvailable());
+    setBool(Metric::LORA_RECEIVING, loraGateway.isReceiving());
+    setUint(Metric::RX_RECEIVED, lora.rxPacketsReceived);
+    setUint(Metric::RX_FORWARDED, lora.rxPacketsForwarded);
+    setUint(Metric::RX_CRC_ERROR, lora.rxPacketsCrcError);
+    setUint(Metric::TX_SENT, lora.txPacketsSent);
+    setFloat(Metric::LAST_RSSI, lora.lastRssi);
+    setFloat(Metric::LAST_SNR, lora.lastSnr);
+    setFloat(Metric::RX_OCCUPANCY, lora.rxOccupancyPct);
+
+    // Network health (what /api/network/health reports)
+    ForwarderStats fwd = udpForwarder.getStatsSnapshot();
+    setBool(Metric::NET_AVAILABLE, networkManager != nullptr);
+    setUint(Metric::NET_LAST_ACK, fwd.lastAckTime);
+    if (networkManager) {
+        setBool(Metric::NET_HEALTHY, networkManager->isApplicationHealthy());
+        setBool(Metric::NET_FAILOVER_ACTIVE, networkManager->isFailoverActive());
+        setUint(Metric::NET_STABILITY_PERIOD, networkManager->getConfig().stabilityPeriod);
+        // Whole seconds: it is shown as a countdown
+        setUint(Metric::NET_PRIMARY_STABLE_FOR, networkManager->getPrimaryStableFor() / 1000 * 1000);
+    }
+
+    if (!sampled || stats.changes != changesBefore) {
+        version++;
+    }
+    sampled = true;
+}
+
+// ================== Push ==================
+
+bool MetricsHub::buildDelta(uint32_t base, String& out) {
+    DynamicJsonDocument doc(METRICS_DOC_SIZE);
+    doc["type"] = "metrics";
+    doc["base"] = base;
+    doc["v"] = version;
+    JsonObject values = doc.createNestedObject("m");
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < METRIC_COUNT; i++) {
+        if (base != 0 && entries[i].version <= base) continue;
+        const Value& value = entries[i].value;
+        switch (METRIC_INFO[i].type) {
+            case MetricType::UINT:  values[METRIC_INFO[i].key] = value.u; break;
+            case MetricType::INT:   values[METRIC_INFO[i].key] = value.i; break;
+            case MetricType::BOOL:  values[METRIC_INFO[i].key] = value.u != 0; break;
+            case MetricType::FLOAT: values[METRIC_INFO[i].key] = value.f; break;
+        }
+        count++;
+    }
+    if (count == 0) return false;
+
+    out = "";
+    serializeJson(doc, out);
+    stats.builds++;
+    return true;
+}
+
+void MetricsHub::push(AsyncWebSocket& ws) {
+    // The boot task is still bringing up the modules sample() reads
+    if (!peripheralsReady) return;
+
+    uint32_t now = millis();
+
+    // Copy the subscribers that are due; the list may change meanwhile
+    Subscriber due[METRICS_MAX_SUBSCRIBERS];
+    uint8_t dueCount = 0;
+    uint8_t subscribed = 0;
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < METRICS_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].id == 0) continue;
+        subscribed++;
+        if (now - subscribers[i].lastPush >= subscribers[i].intervalMs) {
+            due[dueCount++] = subscribers[i];
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (dueCount == 0) {
+        if (stats.subscribers != subscribed) {
+            stats.subscribers = subscribed;
+            snapshot.publish(stats);
+        }
+        return;
+    }
+
+    sample();
+
+    // One delta per distinct client version, shared by every client on it
+    uint32_t sentVersion[METRICS_MAX_SUBSCRIBERS];
+    bool handled[METRICS_MAX_SUBSCRIBERS] = { false };
+    String json;
+
+    for (uint8_t i = 0; i < dueCount; i++) {
+        if (handled[i]) continue;
+        uint32_t base = due[i].version;
+        AsyncWebSocketSharedBuffer buffer;
+        if (base != version && buildDelta(base, json)) {
+            const uint8_t* data = (const uint8_t*)json.c_str();
+            buffer = std::make_shared<std::vector<uint8_t>>(data, data + json.length());
+        }
+
+        for (uint8_t j = i; j < dueCount; j++) {
+            if (handled[j] || due[j].version != base) continue;
+            handled[j] = true;
+            sentVersion[j] = base;
+            if (!buffer) continue;
+
+            // Looked up under the library's lock; false when the client is
+            // gone or still sending earlier messages (catches up later)
+            if (!ws.text(due[j].id, buffer)) {
+                stats.skipped++;
+                continue;
+            }
+            sentVersion[j] = version;
+            stats.sent++;
+        }
+    }
+
+    // Write back, unless the client resubscribed or left in the meantime
+    portENTER_CRITICAL(&mux);
+    for (uint8_t j = 0; j < dueCount; j++) {
+        for (uint8_t i = 0; i < METRICS_MAX_SUBSCRIBERS; i++) {
+            if (subscribers[i].id == due[j].id && subscribers[i].version == due[j].version) {
+                subscribers[i].lastPush = now;
+                subscribers[i].version = sentVersion[j];
+            }
+        }
+    }
+    portEXIT_CRITICAL(&mux);
+
+    stats.version = version;
+    stats.subscribers = subscribed;
+    snapshot.publish(stats);
+}
+
+// ================== Status ==================
+
+void MetricsHub::getStatusJson(JsonObject obj) const {
+    MetricsHubStats s = getStatsSnapshot();
+
+    obj["subscribers"] = s.subscribers;
+    obj["version"] = s.version;
+    obj["samples"] = s.samples;
+    obj["changes"] = s.changes;
+    obj["builds"] = s.builds;
+    obj["sent"] = s.sent;
+    obj["skipped"] = s.skipped;
+}
@@ -0,0 +1,145 @@
+#ifndef METRICS_HUB_H
+#define METRICS_HUB_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include "stats_snapshot.h"
+
+// =============================================================================
+// Metrics Hub
+// =============================================================================
+// Live dashboard values pushed to the web interface over /ws instead of
+// being polled from /api/status and /api/network/health.
+//
+// Each metric keeps its last value and the version at which it changed.
+// Once per push period the hub reads the modules' published snapshots and
+// bumps the version of the metrics that changed; a round where nothing
+// changed leaves the version alone. A client that subscribed with
+//   {"type":"subscribe","topic":"metrics","interval_ms":1000}
+// remembers the version it last received and gets, at its own interval,
+// only the metrics changed since then:
+//   {"type":"metrics","base":41,"v":42,"m":{"uptime":1234,"rx_received":17}}
+// base 0 is a full snapshot (first message, or after a resubscribe).
+// Clients that did not subscribe get nothing.
+//
+// Clients on the same version share one JSON build and one message buffer,
+// sent to each by id with ws.text(), which finds the client under the
+// library's lock; the loop task never holds a client pointer. A client
+// whose send queue is full is skipped and catches up with a larger delta
+// later. Nothing is sampled before the boot task has brought up the
+// peripherals (peripheralsReady).
+//
+// Subscriptions change on the AsyncTCP task (WebSocket events), under a
+// short critical section; sampling and sending run on the loop task from
+// WebServerManager::loop(). Statistics are published through a seqlock
+// snapshot.
+
+#define METRICS_PUSH_INTERVAL_MS    1000    // Default per-client period
+#define METRICS_PUSH_MIN_MS         250
+#define METRICS_PUSH_MAX_MS         10000
+#define METRICS_MAX_SUBSCRIBERS     8
+#define METRICS_DOC_SIZE            1024    // Delta document (full snapshot fits)
+
+enum class Metric : uint8_t {
+    UPTIME = 0,
+    HEAP_FREE,
+    WIFI_CONNECTED,
+    WIFI_RSSI,
+    SERVER_CONNECTED,
+    LORA_AVAILABLE,
+    LORA_RECEIVING,
+    RX_RECEIVED,
+    RX_FORWARDED,
+    RX_CRC_ERROR,
+    TX_SENT,
+    LAST_RSSI,
+    LAST_SNR,
+    RX_OCCUPANCY,
+    NET_AVAILABLE,
+    NET_HEALTHY,
+    NET_LAST_ACK,
+    NET_FAILOVER_ACTIVE,
+    NET_STABILITY_PERIOD,
+    NET_PRIMARY_STABLE_FOR,
+    COUNT
+};
+
+#define METRIC_COUNT    ((uint8_t)Metric::COUNT)
+
+enum class MetricType : uint8_t {
+    UINT = 0,
+    INT,
+    BOOL,
+    FLOAT               // Published rounded to 0.1
+};
+
+struct MetricsHubStats {
+    uint32_t samples;           // Sampling rounds
+    uint32_t changes;           // Metric value changes
+    uint32_t version;
+    uint32_t builds;            // JSON documents built
+    uint32_t sent;              // Messages sent
+    uint32_t skipped;           // Sends refused (full client queue)
+    uint8_t subscribers;
+};
+
+class MetricsHub {
+public:
+    MetricsHub();
+
+    // AsyncTCP task (WebSocket events)
+    void subscribe(uint32_t clientId, uint32_t intervalMs);
+    void unsubscribe(uint32_t clientId);
+    void handleMessage(uint32_t clientId, const uint8_t* data, size_t len);
+
+    // Loop task
+    void push(AsyncWebSocket& ws);
+
+    // Any task
+    MetricsHubStats getStatsSnapshot() const { return snapshot.read(); }
+    void getStatusJson(JsonObject obj) const;
+
+    static const char* metricKey(Metric metric);
+
+private:
+    union Value {
+        uint32_t u;
+        int32_t i;
+        float f;
+    };
+
+    struct Entry {
+        Value value;
+        uint32_t version;       // Version at which the value last changed
+    };
+
+    struct Subscriber {
+        uint32_t id;            // WebSocket client id, 0 = unused
+        uint32_t intervalMs;
+        uint32_t lastPush;
+        uint32_t version;       // Last version the client received, 0 = none
+    };
+
+    Entry entries[METRIC_COUNT];
+    uint32_t version;
+    bool sampled;
+    Subscriber subscribers[METRICS_MAX_SUBSCRIBERS];
+    portMUX_TYPE mux;
+
+    MetricsHubStats stats;
+    StatsSnapshot<MetricsHubStats> snapshot;
+
+    void sample();
+    void set(Metric metric, Value value);
+    void setUint(Metric metric, uint32_t value);
+    void setInt(Metric metric, int32_t value);
+    void setBool(Metric metric, bool value);
+    void setFloat(Metric metric, float value);
+    bool buildDelta(uint32_t base, String& out);
+};
+
+// Global instance
+extern MetricsHub metricsHub;
+
+#endif // METRICS_HUB_H
@@ -7,7 +7,7 @@
 
 #include "network_manager.h"
 #include "udp_forwarder.h"
-#include <LittleFS.h>
+#include "config_store.h"
 #include <ArduinoJson.h>
 
 // Instancia global
@@ -121,6 +121,9 @@ void NetworkManager::update() {
         if (!_manualMode) {
             checkFailover();
         }
+
+        // Publicar para leitores em outras tasks (web server)
+        _statsSnapshot.publish(_stats);
     }
 }
 
@@ -422,23 +425,14 @@ void NetworkManager::loadConfig(const JsonDocument& doc) {
 }
 
 bool NetworkManager::saveConfig() {
-    File file = LittleFS.open("/config.json", "r");
-    if (!file) {
-        Serial.println("[NET] Cannot open config for reading");
-        return false;
-    }
-
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
-
-    if (error) {
-        Serial.println("[NET] Failed to parse config");
+    ConfigSectionView section = configStore.edit(ConfigSection::NETWORK);
+    if (!section.isValid()) {
+        Serial.println("[NET] Config store not available");
         return false;
     }
 
-    // Atualizar secao network
-    JsonObject network = doc.createNestedObject("network");
+    // Atualizar secao network (gravada pelo configStore apos debounce)
+    JsonObject network = section.obj();
     network["wifi_enabled"] = _config.wifiEnabled;
     network["ethernet_enabled"] = _config.ethernetEnabled;
     network["primary"] = _config.primary == PrimaryInterface::WIFI ? "wifi" : "ethernet";
@@ -468,15 +462,6 @@ bool NetworkManager::saveConfig() {
     wifi["subnet"] = wifiConfig.subnet.toString();
     wifi["dns"] = wifiConfig.dns.toString();
 
-    file = LittleFS.open("/config.json", "w");
-    if (!file) {
-        Serial.println("[NET] Cannot open config for writing");
-        return false;
-    }
-
-    serializeJsonPretty(doc, file);
-    file.close();
-
     Serial.println("[NET] Config saved");
     return true;
 }
@@ -559,15 +544,16 @@ String NetworkManager::getStatusJson() {
     ethernet["ip"] = _ethernet.localIP().toString();
     ethernet["mac"] = _ethernet.getMacAddress();
 
-    // Stats
+    // Stats (snapshot: chamado a partir da task do AsyncTCP)
+    NetworkManagerStats snapshot = getStatsSnapshot();
     JsonObject stats = doc.createNestedObject("stats");
-    stats["wifiConnections"] = _stats.wifiConnections;
-    stats["wifiDisconnections"] = _stats.wifiDisconnections;
-    stats["ethernetConnections"] = _stats.ethernetConnections;
-    stats["ethernetDisconnections"] = _stats.ethernetDisconnections;
-    stats["failoverCount"] = _stats.failoverCount;
-    stats["totalUptimeWifi"] = _stats.totalUptimeWifi;
-    stats["totalUptimeEthernet"] = _stats.totalUptimeEthernet;
+    stats["wifiConnections"] = snapshot.wifiConnections;
+    stats["wifiDisconnections"] = snapshot.wifiDisconnections;
+    stats["ethernetConnections"] = snapshot.ethernetConnections;
+    stats["ethernetDisconnections"] = snapshot.ethernetDisconnections;
+    stats["failoverCount"] = snapshot.failoverCount;
+    stats["totalUptimeWifi"] = snapshot.totalUptimeWifi;
+    stats["totalUptimeEthernet"] = snapshot.totalUptimeEthernet;
 
     String output;
     serializeJson(doc, output);
@@ -593,11 +579,7 @@ String NetworkManager::getHealthJson() {
     doc["stabilityPeriod"] = _config.stabilityPeriod;
 
     // Time primary has been stable (during failover recovery)
-    uint32_t primaryStableFor = 0;
-    if (_failoverActive && _primaryStableStart > 0) {
-        primaryStableFor = millis() - _primaryStableStart;
-    }
-    doc["primaryStableFor"] = primaryStableFor;
+    doc["primaryStableFor"] = getPrimaryStableFor();
 
     String output;
     serializeJson(doc, output);
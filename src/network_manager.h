@@ -15,6 +15,7 @@
 #include "wifi_adapter.h"
 #include "ethernet_adapter.h"
 #include <ArduinoJson.h>
+#include "stats_snapshot.h"
 
 // Forward declaration for UDPForwarder
 class UDPForwarder;
@@ -183,11 +184,17 @@ public:
     EthernetAdapter* getEthernet() { return &_ethernet; }
 
     /**
-     * @brief Obter estatisticas
+     * @brief Obter estatisticas (somente na task do loop)
      * @return Referencia para estatisticas
      */
     NetworkManagerStats& getStats() { return _stats; }
 
+    /**
+     * @brief Obter copia consistente das estatisticas (qualquer task)
+     * @return Ultimo snapshot publicado pelo update()
+     */
+    NetworkManagerStats getStatsSnapshot() const { return _statsSnapshot.read(); }
+
     /**
      * @brief Obter status em formato JSON
      * @return String JSON
@@ -203,6 +210,20 @@ public:
      */
     String getHealthJson();
 
+    /**
+     * @brief Verificar se o failover esta ativo (rodando na interface secundaria)
+     * @return true se em failover
+     */
+    bool isFailoverActive() const { return _failoverActive; }
+
+    /**
+     * @brief Tempo em que a primaria esta estavel durante a recuperacao do failover
+     * @return Tempo em ms (0 fora do failover)
+     */
+    uint32_t getPrimaryStableFor() const {
+        return (_failoverActive && _primaryStableStart > 0) ? millis() - _primaryStableStart : 0;
+    }
+
     /**
      * @brief Verificar se a conexao esta saudavel (baseado em ACKs do ChirpStack)
      * @return true se a conexao esta saudavel
@@ -285,6 +306,7 @@ private:
 
     NetworkManagerConfig _config;
     NetworkManagerStats _stats;
+    StatsSnapshot<NetworkManagerStats> _statsSnapshot;
 
     // Referencia ao UDPForwarder para health checks
     UDPForwarder* _udpForwarder;
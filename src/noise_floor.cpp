@@ -0,0 +1,56 @@
+#include "noise_floor.h"
+
+NoiseFloorTable::NoiseFloorTable() {
+    reset();
+}
+
+void NoiseFloorTable::reset() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+uint8_t NoiseFloorTable::binIndex(int16_t rssi) {
+    if (rssi < NOISE_BIN_MIN_DBM) return 0;
+    int16_t bin = (rssi - NOISE_BIN_MIN_DBM) / NOISE_BIN_WIDTH_DB;
+    return bin >= NOISE_BINS ? NOISE_BINS - 1 : bin;
+}
+
+void NoiseFloorTable::record(uint32_t frequency, int16_t rssi) {
+    NoiseChannel& channel = channelFor(frequency);
+
+    if (channel.samples == 0 || rssi < channel.min) channel.min = rssi;
+    if (channel.samples == 0 || rssi > channel.max) channel.max = rssi;
+    channel.samples++;
+    channel.sum += rssi;
+
+    uint8_t bin = binIndex(rssi);
+    if (channel.bins[bin] == UINT16_MAX) {
+        // Keep the shape, drop the resolution
+        for (uint8_t i = 0; i < NOISE_BINS; i++) {
+            channel.bins[i] >>= 1;
+        }
+    }
+    channel.bins[bin]++;
+
+    stats.samples++;
+    stats.lastRssi = rssi;
+    stats.lastFrequency = frequency;
+}
+
+NoiseChannel& NoiseFloorTable::channelFor(uint32_t frequency) {
+    NoiseChannel* fewest = &stats.channels[0];
+
+    for (uint8_t i = 0; i < NOISE_MAX_CHANNELS; i++) {
+        NoiseChannel& channel = stats.channels[i];
+        if (channel.frequency == frequency) return channel;
+        if (channel.frequency == 0) {
+            channel.frequency = frequency;
+            return channel;
+        }
+        if (channel.samples < fewest->samples) fewest = &channel;
+    }
+
+    // Table full: replace the least observed frequency
+    memset(fewest, 0, sizeof(NoiseChannel));
+    fewest->frequency = frequency;
+    return *fewest;
+}
@@ -0,0 +1,55 @@
+#ifndef NOISE_FLOOR_H
+#define NOISE_FLOOR_H
+
+#include <Arduino.h>
+
+// =============================================================================
+// Noise Floor Table
+// =============================================================================
+// Instantaneous RSSI samples taken while the receiver is idle, kept per
+// frequency as min/avg/max and a histogram of fixed 4 dB bins. Memory is
+// fixed: a frequency that does not fit replaces the one with the fewest
+// samples. Written by the radio task only; readers get a copy through the
+// gateway's snapshot.
+
+#define NOISE_MAX_CHANNELS      9       // Channel plan + configured frequency
+#define NOISE_BINS              16
+#define NOISE_BIN_MIN_DBM       -140    // Lower edge of bin 0 (below is counted in it)
+#define NOISE_BIN_WIDTH_DB      4       // Bins cover -140..-76 dBm (above: last bin)
+
+struct NoiseChannel {
+    uint32_t frequency;             // 0 = unused
+    uint32_t samples;
+    int64_t sum;                    // dBm, for the average
+    int16_t min;
+    int16_t max;
+    uint16_t bins[NOISE_BINS];      // Halved together when one saturates
+};
+
+struct NoiseFloorStats {
+    uint32_t samples;
+    uint32_t skipped;               // Frame being received, no sample
+    uint32_t sweeps;
+    int16_t lastRssi;
+    uint32_t lastFrequency;
+    NoiseChannel channels[NOISE_MAX_CHANNELS];
+};
+
+class NoiseFloorTable {
+public:
+    NoiseFloorTable();
+
+    void record(uint32_t frequency, int16_t rssi);
+    void reset();
+
+    NoiseFloorStats& getStats() { return stats; }
+
+    static uint8_t binIndex(int16_t rssi);
+
+private:
+    NoiseFloorStats stats;
+
+    NoiseChannel& channelFor(uint32_t frequency);
+};
+
+#endif // NOISE_FLOOR_H
@@ -1,11 +1,12 @@
 #include "ntp_manager.h"
-#include <LittleFS.h>
+#include "config_store.h"
 #include <WiFi.h>
 
 // Global instance
 NTPManager ntpManager;
 
-NTPManager::NTPManager() {
+NTPManager::NTPManager()
+    : syncPending(false) {
     memset(&status, 0, sizeof(status));
     setDefaultConfig();
 }
@@ -30,14 +31,8 @@ bool NTPManager::begin() {
     Serial.printf("[NTP] Servers: %s, %s\n", config.server1, config.server2);
     Serial.printf("[NTP] Timezone offset: %ld seconds\n", config.timezoneOffset);
 
-    applyConfig();
-
-    // Try initial sync
-    if (sync()) {
-        Serial.println("[NTP] Initial sync successful");
-    } else {
-        Serial.println("[NTP] Initial sync failed (will retry later)");
-    }
+    // Initial sync completes in background, polled by update()
+    startBackgroundSync();
 
     return true;
 }
@@ -47,6 +42,38 @@ void NTPManager::applyConfig() {
                config.server1, config.server2);
 }
 
+void NTPManager::startBackgroundSync() {
+    applyConfig();
+    status.lastSyncAttempt = millis();
+    syncPending = true;
+}
+
+void NTPManager::pollBackgroundSync() {
+    time_t now = 0;
+    time(&now);
+
+    if (now > 1000000000) {
+        syncPending = false;
+        markSynced(now);
+    } else if (millis() - status.lastSyncAttempt >= NTP_SYNC_TIMEOUT) {
+        syncPending = false;
+        status.failCount++;
+        Serial.println("[NTP] Sync failed (timeout), will retry");
+    }
+}
+
+void NTPManager::markSynced(time_t now) {
+    status.synced = true;
+    status.lastSyncTime = millis();
+    status.syncCount++;
+
+    struct tm timeinfo;
+    gmtime_r(&now, &timeinfo);
+    Serial.printf("[NTP] Time synced: %04d-%02d-%02d %02d:%02d:%02d UTC\n",
+                  timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+                  timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+}
+
 bool NTPManager::sync() {
     if (!config.enabled) {
         return false;
@@ -68,16 +95,7 @@ bool NTPManager::sync() {
     }
 
     if (now > 1000000000) {
-        status.synced = true;
-        status.lastSyncTime = millis();
-        status.syncCount++;
-
-        struct tm timeinfo;
-        gmtime_r(&now, &timeinfo);
-        Serial.printf("[NTP] Time synced: %04d-%02d-%02d %02d:%02d:%02d UTC\n",
-                      timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
-                      timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-
+        markSynced(now);
         return true;
     } else {
         status.failCount++;
@@ -89,13 +107,19 @@ bool NTPManager::sync() {
 void NTPManager::update() {
     if (!config.enabled) return;
 
+    if (syncPending) {
+        pollBackgroundSync();
+        return;
+    }
+
     unsigned long now = millis();
 
-    // Periodic resync
-    if (now - status.lastSyncTime >= config.syncInterval) {
+    // Periodic resync, or retry until first sync (spaced by NTP_RETRY_INTERVAL)
+    bool due = !status.synced || now - status.lastSyncTime >= config.syncInterval;
+    if (status.lastSyncAttempt > 0 && due &&
+        now - status.lastSyncAttempt >= NTP_RETRY_INTERVAL) {
         // Re-apply config in case connection was lost
-        applyConfig();
-        sync();
+        startBackgroundSync();
     }
 }
 
@@ -119,23 +143,14 @@ void NTPManager::loadConfig(const JsonDocument& doc) {
 }
 
 bool NTPManager::saveConfig() {
-    File file = LittleFS.open("/config.json", "r");
-    if (!file) {
-        Serial.println("[NTP] Cannot open config for reading");
+    ConfigSectionView section = configStore.edit(ConfigSection::NTP);
+    if (!section.isValid()) {
+        Serial.println("[NTP] Config store not available");
         return false;
     }
 
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
-
-    if (error) {
-        Serial.println("[NTP] Failed to parse config");
-        return false;
-    }
-
-    // Update NTP section
-    JsonObject ntp = doc.createNestedObject("ntp");
+    // Update NTP section (written by configStore after debounce)
+    JsonObject ntp = section.obj();
     ntp["enabled"] = config.enabled;
     ntp["server1"] = config.server1;
     ntp["server2"] = config.server2;
@@ -143,15 +158,6 @@ bool NTPManager::saveConfig() {
     ntp["daylight_offset"] = config.daylightOffset;
     ntp["sync_interval"] = config.syncInterval;
 
-    file = LittleFS.open("/config.json", "w");
-    if (!file) {
-        Serial.println("[NTP] Cannot open config for writing");
-        return false;
-    }
-
-    serializeJsonPretty(doc, file);
-    file.close();
-
     Serial.println("[NTP] Config saved");
     return true;
 }
@@ -12,6 +12,8 @@
 #define NTP_TIMEZONE_DEFAULT 0
 #define NTP_DAYLIGHT_DEFAULT 0
 #define NTP_SYNC_INTERVAL_DEFAULT 3600000  // 1 hour in milliseconds
+#define NTP_SYNC_TIMEOUT 10000             // Background sync wait (10s)
+#define NTP_RETRY_INTERVAL 60000           // Retry after a failed sync (60s)
 
 // NTP Configuration structure
 struct NTPConfig {
@@ -36,13 +38,13 @@ class NTPManager {
 public:
     NTPManager();
 
-    // Initialize NTP
+    // Initialize NTP (starts SNTP, sync completes in background)
     bool begin();
 
-    // Update (check for periodic resync)
+    // Update (poll background sync, schedule periodic resync)
     void update();
 
-    // Manual sync
+    // Manual sync (blocking, up to NTP_SYNC_TIMEOUT)
     bool sync();
 
     // Configuration
@@ -63,9 +65,13 @@ public:
 private:
     NTPConfig config;
     NTPStatus status;
+    bool syncPending;
 
     void setDefaultConfig();
     void applyConfig();
+    void startBackgroundSync();
+    void pollBackgroundSync();
+    void markSynced(time_t now);
 };
 
 // Global instance
@@ -0,0 +1,435 @@
+#include "packet_capture.h"
+#include <sys/time.h>
+
+// Global instance
+PacketCapture packetCapture;
+
+static const char* const STATE_NAMES[] = {
+    "idle",
+    "armed",
+    "running"
+};
+
+static const char* const STOP_REASON_NAMES[] = {
+    "none",
+    "manual",
+    "max_packets",
+    "duration"
+};
+
+#define CAPTURE_DIR_UP      0x01
+#define CAPTURE_DIR_DOWN    0x02
+#define CAPTURE_CRC_OK      0x01
+#define CAPTURE_CRC_BAD     0x02
+
+static void put16be(uint8_t* p, uint16_t value) {
+    p[0] = value >> 8;
+    p[1] = value;
+}
+
+static void put32be(uint8_t* p, uint32_t value) {
+    p[0] = value >> 24;
+    p[1] = value >> 16;
+    p[2] = value >> 8;
+    p[3] = value;
+}
+
+static void put16le(uint8_t* p, uint16_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+}
+
+static void put32le(uint8_t* p, uint32_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+PacketCapture::PacketCapture()
+    : total(0)
+    , state(CaptureState::IDLE)
+    , stopReason(CaptureStopReason::NONE)
+    , startTime(0)
+    , seen(0)
+    , captured(0)
+    , mux(portMUX_INITIALIZER_UNLOCKED)
+{
+    memset(slots, 0, sizeof(slots));
+    memset(&settings, 0, sizeof(settings));
+    memset(&filter, 0, sizeof(filter));
+    memset(&trigger, 0, sizeof(trigger));
+}
+
+// ================== Control ==================
+
+const char* PacketCapture::start(const CaptureSettings& newSettings) {
+    CaptureFilter newFilter;
+    CaptureFilter newTrigger;
+    const char* error = parseFilter(newSettings.filter, newFilter);
+    if (error) return error;
+    error = parseFilter(newSettings.trigger, newTrigger);
+    if (error) return error;
+
+    bool armed = newSettings.trigger[0] != '\0';
+
+    // A new capture replaces the previous one
+    portENTER_CRITICAL(&mux);
+    memset(slots, 0, sizeof(slots));
+    total = 0;
+    seen = 0;
+    captured = 0;
+    settings = newSettings;
+    filter = newFilter;
+    trigger = newTrigger;
+    startTime = millis();
+    stopReason = CaptureStopReason::NONE;
+    state = armed ? CaptureState::ARMED : CaptureState::RUNNING;
+    portEXIT_CRITICAL(&mux);
+
+    Serial.printf("[Capture] %s (filter \"%s\")\n",
+                  armed ? "Armed" : "Started", newSettings.filter);
+    return nullptr;
+}
+
+void PacketCapture::stop() {
+    bool wasActive;
+
+    portENTER_CRITICAL(&mux);
+    wasActive = state != CaptureState::IDLE;
+    if (wasActive) {
+        state = CaptureState::IDLE;
+        stopReason = CaptureStopReason::MANUAL;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    if (wasActive) {
+        Serial.println("[Capture] Stopped");
+    }
+}
+
+void PacketCapture::checkDuration(uint32_t now) {
+    // Counted from the trigger once it has fired
+    if (state == CaptureState::RUNNING && settings.durationS > 0 &&
+        now - startTime >= settings.durationS * 1000UL) {
+        state = CaptureState::IDLE;
+        stopReason = CaptureStopReason::DURATION;
+    }
+}
+
+CaptureStatus PacketCapture::getStatus() {
+    CaptureStatus status;
+    uint32_t now = millis();
+
+    portENTER_CRITICAL(&mux);
+    checkDuration(now);
+    status.state = state;
+    status.stopReason = stopReason;
+    status.settings = settings;
+    status.seen = seen;
+    status.captured = captured;
+    status.firstSeq = total > CAPTURE_RING_SIZE ? total - CAPTURE_RING_SIZE + 1 : 1;
+    status.lastSeq = total;
+    status.elapsedMs = now - startTime;
+    portEXIT_CRITICAL(&mux);
+
+    return status;
+}
+
+// ================== Filter ==================
+
+const char* PacketCapture::parseFilter(const char* expr, CaptureFilter& filter) {
+    memset(&filter, 0, sizeof(filter));
+    filter.directions = CAPTURE_DIR_UP | CAPTURE_DIR_DOWN;
+    filter.crc = CAPTURE_CRC_OK | CAPTURE_CRC_BAD;
+    filter.rssiMin = INT16_MIN;
+    filter.rssiMax = INT16_MAX;
+
+    if (strlen(expr) > CAPTURE_EXPR_MAX) return "Expression too long";
+
+    const char* p = expr;
+    while (true) {
+        while (*p == ' ') p++;
+        if (*p == '\0') break;
+
+        char term[CAPTURE_EXPR_MAX + 1];
+        size_t length = strcspn(p, " ");
+        memcpy(term, p, length);
+        term[length] = '\0';
+        p += length;
+
+        char* value = strpbrk(term, "=<>");
+        char op = value ? *value : '\0';
+        if (value) *value++ = '\0';
+
+        if (strcmp(term, "up") == 0 && op == '\0') {
+            filter.directions = CAPTURE_DIR_UP;
+
+        } else if (strcmp(term, "down") == 0 && op == '\0') {
+            filter.directions = CAPTURE_DIR_DOWN;
+
+        } else if (strcmp(term, "crc") == 0 && op == '=') {
+            if (strcmp(value, "ok") == 0) filter.crc = CAPTURE_CRC_OK;
+            else if (strcmp(value, "bad") == 0) filter.crc = CAPTURE_CRC_BAD;
+            else return "crc: ok or bad";
+
+        } else if (strcmp(term, "sf") == 0 && op == '=') {
+            // Comma separated list
+            char* item = value;
+            while (true) {
+                char* end;
+                long sf = strtol(item, &end, 10);
+                if (end == item || sf < 6 || sf > 12 || (*end != ',' && *end != '\0')) {
+                    return "sf: list of spreading factors 6-12";
+                }
+                filter.sfMask |= 1U << sf;
+                if (*end == '\0') break;
+                item = end + 1;
+            }
+
+        } else if (strcmp(term, "freq") == 0 && op == '=') {
+            char* end;
+            unsigned long frequency = strtoul(value, &end, 10);
+            if (end == value || *end != '\0' || frequency < 137000000UL || frequency > 1020000000UL) {
+                return "freq: frequency in Hz";
+            }
+            filter.frequency = frequency;
+
+        } else if (strcmp(term, "rssi") == 0 && (op == '>' || op == '<')) {
+            char* end;
+            long rssi = strtol(value, &end, 10);
+            if (end == value || *end != '\0' || rssi < -200 || rssi > 0) return "rssi: dBm after > or <";
+            if (op == '>') filter.rssiMin = rssi;
+            else filter.rssiMax = rssi;
+
+        } else if (strcmp(term, "devaddr") == 0 && op == '=') {
+            // "26011B00" or "26011B00/24"
+            char* end;
+            uint32_t address = strtoul(value, &end, 16);
+            uint8_t bits = 32;
+            if (end - value != 8) return "devaddr: 8 hex digits, optional /prefix length";
+            if (*end == '/') {
+                char* lengthEnd;
+                long prefix = strtol(end + 1, &lengthEnd, 10);
+                if (lengthEnd == end + 1 || *lengthEnd != '\0' || prefix < 1 || prefix > 32) {
+                    return "devaddr: prefix length 1-32";
+                }
+                bits = prefix;
+            } else if (*end != '\0') {
+                return "devaddr: 8 hex digits, optional /prefix length";
+            }
+            filter.devAddrSet = true;
+            filter.devAddrMask = 0xFFFFFFFFUL << (32 - bits);
+            filter.devAddrValue = address & filter.devAddrMask;
+
+        } else if (strcmp(term, "mtype") == 0 && op == '=') {
+            char* item = value;
+            while (true) {
+                char* comma = strchr(item, ',');
+                if (comma) *comma = '\0';
+                LoRaWANMType mtype;
+                if (!lorawanMTypeFromName(item, mtype)) return "mtype: unknown MType name";
+                filter.mtypeMask |= LORAWAN_MTYPE_BIT(mtype);
+                if (!comma) break;
+                item = comma + 1;
+            }
+
+        } else {
+            return "Unknown term (up, down, crc=, sf=, freq=, rssi>, rssi<, devaddr=, mtype=)";
+        }
+    }
+
+    return nullptr;
+}
+
+bool PacketCapture::matches(const CaptureFilter& filter, const FrameInfo& info) {
+    if (!(filter.directions & (info.uplink ? CAPTURE_DIR_UP : CAPTURE_DIR_DOWN))) return false;
+    if (!(filter.crc & (info.crcOk ? CAPTURE_CRC_OK : CAPTURE_CRC_BAD))) return false;
+    if (filter.sfMask && !(filter.sfMask & (1U << info.sf))) return false;
+    if (filter.frequency && filter.frequency != info.frequency) return false;
+
+    // RSSI terms only match uplinks
+    if (filter.rssiMin != INT16_MIN && (!info.uplink || info.rssi <= filter.rssiMin)) return false;
+    if (filter.rssiMax != INT16_MAX && (!info.uplink || info.rssi >= filter.rssiMax)) return false;
+
+    if (filter.mtypeMask || filter.devAddrSet) {
+        const LoRaWANHeader& header = *info.header;
+        if (!header.valid) return false;
+        if (filter.mtypeMask && !(filter.mtypeMask & LORAWAN_MTYPE_BIT(header.mtype))) return false;
+        if (filter.devAddrSet) {
+            bool dataFrame = header.mtype >= LoRaWANMType::UNCONFIRMED_UP &&
+                             header.mtype <= LoRaWANMType::CONFIRMED_DOWN;
+            if (!dataFrame || (header.devAddr & filter.devAddrMask) != filter.devAddrValue) return false;
+        }
+    }
+
+    return true;
+}
+
+// ================== Recording ==================
+
+bool PacketCapture::admit(const FrameInfo& info, uint32_t now) {
+    checkDuration(now);
+    if (state == CaptureState::IDLE) return false;
+
+    seen++;
+    if (state == CaptureState::ARMED) {
+        if (!matches(trigger, info)) return false;
+        state = CaptureState::RUNNING;
+        startTime = now;
+    }
+    if (!matches(filter, info)) return false;
+
+    captured++;
+    if (settings.maxPackets > 0 && captured >= settings.maxPackets) {
+        // This frame is still stored
+        state = CaptureState::IDLE;
+        stopReason = CaptureStopReason::MAX_PACKETS;
+    }
+    return true;
+}
+
+PacketCapture::Slot& PacketCapture::nextSlot() {
+    total++;
+    Slot& slot = slots[(total - 1) % CAPTURE_RING_SIZE];
+    slot.seq = total;
+    return slot;
+}
+
+void PacketCapture::recordUplink(const LoRaPacket& packet, const LoRaWANHeader& header) {
+    if (state == CaptureState::IDLE) return;
+
+    FrameInfo info;
+    info.uplink = true;
+    info.crcOk = packet.crcOk;
+    info.sf = packet.spreadingFactor;
+    info.frequency = packet.frequency;
+    info.rssi = packet.rssi;
+    info.header = &header;
+
+    store(info, packet.data, packet.length, packet.bandwidth, packet.snr,
+          micros() - packet.timestamp);
+}
+
+void PacketCapture::recordDownlink(const uint8_t* data, uint8_t length, uint32_t frequency,
+                                   uint8_t sf, float bandwidth) {
+    if (state == CaptureState::IDLE) return;
+
+    LoRaWANHeader header;
+    lorawanDecodeHeader(data, length, header);
+
+    FrameInfo info;
+    info.uplink = false;
+    info.crcOk = true;
+    info.sf = sf;
+    info.frequency = frequency;
+    info.rssi = 0;
+    info.header = &header;
+
+    store(info, data, length, bandwidth, 0, 0);
+}
+
+void PacketCapture::store(const FrameInfo& info, const uint8_t* data, uint8_t length,
+                          float bandwidth, float snr, uint32_t ageUs) {
+    uint8_t syncWord = loraGateway.getConfig().syncWord;
+    uint32_t now = millis();
+
+    // Wall clock once NTP/GPS set it, otherwise time since boot (1970);
+    // read before the critical section, gettimeofday() takes a lock
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    int64_t timestampUs = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec - ageUs;
+
+    portENTER_CRITICAL(&mux);
+    CaptureState before = state;
+    if (admit(info, now)) {
+        // Straight into the slot in its pcap form
+        Slot& slot = nextSlot();
+        writeRecordHeader(slot.bytes, timestampUs, length);
+        writeLoRaTap(slot.bytes + PCAP_RECORD_HEADER_SIZE, info.frequency, bandwidth,
+                     info.sf, info.rssi, snr, syncWord);
+        memcpy(slot.bytes + PCAP_RECORD_HEADER_SIZE + LORATAP_HEADER_SIZE, data, length);
+        slot.size = PCAP_RECORD_HEADER_SIZE + LORATAP_HEADER_SIZE + length;
+    }
+    CaptureState after = state;
+    CaptureStopReason reason = stopReason;
+    portEXIT_CRITICAL(&mux);
+
+    if (before == CaptureState::ARMED && after != CaptureState::ARMED) {
+        Serial.println("[Capture] Triggered");
+    }
+    if (before != CaptureState::IDLE && after == CaptureState::IDLE) {
+        Serial.printf("[Capture] Stopped (%s)\n", stopReasonName(reason));
+    }
+}
+
+// ================== pcap ==================
+
+void PacketCapture::writeGlobalHeader(uint8_t* buffer) {
+    put32le(buffer, PCAP_MAGIC);
+    put16le(buffer + 4, PCAP_VERSION_MAJOR);
+    put16le(buffer + 6, PCAP_VERSION_MINOR);
+    put32le(buffer + 8, 0);                 // UTC
+    put32le(buffer + 12, 0);                // Timestamp accuracy
+    put32le(buffer + 16, LORATAP_HEADER_SIZE + MAX_PACKET_SIZE);    // Snap length
+    put32le(buffer + 20, PCAP_LINKTYPE_LORATAP);
+}
+
+void PacketCapture::writeRecordHeader(uint8_t* p, int64_t timestampUs, uint8_t length) {
+    put32le(p, (uint32_t)(timestampUs / 1000000));
+    put32le(p + 4, (uint32_t)(timestampUs % 1000000));
+    put32le(p + 8, LORATAP_HEADER_SIZE + length);     // Captured
+    put32le(p + 12, LORATAP_HEADER_SIZE + length);    // On air
+}
+
+void PacketCapture::writeLoRaTap(uint8_t* p, uint32_t frequency, float bandwidth, uint8_t sf,
+                                 float rssi, float snr, uint8_t syncWord) {
+    // LoRaTap v0, multi-byte fields big-endian. RSSI is -139 + value in
+    // dBm (value / 4 when the SNR is negative); 0 for downlinks.
+    int32_t rssiValue = 0;
+    if (rssi != 0) {
+        rssiValue = snr >= 0 ? lroundf(rssi + 139) : lroundf((rssi + 139) * 4);
+        rssiValue = constrain(rssiValue, 0, 255);
+    }
+
+    p[0] = 0;                                   // Version
+    p[1] = 0;                                   // Padding
+    put16be(p + 2, LORATAP_HEADER_SIZE);
+    put32be(p + 4, frequency);
+    p[8] = (uint8_t)lroundf(bandwidth / 125.0f); // 125 kHz steps
+    p[9] = sf;
+    p[10] = rssiValue;                          // Packet RSSI
+    p[11] = 0;                                  // Max RSSI (not measured)
+    p[12] = 0;                                  // Current RSSI (not measured)
+    p[13] = (uint8_t)(int8_t)lroundf(snr * 4);
+    p[14] = syncWord;
+}
+
+uint16_t PacketCapture::getRecord(uint32_t seq, uint8_t* buffer) {
+    if (seq == 0) return 0;
+
+    uint16_t size = 0;
+
+    portENTER_CRITICAL(&mux);
+    const Slot& slot = slots[(seq - 1) % CAPTURE_RING_SIZE];
+    if (slot.seq == seq) {
+        memcpy(buffer, slot.bytes, slot.size);
+        size = slot.size;
+    }
+    portEXIT_CRITICAL(&mux);
+
+    return size;
+}
+
+// ================== Names ==================
+
+const char* PacketCapture::stateName(CaptureState state) {
+    uint8_t index = (uint8_t)state;
+    return index < sizeof(STATE_NAMES) / sizeof(STATE_NAMES[0]) ? STATE_NAMES[index] : "unknown";
+}
+
+const char* PacketCapture::stopReasonName(CaptureStopReason reason) {
+    uint8_t index = (uint8_t)reason;
+    return index < sizeof(STOP_REASON_NAMES) / sizeof(STOP_REASON_NAMES[0])
+           ? STOP_REASON_NAMES[index] : "unknown";
+}
@@ -0,0 +1,167 @@
+#ifndef PACKET_CAPTURE_H
+#define PACKET_CAPTURE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "lora_gateway.h"
+#include "lorawan_frame.h"
+
+// =============================================================================
+// Packet Capture
+// =============================================================================
+// Ring of the last CAPTURE_RING_SIZE uplinks and downlinks, downloadable as
+// a pcap file (/api/capture/pcap) that Wireshark opens directly: link type
+// LoRaTap (270), one LoRaTap v0 header (frequency, bandwidth, SF, RSSI,
+// SNR, sync word) in front of each PHYPayload.
+//
+// Each slot already holds the pcap record as it goes on the wire: record
+// header, LoRaTap header and payload, copied once from the received packet
+// (or the downlink buffer). Exporting is writing the slots out in order.
+//
+// A capture is started and stopped over HTTP. It only keeps frames that
+// match its filter expression, and can wait for a trigger expression to
+// match before recording starts. It stops by itself after max_packets
+// frames or duration_s seconds. Expressions are space separated terms that
+// must all match:
+//   up | down              direction
+//   crc=ok | crc=bad       payload CRC (CRC-failed uplinks are only seen
+//                          when they are forwarded)
+//   sf=7,8                 spreading factors
+//   freq=868100000         frequency in Hz
+//   rssi>-110, rssi<-60    uplink RSSI in dBm
+//   devaddr=26011B00/24    DevAddr prefix (data frames)
+//   mtype=join_request,... MTypes
+//
+// Frames are recorded by the loop task (received frames after the header
+// decode, downlinks after transmission); nothing is done while idle. Web
+// handlers copy one slot at a time under a short critical section; slots
+// carry a sequence number so one overwritten during an export is skipped.
+
+#define CAPTURE_RING_SIZE           32      // Frames kept
+#define CAPTURE_EXPR_MAX            96      // Filter/trigger expression length
+#define CAPTURE_MAX_PACKETS_DEFAULT 0       // 0 = until stopped
+#define CAPTURE_DURATION_DEFAULT    0       // s, 0 = until stopped
+
+// pcap format
+#define PCAP_MAGIC                  0xA1B2C3D4
+#define PCAP_VERSION_MAJOR          2
+#define PCAP_VERSION_MINOR          4
+#define PCAP_GLOBAL_HEADER_SIZE     24
+#define PCAP_RECORD_HEADER_SIZE     16
+#define PCAP_LINKTYPE_LORATAP       270
+#define LORATAP_HEADER_SIZE         15      // Version 0
+#define CAPTURE_SLOT_SIZE           (PCAP_RECORD_HEADER_SIZE + LORATAP_HEADER_SIZE + MAX_PACKET_SIZE)
+
+enum class CaptureState : uint8_t {
+    IDLE = 0,
+    ARMED,              // Waiting for the trigger expression to match
+    RUNNING
+};
+
+enum class CaptureStopReason : uint8_t {
+    NONE = 0,
+    MANUAL,
+    MAX_PACKETS,
+    DURATION
+};
+
+// Compiled filter/trigger expression
+struct CaptureFilter {
+    uint8_t directions;         // Bit 0: uplink, bit 1: downlink
+    uint8_t crc;                // Bit 0: CRC ok, bit 1: CRC failed
+    uint16_t sfMask;            // Bit n: SFn, 0 = any
+    uint8_t mtypeMask;          // LORAWAN_MTYPE_BIT, 0 = any
+    bool devAddrSet;
+    uint32_t devAddrMask;
+    uint32_t devAddrValue;
+    uint32_t frequency;         // Hz, 0 = any
+    int16_t rssiMin;            // dBm, exclusive
+    int16_t rssiMax;
+};
+
+struct CaptureSettings {
+    char filter[CAPTURE_EXPR_MAX + 1];
+    char trigger[CAPTURE_EXPR_MAX + 1];    // Empty: record from the start
+    uint32_t maxPackets;
+    uint32_t durationS;
+};
+
+struct CaptureStatus {
+    CaptureState state;
+    CaptureStopReason stopReason;
+    CaptureSettings settings;
+    uint32_t seen;              // Frames offered while armed or running
+    uint32_t captured;          // Frames that matched the filter
+    uint32_t firstSeq;          // Sequence numbers still in the ring
+    uint32_t lastSeq;
+    uint32_t elapsedMs;         // Since start (or since the trigger)
+};
+
+class PacketCapture {
+public:
+    PacketCapture();
+
+    // Web task: returns an error message or nullptr
+    const char* start(const CaptureSettings& settings);
+    void stop();
+    CaptureStatus getStatus();
+
+    // Loop task
+    void recordUplink(const LoRaPacket& packet, const LoRaWANHeader& header);
+    void recordDownlink(const uint8_t* data, uint8_t length, uint32_t frequency,
+                        uint8_t sf, float bandwidth);
+
+    // Any task: copy the pcap record with this sequence number into
+    // buffer (CAPTURE_SLOT_SIZE bytes); returns its size, 0 once overwritten
+    uint16_t getRecord(uint32_t seq, uint8_t* buffer);
+    static void writeGlobalHeader(uint8_t* buffer);
+
+    static const char* parseFilter(const char* expr, CaptureFilter& filter);
+    static const char* stateName(CaptureState state);
+    static const char* stopReasonName(CaptureStopReason reason);
+
+private:
+    struct Slot {
+        uint32_t seq;
+        uint16_t size;
+        uint8_t bytes[CAPTURE_SLOT_SIZE];
+    };
+
+    // What the filter sees of a frame
+    struct FrameInfo {
+        bool uplink;
+        bool crcOk;
+        uint8_t sf;
+        uint32_t frequency;
+        float rssi;
+        const LoRaWANHeader* header;
+    };
+
+    Slot slots[CAPTURE_RING_SIZE];
+    uint32_t total;             // Frames stored since start, also the last sequence number
+
+    volatile CaptureState state;
+    CaptureStopReason stopReason;
+    CaptureSettings settings;
+    CaptureFilter filter;
+    CaptureFilter trigger;
+    uint32_t startTime;         // millis() at start, then at the trigger
+    uint32_t seen;
+    uint32_t captured;
+    portMUX_TYPE mux;
+
+    bool admit(const FrameInfo& info, uint32_t now);
+    void checkDuration(uint32_t now);
+    Slot& nextSlot();
+    void store(const FrameInfo& info, const uint8_t* data, uint8_t length,
+               float bandwidth, float snr, uint32_t ageUs);
+    static bool matches(const CaptureFilter& filter, const FrameInfo& info);
+    static void writeRecordHeader(uint8_t* p, int64_t timestampUs, uint8_t length);
+    static void writeLoRaTap(uint8_t* p, uint32_t frequency, float bandwidth, uint8_t sf,
+                             float rssi, float snr, uint8_t syncWord);
+};
+
+// Global instance
+extern PacketCapture packetCapture;
+
+#endif // PACKET_CAPTURE_H
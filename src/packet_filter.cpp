@@ -0,0 +1,386 @@
+#include "packet_filter.h"
+#include "config_store.h"
+
+// Global instance
+PacketFilter packetFilter;
+
+// MTypes that carry a DevAddr
+#define FILTER_DATA_MTYPES  (LORAWAN_MTYPE_BIT(LoRaWANMType::UNCONFIRMED_UP) | \
+                             LORAWAN_MTYPE_BIT(LoRaWANMType::CONFIRMED_UP) | \
+                             LORAWAN_MTYPE_BIT(LoRaWANMType::UNCONFIRMED_DOWN) | \
+                             LORAWAN_MTYPE_BIT(LoRaWANMType::CONFIRMED_DOWN))
+
+static uint32_t prefixMask(uint8_t length) {
+    return length == 0 ? 0 : 0xFFFFFFFFUL << (32 - length);
+}
+
+// Exactly `digits` hex digits, stops at the first character after them
+static bool parseHex(const char*& p, uint8_t digits, uint64_t& value) {
+    value = 0;
+    for (uint8_t i = 0; i < digits; i++) {
+        char c = *p;
+        uint8_t nibble;
+        if (c >= '0' && c <= '9') nibble = c - '0';
+        else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+        else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+        else return false;
+        value = (value << 4) | nibble;
+        p++;
+    }
+    return true;
+}
+
+static void formatEui(char* out, uint64_t eui) {
+    sprintf(out, "%08X%08X", (uint32_t)(eui >> 32), (uint32_t)eui);
+}
+
+PacketFilter::PacketFilter()
+    : appliedVersion(0)
+    , enabled(false)
+    , defaultAllow(true)
+    , matcherCount(0)
+    , statsResetRequested(false) {
+
+    memset(&stats, 0, sizeof(stats));
+    memset(matchers, 0, sizeof(matchers));
+    memset(rulesByMType, 0, sizeof(rulesByMType));
+
+    FilterConfig config;
+    setDefaultConfig(config);
+    pending.publish(config);
+    appliedVersion = pending.version();
+}
+
+void PacketFilter::setDefaultConfig(FilterConfig& config) {
+    memset(&config, 0, sizeof(config));
+    config.enabled = FILTER_ENABLED_DEFAULT;
+    config.defaultAllow = true;
+}
+
+void PacketFilter::loadConfig(const JsonDocument& doc) {
+    JsonObjectConst filter = doc["server"]["filter"];
+    if (filter.isNull()) return;
+
+    FilterConfig config;
+    setDefaultConfig(config);
+    const char* error = parseConfig(filter, config);
+    if (error) {
+        Serial.printf("[Filter] Invalid config (%s), forwarding everything\n", error);
+        return;
+    }
+
+    setConfig(config);
+    Serial.printf("[Filter] Config loaded: enabled=%d, %u rule(s)\n",
+                  config.enabled, config.ruleCount);
+}
+
+bool PacketFilter::saveConfig() {
+    ConfigSectionView section = configStore.edit(ConfigSection::SERVER);
+    if (!section.isValid()) {
+        Serial.println("[Filter] Config store not available");
+        return false;
+    }
+
+    JsonObject server = section.obj();
+    JsonObject filter = server["filter"].is<JsonObject>() ? server["filter"].as<JsonObject>()
+                                                          : server.createNestedObject("filter");
+    configToJson(getConfig(), filter);
+
+    return true;
+}
+
+void PacketFilter::setConfig(const FilterConfig& config) {
+    pending.publish(config);
+}
+
+// ================== Loop ==================
+
+void PacketFilter::update() {
+    if (statsResetRequested) {
+        statsResetRequested = false;
+        memset(&stats, 0, sizeof(stats));
+        snapshot.publish(stats);
+    }
+
+    // New rules from the web task
+    uint32_t version = pending.version();
+    if (version != appliedVersion) {
+        appliedVersion = version;
+        compile(pending.read());
+        snapshot.publish(stats);
+    }
+}
+
+void PacketFilter::compile(const FilterConfig& config) {
+    enabled = config.enabled;
+    defaultAllow = config.defaultAllow;
+    matcherCount = config.ruleCount < FILTER_MAX_RULES ? config.ruleCount : FILTER_MAX_RULES;
+    memset(rulesByMType, 0, sizeof(rulesByMType));
+
+    for (uint8_t i = 0; i < matcherCount; i++) {
+        const FilterRule& rule = config.rules[i];
+        Matcher& matcher = matchers[i];
+        memset(&matcher, 0, sizeof(matcher));
+        matcher.type = rule.type;
+        matcher.allow = rule.allow;
+
+        uint8_t mtypes = 0;
+        switch (rule.type) {
+            case FilterRuleType::NETID: {
+                // The NetID's DevAddr block is a prefix as well
+                uint32_t prefix;
+                uint8_t length;
+                lorawanNetIdPrefix(rule.value, prefix, length);
+                matcher.mask = prefixMask(length);
+                matcher.value = prefix;
+                mtypes = FILTER_DATA_MTYPES;
+                break;
+            }
+            case FilterRuleType::DEVADDR:
+                matcher.mask = prefixMask(rule.prefixLength);
+                matcher.value = rule.value & matcher.mask;
+                mtypes = FILTER_DATA_MTYPES;
+                break;
+            case FilterRuleType::JOINEUI:
+                matcher.low = rule.euiMin;
+                matcher.high = rule.euiMax;
+                mtypes = LORAWAN_MTYPE_BIT(LoRaWANMType::JOIN_REQUEST);
+                break;
+            case FilterRuleType::MTYPE:
+                mtypes = rule.mtypeMask;
+                break;
+        }
+
+        for (uint8_t t = 0; t < LORAWAN_MTYPE_COUNT; t++) {
+            if (mtypes & (1U << t)) rulesByMType[t] |= (1U << i);
+        }
+    }
+
+    // Hit counters follow the rule positions
+    memset(stats.ruleHits, 0, sizeof(stats.ruleHits));
+
+    Serial.printf("[Filter] %s, %u rule(s), default %s\n", enabled ? "Enabled" : "Disabled",
+                  matcherCount, defaultAllow ? "allow" : "deny");
+}
+
+bool PacketFilter::accept(const LoRaWANHeader& header) {
+    stats.frames++;
+
+    bool allow;
+    if (!header.valid) {
+        stats.undecodable++;
+        allow = !enabled || defaultAllow;
+    } else {
+        stats.mtypes[(uint8_t)header.mtype]++;
+
+        if (!enabled) {
+            allow = true;
+        } else {
+            // Only the rules that apply to this MType, in order
+            int8_t hit = -1;
+            uint16_t candidates = rulesByMType[(uint8_t)header.mtype];
+            while (candidates) {
+                uint8_t i = __builtin_ctz(candidates);
+                candidates &= candidates - 1;
+
+                const Matcher& matcher = matchers[i];
+                bool match;
+                switch (matcher.type) {
+                    case FilterRuleType::NETID:
+                    case FilterRuleType::DEVADDR:
+                        match = (header.devAddr & matcher.mask) == matcher.value;
+                        break;
+                    case FilterRuleType::JOINEUI:
+                        match = header.joinEui >= matcher.low && header.joinEui <= matcher.high;
+                        break;
+                    default:
+                        match = true;
+                        break;
+                }
+                if (match) {
+                    hit = i;
+                    break;
+                }
+            }
+
+            if (hit >= 0) {
+                stats.ruleHits[hit]++;
+                allow = matchers[hit].allow;
+            } else {
+                stats.defaultHits++;
+                allow = defaultAllow;
+            }
+        }
+    }
+
+    if (allow) {
+        stats.accepted++;
+    } else {
+        stats.dropped++;
+    }
+    snapshot.publish(stats);
+    return allow;
+}
+
+// ================== Status ==================
+
+void PacketFilter::getStatusJson(JsonObject obj) const {
+    FilterStats s = getStatsSnapshot();
+
+    obj["frames"] = s.frames;
+    obj["undecodable"] = s.undecodable;
+    obj["accepted"] = s.accepted;
+    obj["dropped"] = s.dropped;
+    obj["default_hits"] = s.defaultHits;
+
+    JsonObject mtypes = obj.createNestedObject("mtypes");
+    for (uint8_t i = 0; i < LORAWAN_MTYPE_COUNT; i++) {
+        mtypes[lorawanMTypeName((LoRaWANMType)i)] = s.mtypes[i];
+    }
+
+    JsonArray hits = obj.createNestedArray("rule_hits");
+    FilterConfig config = getConfig();
+    for (uint8_t i = 0; i < config.ruleCount; i++) {
+        hits.add(s.ruleHits[i]);
+    }
+}
+
+void PacketFilter::resetStats() {
+    statsResetRequested = true;
+}
+
+// ================== JSON ==================
+
+const char* PacketFilter::parseConfig(JsonObjectConst json, FilterConfig& config) {
+    if (json.containsKey("enabled")) config.enabled = json["enabled"];
+
+    if (json.containsKey("default")) {
+        const char* action = json["default"] | "";
+        if (strcmp(action, "allow") == 0) config.defaultAllow = true;
+        else if (strcmp(action, "deny") == 0) config.defaultAllow = false;
+        else return "default: allow or deny";
+    }
+
+    if (!json.containsKey("rules")) return nullptr;
+
+    JsonArrayConst rules = json["rules"];
+    if (rules.isNull()) return "rules: array expected";
+    if (rules.size() > FILTER_MAX_RULES) return "rules: up to 16 rules";
+
+    uint8_t count = 0;
+    for (JsonObjectConst entry : rules) {
+        FilterRule& rule = config.rules[count];
+        memset(&rule, 0, sizeof(rule));
+
+        const char* action = entry["action"] | "";
+        if (strcmp(action, "allow") == 0) rule.allow = true;
+        else if (strcmp(action, "deny") == 0) rule.allow = false;
+        else return "rule action: allow or deny";
+
+        uint64_t value;
+        if (entry.containsKey("netid")) {
+            const char* p = entry["netid"] | "";
+            if (!parseHex(p, 6, value) || *p != '\0') return "netid: 6 hex digits";
+            rule.type = FilterRuleType::NETID;
+            rule.value = value;
+
+        } else if (entry.containsKey("devaddr")) {
+            // "26000000/7"; no length means the full address
+            const char* p = entry["devaddr"] | "";
+            if (!parseHex(p, 8, value)) return "devaddr: 8 hex digits, optional /prefix length";
+            uint8_t length = 32;
+            if (*p == '/') {
+                char* end;
+                long bits = strtol(p + 1, &end, 10);
+                if (end == p + 1 || *end != '\0' || bits < 1 || bits > 32) {
+                    return "devaddr: prefix length 1-32";
+                }
+                length = bits;
+            } else if (*p != '\0') {
+                return "devaddr: 8 hex digits, optional /prefix length";
+            }
+            rule.type = FilterRuleType::DEVADDR;
+            rule.value = (uint32_t)value & prefixMask(length);
+            rule.prefixLength = length;
+
+        } else if (entry.containsKey("joineui")) {
+            // Single EUI or "first-last"
+            const char* p = entry["joineui"] | "";
+            uint64_t last;
+            if (!parseHex(p, 16, value)) return "joineui: 16 hex digits or a first-last range";
+            if (*p == '-') {
+                p++;
+                if (!parseHex(p, 16, last) || *p != '\0' || last < value) {
+                    return "joineui: 16 hex digits or a first-last range";
+                }
+            } else if (*p == '\0') {
+                last = value;
+            } else {
+                return "joineui: 16 hex digits or a first-last range";
+            }
+            rule.type = FilterRuleType::JOINEUI;
+            rule.euiMin = value;
+            rule.euiMax = last;
+
+        } else if (entry.containsKey("mtype")) {
+            // One name or a list of names
+            rule.type = FilterRuleType::MTYPE;
+            LoRaWANMType mtype;
+            if (entry["mtype"].is<const char*>()) {
+                if (!lorawanMTypeFromName(entry["mtype"].as<const char*>(), mtype)) return "mtype: unknown name";
+                rule.mtypeMask = LORAWAN_MTYPE_BIT(mtype);
+            } else {
+                for (JsonVariantConst name : entry["mtype"].as<JsonArrayConst>()) {
+                    if (!lorawanMTypeFromName(name.as<const char*>(), mtype)) return "mtype: unknown name";
+                    rule.mtypeMask |= LORAWAN_MTYPE_BIT(mtype);
+                }
+            }
+            if (rule.mtypeMask == 0) return "mtype: at least one name";
+
+        } else {
+            return "rule needs netid, devaddr, joineui or mtype";
+        }
+
+        count++;
+    }
+    config.ruleCount = count;
+
+    return nullptr;
+}
+
+void PacketFilter::configToJson(const FilterConfig& config, JsonObject json) {
+    json["enabled"] = config.enabled;
+    json["default"] = config.defaultAllow ? "allow" : "deny";
+
+    JsonArray rules = json.createNestedArray("rules");
+    for (uint8_t i = 0; i < config.ruleCount; i++) {
+        const FilterRule& rule = config.rules[i];
+        JsonObject entry = rules.createNestedObject();
+        entry["action"] = rule.allow ? "allow" : "deny";
+
+        char text[40];
+        switch (rule.type) {
+            case FilterRuleType::NETID:
+                sprintf(text, "%06X", rule.value);
+                entry["netid"] = text;
+                break;
+            case FilterRuleType::DEVADDR:
+                sprintf(text, "%08X/%u", rule.value, rule.prefixLength);
+                entry["devaddr"] = text;
+                break;
+            case FilterRuleType::JOINEUI:
+                formatEui(text, rule.euiMin);
+                text[16] = '-';
+                formatEui(text + 17, rule.euiMax);
+                entry["joineui"] = text;
+                break;
+            case FilterRuleType::MTYPE: {
+                JsonArray names = entry.createNestedArray("mtype");
+                for (uint8_t t = 0; t < LORAWAN_MTYPE_COUNT; t++) {
+                    if (rule.mtypeMask & (1U << t)) names.add(lorawanMTypeName((LoRaWANMType)t));
+                }
+                break;
+            }
+        }
+    }
+}
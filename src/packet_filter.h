@@ -0,0 +1,120 @@
+#ifndef PACKET_FILTER_H
+#define PACKET_FILTER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "stats_snapshot.h"
+#include "lorawan_frame.h"
+
+// =============================================================================
+// Packet Filter
+// =============================================================================
+// Decides from the LoRaWAN header whether an uplink is forwarded. Rules are
+// an ordered list (first match wins, otherwise the default action) of:
+//   netid    - DevAddr inside the range a NetID assigns (data frames)
+//   devaddr  - DevAddr prefix, "26000000/7" (data frames)
+//   joineui  - JoinEUI range, "70B3D57ED0000000-70B3D57ED0FFFFFF" (join-requests)
+//   mtype    - list of MTypes ("proprietary", ...)
+// The rule list is compiled into mask/value and range entries plus, per
+// MType, a bitmap of the rules that can apply, so a frame is matched with
+// a few integer compares. Frames that do not decode only get the default.
+//
+// The configuration is set from the web task and handed to the loop task
+// through a seqlock snapshot; matching and counters belong to the loop task.
+
+#define FILTER_MAX_RULES            16
+
+// Defaults (server.filter)
+#define FILTER_ENABLED_DEFAULT      false
+
+enum class FilterRuleType : uint8_t {
+    NETID = 0,
+    DEVADDR,
+    JOINEUI,
+    MTYPE
+};
+
+struct FilterRule {
+    FilterRuleType type;
+    bool allow;
+    uint8_t prefixLength;       // DEVADDR
+    uint8_t mtypeMask;          // MTYPE: LORAWAN_MTYPE_BIT of each listed MType
+    uint32_t value;             // NETID: NetID, DEVADDR: prefix (MSB aligned)
+    uint64_t euiMin;            // JOINEUI, inclusive
+    uint64_t euiMax;
+};
+
+struct FilterConfig {
+    bool enabled;
+    bool defaultAllow;
+    uint8_t ruleCount;
+    FilterRule rules[FILTER_MAX_RULES];
+};
+
+struct FilterStats {
+    uint32_t frames;
+    uint32_t undecodable;           // Not a LoRaWAN R1 frame of its MType
+    uint32_t accepted;
+    uint32_t dropped;
+    uint32_t defaultHits;           // No rule matched
+    uint32_t mtypes[LORAWAN_MTYPE_COUNT];
+    uint32_t ruleHits[FILTER_MAX_RULES];
+};
+
+class PacketFilter {
+public:
+    PacketFilter();
+
+    void loadConfig(const JsonDocument& doc);
+    bool saveConfig();
+
+    // Any task: replace the rules (applied by the loop task on its next pass)
+    void setConfig(const FilterConfig& config);
+    FilterConfig getConfig() const { return pending.read(); }
+
+    // Loop task
+    void update();
+    bool accept(const LoRaWANHeader& header);
+
+    // Any task
+    FilterStats getStatsSnapshot() const { return snapshot.read(); }
+    void getStatusJson(JsonObject obj) const;
+    void resetStats();      // Applied by the loop task on next update()
+
+    // JSON form of the rules (config file and REST API); parseConfig
+    // returns an error message or nullptr
+    static const char* parseConfig(JsonObjectConst json, FilterConfig& config);
+    static void configToJson(const FilterConfig& config, JsonObject json);
+
+private:
+    // Compiled rule: the frame field to test and its mask/value or range
+    struct Matcher {
+        FilterRuleType type;
+        bool allow;
+        uint32_t mask;
+        uint32_t value;
+        uint64_t low;
+        uint64_t high;
+    };
+
+    StatsSnapshot<FilterConfig> pending;
+    uint32_t appliedVersion;
+
+    bool enabled;
+    bool defaultAllow;
+    uint8_t matcherCount;
+    Matcher matchers[FILTER_MAX_RULES];
+    uint16_t rulesByMType[LORAWAN_MTYPE_COUNT];     // Bit i: rule i can match
+
+    FilterStats stats;
+    StatsSnapshot<FilterStats> snapshot;
+    volatile bool statsResetRequested;
+
+    void compile(const FilterConfig& config);
+    static void setDefaultConfig(FilterConfig& config);
+};
+
+// Global instance
+extern PacketFilter packetFilter;
+
+#endif // PACKET_FILTER_H
@@ -0,0 +1,114 @@
+#include "packet_stream.h"
+#include <math.h>
+
+// Global instance
+PacketStream packetStream;
+
+static void put16le(uint8_t* p, uint16_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+}
+
+static void put32le(uint8_t* p, uint32_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+PacketStream::PacketStream()
+    : count(0)
+    , firstSeq(0)
+    , lastFlush(0)
+{
+    memset(buffer, 0, sizeof(buffer));
+    memset(&stats, 0, sizeof(stats));
+}
+
+// ================== Records ==================
+
+void PacketStream::record(const LoRaPacket& packet, const LoRaWANHeader& header, bool forwarded) {
+    uint32_t seq = stats.records++;
+
+    if (count >= PACKET_STREAM_BATCH_MAX) {
+        stats.overflow++;
+        return;
+    }
+    if (count == 0) firstSeq = seq;
+
+    uint8_t flags = 0;
+    if (packet.crcOk) flags |= PACKET_STREAM_FLAG_CRC_OK;
+    if (header.valid) flags |= PACKET_STREAM_FLAG_LORAWAN;
+    if (forwarded) flags |= PACKET_STREAM_FLAG_FORWARDED;
+
+    bool dataFrame = header.valid && header.mtype >= LoRaWANMType::UNCONFIRMED_UP &&
+                     header.mtype <= LoRaWANMType::CONFIRMED_DOWN;
+
+    uint8_t* p = buffer + PACKET_STREAM_HEADER_SIZE + count * PACKET_STREAM_RECORD_SIZE;
+    put32le(p, millis());
+    put16le(p + 4, (uint16_t)(int16_t)lroundf(packet.rssi * 10));
+    p[6] = (uint8_t)(int8_t)lroundf(packet.snr * 4);
+    p[7] = packet.spreadingFactor;
+    p[8] = packet.length;
+    p[9] = flags;
+    p[10] = header.valid ? (uint8_t)header.mtype : 0xFF;
+    p[11] = packet.channel;
+    put32le(p + 12, dataFrame ? header.devAddr : 0);
+    count++;
+}
+
+// ================== Batches ==================
+
+void PacketStream::flush(AsyncWebSocket& ws) {
+    unsigned long now = millis();
+    if (now - lastFlush < PACKET_STREAM_INTERVAL_MS) return;
+    lastFlush = now;
+
+    if (count == 0) return;
+
+    // Nobody listening: the batch is simply discarded
+    stats.clients = ws.count();
+    if (stats.clients == 0) {
+        count = 0;
+        snapshot.publish(stats);
+        return;
+    }
+
+    buffer[0] = PACKET_STREAM_MSG_PACKETS;
+    buffer[1] = PACKET_STREAM_VERSION;
+    buffer[2] = PACKET_STREAM_RECORD_SIZE;
+    buffer[3] = count;
+    put32le(buffer + 4, firstSeq);
+    size_t length = PACKET_STREAM_HEADER_SIZE + count * PACKET_STREAM_RECORD_SIZE;
+
+    // One shared message, queued to each client under the library's lock
+    switch (ws.binaryAll(buffer, length)) {
+        case AsyncWebSocket::ENQUEUED:
+            stats.batches++;
+            break;
+        case AsyncWebSocket::PARTIALLY_ENQUEUED:
+            stats.batches++;
+            stats.partial++;
+            break;
+        default:
+            stats.discarded++;
+            break;
+    }
+
+    count = 0;
+    snapshot.publish(stats);
+}
+
+// ================== Status ==================
+
+void PacketStream::getStatusJson(JsonObject obj) const {
+    PacketStreamStats s = getStatsSnapshot();
+
+    obj["records"] = s.records;
+    obj["batches"] = s.batches;
+    obj["partial"] = s.partial;
+    obj["discarded"] = s.discarded;
+    obj["overflow"] = s.overflow;
+    obj["clients"] = s.clients;
+    obj["interval_ms"] = PACKET_STREAM_INTERVAL_MS;
+}
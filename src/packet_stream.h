@@ -0,0 +1,87 @@
+#ifndef PACKET_STREAM_H
+#define PACKET_STREAM_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include "stats_snapshot.h"
+#include "lora_gateway.h"
+#include "lorawan_frame.h"
+
+// =============================================================================
+// Packet Stream
+// =============================================================================
+// Live received packets for the web interface, as binary WebSocket messages
+// on /ws (the text messages there stay for log lines). Recording a packet
+// appends a fixed 16-byte record to the current batch: no String, no JSON
+// document, no send. Every PACKET_STREAM_INTERVAL_MS the batch goes out as
+// one message, shared by every client.
+//
+// The batch is sent with AsyncWebSocket::binaryAll(), which walks the
+// client list under the library's lock: the list changes on the AsyncTCP
+// task, so the loop task never iterates it itself. A client whose send
+// queue is full (a slow browser on a weak link) misses the batch without
+// holding up the others. Every recorded packet gets a sequence number and
+// the header carries the one of the first record, so a client sees what it
+// missed as a gap; records that arrive while a batch is full (overflow)
+// show up the same way.
+//
+// Message layout (little-endian):
+//   header  type (0x01), version (2), record size (16), record count,
+//           uint32 sequence number of the first record
+//   record  uint32 uptime ms, int16 RSSI (0.1 dBm), int8 SNR (0.25 dB),
+//           uint8 SF, uint8 length, uint8 flags, uint8 MType, uint8 channel,
+//           uint32 DevAddr (0 when the frame has none)
+//
+// Loop task only (records come from the packet loop, batches are sent from
+// WebServerManager::loop()); statistics are published through a seqlock
+// snapshot.
+
+#define PACKET_STREAM_INTERVAL_MS       250     // Batch period
+#define PACKET_STREAM_BATCH_MAX         32      // Records per batch
+
+#define PACKET_STREAM_MSG_PACKETS       0x01
+#define PACKET_STREAM_VERSION           2
+#define PACKET_STREAM_HEADER_SIZE       8
+#define PACKET_STREAM_RECORD_SIZE       16
+
+// Record flags
+#define PACKET_STREAM_FLAG_CRC_OK       0x01
+#define PACKET_STREAM_FLAG_LORAWAN      0x02    // Header decoded, MType valid
+#define PACKET_STREAM_FLAG_FORWARDED    0x04    // Passed the packet filter
+
+struct PacketStreamStats {
+    uint32_t records;           // Packets recorded (next sequence number)
+    uint32_t batches;           // Batches queued to at least one client
+    uint32_t partial;           // ...of which some client missed (full queue)
+    uint32_t discarded;         // Batches no client took
+    uint32_t overflow;          // Records lost to a full batch
+    uint32_t clients;           // Connected clients at the last batch
+};
+
+class PacketStream {
+public:
+    PacketStream();
+
+    // Loop task
+    void record(const LoRaPacket& packet, const LoRaWANHeader& header, bool forwarded);
+    void flush(AsyncWebSocket& ws);
+
+    // Any task
+    PacketStreamStats getStatsSnapshot() const { return snapshot.read(); }
+    void getStatusJson(JsonObject obj) const;
+
+private:
+    uint8_t buffer[PACKET_STREAM_HEADER_SIZE + PACKET_STREAM_BATCH_MAX * PACKET_STREAM_RECORD_SIZE];
+    uint8_t count;
+    uint32_t firstSeq;          // Sequence number of the first record in the batch
+    unsigned long lastFlush;
+
+    PacketStreamStats stats;
+    StatsSnapshot<PacketStreamStats> snapshot;
+};
+
+// Global instance
+extern PacketStream packetStream;
+
+#endif // PACKET_STREAM_H
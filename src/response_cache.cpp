@@ -0,0 +1,135 @@
+#include "response_cache.h"
+
+// Global instance
+ResponseCache responseCache;
+
+static const char* ENDPOINT_NAMES[CACHED_ENDPOINT_COUNT] = {
+    "lora", "server", "lcd", "buzzer", "rtc", "network"
+};
+
+ResponseCache::ResponseCache()
+    : bootId(esp_random())
+    , useCounter(0)
+{
+    for (uint8_t i = 0; i < CACHED_ENDPOINT_COUNT; i++) {
+        entries[i].valid = false;
+        entries[i].version = 0;
+        entries[i].lastUsed = 0;
+    }
+    memset(&stats, 0, sizeof(stats));
+}
+
+const char* ResponseCache::endpointName(CachedEndpoint endpoint) {
+    return (uint8_t)endpoint < CACHED_ENDPOINT_COUNT ? ENDPOINT_NAMES[(uint8_t)endpoint] : "unknown";
+}
+
+// ================== Lookup ==================
+
+String ResponseCache::etag(uint32_t version) const {
+    // Boot id: versions start over after a restart
+    char tag[24];
+    snprintf(tag, sizeof(tag), "\"%08x-%x\"", bootId, version);
+    return String(tag);
+}
+
+bool ResponseCache::serve(AsyncWebServerRequest* request, CachedEndpoint endpoint, uint32_t version) {
+    String tag = etag(version);
+
+    // The browser's copy is current: no body at all
+    if (request->hasHeader("If-None-Match") &&
+        request->getHeader("If-None-Match")->value().indexOf(tag) >= 0) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", tag);
+        response->addHeader("Cache-Control", "no-cache");
+        request->send(response);
+        stats.notModified++;
+        return true;
+    }
+
+    Entry& entry = entries[(uint8_t)endpoint];
+    if (entry.valid && entry.version == version) {
+        entry.lastUsed = ++useCounter;
+        stats.hits++;
+        respond(request, entry.body, tag);
+        return true;
+    }
+
+    stats.misses++;
+    return false;
+}
+
+void ResponseCache::respond(AsyncWebServerRequest* request, const String& body, const String& tag) {
+    AsyncWebServerResponse* response = request->beginResponse(200, "application/json", body);
+    response->addHeader("ETag", tag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+// ================== Storage ==================
+
+void ResponseCache::send(AsyncWebServerRequest* request, CachedEndpoint endpoint, uint32_t version,
+                         const String& body) {
+    Entry& entry = entries[(uint8_t)endpoint];
+    drop(entry);
+
+    if (makeRoom(body.length())) {
+        entry.body = body;
+        entry.valid = true;
+        entry.version = version;
+        entry.lastUsed = ++useCounter;
+        stats.bytes += body.length();
+        stats.entries++;
+    }
+
+    respond(request, body, etag(version));
+}
+
+void ResponseCache::drop(Entry& entry) {
+    if (!entry.valid) return;
+    stats.bytes -= entry.body.length();
+    stats.entries--;
+    entry.body = String();      // Release the heap copy
+    entry.valid = false;
+}
+
+bool ResponseCache::makeRoom(size_t length) {
+    if (length > RESPONSE_CACHE_BUDGET) {
+        stats.tooLarge++;
+        return false;
+    }
+
+    // Evict least recently used bodies until this one fits
+    while (stats.bytes + length > RESPONSE_CACHE_BUDGET) {
+        Entry* oldest = nullptr;
+        for (uint8_t i = 0; i < CACHED_ENDPOINT_COUNT; i++) {
+            if (entries[i].valid && (!oldest || entries[i].lastUsed < oldest->lastUsed)) {
+                oldest = &entries[i];
+            }
+        }
+        if (!oldest) break;
+        drop(*oldest);
+        stats.evictions++;
+    }
+    return true;
+}
+
+// ================== Status ==================
+
+void ResponseCache::getStatusJson(JsonObject obj) const {
+    uint32_t lookups = stats.hits + stats.notModified + stats.misses;
+
+    obj["hits"] = stats.hits;
+    obj["not_modified"] = stats.notModified;
+    obj["misses"] = stats.misses;
+    obj["hit_ratio_pct"] = lookups > 0 ? (stats.hits + stats.notModified) * 100 / lookups : 0;
+    obj["evictions"] = stats.evictions;
+    obj["too_large"] = stats.tooLarge;
+    obj["entries"] = stats.entries;
+    obj["bytes"] = stats.bytes;
+    obj["budget"] = RESPONSE_CACHE_BUDGET;
+
+    JsonArray cached = obj.createNestedArray("cached");
+    for (uint8_t i = 0; i < CACHED_ENDPOINT_COUNT; i++) {
+        if (entries[i].valid) cached.add(ENDPOINT_NAMES[i]);
+    }
+}
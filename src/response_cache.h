@@ -0,0 +1,90 @@
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+
+// =============================================================================
+// Response Cache
+// =============================================================================
+// Serialized bodies of the config GET endpoints, reused until the config
+// behind them changes. The caller passes a version for the endpoint, read
+// before building the body: the config store's section generation (bumped
+// whenever a section is marked dirty), plus the module's own revision where
+// settings can change without being saved. A different version is a miss.
+//
+// Responses carry an ETag made of a per-boot id and the version, with
+// Cache-Control: no-cache, so the browser revalidates and gets a bodyless
+// 304 while the version holds; that needs only the version, not a cached
+// body.
+//
+// Bodies are kept within RESPONSE_CACHE_BUDGET bytes; the least recently
+// used ones are evicted to make room. Endpoints whose output includes live
+// status (WiFi, NTP, GPS) are not cached, and cached bodies leave out live
+// fields such as LCD and RTC presence (served by their status endpoints).
+//
+// AsyncTCP task only (web handlers).
+
+#define RESPONSE_CACHE_BUDGET       4096    // Bytes of cached bodies
+
+enum class CachedEndpoint : uint8_t {
+    LORA_CONFIG = 0,
+    SERVER_CONFIG,
+    LCD_CONFIG,
+    BUZZER_CONFIG,
+    RTC_CONFIG,
+    NETWORK_CONFIG,
+    COUNT
+};
+
+#define CACHED_ENDPOINT_COUNT   ((uint8_t)CachedEndpoint::COUNT)
+
+struct ResponseCacheStats {
+    uint32_t hits;              // Served from a cached body
+    uint32_t notModified;       // 304 on a matching If-None-Match
+    uint32_t misses;            // Body built by the handler
+    uint32_t evictions;         // Bodies dropped for the budget
+    uint32_t tooLarge;          // Bodies over the whole budget (not cached)
+    uint32_t bytes;             // Cached body bytes now
+    uint8_t entries;
+};
+
+class ResponseCache {
+public:
+    ResponseCache();
+
+    // Answer from the cache: 304 or the cached body. False on a miss; the
+    // handler then builds the body and calls send() with the same version
+    bool serve(AsyncWebServerRequest* request, CachedEndpoint endpoint, uint32_t version);
+    void send(AsyncWebServerRequest* request, CachedEndpoint endpoint, uint32_t version,
+              const String& body);
+
+    ResponseCacheStats getStats() const { return stats; }
+    void getStatusJson(JsonObject obj) const;
+
+    static const char* endpointName(CachedEndpoint endpoint);
+
+private:
+    struct Entry {
+        bool valid;
+        uint32_t version;
+        uint32_t lastUsed;      // Use counter value, for LRU
+        String body;
+    };
+
+    Entry entries[CACHED_ENDPOINT_COUNT];
+    uint32_t bootId;
+    uint32_t useCounter;
+    ResponseCacheStats stats;
+
+    String etag(uint32_t version) const;
+    void respond(AsyncWebServerRequest* request, const String& body, const String& tag);
+    void drop(Entry& entry);
+    bool makeRoom(size_t length);
+};
+
+// Global instance
+extern ResponseCache responseCache;
+
+#endif // RESPONSE_CACHE_H
@@ -1,6 +1,6 @@
 #include "rtc_manager.h"
 #include "i2c_bus.h"
-#include <LittleFS.h>
+#include "config_store.h"
 
 // Global instance
 RTCManager rtcManager;
@@ -334,23 +334,14 @@ void RTCManager::loadConfig(const JsonDocument& doc) {
 }
 
 bool RTCManager::saveConfig() {
-    File file = LittleFS.open("/config.json", "r");
-    if (!file) {
-        Serial.println("[RTC] Failed to open config file for reading");
+    ConfigSectionView section = configStore.edit(ConfigSection::RTC);
+    if (!section.isValid()) {
+        Serial.println("[RTC] Config store not available");
         return false;
     }
 
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
-
-    if (error) {
-        Serial.printf("[RTC] JSON parse error: %s\n", error.c_str());
-        return false;
-    }
-
-    // Update RTC section
-    JsonObject rtc = doc["rtc"].to<JsonObject>();
+    // Update RTC section (written by configStore after debounce)
+    JsonObject rtc = section.obj();
     rtc["enabled"] = config.enabled;
     rtc["i2cAddress"] = config.i2cAddress;
     rtc["sdaPin"] = config.sdaPin;
@@ -360,15 +351,6 @@ bool RTCManager::saveConfig() {
     rtc["squareWaveMode"] = config.squareWaveMode;
     rtc["timezoneOffset"] = config.timezoneOffset;
 
-    file = LittleFS.open("/config.json", "w");
-    if (!file) {
-        Serial.println("[RTC] Failed to open config file for writing");
-        return false;
-    }
-
-    serializeJsonPretty(doc, file);
-    file.close();
-
     Serial.println("[RTC] Configuration saved");
     return true;
 }
@@ -0,0 +1,71 @@
+#ifndef STATS_SNAPSHOT_H
+#define STATS_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+
+// =============================================================================
+// Stats Snapshot (seqlock)
+// =============================================================================
+// Single-writer / multi-reader snapshot of a plain statistics struct. The
+// owning module mutates its private copy and calls publish(); readers on
+// other tasks (web handlers on the AsyncTCP task) call read() and always get
+// a consistent copy without taking a lock or blocking the writer.
+//
+// The sequence counter is odd while a publish is in progress; a reader
+// retries when it saw an odd value or the counter changed during its copy.
+
+#define STATS_SNAPSHOT_SPIN_LIMIT   64      // Retries before yielding to the writer
+
+template <typename T>
+class StatsSnapshot {
+public:
+    StatsSnapshot() : sequence(0) {
+        memset((void*)&data, 0, sizeof(T));
+    }
+
+    // Writer side (owner task only)
+    void publish(const T& value) {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        memcpy((void*)&data, &value, sizeof(T));
+
+        std::atomic_thread_fence(std::memory_order_release);
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Reader side (any task)
+    T read() const {
+        T copy;
+        uint32_t spins = 0;
+
+        while (true) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                memcpy(&copy, (const void*)&data, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) {
+                    return copy;
+                }
+            }
+
+            // Writer preempted mid-publish: let it finish
+            if (++spins >= STATS_SNAPSHOT_SPIN_LIMIT) {
+                spins = 0;
+                vTaskDelay(1);
+            }
+        }
+    }
+
+    // Incremented twice per publish (changes whenever the stats do)
+    uint32_t version() const { return sequence.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<uint32_t> sequence;
+    volatile T data;
+};
+
+#endif // STATS_SNAPSHOT_H
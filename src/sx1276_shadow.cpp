@@ -0,0 +1,276 @@
+#include "sx1276_shadow.h"
+#include <math.h>
+
+// Profile registers, ascending; adjacent addresses are written as one burst
+static const uint8_t PROFILE_REGS[SX1276_PROFILE_REG_COUNT] = {
+    SX1276_REG_FRF_MSB,
+    SX1276_REG_FRF_MID,
+    SX1276_REG_FRF_LSB,
+    SX1276_REG_PA_CONFIG,
+    SX1276_REG_OCP,
+    SX1276_REG_MODEM_CONFIG1,
+    SX1276_REG_MODEM_CONFIG2,
+    SX1276_REG_MODEM_CONFIG3,
+    SX1276_REG_DETECT_OPTIMIZE,
+    SX1276_REG_INVERT_IQ,
+    SX1276_REG_DETECTION_THRESHOLD,
+    SX1276_REG_SYNC_WORD,
+    SX1276_REG_INVERT_IQ2,
+    SX1276_REG_PA_DAC
+};
+
+// Index of FRF LSB in PROFILE_REGS (frequency is latched on its write)
+#define PROFILE_FRF_LSB_INDEX   2
+
+// LoRa bandwidths (kHz) in RegModemConfig1 code order
+static const float BANDWIDTHS[] = {
+    7.8, 10.4, 15.6, 20.8, 31.25, 41.7, 62.5, 125.0, 250.0, 500.0
+};
+
+SX1276Shadow::SX1276Shadow()
+    : spi(nullptr)
+    , pinNss(-1)
+{
+    memset(cache, 0, sizeof(cache));
+    memset(known, 0, sizeof(known));
+    memset(&stats, 0, sizeof(stats));
+}
+
+void SX1276Shadow::begin(SPIClass* bus, int8_t nss) {
+    spi = bus;
+    pinNss = nss;
+    sync();
+}
+
+void SX1276Shadow::sync() {
+    invalidate();
+
+    for (uint8_t i = 0; i < SX1276_PROFILE_REG_COUNT; i++) {
+        setKnown(PROFILE_REGS[i], readRegister(PROFILE_REGS[i]));
+    }
+
+    // Other cached registers
+    setKnown(SX1276_REG_OP_MODE, readRegister(SX1276_REG_OP_MODE));
+    setKnown(SX1276_REG_DIO_MAPPING1, readRegister(SX1276_REG_DIO_MAPPING1));
+    setKnown(SX1276_REG_FIFO_TX_BASE_ADDR, readRegister(SX1276_REG_FIFO_TX_BASE_ADDR));
+    setKnown(SX1276_REG_FIFO_RX_BASE_ADDR, readRegister(SX1276_REG_FIFO_RX_BASE_ADDR));
+    setKnown(SX1276_REG_PAYLOAD_LENGTH, readRegister(SX1276_REG_PAYLOAD_LENGTH));
+}
+
+void SX1276Shadow::invalidate() {
+    memset(known, 0, sizeof(known));
+}
+
+uint8_t SX1276Shadow::verify() {
+    uint8_t mismatches = 0;
+    for (uint8_t reg = 0; reg < sizeof(cache); reg++) {
+        if (isKnown(reg) && readRegister(reg) != cache[reg]) mismatches++;
+    }
+    return mismatches;
+}
+
+bool SX1276Shadow::buildProfile(RadioProfile& profile, uint32_t frequency, uint8_t sf,
+                                float bw, uint8_t cr, int8_t txPower, uint8_t syncWord,
+                                bool invertIq, bool crc) {
+    profile.valid = false;
+
+    if (frequency < 137000000UL || frequency > 1020000000UL) return false;
+    if (sf < 6 || sf > 12) return false;
+    if (cr < 5 || cr > 8) return false;
+    if (txPower < 2 || txPower > 20) return false;
+
+    int8_t bwCode = -1;
+    for (uint8_t i = 0; i < sizeof(BANDWIDTHS) / sizeof(BANDWIDTHS[0]); i++) {
+        if (fabsf(bw - BANDWIDTHS[i]) < 0.01f) {
+            bwCode = i;
+            break;
+        }
+    }
+    if (bwCode < 0) return false;
+
+    profile.frequency = frequency;
+    profile.spreadingFactor = sf;
+    profile.bandwidth = bw;
+    profile.codingRate = cr;
+    profile.txPower = txPower;
+    profile.syncWord = syncWord;
+    profile.invertIq = invertIq;
+    profile.crc = crc;
+
+    // FRF at the nominal frequency; the gateway trims it for crystal drift
+    trimProfile(profile, 0);
+
+    // PA_BOOST output; +18..+20 dBm needs the high power DAC and a higher OCP
+    if (txPower <= 17) {
+        profile.regs[3] = 0x80 | 0x70 | (txPower - 2);
+        profile.regs[4] = 0x20 | 0x0B;      // OCP on, 100 mA
+        profile.regs[13] = 0x84;
+    } else {
+        profile.regs[3] = 0x80 | 0x70 | (txPower - 5);
+        profile.regs[4] = 0x20 | 0x11;      // OCP on, 140 mA
+        profile.regs[13] = 0x87;
+    }
+
+    // Explicit header, CRC as requested
+    profile.regs[5] = (bwCode << 4) | ((cr - 4) << 1);
+    profile.regs[6] = (sf << 4) | (crc ? 0x04 : 0x00);
+
+    // Low data rate optimization above 16 ms symbols, AGC on
+    float symbolMs = (float)(1UL << sf) / bw;
+    profile.regs[7] = (symbolMs > 16.0f ? 0x08 : 0x00) | 0x04;
+
+    // SF6 needs its own detection settings
+    profile.regs[8] = (sf == 6) ? 0xC5 : 0xC3;
+    profile.regs[10] = (sf == 6) ? 0x0C : 0x0A;
+
+    // IQ polarity (values from the Semtech reference driver)
+    profile.regs[9] = invertIq ? 0x66 : 0x27;
+    profile.regs[12] = invertIq ? 0x19 : 0x1D;
+
+    profile.regs[11] = syncWord;
+
+    profile.valid = true;
+    return true;
+}
+
+bool SX1276Shadow::sameParameters(const RadioProfile& profile, uint32_t frequency, uint8_t sf,
+                                  float bw, uint8_t cr, int8_t txPower, bool invertIq, bool crc) {
+    return profile.valid &&
+           profile.frequency == frequency &&
+           profile.spreadingFactor == sf &&
+           fabsf(profile.bandwidth - bw) < 0.01f &&
+           profile.codingRate == cr &&
+           profile.txPower == txPower &&
+           profile.invertIq == invertIq &&
+           profile.crc == crc;
+}
+
+void SX1276Shadow::trimProfile(RadioProfile& profile, int32_t trimPpb) {
+    profile.trimPpb = trimPpb;
+
+    // FRF = f * 2^19 / 32 MHz, f corrected by the trim
+    int64_t frequency = (int64_t)profile.frequency +
+                        (int64_t)profile.frequency * trimPpb / 1000000000LL;
+    uint32_t frf = (uint32_t)(((uint64_t)frequency << 19) / SX1276_FXOSC);
+    profile.regs[0] = (frf >> 16) & 0xFF;
+    profile.regs[1] = (frf >> 8) & 0xFF;
+    profile.regs[2] = frf & 0xFF;
+}
+
+int32_t SX1276Shadow::feiToHz(const uint8_t fei[3], float bw) {
+    // 20-bit two's complement; Ferr = FEI * 2^24 / FXOSC * BW / 500 kHz
+    int32_t raw = ((int32_t)(fei[0] & 0x0F) << 16) | ((int32_t)fei[1] << 8) | fei[2];
+    if (raw & 0x80000) raw -= 0x100000;
+    return (int32_t)(raw * (16777216.0f / SX1276_FXOSC) * (bw / 500.0f));
+}
+
+uint8_t SX1276Shadow::applyProfile(const RadioProfile& profile) {
+    if (!profile.valid) return 0;
+
+    uint8_t written = 0;
+    uint8_t i = 0;
+
+    while (i < SX1276_PROFILE_REG_COUNT) {
+        // Block of adjacent register addresses starting at i
+        uint8_t end = i;
+        while (end + 1 < SX1276_PROFILE_REG_COUNT &&
+               PROFILE_REGS[end + 1] == PROFILE_REGS[end] + 1) {
+            end++;
+        }
+
+        // First and last byte in the block that differ from the cache
+        int8_t first = -1;
+        int8_t last = -1;
+        for (uint8_t j = i; j <= end; j++) {
+            uint8_t reg = PROFILE_REGS[j];
+            if (!isKnown(reg) || cache[reg] != profile.regs[j]) {
+                if (first < 0) first = j;
+                last = j;
+            }
+        }
+
+        if (first >= 0) {
+            // A new FRF only takes effect once the LSB is written
+            if (first <= PROFILE_FRF_LSB_INDEX && last < PROFILE_FRF_LSB_INDEX) {
+                last = PROFILE_FRF_LSB_INDEX;
+            }
+
+            uint8_t count = last - first + 1;
+            writeBurst(PROFILE_REGS[first], &profile.regs[first], count);
+            for (int8_t j = first; j <= last; j++) {
+                setKnown(PROFILE_REGS[j], profile.regs[j]);
+            }
+            written += count;
+        }
+
+        i = end + 1;
+    }
+
+    stats.profileSwitches++;
+    stats.bytesWritten += written;
+    stats.bytesSkipped += SX1276_PROFILE_REG_COUNT - written;
+    return written;
+}
+
+void SX1276Shadow::setMode(uint8_t mode) {
+    // The chip changes mode on its own (TX done, CAD done), so always write
+    uint8_t base = isKnown(SX1276_REG_OP_MODE) ? cache[SX1276_REG_OP_MODE]
+                                                 : readRegister(SX1276_REG_OP_MODE);
+    uint8_t value = (base & ~SX1276_MODE_MASK) | (mode & SX1276_MODE_MASK);
+
+    writeRegister(SX1276_REG_OP_MODE, value);
+    setKnown(SX1276_REG_OP_MODE, value);
+}
+
+void SX1276Shadow::writeCached(uint8_t reg, uint8_t value) {
+    if (isKnown(reg) && cache[reg] == value) return;
+
+    writeRegister(reg, value);
+    setKnown(reg, value);
+}
+
+uint8_t SX1276Shadow::readRegister(uint8_t reg) {
+    select();
+    spi->transfer(reg & 0x7F);
+    uint8_t value = spi->transfer(0x00);
+    deselect();
+    return value;
+}
+
+void SX1276Shadow::writeRegister(uint8_t reg, uint8_t value) {
+    select();
+    spi->transfer(reg | 0x80);
+    spi->transfer(value);
+    deselect();
+}
+
+void SX1276Shadow::readBurst(uint8_t reg, uint8_t* data, size_t length) {
+    select();
+    spi->transfer(reg & 0x7F);
+    memset(data, 0, length);
+    spi->transfer(data, length);
+    deselect();
+}
+
+void SX1276Shadow::writeBurst(uint8_t reg, const uint8_t* data, size_t length) {
+    select();
+    spi->transfer(reg | 0x80);
+    spi->writeBytes(data, length);
+    deselect();
+}
+
+void SX1276Shadow::setKnown(uint8_t reg, uint8_t value) {
+    cache[reg & 0x7F] = value;
+    known[(reg & 0x7F) >> 5] |= (1UL << (reg & 31));
+}
+
+void SX1276Shadow::select() {
+    spi->beginTransaction(SPISettings(SX1276_SPI_FREQUENCY, MSBFIRST, SPI_MODE0));
+    digitalWrite(pinNss, LOW);
+}
+
+void SX1276Shadow::deselect() {
+    digitalWrite(pinNss, HIGH);
+    spi->endTransaction();
+    stats.transactions++;
+}
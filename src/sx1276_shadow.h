@@ -0,0 +1,182 @@
+#ifndef SX1276_SHADOW_H
+#define SX1276_SHADOW_H
+
+#include <Arduino.h>
+#include <SPI.h>
+
+// =============================================================================
+// SX1276 Register Shadow
+// =============================================================================
+// Direct SPI access to the SX1276 with a cache of every register written
+// through it. Radio settings are precomputed into profiles (register images);
+// switching profile compares against the cache and writes only the bytes
+// that differ, one burst per run of adjacent registers. RadioLib is only
+// used for chip initialization; all later radio access (profiles, RX
+// read-out, TX, CAD) goes through this layer from the radio task.
+
+#ifndef SX1276_SPI_FREQUENCY
+#define SX1276_SPI_FREQUENCY            2000000     // Same as RadioLib's SX127x default
+#endif
+
+// LoRa mode registers
+#define SX1276_REG_FIFO                 0x00
+#define SX1276_REG_OP_MODE              0x01
+#define SX1276_REG_FRF_MSB              0x06
+#define SX1276_REG_FRF_MID              0x07
+#define SX1276_REG_FRF_LSB              0x08
+#define SX1276_REG_PA_CONFIG            0x09
+#define SX1276_REG_OCP                  0x0B
+#define SX1276_REG_FIFO_ADDR_PTR        0x0D
+#define SX1276_REG_FIFO_TX_BASE_ADDR    0x0E
+#define SX1276_REG_FIFO_RX_BASE_ADDR    0x0F
+#define SX1276_REG_FIFO_RX_CURRENT_ADDR 0x10
+#define SX1276_REG_IRQ_FLAGS            0x12
+#define SX1276_REG_RX_NB_BYTES          0x13
+#define SX1276_REG_MODEM_STAT           0x18
+#define SX1276_REG_PKT_SNR_VALUE        0x19
+#define SX1276_REG_PKT_RSSI_VALUE       0x1A
+#define SX1276_REG_RSSI_VALUE           0x1B
+#define SX1276_REG_MODEM_CONFIG1        0x1D
+#define SX1276_REG_MODEM_CONFIG2        0x1E
+#define SX1276_REG_PAYLOAD_LENGTH       0x22
+#define SX1276_REG_MODEM_CONFIG3        0x26
+#define SX1276_REG_FEI_MSB              0x28
+#define SX1276_REG_FEI_MID              0x29
+#define SX1276_REG_FEI_LSB              0x2A
+#define SX1276_REG_DETECT_OPTIMIZE      0x31
+#define SX1276_REG_INVERT_IQ            0x33
+#define SX1276_REG_DETECTION_THRESHOLD  0x37
+#define SX1276_REG_SYNC_WORD            0x39
+#define SX1276_REG_INVERT_IQ2           0x3B
+#define SX1276_REG_DIO_MAPPING1         0x40
+#define SX1276_REG_VERSION              0x42
+#define SX1276_REG_PA_DAC               0x4D
+
+// RegOpMode (LoRa mode bit 7 set)
+#define SX1276_MODE_MASK                0x07
+#define SX1276_MODE_LONG_RANGE          0x80        // LoRa (not FSK/OOK) mode
+#define SX1276_MODE_SLEEP               0x00
+#define SX1276_MODE_STANDBY             0x01
+#define SX1276_MODE_TX                  0x03
+#define SX1276_MODE_RX_CONTINUOUS       0x05
+#define SX1276_MODE_RX_SINGLE           0x06
+#define SX1276_MODE_CAD                 0x07
+
+// RegIrqFlags
+#define SX1276_IRQ_CAD_DETECTED         0x01
+#define SX1276_IRQ_CAD_DONE             0x04
+#define SX1276_IRQ_TX_DONE              0x08
+#define SX1276_IRQ_VALID_HEADER         0x10
+#define SX1276_IRQ_PAYLOAD_CRC_ERROR    0x20
+#define SX1276_IRQ_RX_DONE              0x40
+#define SX1276_IRQ_RX_TIMEOUT           0x80
+#define SX1276_IRQ_ALL                  0xFF
+
+// RegDioMapping1 (DIO0 function in bits 7-6)
+#define SX1276_DIO0_RX_DONE             0x00
+#define SX1276_DIO0_TX_DONE             0x40
+#define SX1276_DIO0_CAD_DONE            0x80
+
+// Packet RSSI offsets (RegPktRssiValue) for the LF and HF ports
+#define SX1276_HF_THRESHOLD             525000000UL
+#define SX1276_RSSI_OFFSET_LF           -164
+#define SX1276_RSSI_OFFSET_HF           -157
+
+// Crystal, FRF = f * 2^19 / FXOSC
+#define SX1276_FXOSC                    32000000UL
+
+// Registers that make up a radio profile (ascending address order)
+#define SX1276_PROFILE_REG_COUNT        14
+
+// Precomputed register image for one set of radio parameters
+struct RadioProfile {
+    bool valid;
+
+    // Parameters the image was built from
+    uint32_t frequency;        // Hz
+    uint8_t spreadingFactor;
+    float bandwidth;           // kHz
+    uint8_t codingRate;        // 5-8
+    int8_t txPower;            // dBm (PA_BOOST)
+    uint8_t syncWord;
+    bool invertIq;             // LoRaWAN downlinks
+    bool crc;
+    int32_t trimPpb;           // Crystal correction applied to FRF
+
+    uint8_t regs[SX1276_PROFILE_REG_COUNT];
+};
+
+// Register access statistics
+struct SX1276ShadowStats {
+    uint32_t profileSwitches;
+    uint32_t bytesWritten;      // Profile bytes sent to the chip
+    uint32_t bytesSkipped;      // Profile bytes already matching the cache
+    uint32_t transactions;      // SPI transactions (all access)
+};
+
+class SX1276Shadow {
+public:
+    SX1276Shadow();
+
+    // Attach to the bus after RadioLib initialized the chip, then read back
+    // the profile registers so the cache matches the hardware
+    void begin(SPIClass* spi, int8_t pinNss);
+    void sync();
+    void invalidate();
+
+    // Read back every cached register (profile, mode, DIO mapping, FIFO
+    // bases); returns how many no longer match the cache
+    uint8_t verify();
+
+    // Build a register image; false if a parameter is out of range
+    static bool buildProfile(RadioProfile& profile, uint32_t frequency, uint8_t sf,
+                             float bw, uint8_t cr, int8_t txPower, uint8_t syncWord,
+                             bool invertIq, bool crc);
+    static bool sameParameters(const RadioProfile& profile, uint32_t frequency, uint8_t sf,
+                               float bw, uint8_t cr, int8_t txPower, bool invertIq, bool crc);
+
+    // Move the FRF of a profile by a crystal correction (parts per billion);
+    // the nominal frequency in the profile is kept
+    static void trimProfile(RadioProfile& profile, int32_t trimPpb);
+
+    // Frequency error of the last frame from RegFeiMsb..Lsb (Hz, signal
+    // minus receiver)
+    static int32_t feiToHz(const uint8_t fei[3], float bw);
+
+    // Write the bytes of a profile that differ from the cache (standby only);
+    // returns the number of bytes written
+    uint8_t applyProfile(const RadioProfile& profile);
+
+    // Operating mode
+    void setMode(uint8_t mode);
+    uint8_t getMode() const { return cache[SX1276_REG_OP_MODE] & SX1276_MODE_MASK; }
+
+    // Cached single-register write (skipped when unchanged)
+    void writeCached(uint8_t reg, uint8_t value);
+
+    // Uncached access (FIFO, IRQ flags, status registers)
+    uint8_t readRegister(uint8_t reg);
+    void writeRegister(uint8_t reg, uint8_t value);
+    void readBurst(uint8_t reg, uint8_t* data, size_t length);
+    void writeBurst(uint8_t reg, const uint8_t* data, size_t length);
+
+    const SX1276ShadowStats& getStats() const { return stats; }
+    void resetStats() { memset(&stats, 0, sizeof(stats)); }
+
+private:
+    SPIClass* spi;
+    int8_t pinNss;
+
+    uint8_t cache[0x80];
+    uint32_t known[4];          // One bit per register: cache entry valid
+
+    SX1276ShadowStats stats;
+
+    bool isKnown(uint8_t reg) const { return known[reg >> 5] & (1UL << (reg & 31)); }
+    void setKnown(uint8_t reg, uint8_t value);
+
+    void select();
+    void deselect();
+};
+
+#endif // SX1276_SHADOW_H
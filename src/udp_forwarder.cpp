@@ -1,8 +1,10 @@
 #include "udp_forwarder.h"
+#include "airtime.h"
 #include <WiFi.h>  // Para WiFi.macAddress() no fallback de EUI
-#include <LittleFS.h>
+#include "config_store.h"
 #include <time.h>
 #include "ntp_manager.h"
+#include "packet_capture.h"
 
 // Global instance
 UDPForwarder udpForwarder;
@@ -12,13 +14,20 @@ const char UDPForwarder::base64Chars[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
 UDPForwarder::UDPForwarder()
-    : connected(false)
+    : region(nullptr)
+    , connected(false)
     , tokenCounter(0)
     , lastStatTime(0)
-    , lastPullTime(0) {
+    , lastPullTime(0)
+    , statsResetRequested(false) {
 
     memset(&stats, 0, sizeof(stats));
     setDefaultConfig();
+
+    // Static constructor, before Serial.begin(): no log here. loadConfig()
+    // resolves the configured region and reports a fallback
+    region = lorawanRegionFind(config.region);
+    if (region == nullptr) region = lorawanRegionDefault();
 }
 
 void UDPForwarder::setDefaultConfig() {
@@ -34,6 +43,20 @@ void UDPForwarder::setDefaultConfig() {
     config.altitude = 0;
 }
 
+void UDPForwarder::resolveRegion() {
+    region = lorawanRegionFind(config.region);
+    if (region != nullptr) return;
+
+    // Unknown or not compiled in
+    region = lorawanRegionDefault();
+    Serial.printf("[UDP] Region %s not available, using %s\n", config.region, region->name);
+}
+
+void UDPForwarder::setConfig(const ForwarderConfig& newConfig) {
+    config = newConfig;
+    resolveRegion();
+}
+
 bool UDPForwarder::begin() {
     Serial.println("[UDP] Initializing forwarder...");
 
@@ -51,6 +74,8 @@ bool UDPForwarder::begin() {
     }
 
     Serial.printf("[UDP] Gateway EUI: %s\n", getGatewayEuiString().c_str());
+
+    dutyCycle.setRegion(region);
     Serial.printf("[UDP] Server: %s:%d (up) / %d (down)\n",
                   config.serverHost, config.serverPortUp, config.serverPortDown);
 
@@ -101,6 +126,9 @@ void UDPForwarder::generateGatewayEui() {
     config.gatewayEui[6] = mac[4];
     config.gatewayEui[7] = mac[5];
 
+    // /api/server/config reports it: invalidate the cached body
+    configStore.touch(ConfigSection::SERVER);
+
     Serial.printf("[UDP] Generated EUI from MAC: %02X:%02X:%02X:%02X:%02X:%02X\n",
                   mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
 }
@@ -148,28 +176,21 @@ void UDPForwarder::loadConfig(const JsonDocument& doc) {
     config.longitude = server["longitude"] | 0.0;
     config.altitude = server["altitude"] | 0;
 
+    resolveRegion();
+
     Serial.printf("[UDP] Config loaded: %s:%d (region: %s)\n",
-                  config.serverHost, config.serverPortUp, config.region);
+                  config.serverHost, config.serverPortUp, region->name);
 }
 
 bool UDPForwarder::saveConfig() {
-    File file = LittleFS.open("/config.json", "r");
-    if (!file) {
-        Serial.println("[UDP] Cannot open config for reading");
-        return false;
-    }
-
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    DeserializationError error = deserializeJson(doc, file);
-    file.close();
-
-    if (error) {
-        Serial.println("[UDP] Failed to parse config");
+    ConfigSectionView section = configStore.edit(ConfigSection::SERVER);
+    if (!section.isValid()) {
+        Serial.println("[UDP] Config store not available");
         return false;
     }
 
-    // Update server section
-    JsonObject server = doc.createNestedObject("server");
+    // Update server section (written by configStore after debounce)
+    JsonObject server = section.obj();
     server["enabled"] = config.enabled;
     server["host"] = config.serverHost;
     server["port_up"] = config.serverPortUp;
@@ -181,19 +202,17 @@ bool UDPForwarder::saveConfig() {
     server["longitude"] = config.longitude;
     server["altitude"] = config.altitude;
 
-    file = LittleFS.open("/config.json", "w");
-    if (!file) {
-        Serial.println("[UDP] Cannot open config for writing");
-        return false;
-    }
-
-    serializeJsonPretty(doc, file);
-    file.close();
-
     return true;
 }
 
 void UDPForwarder::update() {
+    // Reset requested from the web task is applied by the owner
+    if (statsResetRequested) {
+        statsResetRequested = false;
+        memset(&stats, 0, sizeof(stats));
+        statsSnapshot.publish(stats);
+    }
+
     if (!connected || !config.enabled) return;
 
     unsigned long now = millis();
@@ -212,6 +231,9 @@ void UDPForwarder::update() {
 
     // Check for incoming packets (PULL_ACK, PULL_RESP)
     receivePackets();
+
+    updateDutyStats();
+    statsSnapshot.publish(stats);
 }
 
 bool UDPForwarder::forwardPacket(const LoRaPacket& packet) {
@@ -224,6 +246,7 @@ bool UDPForwarder::forwardPacket(const LoRaPacket& packet) {
     if (sendPushData(jsonData.c_str(), jsonData.length())) {
         stats.pushDataSent++;
         stats.lastPushTime = millis();
+        statsSnapshot.publish(stats);
         return true;
     }
 
@@ -240,8 +263,8 @@ String UDPForwarder::buildRxpkJson(const LoRaPacket& packet) {
     // Time (ISO 8601 format)
     rxpk["time"] = getIsoTimestamp();
 
-    // Channel (always 0 for single channel gateway)
-    rxpk["chan"] = 0;
+    // Channel (index in the hopping plan, 0 on a fixed frequency)
+    rxpk["chan"] = packet.channel;
 
     // RF chain (always 0)
     rxpk["rfch"] = 0;
@@ -249,8 +272,8 @@ String UDPForwarder::buildRxpkJson(const LoRaPacket& packet) {
     // Frequency in MHz
     rxpk["freq"] = packet.frequency / 1000000.0;
 
-    // Signal status (1 = CRC OK)
-    rxpk["stat"] = 1;
+    // Signal status (1 = CRC OK, -1 = CRC failed)
+    rxpk["stat"] = packet.crcOk ? 1 : -1;
 
     // Modulation (always LORA for this gateway)
     rxpk["modu"] = "LORA";
@@ -272,6 +295,9 @@ String UDPForwarder::buildRxpkJson(const LoRaPacket& packet) {
     // SNR
     rxpk["lsnr"] = packet.snr;
 
+    // Frequency offset of the frame (Hz, from the FEI registers)
+    rxpk["foff"] = packet.freqOffset;
+
     // Payload size
     rxpk["size"] = packet.length;
 
@@ -453,13 +479,13 @@ void UDPForwarder::handlePullResp(const uint8_t* data, size_t length, uint16_t t
     }
 
     stats.downlinksReceived++;
-    processTxPacket(doc);
+    const char* txError = processTxPacket(doc);
 
     // Send TX_ACK
-    sendTxAck(token);
+    sendTxAck(token, txError);
 }
 
-void UDPForwarder::processTxPacket(const JsonDocument& doc) {
+const char* UDPForwarder::processTxPacket(const JsonDocument& doc) {
     JsonObjectConst txpk = doc["txpk"];
 
     // Extract TX parameters
@@ -470,13 +496,16 @@ void UDPForwarder::processTxPacket(const JsonDocument& doc) {
     const char* datr = txpk["datr"] | "SF7BW125";
     const char* codr = txpk["codr"] | "4/5";
     bool ipol = txpk["ipol"] | true;
+    bool ncrc = txpk["ncrc"] | false;
     const char* data = txpk["data"] | "";
 
     // Parse data rate (e.g., "SF7BW125")
-    uint8_t sf = 7;
-    float bw = 125.0;
-    if (strlen(datr) >= 7) {
-        sscanf(datr, "SF%hhuBW%f", &sf, &bw);
+    uint8_t sf;
+    uint16_t bw;
+    if (strcmp(modu, "LORA") != 0 || !lorawanParseDatr(datr, sf, bw)) {
+        stats.downlinksInvalid++;
+        Serial.printf("[UDP] TX rejected: unsupported data rate %s %s\n", modu, datr);
+        return TX_ACK_ERR_PARAM;
     }
 
     // Parse coding rate (e.g., "4/5")
@@ -491,23 +520,81 @@ void UDPForwarder::processTxPacket(const JsonDocument& doc) {
 
     if (payloadLen == 0) {
         Serial.println("[UDP] Failed to decode TX payload");
-        return;
+        return nullptr;
+    }
+
+    // Regional parameters: band, downlink data rate, payload size, dwell time, EIRP
+    uint32_t frequency = (uint32_t)(freq * 1000000 + 0.5);
+    uint32_t airtimeUs = loraTimeOnAirUs(sf, bw, cr, payloadLen);
+
+    if (!lorawanRegionContains(region, frequency)) {
+        stats.downlinksInvalid++;
+        Serial.printf("[UDP] TX rejected: %.3f MHz outside %s\n", freq, region->name);
+        return TX_ACK_ERR_FREQ;
     }
 
-    Serial.printf("[UDP] TX: freq=%.2f MHz, SF%d, BW%.0f, %d bytes\n",
-                  freq, sf, bw, payloadLen);
+    int8_t dataRate = lorawanFindDataRate(region, sf, bw, true);
+    bool dwellLimited = region->downlinkDwellMs > 0;
+    if (dataRate < 0 ||
+        payloadLen > lorawanMaxPhyPayload(region, dataRate, dwellLimited) ||
+        (dwellLimited && airtimeUs > region->downlinkDwellMs * 1000UL)) {
+        stats.downlinksInvalid++;
+        Serial.printf("[UDP] TX rejected: SF%dBW%d, %d bytes not allowed in %s\n",
+                      sf, bw, payloadLen, region->name);
+        return TX_ACK_ERR_PARAM;
+    }
+
+    if (powe > region->maxEirpDbm) {
+        stats.downlinksPowerClamped++;
+        powe = region->maxEirpDbm;
+    }
+
+    // Sub-band duty cycle over the last hour
+    if (!dutyCycle.check(frequency, airtimeUs)) {
+        stats.downlinksDutyRejected++;
+        Serial.printf("[UDP] TX rejected: %.2f MHz sub-band over duty-cycle budget (%u us)\n",
+                      freq, airtimeUs);
+        return TX_ACK_ERR_DUTY_CYCLE;
+    }
+
+    Serial.printf("[UDP] TX: freq=%.2f MHz, DR%d (SF%d, BW%d), %d bytes, %u us on air\n",
+                  freq, dataRate, sf, bw, payloadLen, airtimeUs);
 
     // Schedule transmission
     // Note: Single channel gateway cannot do proper timing, send immediately
     // TODO: Implement timing for Class A devices
 
-    if (loraGateway.transmit(payload, payloadLen,
-                             (uint32_t)(freq * 1000000),
-                             sf, bw, cr)) {
+    int16_t state = loraGateway.transmit(payload, payloadLen, frequency, sf, bw, cr, powe, ipol,
+                                         !ncrc);
+    if (state == RADIOLIB_ERR_NONE) {
         stats.downlinksSent++;
+        stats.txAirtimeUs += airtimeUs;
+        dutyCycle.record(frequency, airtimeUs);
+        packetCapture.recordDownlink(payload, payloadLen, frequency, sf, bw);
         Serial.println("[UDP] Downlink transmitted");
-    } else {
-        Serial.println("[UDP] Downlink transmission failed");
+        return nullptr;
+    }
+
+    if (state == RADIO_CMD_ERR_CHANNEL_BUSY) {
+        stats.downlinksChannelBusy++;
+        Serial.println("[UDP] Downlink dropped: channel busy (LBT)");
+        return TX_ACK_ERR_CHANNEL_BUSY;
+    }
+
+    // Anything else never went out: the server must not count it as sent
+    stats.downlinksFailed++;
+    Serial.printf("[UDP] Downlink transmission failed (%d)\n", state);
+    switch (state) {
+        case RADIO_CMD_ERR_INVALID_PARAM:   return TX_ACK_ERR_PARAM;
+        case RADIO_CMD_ERR_QUEUE_FULL:      return TX_ACK_ERR_QUEUE_FULL;
+        default:                            return TX_ACK_ERR_INTERNAL;
+    }
+}
+
+void UDPForwarder::updateDutyStats() {
+    stats.dutyBandCount = dutyCycle.getBandCount();
+    for (uint8_t i = 0; i < stats.dutyBandCount; i++) {
+        dutyCycle.getUsage(i, stats.dutyBands[i]);
     }
 }
 
@@ -652,7 +739,7 @@ size_t UDPForwarder::base64Decode(const char* encoded, uint8_t* output, size_t m
 }
 
 String UDPForwarder::getStatusJson() {
-    DynamicJsonDocument doc(1024);
+    DynamicJsonDocument doc(2048);
 
     doc["connected"] = connected;
     doc["enabled"] = config.enabled;
@@ -673,10 +760,12 @@ String UDPForwarder::getStatusJson() {
     cfg["gateway_eui"] = getGatewayEuiString();
     cfg["description"] = config.description;
     cfg["region"] = config.region;
+    cfg["active_region"] = region->name;
     cfg["latitude"] = config.latitude;
     cfg["longitude"] = config.longitude;
     cfg["altitude"] = config.altitude;
 
+    ForwarderStats stats = getStatsSnapshot();
     JsonObject st = doc.createNestedObject("stats");
     st["push_data_sent"] = stats.pushDataSent;
     st["push_ack_received"] = stats.pushAckReceived;
@@ -686,6 +775,24 @@ String UDPForwarder::getStatusJson() {
     st["tx_ack_sent"] = stats.txAckSent;
     st["downlinks_received"] = stats.downlinksReceived;
     st["downlinks_sent"] = stats.downlinksSent;
+    st["downlinks_duty_rejected"] = stats.downlinksDutyRejected;
+    st["downlinks_invalid"] = stats.downlinksInvalid;
+    st["downlinks_power_clamped"] = stats.downlinksPowerClamped;
+    st["downlinks_channel_busy"] = stats.downlinksChannelBusy;
+    st["downlinks_failed"] = stats.downlinksFailed;
+    st["tx_airtime_ms"] = (uint32_t)(stats.txAirtimeUs / 1000);
+
+    // Rolling-hour duty cycle per regulated sub-band
+    JsonArray duty = doc.createNestedArray("duty_cycle");
+    for (uint8_t i = 0; i < stats.dutyBandCount; i++) {
+        const DutyBandUsage& band = stats.dutyBands[i];
+        JsonObject entry = duty.createNestedObject();
+        entry["band"] = band.name;
+        entry["used_ms"] = band.usedUs / 1000;
+        entry["budget_ms"] = band.budgetUs / 1000;
+        entry["used_pct"] = band.budgetUs > 0 ? band.usedUs * 100.0f / band.budgetUs : 0;
+        entry["rejected"] = band.rejected;
+    }
 
     if (stats.lastAckTime > 0) {
         unsigned long ago = (millis() - stats.lastAckTime) / 1000;
@@ -698,5 +805,5 @@ String UDPForwarder::getStatusJson() {
 }
 
 void UDPForwarder::resetStats() {
-    memset(&stats, 0, sizeof(stats));
+    statsResetRequested = true;
 }
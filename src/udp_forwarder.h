@@ -4,10 +4,13 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include "config.h"
+#include "stats_snapshot.h"
 #include "lora_gateway.h"
 #include "network_manager.h"
+#include "duty_cycle.h"
+#include "lorawan_region.h"
 
-// LoRaWAN Region IDs
+// LoRaWAN Region IDs (names in the regional parameter tables)
 #define REGION_EU868    "EU868"
 #define REGION_US915    "US915"
 #define REGION_AU915    "AU915"
@@ -17,6 +20,14 @@
 #define REGION_RU864    "RU864"
 #define REGION_DEFAULT  REGION_US915
 
+// TX_ACK errors
+#define TX_ACK_ERR_DUTY_CYCLE   "DUTY_CYCLE_OVERFLOW"   // Over the sub-band duty-cycle budget
+#define TX_ACK_ERR_FREQ         "TX_FREQ"               // Outside the regional band
+#define TX_ACK_ERR_PARAM        "TX_PARAM_ERROR"        // Data rate, payload size or dwell time
+#define TX_ACK_ERR_CHANNEL_BUSY "COLLISION_PACKET"      // LBT: channel occupied by another transmission
+#define TX_ACK_ERR_QUEUE_FULL   "QUEUE_FULL"            // Radio command queue full
+#define TX_ACK_ERR_INTERNAL     "INTERNAL_ERROR"        // Radio failed to transmit (timeout, radio down)
+
 // Forwarder configuration
 struct ForwarderConfig {
     bool enabled;
@@ -41,9 +52,19 @@ struct ForwarderStats {
     uint32_t txAckSent;
     uint32_t downlinksReceived;
     uint32_t downlinksSent;
+    uint32_t downlinksDutyRejected;     // Over the sub-band duty-cycle budget
+    uint32_t downlinksInvalid;          // Rejected by the regional parameters
+    uint32_t downlinksPowerClamped;     // TX power above the regional max EIRP
+    uint32_t downlinksChannelBusy;      // Dropped by listen-before-talk
+    uint32_t downlinksFailed;           // Radio did not transmit (any other error)
+    uint64_t txAirtimeUs;               // Downlink time on air
     unsigned long lastPushTime;
     unsigned long lastPullTime;
     unsigned long lastAckTime;
+
+    // Rolling-hour usage per duty-cycle sub-band
+    uint8_t dutyBandCount;
+    DutyBandUsage dutyBands[DUTY_MAX_BANDS];
 };
 
 class UDPForwarder {
@@ -61,14 +82,23 @@ public:
 
     // Configuration
     ForwarderConfig& getConfig() { return config; }
-    ForwarderStats& getStats() { return stats; }
+    void setConfig(const ForwarderConfig& newConfig);     // Resolves the region again
     bool isConnected() const { return connected; }
 
+    // Statistics (owner side, loop task only)
+    ForwarderStats& getStats() { return stats; }
+
+    // Statistics (any task, consistent copy)
+    ForwarderStats getStatsSnapshot() const { return statsSnapshot.read(); }
+
     // Status
     String getStatusJson();
-    void resetStats();
+    void resetStats();      // Applied by the loop task on next update()
     String getGatewayEuiString();
 
+    // Regional parameters of the configured region (resolved by loadConfig/setConfig)
+    const LoRaRegion* getRegion() const { return region; }
+
     // Health check interface for NetworkManager
     /**
      * @brief Get timestamp of last ACK received (PUSH_ACK or PULL_ACK)
@@ -87,7 +117,12 @@ private:
     // Nota: UDP agora eh gerenciado pelo NetworkManager
     // WiFiUDP udp; // REMOVIDO - usar networkManager->udpXXX()
     ForwarderConfig config;
+    const LoRaRegion* region;
     ForwarderStats stats;
+    StatsSnapshot<ForwarderStats> statsSnapshot;
+    volatile bool statsResetRequested;
+
+    DutyCycleLedger dutyCycle;
 
     bool connected;
     uint16_t tokenCounter;
@@ -102,6 +137,7 @@ private:
     // Internal methods
     void setDefaultConfig();
     void generateGatewayEui();
+    void resolveRegion();
 
     // Semtech protocol methods
     bool sendPushData(const char* jsonData, size_t length);
@@ -111,7 +147,8 @@ private:
 
     void receivePackets();
     void handlePullResp(const uint8_t* data, size_t length, uint16_t token);
-    void processTxPacket(const JsonDocument& txpk);
+    const char* processTxPacket(const JsonDocument& txpk);    // TX_ACK error or nullptr
+    void updateDutyStats();
 
     // Helper methods
     String buildRxpkJson(const LoRaPacket& packet);
@@ -0,0 +1,224 @@
+#include "uplink_scheduler.h"
+#include "udp_forwarder.h"
+
+// Global instance
+UplinkScheduler uplinkScheduler;
+
+static const char* const CLASS_NAMES[UPLINK_CLASS_COUNT] = {
+    "join",
+    "confirmed",
+    "unconfirmed",
+    "other"
+};
+
+UplinkScheduler::UplinkScheduler()
+    : freeMask((1UL << UPLINK_QUEUE_SIZE) - 1)
+    , depth(0)
+    , statsResetRequested(false) {
+
+    memset(queues, 0, sizeof(queues));
+    memset(&stats, 0, sizeof(stats));
+}
+
+// ================== Classes ==================
+
+UplinkClass UplinkScheduler::classify(const LoRaWANHeader& header) {
+    if (!header.valid) return UplinkClass::OTHER;
+
+    switch (header.mtype) {
+        case LoRaWANMType::JOIN_REQUEST:
+        case LoRaWANMType::REJOIN_REQUEST:
+            return UplinkClass::JOIN;
+        case LoRaWANMType::CONFIRMED_UP:
+            return UplinkClass::CONFIRMED;
+        case LoRaWANMType::UNCONFIRMED_UP:
+            return UplinkClass::UNCONFIRMED;
+        default:
+            return UplinkClass::OTHER;
+    }
+}
+
+const char* UplinkScheduler::className(UplinkClass cls) {
+    uint8_t index = (uint8_t)cls;
+    return index < UPLINK_CLASS_COUNT ? CLASS_NAMES[index] : "unknown";
+}
+
+uint32_t UplinkScheduler::windowUs(UplinkClass cls) {
+    switch (cls) {
+        case UplinkClass::JOIN:
+            return (UPLINK_JOIN_WINDOW_MS - UPLINK_SERVER_MARGIN_MS) * 1000UL;
+        case UplinkClass::CONFIRMED:
+            return (UPLINK_CONFIRMED_WINDOW_MS - UPLINK_SERVER_MARGIN_MS) * 1000UL;
+        default:
+            return UPLINK_DATA_MAX_AGE_MS * 1000UL;
+    }
+}
+
+// ================== Queues ==================
+
+void UplinkScheduler::push(UplinkClass cls, uint8_t index) {
+    ClassQueue& queue = queues[(uint8_t)cls];
+    queue.slots[(queue.head + queue.count) % UPLINK_QUEUE_SIZE] = index;
+    queue.count++;
+    depth++;
+    if (depth > stats.maxDepth) stats.maxDepth = depth;
+}
+
+uint8_t UplinkScheduler::pop(UplinkClass cls) {
+    ClassQueue& queue = queues[(uint8_t)cls];
+    uint8_t index = queue.slots[queue.head];
+    queue.head = (queue.head + 1) % UPLINK_QUEUE_SIZE;
+    queue.count--;
+    depth--;
+    return index;
+}
+
+bool UplinkScheduler::enqueue(const LoRaPacket& packet, const LoRaWANHeader& header) {
+    UplinkClass cls = classify(header);
+    stats.classes[(uint8_t)cls].queued++;
+
+    if (freeMask == 0) {
+        // Full: push out the oldest frame of the lowest class not above this one
+        int8_t victim = -1;
+        for (int8_t c = UPLINK_CLASS_COUNT - 1; c >= (int8_t)cls; c--) {
+            if (queues[c].count > 0) {
+                victim = c;
+                break;
+            }
+        }
+        if (victim < 0) {
+            stats.classes[(uint8_t)cls].overflow++;
+            Serial.printf("[Uplink] Queue full, %s frame dropped\n", className(cls));
+            return false;
+        }
+
+        freeMask |= 1UL << pop((UplinkClass)victim);
+        stats.classes[victim].overflow++;
+        Serial.printf("[Uplink] Queue full, oldest %s frame dropped\n", className((UplinkClass)victim));
+    }
+
+    uint8_t index = __builtin_ctz(freeMask);
+    freeMask &= ~(1UL << index);
+    pool[index] = packet;
+    push(cls, index);
+    return true;
+}
+
+void UplinkScheduler::dropStale(uint32_t now) {
+    for (uint8_t c = 0; c < UPLINK_CLASS_COUNT; c++) {
+        UplinkClass cls = (UplinkClass)c;
+        uint32_t window = windowUs(cls);
+
+        // FIFO per class: only the head can be the oldest
+        while (queues[c].count > 0 && now - pool[peek(cls)].timestamp > window) {
+            uint8_t index = pop(cls);
+            freeMask |= 1UL << index;
+            stats.classes[c].stale++;
+            Serial.printf("[Uplink] %s frame dropped, %lu ms old\n", className(cls),
+                          (unsigned long)((now - pool[index].timestamp) / 1000));
+        }
+    }
+}
+
+int8_t UplinkScheduler::selectNext(uint32_t now) const {
+    int8_t best = -1;
+    int32_t bestRemaining = 0;
+
+    for (uint8_t c = 0; c < UPLINK_CLASS_COUNT; c++) {
+        if (queues[c].count == 0) continue;
+
+        UplinkClass cls = (UplinkClass)c;
+        uint32_t age = now - pool[peek(cls)].timestamp;
+        int32_t remaining = (int32_t)(windowUs(cls) - age);
+        if (best < 0 || remaining < bestRemaining) {
+            best = c;
+            bestRemaining = remaining;
+        }
+    }
+    return best;
+}
+
+// ================== Loop ==================
+
+void UplinkScheduler::service(bool serverReachable) {
+    if (statsResetRequested) {
+        statsResetRequested = false;
+        memset(&stats, 0, sizeof(stats));
+        stats.maxDepth = depth;
+    }
+
+    dropStale(micros());
+
+    unsigned long start = millis();
+    while (serverReachable && depth > 0) {
+        int8_t c = selectNext(micros());
+        if (c < 0) break;
+
+        UplinkClass cls = (UplinkClass)c;
+        uint8_t index = pop(cls);
+        const LoRaPacket& packet = pool[index];
+        UplinkClassStats& classStats = stats.classes[c];
+
+        if (udpForwarder.forwardPacket(packet)) {
+            // CRC-failed frames are not counted as forwarded uplinks
+            if (packet.crcOk) loraGateway.recordForwarded(packet.timestamp);
+
+            uint32_t wait = micros() - packet.timestamp;
+            classStats.forwarded++;
+            classStats.waitLastUs = wait;
+            if (wait > classStats.waitMaxUs) classStats.waitMaxUs = wait;
+            classStats.waitSamples++;
+            classStats.waitTotalUs += wait;
+            Serial.printf("[Uplink] %s frame forwarded (%lu ms after RX)\n",
+                          className(cls), (unsigned long)(wait / 1000));
+        } else {
+            classStats.failed++;
+            Serial.printf("[Uplink] Failed to forward %s frame\n", className(cls));
+        }
+        freeMask |= 1UL << index;
+
+        // A slow send ages everything still waiting
+        if (millis() - start >= UPLINK_FORWARD_BUDGET_MS) break;
+        dropStale(micros());
+    }
+
+    publishStats();
+}
+
+void UplinkScheduler::publishStats() {
+    for (uint8_t c = 0; c < UPLINK_CLASS_COUNT; c++) {
+        stats.classes[c].depth = queues[c].count;
+    }
+    stats.depth = depth;
+    snapshot.publish(stats);
+}
+
+// ================== Status ==================
+
+void UplinkScheduler::getStatusJson(JsonObject obj) const {
+    UplinkSchedulerStats s = getStatsSnapshot();
+
+    obj["depth"] = s.depth;
+    obj["max_depth"] = s.maxDepth;
+    obj["capacity"] = UPLINK_QUEUE_SIZE;
+
+    for (uint8_t c = 0; c < UPLINK_CLASS_COUNT; c++) {
+        const UplinkClassStats& cls = s.classes[c];
+        JsonObject entry = obj.createNestedObject(className((UplinkClass)c));
+        entry["queued"] = cls.queued;
+        entry["forwarded"] = cls.forwarded;
+        entry["failed"] = cls.failed;
+        entry["stale"] = cls.stale;
+        entry["overflow"] = cls.overflow;
+        entry["depth"] = cls.depth;
+        entry["window_ms"] = windowUs((UplinkClass)c) / 1000;
+        entry["wait_last_ms"] = cls.waitLastUs / 1000;
+        entry["wait_max_ms"] = cls.waitMaxUs / 1000;
+        entry["wait_avg_ms"] = cls.waitSamples > 0
+            ? (uint32_t)(cls.waitTotalUs / cls.waitSamples / 1000) : 0;
+    }
+}
+
+void UplinkScheduler::resetStats() {
+    statsResetRequested = true;
+}
@@ -0,0 +1,115 @@
+#ifndef UPLINK_SCHEDULER_H
+#define UPLINK_SCHEDULER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "stats_snapshot.h"
+#include "lora_gateway.h"
+#include "lorawan_frame.h"
+
+// =============================================================================
+// Uplink Scheduler
+// =============================================================================
+// Sits between the radio queue and UDPForwarder::forwardPacket(). With a
+// fast backhaul every frame leaves on the same loop pass; when forwarding is
+// slow (Ethernet through the serial bridge) frames wait here and the order
+// decides which RX windows are still met.
+//
+// Frames are classified by MType, one FIFO per class. Each class has a
+// window after reception within which the server must have the frame: the
+// join-accept delay for join-requests, RECEIVE_DELAY2 for confirmed uplinks
+// (less a margin for the server round trip). The next frame sent is the
+// class head with the earliest deadline (earliest-deadline-first); within a
+// class FIFO order is deadline order. A frame whose window has passed is
+// dropped, since the server could no longer answer it and the device will
+// retransmit. Unconfirmed uplinks only have a maximum age.
+//
+// Forwarding stops after UPLINK_FORWARD_BUDGET_MS per loop pass so the
+// radio queue is drained (and reclassified) between slow sends.
+// Runs on the loop task; statistics are published through a seqlock snapshot.
+
+#define UPLINK_QUEUE_SIZE           16      // Frames held across all classes
+#define UPLINK_FORWARD_BUDGET_MS    50      // Forwarding time per loop pass (at least one frame)
+#define UPLINK_SERVER_MARGIN_MS     400     // Server round trip before the RX window
+
+// Window after reception per class
+#define UPLINK_JOIN_WINDOW_MS       6000    // JOIN_ACCEPT_DELAY2
+#define UPLINK_CONFIRMED_WINDOW_MS  2000    // RECEIVE_DELAY2
+#define UPLINK_DATA_MAX_AGE_MS      30000   // Unconfirmed and other frames
+
+// Classes in priority order (ties on deadline go to the lower index)
+enum class UplinkClass : uint8_t {
+    JOIN = 0,           // Join- and rejoin-requests
+    CONFIRMED,          // Confirmed data up
+    UNCONFIRMED,        // Unconfirmed data up
+    OTHER,              // Proprietary, downlinks of other gateways, undecodable
+    COUNT
+};
+
+#define UPLINK_CLASS_COUNT  ((uint8_t)UplinkClass::COUNT)
+
+struct UplinkClassStats {
+    uint32_t queued;
+    uint32_t forwarded;
+    uint32_t failed;            // forwardPacket() returned false
+    uint32_t stale;             // Window passed while waiting
+    uint32_t overflow;          // Pushed out by a higher class (or rejected when full)
+    uint32_t waitLastUs;        // Reception to forwarded
+    uint32_t waitMaxUs;
+    uint32_t waitSamples;
+    uint64_t waitTotalUs;
+    uint8_t depth;
+};
+
+struct UplinkSchedulerStats {
+    UplinkClassStats classes[UPLINK_CLASS_COUNT];
+    uint8_t depth;
+    uint8_t maxDepth;
+};
+
+class UplinkScheduler {
+public:
+    UplinkScheduler();
+
+    // Loop task
+    bool enqueue(const LoRaPacket& packet, const LoRaWANHeader& header);
+    void service(bool serverReachable);
+
+    // Any task
+    UplinkSchedulerStats getStatsSnapshot() const { return snapshot.read(); }
+    void getStatusJson(JsonObject obj) const;
+    void resetStats();      // Applied by the loop task on next service()
+
+    static UplinkClass classify(const LoRaWANHeader& header);
+    static const char* className(UplinkClass cls);
+
+private:
+    // Shared frame pool; each class keeps a ring of pool indices
+    struct ClassQueue {
+        uint8_t slots[UPLINK_QUEUE_SIZE];
+        uint8_t head;
+        uint8_t count;
+    };
+
+    LoRaPacket pool[UPLINK_QUEUE_SIZE];
+    uint32_t freeMask;                      // Bit i: pool[i] unused
+    ClassQueue queues[UPLINK_CLASS_COUNT];
+    uint8_t depth;
+
+    UplinkSchedulerStats stats;
+    StatsSnapshot<UplinkSchedulerStats> snapshot;
+    volatile bool statsResetRequested;
+
+    static uint32_t windowUs(UplinkClass cls);
+    uint8_t peek(UplinkClass cls) const { return queues[(uint8_t)cls].slots[queues[(uint8_t)cls].head]; }
+    void push(UplinkClass cls, uint8_t index);
+    uint8_t pop(UplinkClass cls);
+    void dropStale(uint32_t now);
+    int8_t selectNext(uint32_t now) const;
+    void publishStats();
+};
+
+// Global instance
+extern UplinkScheduler uplinkScheduler;
+
+#endif // UPLINK_SCHEDULER_H
@@ -12,22 +12,30 @@
 #include "gps_manager.h"
 #include "rtc_manager.h"
 #include "network_manager.h"
+#include "wifi_connector.h"
+#include "boot_profiler.h"
+#include "config_store.h"
+#include "config_snapshot.h"
+#include "auto_tuner.h"
+#include "packet_filter.h"
+#include "device_table.h"
+#include "uplink_scheduler.h"
+#include "bad_frame_log.h"
+#include "packet_capture.h"
+#include "packet_stream.h"
+#include "metrics_hub.h"
+#include "response_cache.h"
 
 // Global instance
 WebServerManager webServer;
 
-// WiFi network structure (must match main.cpp)
-struct WiFiNetwork {
-    String ssid;
-    String password;
-};
-
 // External references
 extern bool wifiConnectedToInternet;
 extern String wifiHostname;
 extern String wifiSSID;
 extern String wifiPassword;
 extern bool wifiAPMode;
+extern volatile bool peripheralsReady;
 extern std::vector<WiFiNetwork> wifiNetworks;
 
 WebServerManager::WebServerManager()
@@ -95,6 +103,34 @@ void WebServerManager::setupRoutes() {
         }
     );
 
+    // Channel/SF auto-tuning
+    server.on("/api/lora/autotune", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleAutoTune(request);
+    });
+
+    server.on("/api/lora/autotune", HTTP_POST,
+        [](AsyncWebServerRequest *request) {},
+        nullptr,
+        [this](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+            handleAutoTunePost(request, data, len, index, total);
+        }
+    );
+
+    // Noise floor per frequency
+    server.on("/api/lora/noise", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleNoiseFloor(request);
+    });
+
+    // Last frames received with a CRC error
+    server.on("/api/lora/badframes", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleBadFrames(request);
+    });
+
+    // Per-device RF statistics (paginated)
+    server.on("/api/devices", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleDevices(request);
+    });
+
     // Server configuration
     server.on("/api/server/config", HTTP_GET, [this](AsyncWebServerRequest *request) {
         handleServerConfig(request);
@@ -108,6 +144,36 @@ void WebServerManager::setupRoutes() {
         }
     );
 
+    // Uplink forwarding rules
+    server.on("/api/filter", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleFilter(request);
+    });
+
+    server.on("/api/filter", HTTP_POST,
+        [](AsyncWebServerRequest *request) {},
+        nullptr,
+        [this](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+            handleFilterPost(request, data, len, index, total);
+        }
+    );
+
+    // Packet capture (pcap first: /api/capture also matches its subpaths)
+    server.on("/api/capture/pcap", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleCapturePcap(request);
+    });
+
+    server.on("/api/capture", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleCapture(request);
+    });
+
+    server.on("/api/capture", HTTP_POST,
+        [](AsyncWebServerRequest *request) {},
+        nullptr,
+        [this](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+            handleCapturePost(request, data, len, index, total);
+        }
+    );
+
     // WiFi configuration
     server.on("/api/wifi/config", HTTP_GET, [this](AsyncWebServerRequest *request) {
         handleWiFiConfig(request);
@@ -155,6 +221,10 @@ void WebServerManager::setupRoutes() {
         }
     );
 
+    server.on("/api/lcd/status", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        handleLCDStatus(request);
+    });
+
     // Buzzer configuration
     server.on("/api/buzzer/config", HTTP_GET, [this](AsyncWebServerRequest *request) {
         handleBuzzerConfig(request);
@@ -314,6 +384,7 @@ void WebServerManager::setupRoutes() {
             request->send(200, "application/json", "{\"success\":true,\"message\":\"Firmware updated, restarting...\"}");
 
             // Restart after response is sent
+            configStore.flush();
             delay(500);
             ESP.restart();
         },
@@ -381,6 +452,14 @@ void WebServerManager::serveCompressedFile(AsyncWebServerRequest *request,
     request->send(response);
 }
 
+// Displays, RTC, GPS, buzzer and the NetworkManager interfaces are brought
+// up by the boot task after the web server is already answering
+bool WebServerManager::peripheralsPending(AsyncWebServerRequest *request) {
+    if (peripheralsReady) return false;
+    request->send(503, "application/json", "{\"error\":\"Peripherals still initializing\"}");
+    return true;
+}
+
 void WebServerManager::onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client,
                                   AwsEventType type, void *arg, uint8_t *data, size_t len) {
     switch (type) {
@@ -391,11 +470,17 @@ void WebServerManager::onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *c
 
         case WS_EVT_DISCONNECT:
             Serial.printf("[WS] Client #%u disconnected\n", client->id());
+            metricsHub.unsubscribe(client->id());
             break;
 
-        case WS_EVT_DATA:
-            // Handle incoming WebSocket data if needed
+        case WS_EVT_DATA: {
+            // Single-frame text messages: metrics subscriptions
+            AwsFrameInfo *info = (AwsFrameInfo*)arg;
+            if (info->final && info->index == 0 && info->len == len && info->opcode == WS_TEXT) {
+                metricsHub.handleMessage(client->id(), data, len);
+            }
             break;
+        }
 
         default:
             break;
@@ -416,7 +501,7 @@ void WebServerManager::broadcastLog(const String& message) {
 }
 
 void WebServerManager::handleStatus(AsyncWebServerRequest *request) {
-    DynamicJsonDocument doc(2048);
+    DynamicJsonDocument doc(6144);
 
     // System info
     doc["system"]["uptime"] = millis() / 1000;
@@ -427,10 +512,12 @@ void WebServerManager::handleStatus(AsyncWebServerRequest *request) {
 
     // WiFi info
     doc["wifi"]["connected"] = wifiConnectedToInternet;
-    doc["wifi"]["ap_mode"] = wifiAPMode;
-    doc["wifi"]["ssid"] = wifiAPMode ? WiFi.softAPSSID() : WiFi.SSID();
-    doc["wifi"]["ip"] = wifiAPMode ? WiFi.softAPIP().toString() : WiFi.localIP().toString();
-    doc["wifi"]["rssi"] = wifiAPMode ? 0 : WiFi.RSSI();
+    bool apActive = wifiAPMode || wifiConnector.isFallbackActive();
+    doc["wifi"]["ap_mode"] = apActive;
+    doc["wifi"]["fallback"] = wifiConnector.isFallbackActive();
+    doc["wifi"]["ssid"] = apActive ? WiFi.softAPSSID() : WiFi.SSID();
+    doc["wifi"]["ip"] = apActive ? WiFi.softAPIP().toString() : WiFi.localIP().toString();
+    doc["wifi"]["rssi"] = apActive ? 0 : WiFi.RSSI();
     doc["wifi"]["mac"] = WiFi.macAddress();
 
     // Gateway info
@@ -446,10 +533,63 @@ void WebServerManager::handleStatus(AsyncWebServerRequest *request) {
     doc["lora"]["spreading_factor"] = loraCfg.spreadingFactor;
     doc["lora"]["bandwidth"] = loraCfg.bandwidth;
 
-    GatewayStats& loraStats = loraGateway.getStats();
+    GatewayStats loraStats = loraGateway.getStatsSnapshot();
     doc["lora"]["rx_packets"] = loraStats.rxPacketsReceived;
     doc["lora"]["last_rssi"] = loraStats.lastRssi;
     doc["lora"]["last_snr"] = loraStats.lastSnr;
+    doc["lora"]["rx_occupancy_pct"] = loraStats.rxOccupancyPct;
+
+    // Crystal drift: current estimate and trim, history oldest first
+    DriftStats drift = loraGateway.getDriftSnapshot();
+    JsonObject driftObj = doc["lora"].createNestedObject("drift");
+    driftObj["auto_correct"] = loraCfg.driftCorrection;
+    driftObj["offset_ppb"] = drift.estimatePpb;
+    driftObj["trim_ppb"] = drift.trimPpb;
+    driftObj["last_offset_hz"] = drift.lastOffsetHz;
+    driftObj["frames"] = drift.frames;
+    driftObj["rejected"] = drift.rejected;
+    driftObj["corrections"] = drift.corrections;
+    driftObj["reverted"] = drift.reverted;
+    driftObj["diverged"] = drift.diverged;
+
+    JsonArray historyTime = driftObj.createNestedArray("history_uptime_s");
+    JsonArray historyOffset = driftObj.createNestedArray("history_offset_ppb");
+    JsonArray historyTrim = driftObj.createNestedArray("history_trim_ppb");
+    for (uint8_t i = 0; i < drift.historyCount; i++) {
+        const DriftSample& sample =
+            drift.history[(drift.historyHead + DRIFT_HISTORY - drift.historyCount + i) % DRIFT_HISTORY];
+        historyTime.add(sample.uptimeS);
+        historyOffset.add(sample.offsetPpb);
+        historyTrim.add(sample.trimPpb);
+    }
+
+    // Receiver watchdog: stalls found and how RX was brought back
+    JsonObject watchdog = doc["lora"].createNestedObject("watchdog");
+    watchdog["timeout_s"] = loraCfg.watchdogTimeoutS;
+    watchdog["checks"] = loraStats.wdChecks;
+    watchdog["stalls"] = loraStats.wdStalls;
+    watchdog["missed_irq"] = loraStats.wdMissedIrq;
+    JsonObject recoveries = watchdog.createNestedObject("recoveries");
+    recoveries["rearm"] = loraStats.wdRecoveries[(uint8_t)RadioRecovery::REARM];
+    recoveries["reload"] = loraStats.wdRecoveries[(uint8_t)RadioRecovery::RELOAD];
+    recoveries["reset"] = loraStats.wdRecoveries[(uint8_t)RadioRecovery::HARDWARE_RESET];
+    watchdog["failures"] = loraStats.wdFailures;
+    watchdog["downtime_last_ms"] = loraStats.wdDowntimeLastMs;
+    watchdog["downtime_total_ms"] = loraStats.wdDowntimeTotalMs;
+    watchdog["last_cause"] = LoRaGateway::stallCauseName(loraStats.wdLastCause);
+    if (loraStats.wdStalls > 0) {
+        watchdog["last_stall_ago_s"] = (millis() - loraStats.wdLastStallTime) / 1000;
+    }
+
+    // Config persistence (save latency, flash writes)
+    JsonObject cfgStore = doc.createNestedObject("config_store");
+    configStore.getStatusJson(cfgStore);
+
+    // Boot timing (per-stage durations since reset)
+    JsonObject boot = doc.createNestedObject("boot");
+    bootProfiler.toJson(boot);
+    JsonObject bootConfig = boot.createNestedObject("config");
+    configSnapshot.getStatusJson(bootConfig);
 
     String response;
     serializeJson(doc, response);
@@ -457,9 +597,9 @@ void WebServerManager::handleStatus(AsyncWebServerRequest *request) {
 }
 
 void WebServerManager::handleStats(AsyncWebServerRequest *request) {
-    DynamicJsonDocument doc(1024);
+    DynamicJsonDocument doc(8192);
 
-    GatewayStats& loraStats = loraGateway.getStats();
+    GatewayStats loraStats = loraGateway.getStatsSnapshot();
     doc["lora"]["rx_received"] = loraStats.rxPacketsReceived;
     doc["lora"]["rx_forwarded"] = loraStats.rxPacketsForwarded;
     doc["lora"]["rx_crc_error"] = loraStats.rxPacketsCrcError;
@@ -468,13 +608,121 @@ void WebServerManager::handleStats(AsyncWebServerRequest *request) {
     doc["lora"]["last_rssi"] = loraStats.lastRssi;
     doc["lora"]["last_snr"] = loraStats.lastSnr;
 
-    ForwarderStats& fwdStats = udpForwarder.getStats();
+    // RX interrupt to PUSH_DATA sent
+    JsonObject latency = doc["lora"].createNestedObject("forward_latency_us");
+    latency["last"] = loraStats.fwdLatencyLastUs;
+    latency["max"] = loraStats.fwdLatencyMaxUs;
+    latency["avg"] = loraStats.fwdLatencySamples > 0 ?
+                     (uint32_t)(loraStats.fwdLatencyTotalUs / loraStats.fwdLatencySamples) : 0;
+    latency["samples"] = loraStats.fwdLatencySamples;
+
+    // Radio task commands and reconfiguration RX gap
+    JsonObject radioTask = doc["lora"].createNestedObject("radio_task");
+    radioTask["commands"] = loraStats.radioCommands;
+    radioTask["rejected"] = loraStats.radioCommandsRejected;
+    radioTask["reconfigs"] = loraStats.reconfigCount;
+    radioTask["reconfig_gap_us"] = loraStats.reconfigGapLastUs;
+    radioTask["reconfig_gap_max_us"] = loraStats.reconfigGapMaxUs;
+
+    // DIO0 to packet read and receiver re-armed
+    JsonObject rearm = doc["lora"].createNestedObject("rx_rearm_us");
+    rearm["last"] = loraStats.rxRearmLastUs;
+    rearm["max"] = loraStats.rxRearmMaxUs;
+    rearm["avg"] = loraStats.rxRearmSamples > 0 ?
+                   (uint32_t)(loraStats.rxRearmTotalUs / loraStats.rxRearmSamples) : 0;
+
+    // Downlink turnaround and register shadow effectiveness
+    JsonObject turnaround = doc["lora"].createNestedObject("turnaround_us");
+    turnaround["rx_to_tx"] = loraStats.txSetupLastUs;
+    turnaround["rx_to_tx_max"] = loraStats.txSetupMaxUs;
+    turnaround["tx_to_rx"] = loraStats.rxRestoreLastUs;
+    turnaround["tx_to_rx_max"] = loraStats.rxRestoreMaxUs;
+
+    // Listen-before-talk per downlink frequency (LBT regions only)
+    JsonObject lbt = doc["lora"].createNestedObject("lbt");
+    lbt["delay_us"] = loraStats.lbtDelayLastUs;
+    lbt["delay_max_us"] = loraStats.lbtDelayMaxUs;
+    JsonArray lbtChannels = lbt.createNestedArray("channels");
+    for (uint8_t i = 0; i < LORA_LBT_MAX_CHANNELS && loraStats.lbt[i].frequency != 0; i++) {
+        JsonObject entry = lbtChannels.createNestedObject();
+        entry["freq"] = loraStats.lbt[i].frequency;
+        entry["checks"] = loraStats.lbt[i].checks;
+        entry["busy"] = loraStats.lbt[i].busy;
+        entry["blocked"] = loraStats.lbt[i].blocked;
+        entry["last_rssi"] = loraStats.lbt[i].lastRssi;
+    }
+
+    JsonObject registers = doc["lora"].createNestedObject("registers");
+    registers["bytes_written"] = loraStats.regBytesWritten;
+    registers["bytes_skipped"] = loraStats.regBytesSkipped;
+    registers["spi_transactions"] = loraStats.spiTransactions;
+
+    // Time on air and channel occupancy (rolling 15 minutes)
+    JsonObject airtime = doc["lora"].createNestedObject("airtime");
+    airtime["rx_ms"] = (uint32_t)(loraStats.rxAirtimeUs / 1000);
+    airtime["tx_ms"] = (uint32_t)(loraStats.txAirtimeUs / 1000);
+    airtime["rx_occupancy_pct"] = loraStats.rxOccupancyPct;
+    airtime["tx_occupancy_pct"] = loraStats.txOccupancyPct;
+
+    // CAD multi-SF scanning
+    JsonObject scan = doc["lora"].createNestedObject("scan");
+    scan["enabled"] = loraGateway.isScanning();
+    scan["cycle_us"] = loraStats.scanCycleUs;
+    JsonArray perSf = scan.createNestedArray("per_sf");
+    for (uint8_t i = 0; i < LORA_SCAN_SF_COUNT; i++) {
+        JsonObject entry = perSf.createNestedObject();
+        entry["sf"] = LORA_SCAN_SF_MIN + i;
+        entry["cad"] = loraStats.scan[i].cadRuns;
+        entry["detections"] = loraStats.scan[i].detections;
+        entry["packets"] = loraStats.scan[i].packets;
+        entry["misses"] = loraStats.scan[i].misses;
+        entry["false_positives"] = loraStats.scan[i].falsePositives;
+    }
+
+    // Channel hopping: capture per channel of the plan
+    GatewayConfig& loraCfg = loraGateway.getConfig();
+    JsonObject hop = doc["lora"].createNestedObject("hop");
+    hop["enabled"] = loraGateway.isHopping();
+    JsonArray perChannel = hop.createNestedArray("channels");
+    for (uint8_t i = 0; i < loraCfg.hopChannelCount; i++) {
+        JsonObject entry = perChannel.createNestedObject();
+        entry["chan"] = i;
+        entry["freq"] = loraCfg.hopChannels[i];
+        entry["cad"] = loraStats.hop[i].cadRuns;
+        entry["detections"] = loraStats.hop[i].detections;
+        entry["packets"] = loraStats.hop[i].packets;
+    }
+
+    ForwarderStats fwdStats = udpForwarder.getStatsSnapshot();
     doc["forwarder"]["push_sent"] = fwdStats.pushDataSent;
     doc["forwarder"]["push_ack"] = fwdStats.pushAckReceived;
     doc["forwarder"]["pull_sent"] = fwdStats.pullDataSent;
     doc["forwarder"]["pull_ack"] = fwdStats.pullAckReceived;
     doc["forwarder"]["downlinks"] = fwdStats.downlinksReceived;
     doc["forwarder"]["downlinks_sent"] = fwdStats.downlinksSent;
+    doc["forwarder"]["downlinks_duty_rejected"] = fwdStats.downlinksDutyRejected;
+    doc["forwarder"]["downlinks_channel_busy"] = fwdStats.downlinksChannelBusy;
+    doc["forwarder"]["downlinks_failed"] = fwdStats.downlinksFailed;
+
+    // Rolling-hour duty cycle per regulated sub-band
+    JsonArray duty = doc["forwarder"].createNestedArray("duty_cycle");
+    for (uint8_t i = 0; i < fwdStats.dutyBandCount; i++) {
+        JsonObject entry = duty.createNestedObject();
+        entry["band"] = fwdStats.dutyBands[i].name;
+        entry["used_ms"] = fwdStats.dutyBands[i].usedUs / 1000;
+        entry["budget_ms"] = fwdStats.dutyBands[i].budgetUs / 1000;
+        entry["rejected"] = fwdStats.dutyBands[i].rejected;
+    }
+
+    // Uplink priority queue: per-class counters and RX-to-forward wait
+    uplinkScheduler.getStatusJson(doc["forwarder"].createNestedObject("uplink_queue"));
+
+    // Live packet stream and metric pushes to the web interface
+    packetStream.getStatusJson(doc.createNestedObject("packet_stream"));
+    metricsHub.getStatusJson(doc.createNestedObject("metrics_push"));
+
+    // Config GET response cache
+    responseCache.getStatusJson(doc.createNestedObject("response_cache"));
 
     String response;
     serializeJson(doc, response);
@@ -484,13 +732,22 @@ void WebServerManager::handleStats(AsyncWebServerRequest *request) {
 void WebServerManager::handleResetStats(AsyncWebServerRequest *request) {
     loraGateway.resetStats();
     udpForwarder.resetStats();
+    packetFilter.resetStats();
+    deviceTable.clear();
+    badFrameLog.clear();
+    uplinkScheduler.resetStats();
     request->send(200, "application/json", "{\"success\":true}");
 }
 
 void WebServerManager::handleLoRaConfig(AsyncWebServerRequest *request) {
+    // Both counters only grow, so their sum changes whenever either does
+    uint32_t version = configStore.getSectionGeneration(ConfigSection::LORA) +
+                       loraGateway.getConfigRevision();
+    if (responseCache.serve(request, CachedEndpoint::LORA_CONFIG, version)) return;
+
     GatewayConfig& cfg = loraGateway.getConfig();
 
-    DynamicJsonDocument doc(512);
+    DynamicJsonDocument doc(1024);
     doc["enabled"] = cfg.enabled;
     doc["frequency"] = cfg.frequency;
     doc["spreading_factor"] = cfg.spreadingFactor;
@@ -499,9 +756,36 @@ void WebServerManager::handleLoRaConfig(AsyncWebServerRequest *request) {
     doc["tx_power"] = cfg.txPower;
     doc["sync_word"] = cfg.syncWord;
 
+    JsonObject scan = doc.createNestedObject("scan");
+    scan["enabled"] = cfg.scanEnabled;
+    scan["dwell_ms"] = cfg.scanDwellMs;
+    JsonArray sfList = scan.createNestedArray("sf_priority");
+    for (uint8_t i = 0; i < cfg.scanSfCount; i++) {
+        sfList.add(cfg.scanSfList[i]);
+    }
+
+    JsonObject hop = doc.createNestedObject("hop");
+    hop["enabled"] = cfg.hopEnabled;
+    JsonArray channels = hop.createNestedArray("channels");
+    for (uint8_t i = 0; i < cfg.hopChannelCount; i++) {
+        channels.add(cfg.hopChannels[i]);
+    }
+
+    JsonObject noise = doc.createNestedObject("noise");
+    noise["enabled"] = cfg.noiseEnabled;
+    noise["sweep_interval_s"] = cfg.noiseSweepIntervalS;
+
+    JsonObject drift = doc.createNestedObject("drift");
+    drift["auto_correct"] = cfg.driftCorrection;
+
+    JsonObject watchdog = doc.createNestedObject("watchdog");
+    watchdog["timeout_s"] = cfg.watchdogTimeoutS;
+
+    doc["forward_crc_errors"] = cfg.forwardCrcErrors;
+
     String response;
     serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    responseCache.send(request, CachedEndpoint::LORA_CONFIG, version, response);
 }
 
 void WebServerManager::handleLoRaConfigPost(AsyncWebServerRequest *request,
@@ -509,7 +793,7 @@ void WebServerManager::handleLoRaConfigPost(AsyncWebServerRequest *request,
                                              size_t index, size_t total) {
     if (index + len != total) return;  // Wait for complete body
 
-    DynamicJsonDocument doc(512);
+    DynamicJsonDocument doc(1024);
     DeserializationError error = deserializeJson(doc, data, len);
 
     if (error) {
@@ -517,24 +801,379 @@ void WebServerManager::handleLoRaConfigPost(AsyncWebServerRequest *request,
         return;
     }
 
-    GatewayConfig& cfg = loraGateway.getConfig();
+    // Work on a copy; the radio task applies it between packets
+    GatewayConfig cfg = loraGateway.getConfig();
+
+    // Frequencies, scan SFs and hop channels are checked against the
+    // regional parameters
+    const LoRaRegion* region = loraGateway.getRegion();
 
     if (doc.containsKey("enabled")) cfg.enabled = doc["enabled"];
-    if (doc.containsKey("frequency")) cfg.frequency = doc["frequency"];
+    if (doc.containsKey("frequency")) {
+        uint32_t frequency = doc["frequency"] | 0UL;
+        if (frequency < 137000000UL || frequency > 1020000000UL ||
+            (region && !lorawanRegionContains(region, frequency))) {
+            request->send(400, "application/json",
+                          "{\"error\":\"Frequency outside the region band\"}");
+            return;
+        }
+        cfg.frequency = frequency;
+    }
     if (doc.containsKey("spreading_factor")) cfg.spreadingFactor = doc["spreading_factor"];
     if (doc.containsKey("bandwidth")) cfg.bandwidth = doc["bandwidth"];
     if (doc.containsKey("coding_rate")) cfg.codingRate = doc["coding_rate"];
     if (doc.containsKey("tx_power")) cfg.txPower = doc["tx_power"];
     if (doc.containsKey("sync_word")) cfg.syncWord = doc["sync_word"];
 
-    if (loraGateway.saveConfig()) {
-        request->send(200, "application/json", "{\"success\":true,\"message\":\"LoRa config saved. Restart to apply.\"}");
-    } else {
+    if (doc.containsKey("scan")) {
+        JsonObject scan = doc["scan"];
+        if (scan.containsKey("enabled")) cfg.scanEnabled = scan["enabled"];
+        if (scan.containsKey("dwell_ms")) cfg.scanDwellMs = scan["dwell_ms"];
+
+        if (scan.containsKey("sf_priority")) {
+            JsonArray sfList = scan["sf_priority"];
+            uint8_t count = 0;
+            for (JsonVariant sf : sfList) {
+                uint8_t value = sf | 0;
+                if (count >= LORA_SCAN_MAX_STEPS ||
+                    value < LORA_SCAN_SF_MIN || value > LORA_SCAN_SF_MAX) {
+                    request->send(400, "application/json",
+                                  "{\"error\":\"sf_priority: up to 12 entries, SF7-SF12\"}");
+                    return;
+                }
+                if (region && !lorawanUplinkSf(region, value, (uint16_t)cfg.bandwidth)) {
+                    request->send(400, "application/json",
+                                  "{\"error\":\"sf_priority: not an uplink data rate of the region\"}");
+                    return;
+                }
+                cfg.scanSfList[count++] = value;
+            }
+            if (count == 0) {
+                request->send(400, "application/json", "{\"error\":\"sf_priority is empty\"}");
+                return;
+            }
+            cfg.scanSfCount = count;
+        }
+    }
+
+    if (doc.containsKey("hop")) {
+        JsonObject hop = doc["hop"];
+        if (hop.containsKey("enabled")) cfg.hopEnabled = hop["enabled"];
+
+        if (hop.containsKey("channels")) {
+            JsonArray channels = hop["channels"];
+            if (channels.size() > LORA_HOP_MAX_CHANNELS) {
+                request->send(400, "application/json",
+                              "{\"error\":\"channels: up to 8 frequencies\"}");
+                return;
+            }
+            uint8_t count = 0;
+            for (JsonVariant channel : channels) {
+                uint32_t frequency = channel | 0UL;
+                if (frequency < 137000000UL || frequency > 1020000000UL ||
+                    (region && !lorawanRegionContains(region, frequency))) {
+                    request->send(400, "application/json",
+                                  "{\"error\":\"Channel frequency outside the region band\"}");
+                    return;
+                }
+                cfg.hopChannels[count++] = frequency;
+            }
+            cfg.hopChannelCount = count;
+        }
+    }
+
+    if (doc.containsKey("noise")) {
+        JsonObject noise = doc["noise"];
+        if (noise.containsKey("enabled")) cfg.noiseEnabled = noise["enabled"];
+        if (noise.containsKey("sweep_interval_s")) {
+            uint32_t interval = noise["sweep_interval_s"];
+            // 0 disables the sweep; otherwise at least one per minute
+            cfg.noiseSweepIntervalS = (interval > 0 && interval < 60) ? 60 : interval;
+        }
+    }
+
+    if (doc.containsKey("drift")) {
+        JsonObject drift = doc["drift"];
+        if (drift.containsKey("auto_correct")) cfg.driftCorrection = drift["auto_correct"];
+    }
+
+    if (doc.containsKey("watchdog")) {
+        JsonObject watchdog = doc["watchdog"];
+        if (watchdog.containsKey("timeout_s")) {
+            uint16_t timeout = watchdog["timeout_s"];
+            // 0 disables the watchdog; shorter timeouts would poll a quiet channel
+            cfg.watchdogTimeoutS = (timeout > 0 && timeout < LORA_WATCHDOG_MIN_TIMEOUT_S)
+                                   ? LORA_WATCHDOG_MIN_TIMEOUT_S : timeout;
+        }
+    }
+
+    if (doc.containsKey("forward_crc_errors")) cfg.forwardCrcErrors = doc["forward_crc_errors"];
+
+    RadioCompletion result;
+    if (!loraGateway.reconfigure(cfg, &result)) {
+        request->send(500, "application/json", "{\"error\":\"Failed to apply LoRa config\"}");
+        return;
+    }
+
+    if (!loraGateway.saveConfig()) {
+        request->send(500, "application/json", "{\"error\":\"Failed to save config\"}");
+        return;
+    }
+
+    DynamicJsonDocument response(256);
+    response["success"] = true;
+    response["message"] = "LoRa config applied";
+    response["rx_gap_us"] = result.rxGapUs;
+    response["deferred_ms"] = result.deferMs;
+
+    String output;
+    serializeJson(response, output);
+    request->send(200, "application/json", output);
+}
+
+void WebServerManager::handleAutoTune(AsyncWebServerRequest *request) {
+    AutoTunerConfig& cfg = autoTuner.getConfig();
+
+    DynamicJsonDocument doc(4096);
+    JsonObject config = doc.createNestedObject("config");
+    config["enabled"] = cfg.enabled;
+    config["auto_apply"] = cfg.autoApply;
+    config["eval_interval_s"] = cfg.evalIntervalS;
+    config["min_dwell_s"] = cfg.minDwellS;
+    config["sweep_interval_s"] = cfg.sweepIntervalS;
+    config["sweep_duration_s"] = cfg.sweepDurationS;
+    config["min_packets"] = cfg.minPackets;
+    config["min_gain_pct"] = cfg.minGainPct;
+    config["regression_pct"] = cfg.regressionPct;
+    config["window_start_hour"] = cfg.windowStartHour;
+    config["window_end_hour"] = cfg.windowEndHour;
+
+    autoTuner.getStatusJson(doc.createNestedObject("status"));
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServerManager::handleAutoTunePost(AsyncWebServerRequest *request,
+                                           uint8_t *data, size_t len,
+                                           size_t index, size_t total) {
+    if (index + len != total) return;  // Wait for complete body
+
+    DynamicJsonDocument doc(512);
+    DeserializationError error = deserializeJson(doc, data, len);
+
+    if (error) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+
+    AutoTunerConfig& cfg = autoTuner.getConfig();
+
+    if (doc.containsKey("enabled")) cfg.enabled = doc["enabled"];
+    if (doc.containsKey("auto_apply")) cfg.autoApply = doc["auto_apply"];
+    if (doc.containsKey("eval_interval_s")) {
+        uint32_t interval = doc["eval_interval_s"];
+        cfg.evalIntervalS = interval < 60 ? 60 : interval;
+    }
+    if (doc.containsKey("min_dwell_s")) cfg.minDwellS = doc["min_dwell_s"];
+    if (doc.containsKey("sweep_interval_s")) cfg.sweepIntervalS = doc["sweep_interval_s"];
+    if (doc.containsKey("sweep_duration_s")) cfg.sweepDurationS = doc["sweep_duration_s"];
+    if (doc.containsKey("min_packets")) cfg.minPackets = doc["min_packets"];
+    if (doc.containsKey("min_gain_pct")) cfg.minGainPct = doc["min_gain_pct"];
+    if (doc.containsKey("regression_pct")) cfg.regressionPct = doc["regression_pct"];
+    if (doc.containsKey("window_start_hour")) cfg.windowStartHour = (uint8_t)doc["window_start_hour"] % 24;
+    if (doc.containsKey("window_end_hour")) cfg.windowEndHour = (uint8_t)doc["window_end_hour"] % 24;
+    // A sweep in every observation window
+    if (cfg.sweepIntervalS > cfg.evalIntervalS) cfg.sweepIntervalS = cfg.evalIntervalS;
+
+    if (!autoTuner.saveConfig()) {
         request->send(500, "application/json", "{\"error\":\"Failed to save config\"}");
+        return;
     }
+
+    request->send(200, "application/json", "{\"success\":true,\"message\":\"Auto-tune config saved\"}");
+}
+
+void WebServerManager::handleNoiseFloor(AsyncWebServerRequest *request) {
+    NoiseFloorStats noise = loraGateway.getNoiseSnapshot();
+
+    // Columnar arrays: one entry per observed frequency
+    DynamicJsonDocument doc(4096);
+    doc["enabled"] = loraGateway.getConfig().noiseEnabled;
+    doc["samples"] = noise.samples;
+    doc["skipped"] = noise.skipped;
+    doc["sweeps"] = noise.sweeps;
+    doc["last_rssi"] = noise.lastRssi;
+    doc["last_frequency"] = noise.lastFrequency;
+    doc["bin_min_dbm"] = NOISE_BIN_MIN_DBM;
+    doc["bin_width_db"] = NOISE_BIN_WIDTH_DB;
+
+    JsonArray freq = doc.createNestedArray("freq");
+    JsonArray count = doc.createNestedArray("n");
+    JsonArray minRssi = doc.createNestedArray("min");
+    JsonArray avgRssi = doc.createNestedArray("avg");
+    JsonArray maxRssi = doc.createNestedArray("max");
+    JsonArray hist = doc.createNestedArray("hist");
+
+    for (uint8_t i = 0; i < NOISE_MAX_CHANNELS; i++) {
+        const NoiseChannel& channel = noise.channels[i];
+        if (channel.frequency == 0 || channel.samples == 0) continue;
+
+        freq.add(channel.frequency);
+        count.add(channel.samples);
+        minRssi.add(channel.min);
+        avgRssi.add((float)channel.sum / channel.samples);
+        maxRssi.add(channel.max);
+
+        JsonArray bins = hist.createNestedArray();
+        for (uint8_t b = 0; b < NOISE_BINS; b++) {
+            bins.add(channel.bins[b]);
+        }
+    }
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServerManager::handleDevices(AsyncWebServerRequest *request) {
+    long offset = 0;
+    long limit = DEVICE_PAGE_DEFAULT;
+    if (request->hasParam("offset")) {
+        offset = request->getParam("offset")->value().toInt();
+        if (offset < 0) offset = 0;
+    }
+    if (request->hasParam("limit")) {
+        limit = constrain(request->getParam("limit")->value().toInt(), 1, DEVICE_PAGE_MAX);
+    }
+
+    DeviceTableStats tableStats = deviceTable.getStats();
+    uint32_t now = millis();
+
+    // Streamed one entry at a time; the table is never copied as a whole.
+    // Entries are in table order, which shifts when devices are evicted.
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->printf("{\"capacity\":%u,\"count\":%u,\"inserts\":%lu,\"evictions\":%lu,"
+                     "\"max_probe\":%u,\"offset\":%ld,\"devices\":[",
+                     DEVICE_TABLE_MAX_ENTRIES, tableStats.entries,
+                     (unsigned long)tableStats.inserts, (unsigned long)tableStats.evictions,
+                     tableStats.maxProbe, offset);
+
+    DeviceEntry entry;
+    uint16_t slot = 0;
+    long index = 0;
+    long sent = 0;
+    while (sent < limit && deviceTable.next(slot, entry)) {
+        slot++;
+        if (index++ < offset) continue;
+
+        StaticJsonDocument<768> doc;
+        char id[17];
+        if (entry.keyType == DeviceKeyType::DEVADDR) {
+            snprintf(id, sizeof(id), "%08lX", (unsigned long)entry.key);
+            doc["devaddr"] = id;
+        } else {
+            snprintf(id, sizeof(id), "%08lX%08lX", (unsigned long)(entry.key >> 32),
+                     (unsigned long)(entry.key & 0xFFFFFFFF));
+            doc["deveui"] = id;
+        }
+        doc["packets"] = entry.packets;
+        doc["first_seen_s"] = (now - entry.firstSeen) / 1000;
+        doc["last_seen_s"] = (now - entry.lastSeen) / 1000;
+        doc["frequency"] = entry.lastFrequency;
+        doc["sf"] = entry.lastSf;
+        doc["rssi_avg"] = roundf(entry.rssiAvg * 10) / 10;
+        doc["rssi_min"] = entry.rssiMin;
+        doc["rssi_max"] = entry.rssiMax;
+        doc["snr_avg"] = roundf(entry.snrAvg * 10) / 10;
+        doc["snr_min"] = entry.snrMin;
+        doc["snr_max"] = entry.snrMax;
+
+        JsonArray sf = doc.createNestedArray("sf_hist");
+        for (uint8_t i = 0; i < DEVICE_SF_COUNT; i++) {
+            sf.add(entry.sfCount[i]);
+        }
+
+        if (entry.fcntValid) {
+            JsonObject fcnt = doc.createNestedObject("fcnt");
+            fcnt["last"] = entry.lastFcnt;
+            fcnt["lost"] = entry.lost;
+            fcnt["loss_pct"] = roundf(DeviceTable::lossPercent(entry) * 10) / 10;
+            fcnt["duplicates"] = entry.duplicates;
+            fcnt["resets"] = entry.fcntResets;
+        }
+
+        if (sent > 0) response->print(',');
+        serializeJson(doc, *response);
+        sent++;
+    }
+
+    if (deviceTable.next(slot, entry)) {
+        response->printf("],\"next\":%ld}", offset + sent);
+    } else {
+        response->print("],\"next\":null}");
+    }
+    request->send(response);
+}
+
+void WebServerManager::handleBadFrames(AsyncWebServerRequest *request) {
+    uint32_t first = badFrameLog.firstSeq();
+    uint32_t last = badFrameLog.lastSeq();
+    uint32_t now = millis();
+
+    // Oldest first, rxpk field names; frames overwritten while streaming
+    // are skipped
+    AsyncResponseStream *response = request->beginResponseStream("application/json");
+    response->addHeader("Content-Disposition", "attachment; filename=\"badframes.json\"");
+    response->printf("{\"capacity\":%u,\"total\":%lu,\"frames\":[",
+                     BAD_FRAME_LOG_SIZE, (unsigned long)last);
+
+    BadFrame frame;
+    bool firstFrame = true;
+    for (uint32_t seq = first; seq <= last && seq != 0; seq++) {
+        if (!badFrameLog.get(seq, frame)) continue;
+        const LoRaPacket& packet = frame.packet;
+
+        char datr[16];
+        char codr[8];
+        snprintf(datr, sizeof(datr), "SF%dBW%d", packet.spreadingFactor, (int)packet.bandwidth);
+        snprintf(codr, sizeof(codr), "4/%d", packet.codingRate);
+
+        StaticJsonDocument<384> doc;
+        doc["seq"] = frame.seq;
+        doc["age_s"] = (now - frame.uptimeMs) / 1000;
+        doc["tmst"] = packet.timestamp;
+        doc["freq"] = packet.frequency / 1000000.0;
+        doc["chan"] = packet.channel;
+        doc["datr"] = datr;
+        doc["codr"] = codr;
+        doc["rssi"] = roundf(packet.rssi * 10) / 10;
+        doc["lsnr"] = packet.snr;
+        doc["foff"] = packet.freqOffset;
+        doc["size"] = packet.length;
+
+        // Payload as hex (kept by pointer, not copied into the document)
+        char hex[MAX_PACKET_SIZE * 2 + 1];
+        for (uint16_t i = 0; i < packet.length; i++) {
+            snprintf(hex + i * 2, 3, "%02X", packet.data[i]);
+        }
+        hex[packet.length * 2] = '\0';
+        doc["data"] = (const char*)hex;
+
+        if (!firstFrame) response->print(',');
+        firstFrame = false;
+        serializeJson(doc, *response);
+    }
+
+    response->print("]}");
+    request->send(response);
 }
 
 void WebServerManager::handleServerConfig(AsyncWebServerRequest *request) {
+    uint32_t version = configStore.getSectionGeneration(ConfigSection::SERVER);
+    if (responseCache.serve(request, CachedEndpoint::SERVER_CONFIG, version)) return;
+
     ForwarderConfig& cfg = udpForwarder.getConfig();
 
     DynamicJsonDocument doc(512);
@@ -549,9 +1188,15 @@ void WebServerManager::handleServerConfig(AsyncWebServerRequest *request) {
     doc["longitude"] = cfg.longitude;
     doc["altitude"] = cfg.altitude;
 
+    // Regions compiled into this build
+    JsonArray regions = doc.createNestedArray("regions");
+    for (uint8_t i = 0; i < lorawanRegionCount(); i++) {
+        regions.add(lorawanRegionAt(i)->name);
+    }
+
     String response;
     serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    responseCache.send(request, CachedEndpoint::SERVER_CONFIG, version, response);
 }
 
 void WebServerManager::handleServerConfigPost(AsyncWebServerRequest *request,
@@ -567,6 +1212,11 @@ void WebServerManager::handleServerConfigPost(AsyncWebServerRequest *request,
         return;
     }
 
+    if (doc.containsKey("region") && lorawanRegionFind(doc["region"].as<const char*>()) == nullptr) {
+        request->send(400, "application/json", "{\"error\":\"Region not supported by this build\"}");
+        return;
+    }
+
     ForwarderConfig& cfg = udpForwarder.getConfig();
 
     if (doc.containsKey("enabled")) cfg.enabled = doc["enabled"];
@@ -597,16 +1247,164 @@ void WebServerManager::handleServerConfigPost(AsyncWebServerRequest *request,
     }
 }
 
+void WebServerManager::handleFilter(AsyncWebServerRequest *request) {
+    DynamicJsonDocument doc(4096);
+    PacketFilter::configToJson(packetFilter.getConfig(), doc.to<JsonObject>());
+    packetFilter.getStatusJson(doc.createNestedObject("stats"));
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServerManager::handleFilterPost(AsyncWebServerRequest *request,
+                                        uint8_t *data, size_t len,
+                                        size_t index, size_t total) {
+    if (index + len != total) return;  // Wait for complete body
+
+    DynamicJsonDocument doc(4096);
+    DeserializationError error = deserializeJson(doc, data, len);
+
+    if (error) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+
+    // Fields left out keep their value; "rules" replaces the whole list
+    FilterConfig cfg = packetFilter.getConfig();
+    const char* invalid = PacketFilter::parseConfig(doc.as<JsonObjectConst>(), cfg);
+    if (invalid) {
+        DynamicJsonDocument err(256);
+        err["error"] = invalid;
+        String response;
+        serializeJson(err, response);
+        request->send(400, "application/json", response);
+        return;
+    }
+
+    packetFilter.setConfig(cfg);
+
+    if (packetFilter.saveConfig()) {
+        request->send(200, "application/json", "{\"success\":true,\"message\":\"Filter rules applied\"}");
+    } else {
+        request->send(500, "application/json", "{\"error\":\"Failed to save config\"}");
+    }
+}
+
+void WebServerManager::handleCapture(AsyncWebServerRequest *request) {
+    CaptureStatus status = packetCapture.getStatus();
+
+    DynamicJsonDocument doc(768);
+    doc["state"] = PacketCapture::stateName(status.state);
+    doc["stop_reason"] = PacketCapture::stopReasonName(status.stopReason);
+    doc["filter"] = status.settings.filter;
+    doc["trigger"] = status.settings.trigger;
+    doc["max_packets"] = status.settings.maxPackets;
+    doc["duration_s"] = status.settings.durationS;
+    doc["elapsed_s"] = status.elapsedMs / 1000;
+    doc["seen"] = status.seen;
+    doc["captured"] = status.captured;
+    doc["stored"] = status.lastSeq >= status.firstSeq ? status.lastSeq - status.firstSeq + 1 : 0;
+    doc["capacity"] = CAPTURE_RING_SIZE;
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
+void WebServerManager::handleCapturePost(AsyncWebServerRequest *request,
+                                         uint8_t *data, size_t len,
+                                         size_t index, size_t total) {
+    if (index + len != total) return;  // Wait for complete body
+
+    DynamicJsonDocument doc(1024);
+    DeserializationError error = deserializeJson(doc, data, len);
+
+    if (error) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+
+    const char* action = doc["action"] | "";
+    if (strcmp(action, "stop") == 0) {
+        packetCapture.stop();
+        request->send(200, "application/json", "{\"success\":true,\"message\":\"Capture stopped\"}");
+        return;
+    }
+    if (strcmp(action, "start") != 0) {
+        request->send(400, "application/json", "{\"error\":\"action: start or stop\"}");
+        return;
+    }
+
+    // Checked before the copy, which would cut a long expression short
+    const char* filter = doc["filter"] | "";
+    const char* trigger = doc["trigger"] | "";
+    if (strlen(filter) > CAPTURE_EXPR_MAX || strlen(trigger) > CAPTURE_EXPR_MAX) {
+        request->send(400, "application/json", "{\"error\":\"Expression too long\"}");
+        return;
+    }
+
+    CaptureSettings settings;
+    memset(&settings, 0, sizeof(settings));
+    strlcpy(settings.filter, filter, sizeof(settings.filter));
+    strlcpy(settings.trigger, trigger, sizeof(settings.trigger));
+    settings.maxPackets = doc["max_packets"] | CAPTURE_MAX_PACKETS_DEFAULT;
+    settings.durationS = doc["duration_s"] | CAPTURE_DURATION_DEFAULT;
+
+    const char* invalid = packetCapture.start(settings);
+    if (invalid) {
+        DynamicJsonDocument err(256);
+        err["error"] = invalid;
+        String response;
+        serializeJson(err, response);
+        request->send(400, "application/json", response);
+        return;
+    }
+
+    request->send(200, "application/json", "{\"success\":true,\"message\":\"Capture started\"}");
+}
+
+void WebServerManager::handleCapturePcap(AsyncWebServerRequest *request) {
+    CaptureStatus status = packetCapture.getStatus();
+    uint32_t seq = status.firstSeq;
+    uint32_t lastSeq = status.lastSeq;
+
+    // Oldest first, whole records copied straight into the library's chunk
+    // buffer; records overwritten while streaming are skipped
+    AsyncWebServerResponse *response = request->beginChunkedResponse(
+        "application/vnd.tcpdump.pcap",
+        [seq, lastSeq](uint8_t *buffer, size_t maxLen, size_t index) mutable -> size_t {
+            size_t written = 0;
+            if (index == 0) {
+                if (maxLen < PCAP_GLOBAL_HEADER_SIZE) return RESPONSE_TRY_AGAIN;
+                PacketCapture::writeGlobalHeader(buffer);
+                written = PCAP_GLOBAL_HEADER_SIZE;
+            }
+
+            while (seq != 0 && seq <= lastSeq && maxLen - written >= CAPTURE_SLOT_SIZE) {
+                written += packetCapture.getRecord(seq++, buffer + written);
+            }
+
+            // No room for a whole record yet: wait for the window to open
+            if (written == 0 && seq != 0 && seq <= lastSeq) return RESPONSE_TRY_AGAIN;
+            return written;
+        });
+    response->addHeader("Content-Disposition", "attachment; filename=\"capture.pcap\"");
+    request->send(response);
+}
+
 void WebServerManager::handleWiFiConfig(AsyncWebServerRequest *request) {
     DynamicJsonDocument doc(1024);
 
     // Current connection status
     doc["hostname"] = wifiHostname;
     doc["current_ssid"] = wifiSSID;
+    bool apActive = wifiAPMode || wifiConnector.isFallbackActive();
     doc["ap_mode"] = wifiAPMode;
+    doc["fallback"] = wifiConnector.isFallbackActive();
     doc["connected"] = wifiConnectedToInternet;
-    doc["ip"] = wifiAPMode ? WiFi.softAPIP().toString() : WiFi.localIP().toString();
-    doc["rssi"] = wifiAPMode ? 0 : WiFi.RSSI();
+    doc["ip"] = apActive ? WiFi.softAPIP().toString() : WiFi.localIP().toString();
+    doc["rssi"] = apActive ? 0 : WiFi.RSSI();
 
     // List of configured networks
     JsonArray networks = doc.createNestedArray("networks");
@@ -637,28 +1435,25 @@ void WebServerManager::handleWiFiConfigPost(AsyncWebServerRequest *request,
         return;
     }
 
-    // Read current config
-    File file = LittleFS.open("/config.json", "r");
-    if (!file) {
+    // Patch the wifi section of the shared config document
+    ConfigSectionView section = configStore.edit(ConfigSection::WIFI);
+    if (!section.isValid()) {
         request->send(500, "application/json", "{\"error\":\"Cannot read config\"}");
         return;
     }
-
-    DynamicJsonDocument configDoc(JSON_BUFFER_SIZE);
-    deserializeJson(configDoc, file);
-    file.close();
+    JsonObject wifiCfg = section.obj();
 
     // Update hostname if provided
     if (doc.containsKey("hostname")) {
         String newHostname = doc["hostname"].as<String>();
         if (newHostname.length() > 0) {
-            configDoc["wifi"]["hostname"] = newHostname;
+            wifiCfg["hostname"] = newHostname;
         }
     }
 
     // Update ap_mode if provided
     if (doc.containsKey("ap_mode")) {
-        configDoc["wifi"]["ap_mode"] = doc["ap_mode"];
+        wifiCfg["ap_mode"] = doc["ap_mode"];
     }
 
     // Check for action-based operations
@@ -668,6 +1463,7 @@ void WebServerManager::handleWiFiConfigPost(AsyncWebServerRequest *request,
         if (action == "add") {
             // Add a new network
             if (!doc.containsKey("ssid")) {
+                section.discard();
                 request->send(400, "application/json", "{\"error\":\"Missing ssid\"}");
                 return;
             }
@@ -676,12 +1472,13 @@ void WebServerManager::handleWiFiConfigPost(AsyncWebServerRequest *request,
             String newPassword = doc["password"] | "";
 
             // Check if we have room
-            if (!configDoc["wifi"].containsKey("networks")) {
-                configDoc["wifi"].createNestedArray("networks");
+            if (!wifiCfg.containsKey("networks")) {
+                wifiCfg.createNestedArray("networks");
             }
-            JsonArray networks = configDoc["wifi"]["networks"].as<JsonArray>();
+            JsonArray networks = wifiCfg["networks"].as<JsonArray>();
 
             if (networks.size() >= WIFI_MAX_NETWORKS) {
+                section.discard();
                 request->send(400, "application/json", "{\"error\":\"Maximum networks reached\"}");
                 return;
             }
@@ -705,14 +1502,15 @@ void WebServerManager::handleWiFiConfigPost(AsyncWebServerRequest *request,
         } else if (action == "remove") {
             // Remove a network by SSID
             if (!doc.containsKey("ssid")) {
+                section.discard();
                 request->send(400, "application/json", "{\"error\":\"Missing ssid\"}");
                 return;
             }
 
             String removeSsid = doc["ssid"].as<String>();
 
-            if (configDoc["wifi"].containsKey("networks")) {
-                JsonArray networks = configDoc["wifi"]["networks"].as<JsonArray>();
+            if (wifiCfg.containsKey("networks")) {
+                JsonArray networks = wifiCfg["networks"].as<JsonArray>();
                 for (size_t i = 0; i < networks.size(); i++) {
                     if (networks[i]["ssid"].as<String>() == removeSsid) {
                         networks.remove(i);
@@ -724,12 +1522,13 @@ void WebServerManager::handleWiFiConfigPost(AsyncWebServerRequest *request,
         } else if (action == "reorder") {
             // Reorder networks based on provided order
             if (!doc.containsKey("order") || !doc["order"].is<JsonArray>()) {
+                section.discard();
                 request->send(400, "application/json", "{\"error\":\"Missing order array\"}");
                 return;
             }
 
             JsonArray order = doc["order"].as<JsonArray>();
-            JsonArray oldNetworks = configDoc["wifi"]["networks"].as<JsonArray>();
+            JsonArray oldNetworks = wifiCfg["networks"].as<JsonArray>();
 
             // Create temporary storage for reordered networks
             DynamicJsonDocument tempDoc(512);
@@ -748,7 +1547,7 @@ void WebServerManager::handleWiFiConfigPost(AsyncWebServerRequest *request,
             }
 
             // Replace networks array
-            configDoc["wifi"]["networks"] = newNetworks;
+            wifiCfg["networks"] = newNetworks;
         }
 
     } else if (doc.containsKey("networks") && doc["networks"].is<JsonArray>()) {
@@ -756,10 +1555,10 @@ void WebServerManager::handleWiFiConfigPost(AsyncWebServerRequest *request,
         JsonArray newNetworks = doc["networks"].as<JsonArray>();
 
         // Clear and recreate networks array
-        if (!configDoc["wifi"].containsKey("networks")) {
-            configDoc["wifi"].createNestedArray("networks");
+        if (!wifiCfg.containsKey("networks")) {
+            wifiCfg.createNestedArray("networks");
         }
-        JsonArray configNetworks = configDoc["wifi"]["networks"];
+        JsonArray configNetworks = wifiCfg["networks"];
         configNetworks.clear();
 
         int count = 0;
@@ -777,16 +1576,7 @@ void WebServerManager::handleWiFiConfigPost(AsyncWebServerRequest *request,
     }
 
 save_config:
-    // Save config
-    file = LittleFS.open("/config.json", "w");
-    if (!file) {
-        request->send(500, "application/json", "{\"error\":\"Cannot write config\"}");
-        return;
-    }
-
-    serializeJsonPretty(configDoc, file);
-    file.close();
-
+    // Written by configStore after debounce
     request->send(200, "application/json", "{\"success\":true,\"message\":\"WiFi config saved. Restart to apply.\"}");
 }
 
@@ -898,6 +1688,10 @@ void WebServerManager::handleNTPSync(AsyncWebServerRequest *request) {
 }
 
 void WebServerManager::handleLCDConfig(AsyncWebServerRequest *request) {
+    if (peripheralsPending(request)) return;
+    uint32_t version = configStore.getSectionGeneration(ConfigSection::LCD);
+    if (responseCache.serve(request, CachedEndpoint::LCD_CONFIG, version)) return;
+
     LCDConfig& cfg = lcdManager.getConfig();
 
     DynamicJsonDocument doc(512);
@@ -910,11 +1704,10 @@ void WebServerManager::handleLCDConfig(AsyncWebServerRequest *request) {
     doc["scl"] = cfg.scl;
     doc["backlight"] = cfg.backlightOn;
     doc["rotation_interval"] = cfg.rotationInterval;
-    doc["available"] = lcdManager.isAvailable();
 
     String response;
     serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    responseCache.send(request, CachedEndpoint::LCD_CONFIG, version, response);
 }
 
 void WebServerManager::handleLCDConfigPost(AsyncWebServerRequest *request,
@@ -922,6 +1715,8 @@ void WebServerManager::handleLCDConfigPost(AsyncWebServerRequest *request,
                                             size_t index, size_t total) {
     if (index + len != total) return;
 
+    if (peripheralsPending(request)) return;
+
     DynamicJsonDocument doc(512);
     DeserializationError error = deserializeJson(doc, data, len);
 
@@ -954,9 +1749,25 @@ void WebServerManager::handleLCDConfigPost(AsyncWebServerRequest *request,
     }
 }
 
+void WebServerManager::handleLCDStatus(AsyncWebServerRequest *request) {
+    if (peripheralsPending(request)) return;
+
+    DynamicJsonDocument doc(128);
+    doc["enabled"] = lcdManager.getConfig().enabled;
+    doc["available"] = lcdManager.isAvailable();
+
+    String response;
+    serializeJson(doc, response);
+    request->send(200, "application/json", response);
+}
+
 // ================== Buzzer Handlers ==================
 
 void WebServerManager::handleBuzzerConfig(AsyncWebServerRequest *request) {
+    if (peripheralsPending(request)) return;
+    uint32_t version = configStore.getSectionGeneration(ConfigSection::BUZZER);
+    if (responseCache.serve(request, CachedEndpoint::BUZZER_CONFIG, version)) return;
+
     DynamicJsonDocument doc(512);
 
 #if BUZZER_ENABLED
@@ -979,7 +1790,7 @@ void WebServerManager::handleBuzzerConfig(AsyncWebServerRequest *request) {
 
     String response;
     serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    responseCache.send(request, CachedEndpoint::BUZZER_CONFIG, version, response);
 }
 
 void WebServerManager::handleBuzzerConfigPost(AsyncWebServerRequest *request,
@@ -987,6 +1798,8 @@ void WebServerManager::handleBuzzerConfigPost(AsyncWebServerRequest *request,
                                                size_t index, size_t total) {
     if (index + len != total) return;
 
+    if (peripheralsPending(request)) return;
+
     DynamicJsonDocument doc(512);
     DeserializationError error = deserializeJson(doc, data, len);
 
@@ -1022,6 +1835,8 @@ void WebServerManager::handleBuzzerTest(AsyncWebServerRequest *request,
                                          size_t index, size_t total) {
     if (index + len != total) return;
 
+    if (peripheralsPending(request)) return;
+
     DynamicJsonDocument doc(256);
     DeserializationError error = deserializeJson(doc, data, len);
 
@@ -1059,6 +1874,7 @@ void WebServerManager::handleBuzzerTest(AsyncWebServerRequest *request,
 }
 
 void WebServerManager::handleGPSConfig(AsyncWebServerRequest *request) {
+    if (peripheralsPending(request)) return;
 #if GPS_ENABLED
     request->send(200, "application/json", gpsManager.getStatusJson());
 #else
@@ -1076,6 +1892,8 @@ void WebServerManager::handleGPSConfigPost(AsyncWebServerRequest *request,
                                             size_t index, size_t total) {
     if (index + len != total) return;
 
+    if (peripheralsPending(request)) return;
+
     DynamicJsonDocument doc(512);
     DeserializationError error = deserializeJson(doc, data, len);
 
@@ -1109,9 +1927,12 @@ void WebServerManager::handleGPSConfigPost(AsyncWebServerRequest *request,
 // ================== RTC Handlers ==================
 
 void WebServerManager::handleRTCConfig(AsyncWebServerRequest *request) {
+    if (peripheralsPending(request)) return;
 #if RTC_ENABLED
+    uint32_t version = configStore.getSectionGeneration(ConfigSection::RTC);
+    if (responseCache.serve(request, CachedEndpoint::RTC_CONFIG, version)) return;
+
     RTCConfig& cfg = rtcManager.getConfig();
-    RTCStatus& st = rtcManager.getStatus();
 
     DynamicJsonDocument doc(512);
     doc["enabled"] = cfg.enabled;
@@ -1123,11 +1944,10 @@ void WebServerManager::handleRTCConfig(AsyncWebServerRequest *request) {
     doc["syncInterval"] = cfg.syncInterval;
     doc["squareWaveMode"] = cfg.squareWaveMode;
     doc["timezoneOffset"] = cfg.timezoneOffset;
-    doc["available"] = st.available;
 
     String response;
     serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    responseCache.send(request, CachedEndpoint::RTC_CONFIG, version, response);
 #else
     DynamicJsonDocument doc(128);
     doc["enabled"] = false;
@@ -1143,6 +1963,8 @@ void WebServerManager::handleRTCConfigPost(AsyncWebServerRequest *request,
                                             size_t index, size_t total) {
     if (index + len != total) return;
 
+    if (peripheralsPending(request)) return;
+
     DynamicJsonDocument doc(512);
     DeserializationError error = deserializeJson(doc, data, len);
 
@@ -1177,6 +1999,7 @@ void WebServerManager::handleRTCConfigPost(AsyncWebServerRequest *request,
 }
 
 void WebServerManager::handleRTCStatus(AsyncWebServerRequest *request) {
+    if (peripheralsPending(request)) return;
 #if RTC_ENABLED
     request->send(200, "application/json", rtcManager.getStatusJson());
 #else
@@ -1191,6 +2014,7 @@ void WebServerManager::handleRTCStatus(AsyncWebServerRequest *request) {
 }
 
 void WebServerManager::handleRTCSync(AsyncWebServerRequest *request) {
+    if (peripheralsPending(request)) return;
 #if RTC_ENABLED
     if (!rtcManager.isAvailable()) {
         request->send(400, "application/json", "{\"success\":false,\"error\":\"RTC not available\"}");
@@ -1220,6 +2044,8 @@ void WebServerManager::handleRTCSetTime(AsyncWebServerRequest *request,
                                          size_t index, size_t total) {
     if (index + len != total) return;
 
+    if (peripheralsPending(request)) return;
+
     DynamicJsonDocument doc(512);
     DeserializationError error = deserializeJson(doc, data, len);
 
@@ -1288,6 +2114,7 @@ void WebServerManager::handleRTCSetTime(AsyncWebServerRequest *request,
 
 void WebServerManager::handleRestart(AsyncWebServerRequest *request) {
     request->send(200, "application/json", "{\"success\":true,\"message\":\"Restarting...\"}");
+    configStore.flush();
     delay(500);
     ESP.restart();
 }
@@ -1350,6 +2177,10 @@ bool WebServerManager::isValidESP32Firmware(uint8_t *data, size_t len) {
 void WebServerManager::loop() {
     // Cleanup disconnected WebSocket clients
     ws.cleanupClients();
+
+    // Send the batch of received packets and the metric deltas
+    packetStream.flush(ws);
+    metricsHub.push(ws);
 }
 
 // ============================================================================
@@ -1581,6 +2412,11 @@ void WebServerManager::handleFileWrite(AsyncWebServerRequest *request) {
     size_t written = file.print(content);
     file.close();
 
+    // Config edited by hand: make the in-memory copy follow the file
+    if (written > 0 && filepath == CONFIG_FILE_PATH) {
+        configStore.reloadFromFile();
+    }
+
     if (written > 0) {
         request->send(200, "application/json", "{\"status\":\"ok\"}");
     } else {
@@ -1681,12 +2517,17 @@ void WebServerManager::handleFileUpload(AsyncWebServerRequest *request, String f
     if (final && uploadFile) {
         Serial.printf("[Files] Upload complete: %u bytes\n", index + len);
         uploadFile.close();
+
+        if (strcmp(uploadFile.path(), CONFIG_FILE_PATH) == 0) {
+            configStore.reloadFromFile();
+        }
     }
 }
 
 // ==================== Network Manager Handlers ====================
 
 void WebServerManager::handleNetworkStatus(AsyncWebServerRequest *request) {
+    if (peripheralsPending(request)) return;
     if (networkManager) {
         String json = networkManager->getStatusJson();
         request->send(200, "application/json", json);
@@ -1696,6 +2537,7 @@ void WebServerManager::handleNetworkStatus(AsyncWebServerRequest *request) {
 }
 
 void WebServerManager::handleNetworkHealth(AsyncWebServerRequest *request) {
+    if (peripheralsPending(request)) return;
     if (networkManager) {
         String json = networkManager->getHealthJson();
         request->send(200, "application/json", json);
@@ -1705,11 +2547,15 @@ void WebServerManager::handleNetworkHealth(AsyncWebServerRequest *request) {
 }
 
 void WebServerManager::handleNetworkConfig(AsyncWebServerRequest *request) {
+    if (peripheralsPending(request)) return;
     if (!networkManager) {
         request->send(503, "application/json", "{\"error\":\"Network Manager not available\"}");
         return;
     }
 
+    uint32_t version = configStore.getSectionGeneration(ConfigSection::NETWORK);
+    if (responseCache.serve(request, CachedEndpoint::NETWORK_CONFIG, version)) return;
+
     DynamicJsonDocument doc(1536);
     NetworkManagerConfig& cfg = networkManager->getConfig();
 
@@ -1748,11 +2594,12 @@ void WebServerManager::handleNetworkConfig(AsyncWebServerRequest *request) {
 
     String output;
     serializeJson(doc, output);
-    request->send(200, "application/json", output);
+    responseCache.send(request, CachedEndpoint::NETWORK_CONFIG, version, output);
 }
 
 void WebServerManager::handleNetworkConfigPost(AsyncWebServerRequest *request, uint8_t *data,
                                                 size_t len, size_t index, size_t total) {
+    if (peripheralsPending(request)) return;
     if (!networkManager) {
         request->send(503, "application/json", "{\"error\":\"Network Manager not available\"}");
         return;
@@ -1859,6 +2706,7 @@ void WebServerManager::handleNetworkConfigPost(AsyncWebServerRequest *request, u
 
 void WebServerManager::handleNetworkForce(AsyncWebServerRequest *request, uint8_t *data,
                                            size_t len, size_t index, size_t total) {
+    if (peripheralsPending(request)) return;
     if (!networkManager) {
         request->send(503, "application/json", "{\"error\":\"Network Manager not available\"}");
         return;
@@ -1899,6 +2747,7 @@ void WebServerManager::handleNetworkForce(AsyncWebServerRequest *request, uint8_
 }
 
 void WebServerManager::handleNetworkReconnect(AsyncWebServerRequest *request) {
+    if (peripheralsPending(request)) return;
     if (!networkManager) {
         request->send(503, "application/json", "{\"error\":\"Network Manager not available\"}");
         return;
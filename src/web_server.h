@@ -36,9 +36,22 @@ private:
     void handleLoRaConfig(AsyncWebServerRequest *request);
     void handleLoRaConfigPost(AsyncWebServerRequest *request, uint8_t *data,
                                size_t len, size_t index, size_t total);
+    void handleAutoTune(AsyncWebServerRequest *request);
+    void handleAutoTunePost(AsyncWebServerRequest *request, uint8_t *data,
+                             size_t len, size_t index, size_t total);
+    void handleNoiseFloor(AsyncWebServerRequest *request);
+    void handleDevices(AsyncWebServerRequest *request);
+    void handleBadFrames(AsyncWebServerRequest *request);
     void handleServerConfig(AsyncWebServerRequest *request);
     void handleServerConfigPost(AsyncWebServerRequest *request, uint8_t *data,
                                  size_t len, size_t index, size_t total);
+    void handleFilter(AsyncWebServerRequest *request);
+    void handleFilterPost(AsyncWebServerRequest *request, uint8_t *data,
+                          size_t len, size_t index, size_t total);
+    void handleCapture(AsyncWebServerRequest *request);
+    void handleCapturePost(AsyncWebServerRequest *request, uint8_t *data,
+                           size_t len, size_t index, size_t total);
+    void handleCapturePcap(AsyncWebServerRequest *request);
     void handleWiFiConfig(AsyncWebServerRequest *request);
     void handleWiFiConfigPost(AsyncWebServerRequest *request, uint8_t *data,
                                size_t len, size_t index, size_t total);
@@ -50,6 +63,7 @@ private:
     void handleLCDConfig(AsyncWebServerRequest *request);
     void handleLCDConfigPost(AsyncWebServerRequest *request, uint8_t *data,
                               size_t len, size_t index, size_t total);
+    void handleLCDStatus(AsyncWebServerRequest *request);
     void handleBuzzerConfig(AsyncWebServerRequest *request);
     void handleBuzzerConfigPost(AsyncWebServerRequest *request, uint8_t *data,
                                  size_t len, size_t index, size_t total);
@@ -97,6 +111,9 @@ private:
 
     // Security helpers
     bool isValidPath(const String& path);
+
+    // 503 until the boot task has initialized the peripherals
+    bool peripheralsPending(AsyncWebServerRequest *request);
 };
 
 // Global instance
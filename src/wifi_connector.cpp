@@ -0,0 +1,402 @@
+/**
+ * @file wifi_connector.cpp
+ * @brief Non-blocking WiFi station connection manager
+ */
+
+#include "wifi_connector.h"
+#include <Preferences.h>
+
+// Global instance
+WiFiConnector wifiConnector;
+
+// Event flags (written by the WiFi event task)
+volatile bool WiFiConnector::gotIpFlag = false;
+volatile bool WiFiConnector::disconnectedFlag = false;
+volatile uint8_t WiFiConnector::disconnectReason = 0;
+
+WiFiConnector::WiFiConnector()
+    : networks(nullptr)
+    , state(WiFiConnectState::IDLE)
+    , candidateCount(0)
+    , candidateIndex(0)
+    , connectingIndex(-1)
+    , stateStart(0)
+    , connectStart(0)
+    , viaCache(false)
+    , fallbackActive(false)
+    , connectedCallback(nullptr)
+    , fallbackCallback(nullptr) {
+
+    memset(&stats, 0, sizeof(stats));
+    memset(&cache, 0, sizeof(cache));
+}
+
+void WiFiConnector::onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            gotIpFlag = true;
+            break;
+
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            disconnectReason = info.wifi_sta_disconnected.reason;
+            disconnectedFlag = true;
+            break;
+
+        default:
+            break;
+    }
+}
+
+void WiFiConnector::begin(const std::vector<WiFiNetwork>* networkList, const char* host) {
+    networks = networkList;
+    hostname = host;
+
+    Serial.printf("[WiFi] %d network(s) configured\n", networks ? networks->size() : 0);
+
+    WiFi.onEvent(onWiFiEvent);
+    prepareStation();
+    loadCache();
+    connectStart = millis();
+
+    if (!startFastConnect()) {
+        startScan();
+    }
+}
+
+void WiFiConnector::prepareStation() {
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
+    WiFi.mode(WIFI_STA);
+    WiFi.setHostname(hostname.c_str());
+    WiFi.setSleep(false);
+}
+
+void WiFiConnector::setState(WiFiConnectState newState) {
+    state = newState;
+    stateStart = millis();
+}
+
+const char* WiFiConnector::getStateName() const {
+    switch (state) {
+        case WiFiConnectState::IDLE:         return "idle";
+        case WiFiConnectState::FAST_CONNECT: return "fast_connect";
+        case WiFiConnectState::SCANNING:     return "scanning";
+        case WiFiConnectState::CONNECTING:   return "connecting";
+        case WiFiConnectState::CONNECTED:    return "connected";
+        case WiFiConnectState::WAIT_RETRY:   return "wait_retry";
+        case WiFiConnectState::AP_FALLBACK:  return "ap_fallback";
+    }
+    return "unknown";
+}
+
+int WiFiConnector::findNetwork(const char* ssid) const {
+    if (!networks) return -1;
+    for (size_t i = 0; i < networks->size(); i++) {
+        if ((*networks)[i].ssid == ssid) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+bool WiFiConnector::startFastConnect() {
+    if (!cache.valid) return false;
+
+    // Cached network must still be configured (password may have changed)
+    int index = findNetwork(cache.ssid);
+    if (index < 0) {
+        Serial.printf("[WiFi] Cached network %s no longer configured\n", cache.ssid);
+        return false;
+    }
+
+    const WiFiNetwork& network = (*networks)[index];
+    Serial.printf("[WiFi] Fast reconnect to %s (ch %d, %02X:%02X:%02X:%02X:%02X:%02X)\n",
+                  cache.ssid, cache.channel,
+                  cache.bssid[0], cache.bssid[1], cache.bssid[2],
+                  cache.bssid[3], cache.bssid[4], cache.bssid[5]);
+
+    gotIpFlag = false;
+    disconnectedFlag = false;
+    connectingIndex = index;
+    viaCache = true;
+    WiFi.begin(network.ssid.c_str(), network.password.c_str(), cache.channel, cache.bssid);
+    setState(WiFiConnectState::FAST_CONNECT);
+    return true;
+}
+
+void WiFiConnector::startScan() {
+    if (!networks || networks->empty()) {
+        enterFallback();
+        return;
+    }
+
+    Serial.println("[WiFi] Scanning for configured networks...");
+    WiFi.disconnect();
+    WiFi.scanDelete();
+    WiFi.scanNetworks(true);  // async
+    setState(WiFiConnectState::SCANNING);
+}
+
+void WiFiConnector::rankCandidates(int found) {
+    candidateCount = 0;
+    candidateIndex = 0;
+
+    // Strongest AP for each configured SSID seen in the scan
+    for (size_t n = 0; n < networks->size() && candidateCount < WIFI_MAX_NETWORKS; n++) {
+        const String& ssid = (*networks)[n].ssid;
+        int best = -1;
+        for (int i = 0; i < found; i++) {
+            if (WiFi.SSID(i) == ssid && (best < 0 || WiFi.RSSI(i) > WiFi.RSSI(best))) {
+                best = i;
+            }
+        }
+
+        Candidate& c = candidates[candidateCount++];
+        c.networkIndex = (int8_t)n;
+        if (best >= 0) {
+            c.rssi = WiFi.RSSI(best);
+            c.channel = WiFi.channel(best);
+            memcpy(c.bssid, WiFi.BSSID(best), 6);
+        } else {
+            // Not seen (out of range or hidden) - still try it last, unpinned
+            c.rssi = INT32_MIN;
+            c.channel = 0;
+            memset(c.bssid, 0, sizeof(c.bssid));
+        }
+    }
+
+    // Insertion sort by RSSI, strongest first (stable: keeps config order on ties)
+    for (uint8_t i = 1; i < candidateCount; i++) {
+        Candidate key = candidates[i];
+        int j = i - 1;
+        while (j >= 0 && candidates[j].rssi < key.rssi) {
+            candidates[j + 1] = candidates[j];
+            j--;
+        }
+        candidates[j + 1] = key;
+    }
+
+    for (uint8_t i = 0; i < candidateCount; i++) {
+        const Candidate& c = candidates[i];
+        if (c.channel > 0) {
+            Serial.printf("[WiFi] Candidate %d: %s (%d dBm, ch %d)\n", i + 1,
+                          (*networks)[c.networkIndex].ssid.c_str(), c.rssi, c.channel);
+        } else {
+            Serial.printf("[WiFi] Candidate %d: %s (not seen in scan)\n", i + 1,
+                          (*networks)[c.networkIndex].ssid.c_str());
+        }
+    }
+
+    WiFi.scanDelete();
+}
+
+bool WiFiConnector::connectNextCandidate() {
+    while (candidateIndex < candidateCount) {
+        const Candidate& c = candidates[candidateIndex++];
+        const WiFiNetwork& network = (*networks)[c.networkIndex];
+
+        Serial.printf("[WiFi] Connecting to %s...\n", network.ssid.c_str());
+
+        gotIpFlag = false;
+        disconnectedFlag = false;
+        connectingIndex = c.networkIndex;
+        viaCache = false;
+
+        if (c.channel > 0) {
+            WiFi.begin(network.ssid.c_str(), network.password.c_str(), c.channel, c.bssid);
+        } else {
+            WiFi.begin(network.ssid.c_str(), network.password.c_str());
+        }
+        setState(WiFiConnectState::CONNECTING);
+        return true;
+    }
+    return false;
+}
+
+void WiFiConnector::update() {
+    unsigned long now = millis();
+    unsigned long elapsed = now - stateStart;
+
+    // Our own WiFi.disconnect() before a new attempt is not a failure
+    if (disconnectedFlag && disconnectReason == WIFI_REASON_ASSOC_LEAVE &&
+        (state == WiFiConnectState::FAST_CONNECT || state == WiFiConnectState::CONNECTING)) {
+        disconnectedFlag = false;
+    }
+
+    switch (state) {
+        case WiFiConnectState::FAST_CONNECT:
+            if (gotIpFlag) {
+                handleConnected();
+            } else if (disconnectedFlag || elapsed >= WIFI_FAST_CONNECT_TIMEOUT) {
+                Serial.printf("[WiFi] Fast reconnect failed (reason %d), scanning\n",
+                              disconnectedFlag ? disconnectReason : 0);
+                stats.failedAttempts++;
+                startScan();
+            }
+            break;
+
+        case WiFiConnectState::SCANNING: {
+            int found = WiFi.scanComplete();
+            if (found >= 0) {
+                Serial.printf("[WiFi] Scan complete: %d AP(s) visible\n", found);
+                rankCandidates(found);
+                if (!connectNextCandidate()) {
+                    enterFallback();
+                }
+            } else if (found == WIFI_SCAN_FAILED || elapsed >= WIFI_SCAN_TIMEOUT) {
+                // Scan unusable - try configured networks blindly
+                Serial.println("[WiFi] Scan failed, trying networks in configured order");
+                WiFi.scanDelete();
+                rankCandidates(0);
+                if (!connectNextCandidate()) {
+                    enterFallback();
+                }
+            }
+            break;
+        }
+
+        case WiFiConnectState::CONNECTING:
+            if (gotIpFlag) {
+                handleConnected();
+            } else if (disconnectedFlag || elapsed >= WIFI_CONNECT_TIMEOUT) {
+                Serial.printf("[WiFi] Connection to %s failed (reason %d)\n",
+                              (*networks)[connectingIndex].ssid.c_str(),
+                              disconnectedFlag ? disconnectReason : 0);
+                stats.failedAttempts++;
+                WiFi.disconnect();
+                if (!connectNextCandidate()) {
+                    enterFallback();
+                }
+            }
+            break;
+
+        case WiFiConnectState::CONNECTED:
+            if (disconnectedFlag) {
+                disconnectedFlag = false;
+                stats.disconnects++;
+                stats.lastDisconnectReason = disconnectReason;
+                Serial.printf("[WiFi] Connection lost (reason %d)\n", disconnectReason);
+                setState(WiFiConnectState::WAIT_RETRY);
+            }
+            break;
+
+        case WiFiConnectState::WAIT_RETRY:
+            if (elapsed >= WIFI_RECONNECT_DELAY) {
+                connectStart = now;
+                if (!startFastConnect()) {
+                    startScan();
+                }
+            }
+            break;
+
+        case WiFiConnectState::AP_FALLBACK:
+            // The AP stays up (AP+STA) while the station looks again
+            if (elapsed >= WIFI_FALLBACK_RESCAN && networks && !networks->empty()) {
+                connectStart = now;
+                if (!startFastConnect()) {
+                    startScan();
+                }
+            }
+            break;
+
+        case WiFiConnectState::IDLE:
+            break;
+    }
+}
+
+void WiFiConnector::handleConnected() {
+    gotIpFlag = false;
+    disconnectedFlag = false;
+
+    stats.lastConnectTime = millis() - connectStart;
+    if (viaCache) {
+        stats.fastConnects++;
+    } else {
+        stats.scanConnects++;
+    }
+
+    const WiFiNetwork& network = (*networks)[connectingIndex];
+    Serial.printf("[WiFi] Connected to %s in %lu ms%s\n", network.ssid.c_str(),
+                  (unsigned long)stats.lastConnectTime, viaCache ? " (cached BSSID)" : "");
+    Serial.printf("[WiFi] IP: %s, RSSI: %d dBm\n",
+                  WiFi.localIP().toString().c_str(), WiFi.RSSI());
+
+    saveCache(network.ssid.c_str(), WiFi.BSSID(), (uint8_t)WiFi.channel());
+    setState(WiFiConnectState::CONNECTED);
+
+    if (connectedCallback) {
+        connectedCallback(network.ssid.c_str());
+    }
+    fallbackActive = false;
+}
+
+void WiFiConnector::enterFallback() {
+    WiFi.disconnect();
+    setState(WiFiConnectState::AP_FALLBACK);
+
+    if (fallbackActive) {
+        Serial.printf("[WiFi] No configured network yet, next try in %d s\n",
+                      WIFI_FALLBACK_RESCAN / 1000);
+        return;
+    }
+
+    Serial.println("[WiFi] All networks failed");
+    fallbackActive = true;
+    if (fallbackCallback) {
+        fallbackCallback();
+    }
+}
+
+// ================== Fast-reconnect cache ==================
+
+void WiFiConnector::loadCache() {
+    Preferences prefs;
+    cache.valid = false;
+
+    if (!prefs.begin(WIFI_CACHE_NAMESPACE, true)) {
+        return;
+    }
+
+    size_t ssidLen = prefs.getString("ssid", cache.ssid, sizeof(cache.ssid));
+    size_t bssidLen = prefs.getBytes("bssid", cache.bssid, sizeof(cache.bssid));
+    cache.channel = prefs.getUChar("chan", 0);
+    prefs.end();
+
+    cache.valid = ssidLen > 0 && bssidLen == sizeof(cache.bssid) &&
+                  cache.channel >= 1 && cache.channel <= 14;
+}
+
+void WiFiConnector::saveCache(const char* ssid, const uint8_t* bssid, uint8_t channel) {
+    if (!bssid) return;
+
+    // Only touch NVS when something actually changed
+    if (cache.valid && strcmp(cache.ssid, ssid) == 0 &&
+        memcmp(cache.bssid, bssid, 6) == 0 && cache.channel == channel) {
+        return;
+    }
+
+    Preferences prefs;
+    if (!prefs.begin(WIFI_CACHE_NAMESPACE, false)) {
+        Serial.println("[WiFi] Cannot open NVS for BSSID cache");
+        return;
+    }
+    prefs.putString("ssid", ssid);
+    prefs.putBytes("bssid", bssid, 6);
+    prefs.putUChar("chan", channel);
+    prefs.end();
+
+    strlcpy(cache.ssid, ssid, sizeof(cache.ssid));
+    memcpy(cache.bssid, bssid, 6);
+    cache.channel = channel;
+    cache.valid = true;
+    Serial.printf("[WiFi] Cached BSSID/channel for %s\n", ssid);
+}
+
+void WiFiConnector::clearCache() {
+    Preferences prefs;
+    if (prefs.begin(WIFI_CACHE_NAMESPACE, false)) {
+        prefs.clear();
+        prefs.end();
+    }
+    cache.valid = false;
+}
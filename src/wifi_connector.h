@@ -0,0 +1,148 @@
+/**
+ * @file wifi_connector.h
+ * @brief Non-blocking WiFi station connection manager
+ *
+ * Scans once, ranks the configured SSIDs by RSSI and connects in the
+ * background while the LoRa radio is already receiving. The BSSID and
+ * channel of the last successful connection are cached in NVS so the
+ * next boot can skip the scan and reconnect in well under a second.
+ */
+
+#ifndef WIFI_CONNECTOR_H
+#define WIFI_CONNECTOR_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <vector>
+#include "config.h"
+
+// Connection timing
+#define WIFI_FAST_CONNECT_TIMEOUT   3000    // Attempt on cached BSSID/channel
+#define WIFI_CONNECT_TIMEOUT        10000   // Attempt per scanned candidate
+#define WIFI_SCAN_TIMEOUT           8000    // Async scan watchdog
+#define WIFI_RECONNECT_DELAY        2000    // Delay before reconnecting after a drop
+#define WIFI_FALLBACK_RESCAN        60000   // Retry the station from the fallback AP
+
+// NVS namespace for the fast-reconnect cache
+#define WIFI_CACHE_NAMESPACE        "wifi_fast"
+
+// WiFi network structure (configured station networks)
+struct WiFiNetwork {
+    String ssid;
+    String password;
+};
+
+// Connection state machine
+enum class WiFiConnectState {
+    IDLE,
+    FAST_CONNECT,   // Connecting straight to cached BSSID/channel
+    SCANNING,       // Async scan in progress
+    CONNECTING,     // Trying ranked scan candidates
+    CONNECTED,
+    WAIT_RETRY,     // Link dropped, waiting before reconnecting
+    AP_FALLBACK     // All networks failed, fallback AP is up; rescans (AP+STA)
+};
+
+// Connection statistics
+struct WiFiConnectStats {
+    uint32_t fastConnects;      // Connections made via cached BSSID/channel
+    uint32_t scanConnects;      // Connections made after a scan
+    uint32_t failedAttempts;    // Candidate attempts that failed
+    uint32_t disconnects;       // Link drops while connected
+    uint32_t lastConnectTime;   // Duration of last connection (ms, from start to IP)
+    uint8_t lastDisconnectReason;
+};
+
+// Called from update() (loop context) when the station gets an IP
+typedef void (*WiFiConnectedCallback)(const char* ssid);
+
+// Called from update() (loop context) when every configured network failed;
+// not again on the failed rescans that follow while the fallback AP is up
+typedef void (*WiFiFallbackCallback)();
+
+class WiFiConnector {
+public:
+    WiFiConnector();
+
+    // Start connecting in the background (returns immediately)
+    void begin(const std::vector<WiFiNetwork>* networks, const char* hostname);
+
+    // Drive the state machine (call from loop)
+    void update();
+
+    // Callbacks
+    void setConnectedCallback(WiFiConnectedCallback callback) { connectedCallback = callback; }
+    void setFallbackCallback(WiFiFallbackCallback callback) { fallbackCallback = callback; }
+
+    // Status
+    bool isConnected() const { return state == WiFiConnectState::CONNECTED; }
+    // Fallback AP up; still true inside the connected callback that ends it
+    bool isFallbackActive() const { return fallbackActive; }
+    WiFiConnectState getState() const { return state; }
+    const char* getStateName() const;
+    const WiFiConnectStats& getStats() const { return stats; }
+
+    // Forget the cached BSSID/channel
+    void clearCache();
+
+private:
+    // Scan candidate (configured network seen in scan)
+    struct Candidate {
+        int8_t networkIndex;    // Index into configured networks
+        int32_t rssi;
+        uint8_t bssid[6];
+        int32_t channel;        // 0 = unknown (not seen in scan / hidden)
+    };
+
+    // Fast-reconnect cache
+    struct FastCache {
+        bool valid;
+        char ssid[33];
+        uint8_t bssid[6];
+        uint8_t channel;
+    };
+
+    const std::vector<WiFiNetwork>* networks;
+    String hostname;
+
+    WiFiConnectState state;
+    WiFiConnectStats stats;
+    FastCache cache;
+
+    Candidate candidates[WIFI_MAX_NETWORKS];
+    uint8_t candidateCount;
+    uint8_t candidateIndex;
+    int8_t connectingIndex;     // Network being tried
+
+    unsigned long stateStart;
+    unsigned long connectStart;
+    bool viaCache;
+    bool fallbackActive;
+
+    WiFiConnectedCallback connectedCallback;
+    WiFiFallbackCallback fallbackCallback;
+
+    // Set from the WiFi event task, consumed in update()
+    static volatile bool gotIpFlag;
+    static volatile bool disconnectedFlag;
+    static volatile uint8_t disconnectReason;
+    static void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info);
+
+    void setState(WiFiConnectState newState);
+    void prepareStation();
+    bool startFastConnect();
+    void startScan();
+    void rankCandidates(int found);
+    bool connectNextCandidate();
+    void handleConnected();
+    void enterFallback();
+    int findNetwork(const char* ssid) const;
+
+    void loadCache();
+    void saveCache(const char* ssid, const uint8_t* bssid, uint8_t channel);
+};
+
+// Global instance
+extern WiFiConnector wifiConnector;
+
+#endif // WIFI_CONNECTOR_H
@@ -0,0 +1,143 @@
+/**
+ * @file test_airtime.cpp
+ * @brief Tests for LoRa time on air and the duty-cycle ledger
+ *
+ * Tests the Semtech time-on-air formula against reference values, and the
+ * one-minute bucket ring that keeps the rolling-hour airtime per sub-band.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstring>
+
+#include "airtime.h"
+#include "duty_window.h"
+
+// ============================================================
+// Time on Air Tests
+// ============================================================
+
+void test_toa_sf7_short_frame(void) {
+    // SF7/125 kHz, CR 4/5, 13 bytes (empty LoRaWAN uplink)
+    TEST_ASSERT_EQUAL_UINT32(46336, loraTimeOnAirUs(7, 125.0f, 5, 13));
+}
+
+void test_toa_sf10_51_bytes(void) {
+    TEST_ASSERT_EQUAL_UINT32(616448, loraTimeOnAirUs(10, 125.0f, 5, 51));
+}
+
+void test_toa_sf12_uses_low_data_rate_optimization(void) {
+    // Tsym = 32.768 ms > 16 ms: DE = 1
+    TEST_ASSERT_EQUAL_UINT32(1155072, loraTimeOnAirUs(12, 125.0f, 5, 13));
+}
+
+void test_toa_grows_with_payload(void) {
+    uint32_t previous = 0;
+    for (uint16_t length = 0; length <= 255; length += 17) {
+        uint32_t toa = loraTimeOnAirUs(9, 125.0f, 5, length);
+        TEST_ASSERT_TRUE(toa >= previous);
+        previous = toa;
+    }
+}
+
+void test_toa_wider_bandwidth_is_shorter(void) {
+    TEST_ASSERT_TRUE(loraTimeOnAirUs(7, 250.0f, 5, 20) < loraTimeOnAirUs(7, 125.0f, 5, 20));
+    TEST_ASSERT_TRUE(loraTimeOnAirUs(12, 500.0f, 5, 20) < loraTimeOnAirUs(12, 125.0f, 5, 20));
+}
+
+void test_toa_invalid_parameters(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, loraTimeOnAirUs(13, 125.0f, 5, 10));
+    TEST_ASSERT_EQUAL_UINT32(0, loraTimeOnAirUs(7, 125.0f, 4, 10));
+    TEST_ASSERT_EQUAL_UINT32(0, loraTimeOnAirUs(7, 0.0f, 5, 10));
+}
+
+// ============================================================
+// Duty Cycle Ledger Tests
+// ============================================================
+
+void test_budget_one_percent_is_36_seconds(void) {
+    DutyWindow ledger;
+    ledger.reset(0, 100);
+    TEST_ASSERT_EQUAL_UINT32(36000000, ledger.budgetUs());
+}
+
+void test_rejects_when_budget_exhausted(void) {
+    DutyWindow ledger;
+    ledger.reset(0, 100);
+
+    // 31 SF12 frames of 1.155 s fit in 36 s, the 32nd does not
+    uint32_t frame = loraTimeOnAirUs(12, 125.0f, 5, 13);
+    uint32_t now = 0;
+    for (int i = 0; i < 31; i++) {
+        TEST_ASSERT_TRUE(ledger.check(now, frame));
+        ledger.record(now, frame);
+        now += 1000;
+    }
+    TEST_ASSERT_FALSE(ledger.check(now, frame));
+}
+
+void test_airtime_leaves_after_one_hour(void) {
+    DutyWindow ledger;
+    ledger.reset(0, 100);
+    ledger.record(0, 36000000);
+    TEST_ASSERT_FALSE(ledger.check(30UL * 60 * 1000, 1000));
+
+    // Still inside the window one minute before it expires
+    TEST_ASSERT_FALSE(ledger.check(59UL * 60 * 1000, 1000));
+
+    // The bucket of minute 0 is dropped when minute 60 starts
+    TEST_ASSERT_TRUE(ledger.check(60UL * 60 * 1000, 1000));
+    TEST_ASSERT_EQUAL_UINT32(0, ledger.used);
+}
+
+void test_long_gap_clears_all_buckets(void) {
+    DutyWindow ledger;
+    ledger.reset(0, 1000);
+    for (uint32_t minute = 0; minute < 10; minute++) {
+        ledger.record(minute * 60000UL, 500000);
+    }
+    TEST_ASSERT_EQUAL_UINT32(5000000, ledger.used);
+
+    ledger.advance(5UL * 3600 * 1000);
+    TEST_ASSERT_EQUAL_UINT32(0, ledger.used);
+}
+
+void test_partial_expiry_keeps_recent_minutes(void) {
+    DutyWindow ledger;
+    ledger.reset(0, 100);
+    ledger.record(0, 1000);                 // Minute 0
+    ledger.record(30UL * 60000, 2000);      // Minute 30
+
+    ledger.advance(61UL * 60000);
+    TEST_ASSERT_EQUAL_UINT32(2000, ledger.used);
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    // Setup code before each test (if needed)
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_toa_sf7_short_frame);
+    RUN_TEST(test_toa_sf10_51_bytes);
+    RUN_TEST(test_toa_sf12_uses_low_data_rate_optimization);
+    RUN_TEST(test_toa_grows_with_payload);
+    RUN_TEST(test_toa_wider_bandwidth_is_shorter);
+    RUN_TEST(test_toa_invalid_parameters);
+    RUN_TEST(test_budget_one_percent_is_36_seconds);
+    RUN_TEST(test_rejects_when_budget_exhausted);
+    RUN_TEST(test_airtime_leaves_after_one_hour);
+    RUN_TEST(test_long_gap_clears_all_buckets);
+    RUN_TEST(test_partial_expiry_keeps_recent_minutes);
+
+    return UNITY_END();
+}
@@ -0,0 +1,156 @@
+/**
+ * @file test_auto_tuner.cpp
+ * @brief Tests for the auto tuner exposure model
+ *
+ * Tests how sweep listening time is credited to the channel/SF grid, the
+ * floor a candidate needs before it is rated, and the decay that carries the
+ * grid over between observation windows, up to the default parameters
+ * producing a recommendation.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstring>
+
+#include "auto_tuner_model.h"
+
+// SF7..SF12 over one US915/AU915 sub-band (LORA_SCAN_SF_COUNT, LORA_HOP_MAX_CHANNELS)
+#define SF_COUNT        6
+#define CHANNEL_COUNT   8
+#define SWEEP_WEIGHT    ((1UL << SF_COUNT) - 1)
+
+static uint32_t sweepExposureMs(uint32_t sweepMs, uint8_t sfIndex, uint8_t channelCount) {
+    return tunerCellExposureMs(sweepMs, tunerSfWeight(sfIndex), SWEEP_WEIGHT, channelCount);
+}
+
+// ============================================================
+// Exposure Tests
+// ============================================================
+
+void test_sweep_splits_time_by_sf_weight(void) {
+    // 60 s over 8 channels: SF7 gets 1/63, SF12 32/63 of each channel's share
+    TEST_ASSERT_EQUAL_UINT32(119, sweepExposureMs(60000, 0, CHANNEL_COUNT));
+    TEST_ASSERT_EQUAL_UINT32(3809, sweepExposureMs(60000, 5, CHANNEL_COUNT));
+}
+
+void test_exposure_without_weight_or_channels_is_zero(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, tunerCellExposureMs(60000, 1, 0, CHANNEL_COUNT));
+    TEST_ASSERT_EQUAL_UINT32(0, tunerCellExposureMs(60000, 1, SWEEP_WEIGHT, 0));
+}
+
+void test_one_default_sweep_reaches_every_floor(void) {
+    uint32_t sweepMs = TUNER_SWEEP_DURATION_DEFAULT * 1000UL;
+
+    for (uint8_t channels = 1; channels <= CHANNEL_COUNT; channels++) {
+        for (uint8_t i = 0; i < SF_COUNT; i++) {
+            uint32_t floor = tunerMinExposureMs(sweepMs, i, SF_COUNT, channels);
+            TEST_ASSERT_TRUE(floor > 0);
+            TEST_ASSERT_TRUE(floor <= TUNER_MIN_EXPOSURE_MS);
+            TEST_ASSERT_TRUE(sweepExposureMs(sweepMs, i, channels) >= floor);
+        }
+    }
+}
+
+void test_floor_capped_without_sweeps_or_for_long_sweeps(void) {
+    TEST_ASSERT_EQUAL_UINT32(TUNER_MIN_EXPOSURE_MS, tunerMinExposureMs(0, 0, SF_COUNT, CHANNEL_COUNT));
+    TEST_ASSERT_EQUAL_UINT32(TUNER_MIN_EXPOSURE_MS, tunerMinExposureMs(600000, 5, SF_COUNT, 1));
+}
+
+// ============================================================
+// Decay Tests
+// ============================================================
+
+void test_decay_keeps_three_quarters(void) {
+    TunerCell cell = { 8, 1000 };
+    tunerDecayCell(cell);
+    TEST_ASSERT_EQUAL_UINT32(6, cell.packets);
+    TEST_ASSERT_EQUAL_UINT32(750, cell.exposureMs);
+}
+
+void test_decay_accumulates_across_windows(void) {
+    // Settles at four windows' worth of listening
+    TunerCell cell = { 0, 0 };
+    for (uint8_t window = 0; window < 40; window++) {
+        cell.exposureMs += 1000;
+        if (window < 39) tunerDecayCell(cell);
+    }
+    TEST_ASSERT_TRUE(cell.exposureMs > 3990 && cell.exposureMs <= 4000);
+}
+
+// ============================================================
+// Default Parameter Tests
+// ============================================================
+
+void test_default_sweep_runs_in_every_window(void) {
+    TEST_ASSERT_TRUE(TUNER_SWEEP_INTERVAL_DEFAULT > 0);
+    TEST_ASSERT_TRUE(TUNER_SWEEP_INTERVAL_DEFAULT <= TUNER_EVAL_INTERVAL_DEFAULT);
+}
+
+void test_default_parameters_produce_recommendation(void) {
+    // Receiver fixed on channel 0 SF7, catching one packet per window there;
+    // the sweep of each window catches two packets on channel 3 SF9
+    uint32_t sweepMs = TUNER_SWEEP_DURATION_DEFAULT * 1000UL;
+    uint32_t windowMs = TUNER_EVAL_INTERVAL_DEFAULT * 1000UL;
+    const uint8_t candidate = 2;
+
+    TunerCell cell = { 0, 0 };
+    TunerCell baseline = { 0, 0 };
+    uint32_t floor = tunerMinExposureMs(sweepMs, candidate, SF_COUNT, CHANNEL_COUNT);
+
+    int recommendedAt = -1;
+    for (int window = 1; window <= 8 && recommendedAt < 0; window++) {
+        cell.packets += 2;
+        cell.exposureMs += sweepExposureMs(sweepMs, candidate, CHANNEL_COUNT);
+        baseline.packets += 1;
+        baseline.exposureMs += windowMs - sweepMs;
+
+        float rate = cell.packets * 3600000.0f / cell.exposureMs;
+        float current = baseline.packets * 3600000.0f / baseline.exposureMs;
+        if (cell.exposureMs >= floor && cell.packets >= TUNER_MIN_PACKETS_DEFAULT &&
+            rate >= current * (1.0f + TUNER_MIN_GAIN_DEFAULT / 100.0f)) {
+            recommendedAt = window;
+        }
+
+        tunerDecayCell(cell);
+        tunerDecayCell(baseline);
+    }
+
+    TEST_ASSERT_EQUAL_INT(4, recommendedAt);
+}
+
+void test_fixed_floor_never_reached_by_sf7(void) {
+    // What a 5 s floor would need: more than the decayed grid ever holds
+    uint32_t sweepMs = TUNER_SWEEP_DURATION_DEFAULT * 1000UL;
+    uint32_t perWindow = sweepExposureMs(sweepMs, 0, CHANNEL_COUNT);
+    uint32_t settled = perWindow * TUNER_DECAY_DEN / (TUNER_DECAY_DEN - TUNER_DECAY_NUM);
+    TEST_ASSERT_TRUE(settled < TUNER_MIN_EXPOSURE_MS);
+    TEST_ASSERT_TRUE(perWindow >= tunerMinExposureMs(sweepMs, 0, SF_COUNT, CHANNEL_COUNT));
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    // Setup code before each test (if needed)
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_sweep_splits_time_by_sf_weight);
+    RUN_TEST(test_exposure_without_weight_or_channels_is_zero);
+    RUN_TEST(test_one_default_sweep_reaches_every_floor);
+    RUN_TEST(test_floor_capped_without_sweeps_or_for_long_sweeps);
+    RUN_TEST(test_decay_keeps_three_quarters);
+    RUN_TEST(test_decay_accumulates_across_windows);
+    RUN_TEST(test_default_sweep_runs_in_every_window);
+    RUN_TEST(test_default_parameters_produce_recommendation);
+    RUN_TEST(test_fixed_floor_never_reached_by_sf7);
+
+    return UNITY_END();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file test_bad_frame_log.cpp
+ * @brief Tests for the CRC error frame ring
+ *
+ * Tests the sequence numbering of the bad frame log: which frames are still
+ * in the ring after it wraps, and that a reader asking for an overwritten
+ * frame gets nothing instead of a newer one.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstring>
+
+// Constants (mirror values from src/bad_frame_log.h)
+#define BAD_FRAME_LOG_SIZE  16
+
+/**
+ * Mirrors BadFrameLog (frames reduced to a tag byte)
+ */
+struct Log {
+    struct Frame {
+        uint32_t seq;
+        uint8_t tag;
+    };
+
+    Frame frames[BAD_FRAME_LOG_SIZE];
+    uint32_t total;
+
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    void record(uint8_t tag) {
+        total++;
+        Frame& frame = frames[(total - 1) % BAD_FRAME_LOG_SIZE];
+        frame.seq = total;
+        frame.tag = tag;
+    }
+
+    bool get(uint32_t seq, Frame& frame) const {
+        if (seq == 0) return false;
+        const Frame& slot = frames[(seq - 1) % BAD_FRAME_LOG_SIZE];
+        if (slot.seq != seq) return false;
+        frame = slot;
+        return true;
+    }
+
+    uint32_t firstSeq() const { return total > BAD_FRAME_LOG_SIZE ? total - BAD_FRAME_LOG_SIZE + 1 : 1; }
+    uint32_t lastSeq() const { return total; }
+};
+
+static Log ring;
+
+// Frames a reader gets walking firstSeq()..lastSeq()
+static uint32_t walk(uint8_t* tags) {
+    uint32_t count = 0;
+    Log::Frame frame;
+    for (uint32_t seq = ring.firstSeq(); seq <= ring.lastSeq() && seq != 0; seq++) {
+        if (ring.get(seq, frame)) tags[count++] = frame.tag;
+    }
+    return count;
+}
+
+// ============================================================
+// Ring Tests
+// ============================================================
+
+void test_empty_ring(void) {
+    uint8_t tags[BAD_FRAME_LOG_SIZE];
+    TEST_ASSERT_EQUAL_UINT32(0, walk(tags));
+
+    Log::Frame frame;
+    TEST_ASSERT_FALSE(ring.get(0, frame));
+    TEST_ASSERT_FALSE(ring.get(1, frame));
+}
+
+void test_partial_ring_oldest_first(void) {
+    for (uint8_t i = 1; i <= 3; i++) ring.record(i);
+
+    uint8_t tags[BAD_FRAME_LOG_SIZE];
+    TEST_ASSERT_EQUAL_UINT32(3, walk(tags));
+    TEST_ASSERT_EQUAL_UINT8(1, tags[0]);
+    TEST_ASSERT_EQUAL_UINT8(3, tags[2]);
+}
+
+void test_wrapped_ring_keeps_last_frames(void) {
+    for (uint8_t i = 1; i <= 40; i++) ring.record(i);
+
+    uint8_t tags[BAD_FRAME_LOG_SIZE];
+    TEST_ASSERT_EQUAL_UINT32(BAD_FRAME_LOG_SIZE, walk(tags));
+    TEST_ASSERT_EQUAL_UINT8(40 - BAD_FRAME_LOG_SIZE + 1, tags[0]);
+    TEST_ASSERT_EQUAL_UINT8(40, tags[BAD_FRAME_LOG_SIZE - 1]);
+}
+
+void test_overwritten_frame_not_returned(void) {
+    for (uint8_t i = 1; i <= 5; i++) ring.record(i);
+    uint32_t seq = ring.firstSeq();
+
+    // Writer laps the reader: the slot now holds a newer frame
+    for (uint8_t i = 6; i <= 5 + BAD_FRAME_LOG_SIZE; i++) ring.record(i);
+
+    Log::Frame frame;
+    TEST_ASSERT_FALSE(ring.get(seq, frame));
+    TEST_ASSERT_TRUE(ring.get(seq + BAD_FRAME_LOG_SIZE, frame));
+    TEST_ASSERT_EQUAL_UINT8(1 + BAD_FRAME_LOG_SIZE, frame.tag);
+}
+
+void test_clear_restarts_sequence(void) {
+    for (uint8_t i = 1; i <= 20; i++) ring.record(i);
+    ring.clear();
+    ring.record(99);
+
+    Log::Frame frame;
+    TEST_ASSERT_EQUAL_UINT32(1, ring.firstSeq());
+    TEST_ASSERT_TRUE(ring.get(1, frame));
+    TEST_ASSERT_EQUAL_UINT8(99, frame.tag);
+    TEST_ASSERT_FALSE(ring.get(17, frame));
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    ring.clear();
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty_ring);
+    RUN_TEST(test_partial_ring_oldest_first);
+    RUN_TEST(test_wrapped_ring_keeps_last_frames);
+    RUN_TEST(test_overwritten_frame_not_returned);
+    RUN_TEST(test_clear_restarts_sequence);
+
+    return UNITY_END();
+}
@@ -0,0 +1,228 @@
+/**
+ * @file test_config_store.cpp
+ * @brief Tests for config store persistence logic
+ *
+ * Tests the CRC32 used for the /config.crc sidecar, the debounce/coalescing
+ * decision for pending writes, and the boot-time choice between
+ * /config.json and an interrupted /config.json.tmp.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstring>
+
+// Config constants (mirror values from src/config_store.h)
+#define CONFIG_SAVE_DEBOUNCE_MS     2000
+#define CONFIG_SAVE_MAX_DELAY_MS    10000
+
+/**
+ * Mirrors ConfigStore::crc32() (reflected CRC-32, poly 0xEDB88320)
+ */
+static uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0) {
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * Mirrors the pending-write state and ConfigStore::update() decision
+ */
+struct MockDirtyState {
+    uint16_t dirtyMask;
+    uint32_t firstDirtyAt;
+    uint32_t lastDirtyAt;
+};
+
+static void markDirty(MockDirtyState& state, uint8_t section, uint32_t now) {
+    if (state.dirtyMask == 0) {
+        state.firstDirtyAt = now;
+    }
+    state.lastDirtyAt = now;
+    state.dirtyMask |= (1 << section);
+}
+
+static bool shouldFlush(const MockDirtyState& state, uint32_t now) {
+    if (state.dirtyMask == 0) return false;
+    return now - state.lastDirtyAt >= CONFIG_SAVE_DEBOUNCE_MS ||
+           now - state.firstDirtyAt >= CONFIG_SAVE_MAX_DELAY_MS;
+}
+
+/**
+ * Mirrors the file selection in ConfigStore::begin()
+ */
+enum class LoadSource { MAIN, TEMP, NONE };
+
+struct MockFile {
+    bool exists;
+    bool parses;
+    uint32_t crc;
+    uint32_t length;
+};
+
+static LoadSource chooseSource(const MockFile& main, const MockFile& tmp,
+                               bool haveCrc, uint32_t crc, uint32_t length) {
+    bool mainOk = main.exists && main.parses;
+    bool tmpMatches = tmp.exists && tmp.parses && tmp.crc == crc && tmp.length == length;
+
+    if (mainOk) {
+        if (haveCrc && (main.crc != crc || main.length != length) && tmpMatches) {
+            return LoadSource::TEMP;    // Interrupted after temp file was complete
+        }
+        return LoadSource::MAIN;        // Matches, or external edit
+    }
+
+    if (tmp.exists && tmp.parses && (!haveCrc || tmpMatches)) {
+        return LoadSource::TEMP;
+    }
+    return LoadSource::NONE;
+}
+
+// ============================================================
+// CRC tests
+// ============================================================
+
+void test_crc32_check_value(void) {
+    const char* check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(0xCBF43926, crc32((const uint8_t*)check, 9),
+        "CRC-32 check value for \"123456789\" must be 0xCBF43926");
+}
+
+void test_crc32_incremental_matches_single_pass(void) {
+    const char* text = "{\"lora\":{\"frequency\":916800000}}";
+    size_t len = strlen(text);
+
+    uint32_t single = crc32((const uint8_t*)text, len);
+    uint32_t partial = crc32((const uint8_t*)text, 10);
+    uint32_t chained = crc32((const uint8_t*)text + 10, len - 10, partial);
+
+    TEST_ASSERT_EQUAL_HEX32(single, chained);
+}
+
+void test_crc32_detects_truncation(void) {
+    const char* text = "{\"ntp\":{\"enabled\":true}}";
+    size_t len = strlen(text);
+
+    TEST_ASSERT_TRUE(crc32((const uint8_t*)text, len) != crc32((const uint8_t*)text, len - 1));
+}
+
+// ============================================================
+// Debounce tests
+// ============================================================
+
+void test_no_flush_without_changes(void) {
+    MockDirtyState state = {0, 0, 0};
+    TEST_ASSERT_FALSE(shouldFlush(state, 100000));
+}
+
+void test_flush_after_quiet_period(void) {
+    MockDirtyState state = {0, 0, 0};
+    markDirty(state, 1, 1000);
+
+    TEST_ASSERT_FALSE_MESSAGE(shouldFlush(state, 1000 + CONFIG_SAVE_DEBOUNCE_MS - 1),
+        "Should wait for the debounce period");
+    TEST_ASSERT_TRUE_MESSAGE(shouldFlush(state, 1000 + CONFIG_SAVE_DEBOUNCE_MS),
+        "Should flush once the debounce period elapsed");
+}
+
+void test_edits_are_coalesced(void) {
+    MockDirtyState state = {0, 0, 0};
+
+    // Several sections saved in quick succession (e.g. web UI "save all")
+    markDirty(state, 1, 1000);
+    markDirty(state, 2, 1500);
+    markDirty(state, 3, 2500);
+
+    TEST_ASSERT_FALSE(shouldFlush(state, 4000));
+    TEST_ASSERT_TRUE(shouldFlush(state, 4500));
+    TEST_ASSERT_EQUAL_HEX16(0x000E, state.dirtyMask);
+}
+
+void test_max_delay_bounds_continuous_edits(void) {
+    MockDirtyState state = {0, 0, 0};
+
+    // Edit every second: debounce alone would never fire
+    uint32_t now = 0;
+    bool flushed = false;
+    for (int i = 0; i < 20 && !flushed; i++) {
+        now = 1000 + i * 1000;
+        markDirty(state, 0, now);
+        flushed = shouldFlush(state, now);
+    }
+
+    TEST_ASSERT_TRUE_MESSAGE(flushed, "Max delay must force a write");
+    TEST_ASSERT_EQUAL_UINT32(1000 + CONFIG_SAVE_MAX_DELAY_MS, now);
+}
+
+// ============================================================
+// Recovery tests
+// ============================================================
+
+void test_load_main_when_crc_matches(void) {
+    MockFile main = {true, true, 0x1234, 100};
+    MockFile tmp = {false, false, 0, 0};
+    TEST_ASSERT_TRUE(chooseSource(main, tmp, true, 0x1234, 100) == LoadSource::MAIN);
+}
+
+void test_recover_temp_after_interrupted_rename(void) {
+    // Sidecar already describes the new content, rename did not happen
+    MockFile main = {true, true, 0x1111, 100};
+    MockFile tmp = {true, true, 0x2222, 120};
+    TEST_ASSERT_TRUE(chooseSource(main, tmp, true, 0x2222, 120) == LoadSource::TEMP);
+}
+
+void test_ignore_incomplete_temp(void) {
+    // Power cut while writing the temp file: sidecar still matches main
+    MockFile main = {true, true, 0x1111, 100};
+    MockFile tmp = {true, false, 0x3333, 40};
+    TEST_ASSERT_TRUE(chooseSource(main, tmp, true, 0x1111, 100) == LoadSource::MAIN);
+}
+
+void test_external_edit_is_kept(void) {
+    // File manager edit: CRC differs but no temp file
+    MockFile main = {true, true, 0x4444, 90};
+    MockFile tmp = {false, false, 0, 0};
+    TEST_ASSERT_TRUE(chooseSource(main, tmp, true, 0x1111, 100) == LoadSource::MAIN);
+}
+
+void test_missing_main_uses_temp(void) {
+    MockFile main = {false, false, 0, 0};
+    MockFile tmp = {true, true, 0x2222, 120};
+    TEST_ASSERT_TRUE(chooseSource(main, tmp, true, 0x2222, 120) == LoadSource::TEMP);
+    TEST_ASSERT_TRUE(chooseSource(main, tmp, true, 0x9999, 120) == LoadSource::NONE);
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    // Setup code before each test (if needed)
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_crc32_check_value);
+    RUN_TEST(test_crc32_incremental_matches_single_pass);
+    RUN_TEST(test_crc32_detects_truncation);
+    RUN_TEST(test_no_flush_without_changes);
+    RUN_TEST(test_flush_after_quiet_period);
+    RUN_TEST(test_edits_are_coalesced);
+    RUN_TEST(test_max_delay_bounds_continuous_edits);
+    RUN_TEST(test_load_main_when_crc_matches);
+    RUN_TEST(test_recover_temp_after_interrupted_rename);
+    RUN_TEST(test_ignore_incomplete_temp);
+    RUN_TEST(test_external_edit_is_kept);
+    RUN_TEST(test_missing_main_uses_temp);
+
+    return UNITY_END();
+}
@@ -0,0 +1,323 @@
+/**
+ * @file test_device_table.cpp
+ * @brief Tests for the per-device statistics table
+ *
+ * Tests the open-addressing table (lookup through probe runs, backward
+ * shift removal, least-recently-seen eviction at the load limit) and the
+ * per-device accounting: RSSI/SNR averages and extremes, SF histogram and
+ * the FCnt gap loss estimate with duplicates and counter resets.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+// Constants (mirror values from src/device_table.h)
+#define DEVICE_TABLE_SLOTS          64
+#define DEVICE_TABLE_MAX_ENTRIES    48
+#define DEVICE_TABLE_MASK           (DEVICE_TABLE_SLOTS - 1)
+#define DEVICE_EWMA_ALPHA           0.125f
+#define DEVICE_FCNT_MAX_GAP         16384
+#define DEVICE_SF_MIN               7
+#define DEVICE_SF_COUNT             6
+
+struct Entry {
+    uint64_t key;
+    uint8_t keyType;
+    bool used;
+    bool fcntValid;
+    uint32_t lastSeen;
+    uint32_t packets;
+    float rssiAvg;
+    float snrAvg;
+    int16_t rssiMin;
+    int16_t rssiMax;
+    uint16_t sfCount[DEVICE_SF_COUNT];
+    uint16_t lastFcnt;
+    uint16_t duplicates;
+    uint16_t fcntResets;
+    uint32_t fcntFrames;
+    uint32_t lost;
+};
+
+/**
+ * Mirrors the hash table of DeviceTable
+ */
+struct Table {
+    Entry slots[DEVICE_TABLE_SLOTS];
+    uint16_t entries;
+    uint32_t evictions;
+    bool identityHash;      // Test hook: home slot is the key's low bits
+
+    uint16_t hash(uint64_t key, uint8_t type) const {
+        if (identityHash) return key & DEVICE_TABLE_MASK;
+        uint64_t mixed = (key ^ ((uint64_t)type << 63)) * 0x9E3779B97F4A7C15ULL;
+        return (uint16_t)(mixed >> 32) & DEVICE_TABLE_MASK;
+    }
+
+    int find(uint64_t key, uint8_t type) const {
+        uint16_t slot = hash(key, type);
+        for (uint16_t probe = 0; probe < DEVICE_TABLE_SLOTS; probe++) {
+            if (!slots[slot].used) return -1;
+            if (slots[slot].key == key && slots[slot].keyType == type) return slot;
+            slot = (slot + 1) & DEVICE_TABLE_MASK;
+        }
+        return -1;
+    }
+
+    int insert(uint64_t key, uint8_t type, uint32_t now) {
+        if (entries >= DEVICE_TABLE_MAX_ENTRIES) evictOldest(now);
+
+        uint16_t slot = hash(key, type);
+        while (slots[slot].used) slot = (slot + 1) & DEVICE_TABLE_MASK;
+
+        memset(&slots[slot], 0, sizeof(Entry));
+        slots[slot].used = true;
+        slots[slot].key = key;
+        slots[slot].keyType = type;
+        slots[slot].lastSeen = now;
+        entries++;
+        return slot;
+    }
+
+    void remove(uint16_t slot) {
+        uint16_t hole = slot;
+        uint16_t next = slot;
+        while (true) {
+            next = (next + 1) & DEVICE_TABLE_MASK;
+            if (!slots[next].used) break;
+
+            uint16_t home = hash(slots[next].key, slots[next].keyType);
+            bool stays = hole <= next ? (home > hole && home <= next)
+                                      : (home > hole || home <= next);
+            if (!stays) {
+                slots[hole] = slots[next];
+                hole = next;
+            }
+        }
+        slots[hole].used = false;
+        entries--;
+    }
+
+    void evictOldest(uint32_t now) {
+        int oldest = -1;
+        uint32_t oldestAge = 0;
+        for (uint16_t i = 0; i < DEVICE_TABLE_SLOTS; i++) {
+            if (!slots[i].used) continue;
+            uint32_t age = now - slots[i].lastSeen;
+            if (oldest < 0 || age > oldestAge) {
+                oldest = i;
+                oldestAge = age;
+            }
+        }
+        if (oldest < 0) return;
+        remove(oldest);
+        evictions++;
+    }
+
+    Entry& touch(uint64_t key, uint32_t now) {
+        int slot = find(key, 0);
+        if (slot < 0) slot = insert(key, 0, now);
+        slots[slot].lastSeen = now;
+        return slots[slot];
+    }
+};
+
+/**
+ * Mirrors DeviceTable::update() (RSSI, SF and FCnt parts)
+ */
+static void account(Entry& entry, float rssi, float snr, uint8_t sf, uint16_t fcnt) {
+    int16_t rounded = (int16_t)lroundf(rssi);
+    if (entry.packets == 0) {
+        entry.rssiAvg = rssi;
+        entry.snrAvg = snr;
+        entry.rssiMin = entry.rssiMax = rounded;
+    } else {
+        entry.rssiAvg += DEVICE_EWMA_ALPHA * (rssi - entry.rssiAvg);
+        entry.snrAvg += DEVICE_EWMA_ALPHA * (snr - entry.snrAvg);
+        if (rounded < entry.rssiMin) entry.rssiMin = rounded;
+        if (rounded > entry.rssiMax) entry.rssiMax = rounded;
+    }
+    entry.packets++;
+
+    uint8_t sfIndex = sf - DEVICE_SF_MIN;
+    if (sfIndex < DEVICE_SF_COUNT) entry.sfCount[sfIndex]++;
+
+    uint16_t gap = fcnt - entry.lastFcnt;
+    if (!entry.fcntValid) {
+        entry.fcntValid = true;
+        entry.fcntFrames = 1;
+    } else if (gap == 0) {
+        entry.duplicates++;
+    } else if (gap <= DEVICE_FCNT_MAX_GAP) {
+        entry.lost += gap - 1;
+        entry.fcntFrames++;
+    } else {
+        entry.fcntResets++;
+        entry.fcntFrames = 1;
+        entry.lost = 0;
+    }
+    entry.lastFcnt = fcnt;
+}
+
+static float lossPercent(const Entry& entry) {
+    uint32_t expected = entry.fcntFrames + entry.lost;
+    if (expected == 0) return 0;
+    return 100.0f * entry.lost / expected;
+}
+
+static Table table;
+static Entry device;
+
+// ============================================================
+// Hash Table Tests
+// ============================================================
+
+void test_insert_and_find(void) {
+    for (uint32_t i = 0; i < 20; i++) {
+        table.insert(0x26010000 + i, 0, i);
+    }
+    TEST_ASSERT_EQUAL_UINT16(20, table.entries);
+    for (uint32_t i = 0; i < 20; i++) {
+        TEST_ASSERT_TRUE(table.find(0x26010000 + i, 0) >= 0);
+    }
+    TEST_ASSERT_EQUAL_INT(-1, table.find(0x26020000, 0));
+
+    // Same value as DevEUI is a different device
+    TEST_ASSERT_EQUAL_INT(-1, table.find(0x26010000, 1));
+}
+
+void test_remove_keeps_probe_run_reachable(void) {
+    // Three colliding keys at the end of the table wrap around to slot 0
+    const uint64_t home = DEVICE_TABLE_SLOTS - 2;
+    table.identityHash = true;
+    table.insert(home, 0, 0);
+    table.insert(home + DEVICE_TABLE_SLOTS, 0, 0);
+    table.insert(home + 2 * DEVICE_TABLE_SLOTS, 0, 0);
+    TEST_ASSERT_EQUAL_INT(0, table.find(home + 2 * DEVICE_TABLE_SLOTS, 0));
+
+    table.remove(home);
+    TEST_ASSERT_EQUAL_INT(-1, table.find(home, 0));
+    TEST_ASSERT_EQUAL_INT(home, table.find(home + DEVICE_TABLE_SLOTS, 0));
+    TEST_ASSERT_EQUAL_INT(home + 1, table.find(home + 2 * DEVICE_TABLE_SLOTS, 0));
+    TEST_ASSERT_FALSE(table.slots[0].used);
+}
+
+void test_remove_leaves_entry_at_home(void) {
+    // An entry at its home slot stays; one displaced past it fills the hole
+    table.identityHash = true;
+    table.insert(10, 0, 0);                         // slot 10
+    table.insert(11, 0, 0);                         // slot 11, home
+    table.insert(10 + DEVICE_TABLE_SLOTS, 0, 0);    // home 10, slot 12
+
+    table.remove(10);
+    TEST_ASSERT_EQUAL_INT(11, table.find(11, 0));
+    TEST_ASSERT_EQUAL_INT(10, table.find(10 + DEVICE_TABLE_SLOTS, 0));
+    TEST_ASSERT_FALSE(table.slots[12].used);
+}
+
+void test_full_table_evicts_least_recent(void) {
+    for (uint32_t i = 0; i < DEVICE_TABLE_MAX_ENTRIES; i++) {
+        table.insert(1000 + i, 0, 100 + i);
+    }
+    // Device 1000 heard again: 1001 is now the oldest
+    table.touch(1000, 500);
+
+    table.touch(9999, 600);
+    TEST_ASSERT_EQUAL_UINT16(DEVICE_TABLE_MAX_ENTRIES, table.entries);
+    TEST_ASSERT_EQUAL_UINT32(1, table.evictions);
+    TEST_ASSERT_EQUAL_INT(-1, table.find(1001, 0));
+    TEST_ASSERT_TRUE(table.find(1000, 0) >= 0);
+    TEST_ASSERT_TRUE(table.find(9999, 0) >= 0);
+}
+
+void test_eviction_age_survives_millis_wrap(void) {
+    table.insert(1, 0, 0xFFFFFF00);     // Before the wrap, older
+    table.insert(2, 0, 0x00000010);     // After the wrap
+    table.evictOldest(0x00000100);
+    TEST_ASSERT_EQUAL_INT(-1, table.find(1, 0));
+    TEST_ASSERT_TRUE(table.find(2, 0) >= 0);
+}
+
+// ============================================================
+// Accounting Tests
+// ============================================================
+
+void test_rssi_average_and_extremes(void) {
+    account(device, -80.0f, 8.0f, 7, 1);
+    TEST_ASSERT_EQUAL_FLOAT(-80.0f, device.rssiAvg);
+
+    account(device, -120.0f, -8.0f, 7, 2);
+    TEST_ASSERT_EQUAL_FLOAT(-85.0f, device.rssiAvg);     // 1/8 of the step
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, device.snrAvg);
+    TEST_ASSERT_EQUAL_INT16(-120, device.rssiMin);
+    TEST_ASSERT_EQUAL_INT16(-80, device.rssiMax);
+}
+
+void test_sf_histogram(void) {
+    account(device, -90, 0, 7, 1);
+    account(device, -90, 0, 12, 2);
+    account(device, -90, 0, 12, 3);
+    account(device, -90, 0, 6, 4);      // Out of range: not counted
+    TEST_ASSERT_EQUAL_UINT16(1, device.sfCount[0]);
+    TEST_ASSERT_EQUAL_UINT16(2, device.sfCount[5]);
+}
+
+void test_fcnt_gaps_count_as_lost(void) {
+    account(device, -90, 0, 7, 10);
+    account(device, -90, 0, 7, 11);
+    account(device, -90, 0, 7, 14);     // 12, 13 missed
+    TEST_ASSERT_EQUAL_UINT32(2, device.lost);
+    TEST_ASSERT_EQUAL_UINT32(3, device.fcntFrames);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 40.0f, lossPercent(device));
+}
+
+void test_fcnt_duplicate_and_wrap(void) {
+    account(device, -90, 0, 7, 0xFFFE);
+    account(device, -90, 0, 7, 0xFFFE);     // Retransmission
+    account(device, -90, 0, 7, 0x0001);     // Wraps: 0xFFFF, 0x0000 missed
+    TEST_ASSERT_EQUAL_UINT16(1, device.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(2, device.lost);
+    TEST_ASSERT_EQUAL_UINT16(0, device.fcntResets);
+}
+
+void test_fcnt_reset_restarts_tracking(void) {
+    account(device, -90, 0, 7, 500);
+    account(device, -90, 0, 7, 505);
+    account(device, -90, 0, 7, 0);          // Device rejoined
+    TEST_ASSERT_EQUAL_UINT16(1, device.fcntResets);
+    TEST_ASSERT_EQUAL_UINT32(0, device.lost);
+    TEST_ASSERT_EQUAL_UINT32(1, device.fcntFrames);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, lossPercent(device));
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    memset(&table, 0, sizeof(table));
+    memset(&device, 0, sizeof(device));
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_insert_and_find);
+    RUN_TEST(test_remove_keeps_probe_run_reachable);
+    RUN_TEST(test_remove_leaves_entry_at_home);
+    RUN_TEST(test_full_table_evicts_least_recent);
+    RUN_TEST(test_eviction_age_survives_millis_wrap);
+    RUN_TEST(test_rssi_average_and_extremes);
+    RUN_TEST(test_sf_histogram);
+    RUN_TEST(test_fcnt_gaps_count_as_lost);
+    RUN_TEST(test_fcnt_duplicate_and_wrap);
+    RUN_TEST(test_fcnt_reset_restarts_tracking);
+
+    return UNITY_END();
+}
@@ -0,0 +1,267 @@
+/**
+ * @file test_freq_drift.cpp
+ * @brief Tests for the FEI conversion and the crystal drift estimator
+ *
+ * Tests the 20-bit FEI register decoding, the FRF trim, the median over the
+ * offset window and the estimator's guard rails: minimum frames, deadband,
+ * step and total limits, and the revert when a step makes things worse.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// Constants (mirror values from src/freq_drift.h and src/sx1276_shadow.h)
+#define SX1276_FXOSC            32000000UL
+#define DRIFT_WINDOW            16
+#define DRIFT_MIN_SAMPLES       8
+#define DRIFT_MIN_SNR_DB        -10.0f
+#define DRIFT_DEADBAND_PPB      1000
+#define DRIFT_MAX_STEP_PPB      5000
+#define DRIFT_MAX_TRIM_PPB      25000
+
+template <typename T>
+static T clampValue(T value, T low, T high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+/**
+ * Mirrors SX1276Shadow::feiToHz()
+ */
+static int32_t feiToHz(const uint8_t fei[3], float bw) {
+    int32_t raw = ((int32_t)(fei[0] & 0x0F) << 16) | ((int32_t)fei[1] << 8) | fei[2];
+    if (raw & 0x80000) raw -= 0x100000;
+    return (int32_t)(raw * (16777216.0f / SX1276_FXOSC) * (bw / 500.0f));
+}
+
+/**
+ * Mirrors the FRF computation of SX1276Shadow::trimProfile()
+ */
+static uint32_t trimmedFrf(uint32_t frequency, int32_t trimPpb) {
+    int64_t corrected = (int64_t)frequency + (int64_t)frequency * trimPpb / 1000000000LL;
+    return (uint32_t)(((uint64_t)corrected << 19) / SX1276_FXOSC);
+}
+
+/**
+ * Mirrors FrequencyDrift::median()
+ */
+static int32_t median(int32_t* values, uint8_t count) {
+    if (count == 0) return 0;
+    for (uint8_t i = 1; i < count; i++) {
+        int32_t value = values[i];
+        int8_t j = i - 1;
+        while (j >= 0 && values[j] > value) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = value;
+    }
+    if (count & 1) return values[count / 2];
+    return (int32_t)(((int64_t)values[count / 2 - 1] + values[count / 2]) / 2);
+}
+
+/**
+ * Mirrors FrequencyDrift (record/evaluate, without the history)
+ */
+struct Drift {
+    int32_t window[DRIFT_WINDOW];
+    uint8_t head;
+    uint8_t count;
+    int32_t trimPpb;
+    bool diverged;
+    uint32_t rejected;
+    uint32_t reverted;
+    bool stepPending;
+    int32_t stepPpb;
+    int32_t stepEstimatePpb;
+
+    void record(uint32_t frequency, int32_t offsetHz, float snr) {
+        int32_t offsetPpb = (int32_t)((int64_t)offsetHz * 1000000000LL / frequency);
+        if (snr < DRIFT_MIN_SNR_DB || abs(offsetPpb) > 2 * DRIFT_MAX_TRIM_PPB) {
+            rejected++;
+            return;
+        }
+        window[head] = offsetPpb;
+        head = (head + 1) % DRIFT_WINDOW;
+        if (count < DRIFT_WINDOW) count++;
+    }
+
+    bool evaluate(bool autoCorrect) {
+        if (count < DRIFT_MIN_SAMPLES) return false;
+
+        int32_t sorted[DRIFT_WINDOW];
+        memcpy(sorted, window, count * sizeof(int32_t));
+        int32_t estimate = median(sorted, count);
+
+        if (stepPending) {
+            stepPending = false;
+            if (abs(estimate) > abs(stepEstimatePpb)) {
+                trimPpb -= stepPpb;
+                reverted++;
+                diverged = true;
+                head = 0;
+                count = 0;
+                return true;
+            }
+        }
+
+        if (!autoCorrect || diverged || abs(estimate) < DRIFT_DEADBAND_PPB) return false;
+
+        int32_t step = clampValue<int32_t>(estimate, -DRIFT_MAX_STEP_PPB, DRIFT_MAX_STEP_PPB);
+        int32_t trim = clampValue<int32_t>(trimPpb + step, -DRIFT_MAX_TRIM_PPB, DRIFT_MAX_TRIM_PPB);
+        if (trim == trimPpb) return false;
+
+        stepPending = true;
+        stepPpb = trim - trimPpb;
+        stepEstimatePpb = estimate;
+        trimPpb = trim;
+        head = 0;
+        count = 0;
+        return true;
+    }
+};
+
+static Drift drift;
+
+static void feed(uint32_t frequency, int32_t offsetHz, uint8_t frames) {
+    for (uint8_t i = 0; i < frames; i++) {
+        drift.record(frequency, offsetHz, 5.0f);
+    }
+}
+
+// ============================================================
+// FEI Register Tests
+// ============================================================
+
+void test_fei_positive_and_negative(void) {
+    // 0x00400 = 1024 -> 1024 * 0.524288 * 125/500 = 134 Hz
+    uint8_t positive[3] = { 0x00, 0x04, 0x00 };
+    TEST_ASSERT_EQUAL_INT32(134, feiToHz(positive, 125.0f));
+
+    // 0xFFC00 = -1024 (20-bit two's complement); upper nibble of MSB ignored
+    uint8_t negative[3] = { 0xFF, 0xFC, 0x00 };
+    TEST_ASSERT_EQUAL_INT32(-134, feiToHz(negative, 125.0f));
+}
+
+void test_fei_scales_with_bandwidth(void) {
+    uint8_t fei[3] = { 0x00, 0x04, 0x00 };
+    TEST_ASSERT_EQUAL_INT32(536, feiToHz(fei, 500.0f));
+    TEST_ASSERT_EQUAL_INT32(268, feiToHz(fei, 250.0f));
+}
+
+void test_trim_moves_frf(void) {
+    // 868.1 MHz: FRF 0xD9 0x06 0x66; one FRF step is 61 Hz
+    TEST_ASSERT_EQUAL_HEX32(0xD90666, trimmedFrf(868100000, 0));
+
+    // +10 ppm = +8681 Hz = +142 steps
+    TEST_ASSERT_EQUAL_UINT32(0xD90666 + 142, trimmedFrf(868100000, 10000));
+    TEST_ASSERT_EQUAL_UINT32(0xD90666 - 142, trimmedFrf(868100000, -10000));
+}
+
+// ============================================================
+// Median Tests
+// ============================================================
+
+void test_median_rejects_outliers(void) {
+    int32_t values[] = { 900, -40000, 1100, 1000, 45000 };
+    TEST_ASSERT_EQUAL_INT32(1000, median(values, 5));
+
+    int32_t even[] = { 4, 1, 3, 2 };
+    TEST_ASSERT_EQUAL_INT32(2, median(even, 4));
+}
+
+// ============================================================
+// Estimator Tests
+// ============================================================
+
+void test_needs_minimum_frames(void) {
+    feed(915000000, 9150, DRIFT_MIN_SAMPLES - 1);
+    TEST_ASSERT_FALSE(drift.evaluate(true));
+    TEST_ASSERT_EQUAL_INT32(0, drift.trimPpb);
+}
+
+void test_low_snr_and_implausible_offsets_rejected(void) {
+    drift.record(915000000, 915, -15.0f);
+    drift.record(915000000, 100000, 5.0f);     // ~109 ppm
+    TEST_ASSERT_EQUAL_UINT32(2, drift.rejected);
+    TEST_ASSERT_EQUAL_UINT8(0, drift.count);
+}
+
+void test_deadband_leaves_trim(void) {
+    feed(915000000, 500, DRIFT_MIN_SAMPLES);   // ~0.55 ppm
+    TEST_ASSERT_FALSE(drift.evaluate(true));
+    TEST_ASSERT_EQUAL_INT32(0, drift.trimPpb);
+}
+
+void test_step_and_total_limits(void) {
+    // 12 ppm offset: 5 ppm per evaluation
+    feed(915000000, 10980, DRIFT_MIN_SAMPLES);
+    TEST_ASSERT_TRUE(drift.evaluate(true));
+    TEST_ASSERT_EQUAL_INT32(DRIFT_MAX_STEP_PPB, drift.trimPpb);
+
+    // Residual 7 ppm: another full step
+    feed(915000000, 6405, DRIFT_MIN_SAMPLES);
+    TEST_ASSERT_TRUE(drift.evaluate(true));
+    TEST_ASSERT_EQUAL_INT32(2 * DRIFT_MAX_STEP_PPB, drift.trimPpb);
+
+    // Never past the maximum trim
+    drift.trimPpb = DRIFT_MAX_TRIM_PPB - 1000;
+    drift.stepPending = false;
+    feed(915000000, 4575, DRIFT_MIN_SAMPLES);
+    TEST_ASSERT_TRUE(drift.evaluate(true));
+    TEST_ASSERT_EQUAL_INT32(DRIFT_MAX_TRIM_PPB, drift.trimPpb);
+}
+
+void test_worse_offset_reverts_and_stops(void) {
+    feed(915000000, 2745, DRIFT_MIN_SAMPLES);  // 3 ppm
+    TEST_ASSERT_TRUE(drift.evaluate(true));
+    TEST_ASSERT_EQUAL_INT32(3000, drift.trimPpb);
+
+    // Offset doubled instead of shrinking: the step is undone
+    feed(915000000, 5490, DRIFT_MIN_SAMPLES);
+    TEST_ASSERT_TRUE(drift.evaluate(true));
+    TEST_ASSERT_EQUAL_INT32(0, drift.trimPpb);
+    TEST_ASSERT_TRUE(drift.diverged);
+    TEST_ASSERT_EQUAL_UINT32(1, drift.reverted);
+
+    // No further correction
+    feed(915000000, 5490, DRIFT_MIN_SAMPLES);
+    TEST_ASSERT_FALSE(drift.evaluate(true));
+    TEST_ASSERT_EQUAL_INT32(0, drift.trimPpb);
+}
+
+void test_estimate_only_without_auto_correct(void) {
+    feed(915000000, 9150, DRIFT_MIN_SAMPLES);
+    TEST_ASSERT_FALSE(drift.evaluate(false));
+    TEST_ASSERT_EQUAL_INT32(0, drift.trimPpb);
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    memset(&drift, 0, sizeof(drift));
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_fei_positive_and_negative);
+    RUN_TEST(test_fei_scales_with_bandwidth);
+    RUN_TEST(test_trim_moves_frf);
+    RUN_TEST(test_median_rejects_outliers);
+    RUN_TEST(test_needs_minimum_frames);
+    RUN_TEST(test_low_snr_and_implausible_offsets_rejected);
+    RUN_TEST(test_deadband_leaves_trim);
+    RUN_TEST(test_step_and_total_limits);
+    RUN_TEST(test_worse_offset_reverts_and_stops);
+    RUN_TEST(test_estimate_only_without_auto_correct);
+
+    return UNITY_END();
+}
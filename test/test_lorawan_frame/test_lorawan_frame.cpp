@@ -0,0 +1,316 @@
+/**
+ * @file test_lorawan_frame.cpp
+ * @brief Tests for the LoRaWAN header decoder and the packet filter rules
+ *
+ * Tests the in-place decoding of data frames and join-requests, the length
+ * checks per MType, the DevAddr prefix a NetID assigns and the first-match
+ * rule evaluation with its per-MType candidate bitmaps.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstring>
+
+#include "lorawan_frame.h"
+
+// Constants (mirror values from src/packet_filter.h)
+#define FILTER_MAX_RULES            16
+
+#define DATA_MTYPES (LORAWAN_MTYPE_BIT(LoRaWANMType::UNCONFIRMED_UP) | \
+                     LORAWAN_MTYPE_BIT(LoRaWANMType::CONFIRMED_UP) | \
+                     LORAWAN_MTYPE_BIT(LoRaWANMType::UNCONFIRMED_DOWN) | \
+                     LORAWAN_MTYPE_BIT(LoRaWANMType::CONFIRMED_DOWN))
+
+typedef LoRaWANHeader Header;
+
+static uint32_t prefixMask(uint8_t length) {
+    return length == 0 ? 0 : 0xFFFFFFFFUL << (32 - length);
+}
+
+/**
+ * Mirrors PacketFilter::compile()/accept() with compiled matchers
+ */
+enum RuleType : uint8_t { NETID, DEVADDR, JOINEUI, MTYPE_RULE };
+
+struct Matcher {
+    RuleType type;
+    bool allow;
+    uint32_t mask;
+    uint32_t value;
+    uint64_t low;
+    uint64_t high;
+};
+
+struct Filter {
+    bool defaultAllow;
+    uint8_t count;
+    Matcher matchers[FILTER_MAX_RULES];
+    uint16_t rulesByMType[LORAWAN_MTYPE_COUNT];
+    uint32_t ruleHits[FILTER_MAX_RULES];
+    uint32_t defaultHits;
+
+    void add(const Matcher& matcher, uint8_t mtypes) {
+        matchers[count] = matcher;
+        for (uint8_t t = 0; t < LORAWAN_MTYPE_COUNT; t++) {
+            if (mtypes & (1U << t)) rulesByMType[t] |= (1U << count);
+        }
+        count++;
+    }
+
+    void addNetId(uint32_t netId, bool allow) {
+        Matcher m = {};
+        uint32_t prefix;
+        uint8_t length;
+        lorawanNetIdPrefix(netId, prefix, length);
+        m.type = NETID;
+        m.allow = allow;
+        m.mask = prefixMask(length);
+        m.value = prefix;
+        add(m, DATA_MTYPES);
+    }
+
+    void addDevAddr(uint32_t value, uint8_t length, bool allow) {
+        Matcher m = {};
+        m.type = DEVADDR;
+        m.allow = allow;
+        m.mask = prefixMask(length);
+        m.value = value & m.mask;
+        add(m, DATA_MTYPES);
+    }
+
+    void addJoinEui(uint64_t low, uint64_t high, bool allow) {
+        Matcher m = {};
+        m.type = JOINEUI;
+        m.allow = allow;
+        m.low = low;
+        m.high = high;
+        add(m, LORAWAN_MTYPE_BIT(LoRaWANMType::JOIN_REQUEST));
+    }
+
+    void addMType(uint8_t mask, bool allow) {
+        Matcher m = {};
+        m.type = MTYPE_RULE;
+        m.allow = allow;
+        add(m, mask);
+    }
+
+    bool accept(const Header& header) {
+        if (!header.valid) return defaultAllow;
+
+        uint16_t candidates = rulesByMType[(uint8_t)header.mtype];
+        while (candidates) {
+            uint8_t i = __builtin_ctz(candidates);
+            candidates &= candidates - 1;
+
+            const Matcher& m = matchers[i];
+            bool match;
+            switch (m.type) {
+                case NETID:
+                case DEVADDR:
+                    match = (header.devAddr & m.mask) == m.value;
+                    break;
+                case JOINEUI:
+                    match = header.joinEui >= m.low && header.joinEui <= m.high;
+                    break;
+                default:
+                    match = true;
+                    break;
+            }
+            if (match) {
+                ruleHits[i]++;
+                return m.allow;
+            }
+        }
+        defaultHits++;
+        return defaultAllow;
+    }
+};
+
+static Filter filter;
+
+static Header dataFrame(uint32_t devAddr) {
+    uint8_t frame[] = { 0x40, 0, 0, 0, 0, 0x00, 0x01, 0x00, 0x01, 0xAA, 0, 0, 0, 0 };
+    frame[1] = devAddr;
+    frame[2] = devAddr >> 8;
+    frame[3] = devAddr >> 16;
+    frame[4] = devAddr >> 24;
+    Header header;
+    lorawanDecodeHeader(frame, sizeof(frame), header);
+    header.payload = nullptr;   // Points into the local frame
+    return header;
+}
+
+static Header joinRequest(uint64_t joinEui) {
+    uint8_t frame[LORAWAN_JOIN_REQUEST_SIZE] = { 0x00 };
+    for (uint8_t i = 0; i < 8; i++) frame[1 + i] = joinEui >> (8 * i);
+    Header header;
+    lorawanDecodeHeader(frame, sizeof(frame), header);
+    return header;
+}
+
+// ============================================================
+// Decoder Tests
+// ============================================================
+
+void test_decode_data_frame(void) {
+    // Unconfirmed up, DevAddr 0x26011BDA, FCtrl with 2 FOpts bytes, FCnt 0x0102
+    const uint8_t frame[] = {
+        0x40, 0xDA, 0x1B, 0x01, 0x26, 0x82, 0x02, 0x01,
+        0x03, 0x05,             // FOpts
+        0x0A, 0x11, 0x22,       // FPort 10, FRMPayload
+        0xDE, 0xAD, 0xBE, 0xEF  // MIC
+    };
+    Header header;
+    TEST_ASSERT_TRUE(lorawanDecodeHeader(frame, sizeof(frame), header));
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)LoRaWANMType::UNCONFIRMED_UP, (uint8_t)header.mtype);
+    TEST_ASSERT_EQUAL_HEX32(0x26011BDA, header.devAddr);
+    TEST_ASSERT_EQUAL_UINT16(0x0102, header.fcnt);
+    TEST_ASSERT_EQUAL_UINT8(2, header.foptsLength);
+    TEST_ASSERT_EQUAL_INT16(10, header.fport);
+    TEST_ASSERT_EQUAL_UINT8(2, header.payloadLength);
+    TEST_ASSERT_TRUE(header.payload == frame + 11);
+}
+
+void test_decode_data_frame_without_port(void) {
+    const uint8_t frame[] = { 0x80, 1, 2, 3, 4, 0x00, 0x05, 0x00, 0xDE, 0xAD, 0xBE, 0xEF };
+    Header header;
+    TEST_ASSERT_TRUE(lorawanDecodeHeader(frame, sizeof(frame), header));
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)LoRaWANMType::CONFIRMED_UP, (uint8_t)header.mtype);
+    TEST_ASSERT_EQUAL_INT16(-1, header.fport);
+    TEST_ASSERT_EQUAL_UINT8(0, header.payloadLength);
+}
+
+void test_decode_rejects_truncated_frames(void) {
+    // FOpts length runs into the MIC
+    const uint8_t fopts[] = { 0x40, 1, 2, 3, 4, 0x03, 0x05, 0x00, 0x03, 0xDE, 0xAD, 0xBE, 0xEF };
+    Header header;
+    TEST_ASSERT_FALSE(lorawanDecodeHeader(fopts, sizeof(fopts), header));
+    TEST_ASSERT_FALSE(header.valid);
+
+    const uint8_t shortJoin[] = { 0x00, 1, 2, 3 };
+    TEST_ASSERT_FALSE(lorawanDecodeHeader(shortJoin, sizeof(shortJoin), header));
+
+    // Major version other than R1
+    const uint8_t major[] = { 0x41, 1, 2, 3, 4, 0x00, 0x05, 0x00, 0xDE, 0xAD, 0xBE, 0xEF };
+    TEST_ASSERT_FALSE(lorawanDecodeHeader(major, sizeof(major), header));
+
+    TEST_ASSERT_FALSE(lorawanDecodeHeader(nullptr, 0, header));
+}
+
+void test_decode_join_request(void) {
+    Header header = joinRequest(0x70B3D57ED0001234ULL);
+    TEST_ASSERT_TRUE(header.valid);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)LoRaWANMType::JOIN_REQUEST, (uint8_t)header.mtype);
+    TEST_ASSERT_TRUE(header.joinEui == 0x70B3D57ED0001234ULL);
+}
+
+void test_decode_proprietary_any_length(void) {
+    const uint8_t frame[] = { 0xE0, 0x55 };
+    Header header;
+    TEST_ASSERT_TRUE(lorawanDecodeHeader(frame, sizeof(frame), header));
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)LoRaWANMType::PROPRIETARY, (uint8_t)header.mtype);
+}
+
+// ============================================================
+// NetID Tests
+// ============================================================
+
+void test_netid_type0_prefix(void) {
+    // NetID 000013 (TTN): type 0, NwkID 0x13 -> DevAddr 26000000/7
+    uint32_t prefix;
+    uint8_t length;
+    lorawanNetIdPrefix(0x000013, prefix, length);
+    TEST_ASSERT_EQUAL_UINT8(7, length);
+    TEST_ASSERT_EQUAL_HEX32(0x26000000, prefix);
+}
+
+void test_netid_type3_prefix(void) {
+    // Type 3: prefix 1110, 11-bit NwkID
+    uint32_t prefix;
+    uint8_t length;
+    lorawanNetIdPrefix(0x600001, prefix, length);
+    TEST_ASSERT_EQUAL_UINT8(15, length);
+    TEST_ASSERT_EQUAL_HEX32(0xE0020000, prefix);
+}
+
+// ============================================================
+// Rule Tests
+// ============================================================
+
+void test_first_match_wins(void) {
+    filter.defaultAllow = false;
+    filter.addDevAddr(0x26011B00, 24, false);       // Deny one block...
+    filter.addNetId(0x000013, true);                // ...of an allowed NetID
+
+    TEST_ASSERT_FALSE(filter.accept(dataFrame(0x26011BDA)));
+    TEST_ASSERT_TRUE(filter.accept(dataFrame(0x2601AAAA)));
+    TEST_ASSERT_FALSE(filter.accept(dataFrame(0x48000001)));
+
+    TEST_ASSERT_EQUAL_UINT32(1, filter.ruleHits[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, filter.ruleHits[1]);
+    TEST_ASSERT_EQUAL_UINT32(1, filter.defaultHits);
+}
+
+void test_rules_only_apply_to_their_mtypes(void) {
+    // A DevAddr rule never sees a join-request, a JoinEUI rule never a data frame
+    filter.defaultAllow = true;
+    filter.addDevAddr(0x00000000, 0, false);
+    filter.addJoinEui(0x70B3D57ED0000000ULL, 0x70B3D57ED0FFFFFFULL, false);
+
+    TEST_ASSERT_FALSE(filter.accept(dataFrame(0x12345678)));
+    TEST_ASSERT_FALSE(filter.accept(joinRequest(0x70B3D57ED0000042ULL)));
+    TEST_ASSERT_TRUE(filter.accept(joinRequest(0x70B3D57ED1000000ULL)));
+    TEST_ASSERT_EQUAL_UINT32(1, filter.ruleHits[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, filter.ruleHits[1]);
+}
+
+void test_mtype_rule(void) {
+    filter.defaultAllow = true;
+    filter.addMType(LORAWAN_MTYPE_BIT(LoRaWANMType::PROPRIETARY), false);
+
+    const uint8_t frame[] = { 0xE0, 0x55 };
+    Header header;
+    lorawanDecodeHeader(frame, sizeof(frame), header);
+    TEST_ASSERT_FALSE(filter.accept(header));
+    TEST_ASSERT_TRUE(filter.accept(dataFrame(0x26011BDA)));
+}
+
+void test_undecodable_gets_default(void) {
+    filter.defaultAllow = false;
+    filter.addMType(0xFF, true);
+
+    Header header;
+    const uint8_t frame[] = { 0x40, 1, 2 };
+    lorawanDecodeHeader(frame, sizeof(frame), header);
+    TEST_ASSERT_FALSE(filter.accept(header));
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    memset(&filter, 0, sizeof(filter));
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_decode_data_frame);
+    RUN_TEST(test_decode_data_frame_without_port);
+    RUN_TEST(test_decode_rejects_truncated_frames);
+    RUN_TEST(test_decode_join_request);
+    RUN_TEST(test_decode_proprietary_any_length);
+    RUN_TEST(test_netid_type0_prefix);
+    RUN_TEST(test_netid_type3_prefix);
+    RUN_TEST(test_first_match_wins);
+    RUN_TEST(test_rules_only_apply_to_their_mtypes);
+    RUN_TEST(test_mtype_rule);
+    RUN_TEST(test_undecodable_gets_default);
+
+    return UNITY_END();
+}
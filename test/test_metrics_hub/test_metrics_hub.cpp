@@ -0,0 +1,221 @@
+/**
+ * @file test_metrics_hub.cpp
+ * @brief Tests for the versioned metrics pushed over WebSocket
+ *
+ * Tests change detection and versioning, which metrics go in a delta for
+ * a client's last version, and that clients on the same version share one
+ * built delta while a client whose send is refused catches up later.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+// Constants (mirror values from src/metrics_hub.h)
+#define METRICS_MAX_SUBSCRIBERS     8
+#define METRIC_COUNT                6
+
+/**
+ * Mirrors MetricsHub: values reduced to uint32, delta reduced to the
+ * set of metric indexes it carries
+ */
+struct Hub {
+    struct Entry {
+        uint32_t value;
+        uint32_t version;
+    };
+    struct Client {
+        uint32_t version;
+        bool queueFull;         // ws.text() refuses the message
+        uint32_t received;      // Bitmask of metrics in the last message
+        bool got;
+    };
+
+    Entry entries[METRIC_COUNT];
+    uint32_t version;
+    bool sampled;
+    uint32_t changes;
+    uint32_t builds;
+
+    void reset() { memset(this, 0, sizeof(*this)); }
+
+    void set(uint8_t metric, uint32_t value) {
+        Entry& entry = entries[metric];
+        if (sampled && entry.value == value) return;
+        entry.value = value;
+        entry.version = version + 1;
+        changes++;
+    }
+
+    void sample(const uint32_t* values) {
+        uint32_t before = changes;
+        for (uint8_t i = 0; i < METRIC_COUNT; i++) set(i, values[i]);
+        if (!sampled || changes != before) version++;
+        sampled = true;
+    }
+
+    uint32_t buildDelta(uint32_t base) {
+        uint32_t mask = 0;
+        for (uint8_t i = 0; i < METRIC_COUNT; i++) {
+            if (base != 0 && entries[i].version <= base) continue;
+            mask |= 1UL << i;
+        }
+        if (mask) builds++;
+        return mask;
+    }
+
+    void push(Client* clients, uint8_t count) {
+        bool handled[METRICS_MAX_SUBSCRIBERS] = { false };
+        uint32_t sent[METRICS_MAX_SUBSCRIBERS];
+        for (uint8_t i = 0; i < count; i++) clients[i].got = false;
+
+        for (uint8_t i = 0; i < count; i++) {
+            if (handled[i]) continue;
+            uint32_t base = clients[i].version;
+            uint32_t delta = base != version ? buildDelta(base) : 0;
+            for (uint8_t j = i; j < count; j++) {
+                if (handled[j] || clients[j].version != base) continue;
+                handled[j] = true;
+                sent[j] = base;
+                if (!delta || clients[j].queueFull) continue;
+                clients[j].received = delta;
+                clients[j].got = true;
+                sent[j] = version;
+            }
+        }
+        for (uint8_t j = 0; j < count; j++) clients[j].version = sent[j];
+    }
+};
+
+static Hub hub;
+
+// ============================================================
+// Versioning Tests
+// ============================================================
+
+void test_first_sample_sets_every_metric(void) {
+    uint32_t values[METRIC_COUNT] = { 0, 0, 0, 0, 0, 0 };
+    hub.sample(values);
+    TEST_ASSERT_EQUAL_UINT32(1, hub.version);
+    TEST_ASSERT_EQUAL_HEX32(0x3F, hub.buildDelta(0));
+}
+
+void test_unchanged_round_keeps_version(void) {
+    uint32_t values[METRIC_COUNT] = { 1, 2, 3, 4, 5, 6 };
+    hub.sample(values);
+    hub.sample(values);
+    TEST_ASSERT_EQUAL_UINT32(1, hub.version);
+    TEST_ASSERT_EQUAL_HEX32(0, hub.buildDelta(1));
+}
+
+void test_delta_holds_changes_since_base(void) {
+    uint32_t values[METRIC_COUNT] = { 1, 2, 3, 4, 5, 6 };
+    hub.sample(values);             // v1
+    values[1] = 20;
+    hub.sample(values);             // v2
+    values[4] = 50;
+    hub.sample(values);             // v3
+
+    TEST_ASSERT_EQUAL_HEX32(0x10, hub.buildDelta(2));
+    TEST_ASSERT_EQUAL_HEX32(0x12, hub.buildDelta(1));
+    TEST_ASSERT_EQUAL_HEX32(0x3F, hub.buildDelta(0));
+}
+
+void test_float_rounding_hides_noise(void) {
+    // Mirror of setFloat(): values are compared after rounding to 0.1
+    float a = roundf(-87.24f * 10.0f) / 10.0f;
+    float b = roundf(-87.21f * 10.0f) / 10.0f;
+    uint32_t ua, ub;
+    memcpy(&ua, &a, 4);
+    memcpy(&ub, &b, 4);
+    TEST_ASSERT_EQUAL_HEX32(ua, ub);
+}
+
+// ============================================================
+// Push Tests
+// ============================================================
+
+void test_clients_on_same_version_share_one_build(void) {
+    uint32_t values[METRIC_COUNT] = { 1, 2, 3, 4, 5, 6 };
+    hub.sample(values);
+
+    Hub::Client clients[4];
+    memset(clients, 0, sizeof(clients));
+    hub.push(clients, 4);
+    TEST_ASSERT_EQUAL_UINT32(1, hub.builds);
+
+    values[0] = 10;
+    hub.sample(values);
+    hub.push(clients, 4);
+    TEST_ASSERT_EQUAL_UINT32(2, hub.builds);
+    for (uint8_t i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(clients[i].got);
+        TEST_ASSERT_EQUAL_HEX32(0x01, clients[i].received);
+        TEST_ASSERT_EQUAL_UINT32(2, clients[i].version);
+    }
+}
+
+void test_nothing_sent_without_changes(void) {
+    uint32_t values[METRIC_COUNT] = { 1, 2, 3, 4, 5, 6 };
+    hub.sample(values);
+    Hub::Client client;
+    memset(&client, 0, sizeof(client));
+    hub.push(&client, 1);
+
+    hub.sample(values);
+    hub.push(&client, 1);
+    TEST_ASSERT_FALSE(client.got);
+    TEST_ASSERT_EQUAL_UINT32(1, hub.builds);
+}
+
+void test_slow_client_catches_up_with_larger_delta(void) {
+    uint32_t values[METRIC_COUNT] = { 1, 2, 3, 4, 5, 6 };
+    hub.sample(values);
+
+    Hub::Client clients[2];
+    memset(clients, 0, sizeof(clients));
+    hub.push(clients, 2);
+
+    clients[1].queueFull = true;
+    values[2] = 30;
+    hub.sample(values);
+    hub.push(clients, 2);
+    TEST_ASSERT_TRUE(clients[0].got);
+    TEST_ASSERT_FALSE(clients[1].got);
+    TEST_ASSERT_EQUAL_UINT32(1, clients[1].version);
+
+    clients[1].queueFull = false;
+    values[3] = 40;
+    hub.sample(values);
+    hub.push(clients, 2);
+    TEST_ASSERT_EQUAL_HEX32(0x08, clients[0].received);
+    TEST_ASSERT_EQUAL_HEX32(0x0C, clients[1].received);
+    TEST_ASSERT_EQUAL_UINT32(clients[0].version, clients[1].version);
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    hub.reset();
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_first_sample_sets_every_metric);
+    RUN_TEST(test_unchanged_round_keeps_version);
+    RUN_TEST(test_delta_holds_changes_since_base);
+    RUN_TEST(test_float_rounding_hides_noise);
+    RUN_TEST(test_clients_on_same_version_share_one_build);
+    RUN_TEST(test_nothing_sent_without_changes);
+    RUN_TEST(test_slow_client_catches_up_with_larger_delta);
+
+    return UNITY_END();
+}
@@ -0,0 +1,244 @@
+/**
+ * @file test_packet_capture.cpp
+ * @brief Tests for the pcap/LoRaTap packet capture
+ *
+ * Tests the bytes written for Wireshark (pcap global header, LoRaTap v0
+ * header) and the matching of compiled filter expressions against
+ * uplinks and downlinks.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+// Constants (mirror values from src/packet_capture.h)
+#define PCAP_MAGIC                  0xA1B2C3D4
+#define PCAP_GLOBAL_HEADER_SIZE     24
+#define PCAP_LINKTYPE_LORATAP       270
+#define LORATAP_HEADER_SIZE         15
+#define MAX_PACKET_SIZE             256
+
+#define CAPTURE_DIR_UP      0x01
+#define CAPTURE_DIR_DOWN    0x02
+#define CAPTURE_CRC_OK      0x01
+#define CAPTURE_CRC_BAD     0x02
+
+static void put16be(uint8_t* p, uint16_t value) { p[0] = value >> 8; p[1] = value; }
+static void put32be(uint8_t* p, uint32_t value) {
+    p[0] = value >> 24; p[1] = value >> 16; p[2] = value >> 8; p[3] = value;
+}
+static void put16le(uint8_t* p, uint16_t value) { p[0] = value; p[1] = value >> 8; }
+static void put32le(uint8_t* p, uint32_t value) {
+    p[0] = value; p[1] = value >> 8; p[2] = value >> 16; p[3] = value >> 24;
+}
+
+/**
+ * Mirrors PacketCapture::writeGlobalHeader()
+ */
+static void writeGlobalHeader(uint8_t* buffer) {
+    put32le(buffer, PCAP_MAGIC);
+    put16le(buffer + 4, 2);
+    put16le(buffer + 6, 4);
+    put32le(buffer + 8, 0);
+    put32le(buffer + 12, 0);
+    put32le(buffer + 16, LORATAP_HEADER_SIZE + MAX_PACKET_SIZE);
+    put32le(buffer + 20, PCAP_LINKTYPE_LORATAP);
+}
+
+/**
+ * Mirrors PacketCapture::writeLoRaTap()
+ */
+static void writeLoRaTap(uint8_t* p, uint32_t frequency, float bandwidth, uint8_t sf,
+                         float rssi, float snr, uint8_t syncWord) {
+    int32_t rssiValue = 0;
+    if (rssi != 0) {
+        rssiValue = snr >= 0 ? lroundf(rssi + 139) : lroundf((rssi + 139) * 4);
+        if (rssiValue < 0) rssiValue = 0;
+        if (rssiValue > 255) rssiValue = 255;
+    }
+    p[0] = 0;
+    p[1] = 0;
+    put16be(p + 2, LORATAP_HEADER_SIZE);
+    put32be(p + 4, frequency);
+    p[8] = (uint8_t)lroundf(bandwidth / 125.0f);
+    p[9] = sf;
+    p[10] = rssiValue;
+    p[11] = 0;
+    p[12] = 0;
+    p[13] = (uint8_t)(int8_t)lroundf(snr * 4);
+    p[14] = syncWord;
+}
+
+struct Filter {
+    uint8_t directions;
+    uint8_t crc;
+    uint16_t sfMask;
+    bool devAddrSet;
+    uint32_t devAddrMask;
+    uint32_t devAddrValue;
+    uint32_t frequency;
+    int16_t rssiMin;
+    int16_t rssiMax;
+};
+
+struct Frame {
+    bool uplink;
+    bool crcOk;
+    uint8_t sf;
+    uint32_t frequency;
+    float rssi;
+    bool dataFrame;
+    uint32_t devAddr;
+};
+
+static Filter anyFilter() {
+    Filter filter;
+    memset(&filter, 0, sizeof(filter));
+    filter.directions = CAPTURE_DIR_UP | CAPTURE_DIR_DOWN;
+    filter.crc = CAPTURE_CRC_OK | CAPTURE_CRC_BAD;
+    filter.rssiMin = INT16_MIN;
+    filter.rssiMax = INT16_MAX;
+    return filter;
+}
+
+/**
+ * Mirrors PacketCapture::matches() (MType terms left out)
+ */
+static bool matches(const Filter& filter, const Frame& frame) {
+    if (!(filter.directions & (frame.uplink ? CAPTURE_DIR_UP : CAPTURE_DIR_DOWN))) return false;
+    if (!(filter.crc & (frame.crcOk ? CAPTURE_CRC_OK : CAPTURE_CRC_BAD))) return false;
+    if (filter.sfMask && !(filter.sfMask & (1U << frame.sf))) return false;
+    if (filter.frequency && filter.frequency != frame.frequency) return false;
+    if (filter.rssiMin != INT16_MIN && (!frame.uplink || frame.rssi <= filter.rssiMin)) return false;
+    if (filter.rssiMax != INT16_MAX && (!frame.uplink || frame.rssi >= filter.rssiMax)) return false;
+    if (filter.devAddrSet &&
+        (!frame.dataFrame || (frame.devAddr & filter.devAddrMask) != filter.devAddrValue)) return false;
+    return true;
+}
+
+static const Frame UPLINK = { true, true, 9, 868100000, -95.0f, true, 0x26011B42 };
+static const Frame DOWNLINK = { false, true, 12, 869525000, 0, true, 0x26011B42 };
+
+// ============================================================
+// File Format Tests
+// ============================================================
+
+void test_pcap_global_header(void) {
+    uint8_t header[PCAP_GLOBAL_HEADER_SIZE];
+    writeGlobalHeader(header);
+
+    // Little-endian magic, version 2.4, LoRaTap link type
+    const uint8_t magic[] = { 0xD4, 0xC3, 0xB2, 0xA1, 0x02, 0x00, 0x04, 0x00 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(magic, header, sizeof(magic));
+    TEST_ASSERT_EQUAL_UINT8(0x0E, header[20]);
+    TEST_ASSERT_EQUAL_UINT8(0x01, header[21]);
+}
+
+void test_loratap_uplink_header(void) {
+    uint8_t tap[LORATAP_HEADER_SIZE];
+    writeLoRaTap(tap, 868100000, 125, 9, -95.0f, 7.25f, 0x34);
+
+    const uint8_t expected[LORATAP_HEADER_SIZE] = {
+        0x00, 0x00, 0x00, 0x0F,             // Version, padding, length
+        0x33, 0xBE, 0x27, 0xA0,             // 868100000 Hz
+        0x01, 0x09,                         // 125 kHz, SF9
+        44, 0x00, 0x00,                     // -139 + 44 = -95 dBm
+        29,                                 // 7.25 dB * 4
+        0x34
+    };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, tap, LORATAP_HEADER_SIZE);
+}
+
+void test_loratap_negative_snr(void) {
+    uint8_t tap[LORATAP_HEADER_SIZE];
+    writeLoRaTap(tap, 868100000, 500, 12, -125.5f, -10.0f, 0x34);
+
+    TEST_ASSERT_EQUAL_UINT8(4, tap[8]);                 // 500 kHz in 125 kHz steps
+    TEST_ASSERT_EQUAL_UINT8(54, tap[10]);               // -139 + 54 / 4 = -125.5 dBm
+    TEST_ASSERT_EQUAL_INT8(-40, (int8_t)tap[13]);
+}
+
+void test_loratap_downlink_has_no_rssi(void) {
+    uint8_t tap[LORATAP_HEADER_SIZE];
+    writeLoRaTap(tap, 869525000, 125, 12, 0, 0, 0x34);
+    TEST_ASSERT_EQUAL_UINT8(0, tap[10]);
+    TEST_ASSERT_EQUAL_UINT8(0, tap[13]);
+}
+
+// ============================================================
+// Filter Tests
+// ============================================================
+
+void test_empty_filter_matches_everything(void) {
+    Filter filter = anyFilter();
+    TEST_ASSERT_TRUE(matches(filter, UPLINK));
+    TEST_ASSERT_TRUE(matches(filter, DOWNLINK));
+}
+
+void test_direction_and_sf(void) {
+    Filter filter = anyFilter();
+    filter.directions = CAPTURE_DIR_DOWN;
+    filter.sfMask = (1U << 12) | (1U << 9);
+    TEST_ASSERT_FALSE(matches(filter, UPLINK));
+    TEST_ASSERT_TRUE(matches(filter, DOWNLINK));
+}
+
+void test_rssi_terms_only_match_uplinks(void) {
+    Filter filter = anyFilter();
+    filter.rssiMin = -100;
+    TEST_ASSERT_TRUE(matches(filter, UPLINK));
+    TEST_ASSERT_FALSE(matches(filter, DOWNLINK));
+
+    filter.rssiMin = -90;
+    TEST_ASSERT_FALSE(matches(filter, UPLINK));
+}
+
+void test_devaddr_prefix(void) {
+    Filter filter = anyFilter();
+    filter.devAddrSet = true;
+    filter.devAddrMask = 0xFFFFFF00;
+    filter.devAddrValue = 0x26011B00;
+    TEST_ASSERT_TRUE(matches(filter, UPLINK));
+
+    Frame join = UPLINK;
+    join.dataFrame = false;
+    TEST_ASSERT_FALSE(matches(filter, join));
+}
+
+void test_crc_term(void) {
+    Filter filter = anyFilter();
+    filter.crc = CAPTURE_CRC_BAD;
+    Frame bad = UPLINK;
+    bad.crcOk = false;
+    TEST_ASSERT_FALSE(matches(filter, UPLINK));
+    TEST_ASSERT_TRUE(matches(filter, bad));
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    // Setup code before each test (if needed)
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_pcap_global_header);
+    RUN_TEST(test_loratap_uplink_header);
+    RUN_TEST(test_loratap_negative_snr);
+    RUN_TEST(test_loratap_downlink_has_no_rssi);
+    RUN_TEST(test_empty_filter_matches_everything);
+    RUN_TEST(test_direction_and_sf);
+    RUN_TEST(test_rssi_terms_only_match_uplinks);
+    RUN_TEST(test_devaddr_prefix);
+    RUN_TEST(test_crc_term);
+
+    return UNITY_END();
+}
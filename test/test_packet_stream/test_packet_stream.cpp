@@ -0,0 +1,219 @@
+/**
+ * @file test_packet_stream.cpp
+ * @brief Tests for the binary WebSocket packet stream
+ *
+ * Tests the 16-byte record encoding and the record sequence numbers: a
+ * client with a full send queue misses the shared batch, and the sequence
+ * number in the header of its next batch tells it how many records it
+ * missed, overflow included.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+// Constants (mirror values from src/packet_stream.h)
+#define PACKET_STREAM_BATCH_MAX         32
+#define PACKET_STREAM_HEADER_SIZE       8
+#define PACKET_STREAM_RECORD_SIZE       16
+#define PACKET_STREAM_FLAG_CRC_OK       0x01
+#define PACKET_STREAM_FLAG_LORAWAN      0x02
+#define PACKET_STREAM_FLAG_FORWARDED    0x04
+
+static void put16le(uint8_t* p, uint16_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+}
+
+static void put32le(uint8_t* p, uint32_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+static uint32_t get32le(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * Mirrors PacketStream::record() and flush(); the library's binaryAll()
+ * queues the shared batch to every client whose queue has room
+ */
+struct Stream {
+    struct Client {
+        bool queueFull;
+        bool received;
+        bool synced;
+        uint32_t nextSeq;           // Client side: sequence number expected next
+        uint32_t missed;            // Client side: records seen as a gap
+    };
+
+    uint8_t buffer[PACKET_STREAM_HEADER_SIZE + PACKET_STREAM_BATCH_MAX * PACKET_STREAM_RECORD_SIZE];
+    uint8_t count;
+    uint32_t records;
+    uint32_t firstSeq;
+    uint32_t overflow;
+
+    void reset() { memset(this, 0, sizeof(*this)); }
+
+    void record(uint32_t ms, float rssi, float snr, uint8_t sf, uint8_t length,
+                uint8_t flags, uint8_t mtype, uint32_t devAddr) {
+        uint32_t seq = records++;
+        if (count >= PACKET_STREAM_BATCH_MAX) {
+            overflow++;
+            return;
+        }
+        if (count == 0) firstSeq = seq;
+        uint8_t* p = buffer + PACKET_STREAM_HEADER_SIZE + count * PACKET_STREAM_RECORD_SIZE;
+        put32le(p, ms);
+        put16le(p + 4, (uint16_t)(int16_t)lroundf(rssi * 10));
+        p[6] = (uint8_t)(int8_t)lroundf(snr * 4);
+        p[7] = sf;
+        p[8] = length;
+        p[9] = flags;
+        p[10] = mtype;
+        p[11] = 0;
+        put32le(p + 12, devAddr);
+        count++;
+    }
+
+    // What the web page does with a batch it receives
+    static void receive(Client& client, const uint8_t* message) {
+        uint32_t seq = get32le(message + 4);
+        if (client.synced) client.missed += seq - client.nextSeq;
+        client.nextSeq = seq + message[3];
+        client.synced = true;
+        client.received = true;
+    }
+
+    void flush(Client* clients, uint8_t n) {
+        buffer[3] = count;
+        put32le(buffer + 4, firstSeq);
+        for (uint8_t i = 0; i < n; i++) {
+            clients[i].received = false;
+            if (!clients[i].queueFull) receive(clients[i], buffer);
+        }
+        count = 0;
+    }
+};
+
+static Stream stream;
+
+// ============================================================
+// Record Encoding Tests
+// ============================================================
+
+void test_record_layout(void) {
+    stream.record(0x01020304, -112.5f, -7.25f, 9, 23,
+                  PACKET_STREAM_FLAG_CRC_OK | PACKET_STREAM_FLAG_LORAWAN, 2, 0x26011B2C);
+
+    const uint8_t* p = stream.buffer + PACKET_STREAM_HEADER_SIZE;
+    TEST_ASSERT_EQUAL_UINT32(0x01020304, get32le(p));
+    TEST_ASSERT_EQUAL_INT16(-1125, (int16_t)(p[4] | (p[5] << 8)));
+    TEST_ASSERT_EQUAL_INT8(-29, (int8_t)p[6]);
+    TEST_ASSERT_EQUAL_UINT8(9, p[7]);
+    TEST_ASSERT_EQUAL_UINT8(23, p[8]);
+    TEST_ASSERT_EQUAL_HEX8(0x03, p[9]);
+    TEST_ASSERT_EQUAL_UINT8(2, p[10]);
+    TEST_ASSERT_EQUAL_HEX32(0x26011B2C, get32le(p + 12));
+}
+
+void test_snr_range_fits_int8(void) {
+    // SX1276 SNR spans -32..+31.75 dB
+    stream.record(0, -60, 31.75f, 7, 1, 0, 0xFF, 0);
+    stream.record(0, -60, -32.0f, 7, 1, 0, 0xFF, 0);
+    const uint8_t* p = stream.buffer + PACKET_STREAM_HEADER_SIZE;
+    TEST_ASSERT_EQUAL_INT8(127, (int8_t)p[6]);
+    TEST_ASSERT_EQUAL_INT8(-128, (int8_t)p[PACKET_STREAM_RECORD_SIZE + 6]);
+}
+
+void test_full_batch_counts_overflow(void) {
+    for (uint8_t i = 0; i < PACKET_STREAM_BATCH_MAX + 3; i++) {
+        stream.record(i, -80, 5, 7, 10, 0, 0, 0);
+    }
+    TEST_ASSERT_EQUAL_UINT8(PACKET_STREAM_BATCH_MAX, stream.count);
+    TEST_ASSERT_EQUAL_UINT32(3, stream.overflow);
+}
+
+// ============================================================
+// Sequence Number Tests
+// ============================================================
+
+void test_slow_client_misses_batch_without_affecting_others(void) {
+    Stream::Client clients[2];
+    memset(clients, 0, sizeof(clients));
+    clients[1].queueFull = true;
+
+    for (uint8_t i = 0; i < 5; i++) stream.record(i, -80, 5, 7, 10, 0, 0, 0);
+    stream.flush(clients, 2);
+
+    TEST_ASSERT_TRUE(clients[0].received);
+    TEST_ASSERT_FALSE(clients[1].received);
+    TEST_ASSERT_EQUAL_UINT32(5, clients[0].nextSeq);
+}
+
+void test_missed_batches_show_as_sequence_gap(void) {
+    Stream::Client client;
+    memset(&client, 0, sizeof(client));
+
+    stream.record(0, -80, 5, 7, 10, 0, 0, 0);
+    stream.flush(&client, 1);
+
+    client.queueFull = true;
+    for (uint8_t i = 0; i < 4; i++) stream.record(i, -80, 5, 7, 10, 0, 0, 0);
+    stream.flush(&client, 1);
+    for (uint8_t i = 0; i < 3; i++) stream.record(i, -80, 5, 7, 10, 0, 0, 0);
+    stream.flush(&client, 1);
+
+    // Queue drained: the next batch starts 7 records further on
+    client.queueFull = false;
+    stream.record(9, -80, 5, 7, 10, 0, 0, 0);
+    stream.flush(&client, 1);
+    TEST_ASSERT_TRUE(client.received);
+    TEST_ASSERT_EQUAL_UINT32(7, client.missed);
+
+    stream.record(10, -80, 5, 7, 10, 0, 0, 0);
+    stream.flush(&client, 1);
+    TEST_ASSERT_EQUAL_UINT32(7, client.missed);
+}
+
+void test_overflow_shows_as_sequence_gap(void) {
+    Stream::Client client;
+    memset(&client, 0, sizeof(client));
+
+    for (uint8_t i = 0; i < PACKET_STREAM_BATCH_MAX + 3; i++) {
+        stream.record(i, -80, 5, 7, 10, 0, 0, 0);
+    }
+    stream.flush(&client, 1);
+    stream.record(0, -80, 5, 7, 10, 0, 0, 0);
+    stream.flush(&client, 1);
+
+    TEST_ASSERT_EQUAL_UINT32(3, client.missed);
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    stream.reset();
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_record_layout);
+    RUN_TEST(test_snr_range_fits_int8);
+    RUN_TEST(test_full_batch_counts_overflow);
+    RUN_TEST(test_slow_client_misses_batch_without_affecting_others);
+    RUN_TEST(test_missed_batches_show_as_sequence_gap);
+    RUN_TEST(test_overflow_shows_as_sequence_gap);
+
+    return UNITY_END();
+}
@@ -0,0 +1,148 @@
+/**
+ * @file test_radio_watchdog.cpp
+ * @brief Tests for the receiver watchdog
+ *
+ * Tests how a register poll is classified (SPI fault, LoRa mode lost,
+ * missed RX_DONE interrupt, RX mode lost, register drift) and which
+ * recovery step is tried first, including escalation after a recovery
+ * that did not hold.
+ */
+
+#include <unity.h>
+#include <cstdint>
+
+// Constants (mirror values from src/sx1276_shadow.h and src/lora_gateway.h)
+#define SX1276_MODE_LONG_RANGE          0x80
+#define SX1276_MODE_MASK                0x07
+#define SX1276_MODE_STANDBY             0x01
+#define SX1276_MODE_RX_CONTINUOUS       0x05
+#define SX1276_IRQ_RX_DONE              0x40
+#define LORA_WATCHDOG_ESCALATE_MS       600000
+
+enum Cause { NONE = 0, MISSED_IRQ, RX_MODE_LOST, REGISTERS, LORA_MODE_LOST, SPI_FAULT };
+enum Recovery { REARM = 0, RELOAD, HARDWARE_RESET };
+
+/**
+ * Mirrors LoRaGateway::watchdogCheck() over already read register values
+ */
+static Cause classify(uint8_t version, uint8_t opMode, uint8_t irqFlags,
+                      bool dio0Flag, uint8_t mismatches) {
+    if (version == 0x00 || version == 0xFF) return SPI_FAULT;
+    if (!(opMode & SX1276_MODE_LONG_RANGE)) return LORA_MODE_LOST;
+    if ((irqFlags & SX1276_IRQ_RX_DONE) && !dio0Flag) return MISSED_IRQ;
+    if ((opMode & SX1276_MODE_MASK) != SX1276_MODE_RX_CONTINUOUS) return RX_MODE_LOST;
+    if (mismatches > 0) return REGISTERS;
+    return NONE;
+}
+
+/**
+ * Mirrors the first recovery step chosen in LoRaGateway::watchdogUpdate()
+ */
+static Recovery firstStep(Cause cause, uint32_t now, uint32_t lastRecoveryTime,
+                          Recovery lastRecovery) {
+    Recovery level;
+    switch (cause) {
+        case REGISTERS:      level = RELOAD; break;
+        case LORA_MODE_LOST:
+        case SPI_FAULT:      level = HARDWARE_RESET; break;
+        default:             level = REARM; break;
+    }
+    if (lastRecoveryTime != 0 && now - lastRecoveryTime < LORA_WATCHDOG_ESCALATE_MS &&
+        lastRecovery >= level) {
+        level = lastRecovery < HARDWARE_RESET ? (Recovery)(lastRecovery + 1) : HARDWARE_RESET;
+    }
+    return level;
+}
+
+static const uint8_t RX_LORA = SX1276_MODE_LONG_RANGE | SX1276_MODE_RX_CONTINUOUS;
+
+// ============================================================
+// Classification Tests
+// ============================================================
+
+void test_healthy_receiver(void) {
+    TEST_ASSERT_EQUAL(NONE, classify(0x12, RX_LORA, 0x00, false, 0));
+}
+
+void test_spi_fault_on_dead_bus(void) {
+    // Floating MISO reads 0xFF, a missing chip 0x00
+    TEST_ASSERT_EQUAL(SPI_FAULT, classify(0xFF, 0xFF, 0xFF, false, 0));
+    TEST_ASSERT_EQUAL(SPI_FAULT, classify(0x00, 0x00, 0x00, false, 0));
+}
+
+void test_lora_mode_lost_after_brownout(void) {
+    // Chip reset by itself: FSK standby
+    TEST_ASSERT_EQUAL(LORA_MODE_LOST, classify(0x12, SX1276_MODE_STANDBY, 0x00, false, 5));
+}
+
+void test_missed_irq(void) {
+    TEST_ASSERT_EQUAL(MISSED_IRQ, classify(0x12, RX_LORA, SX1276_IRQ_RX_DONE, false, 0));
+
+    // Edge already latched: the radio task picks it up normally
+    TEST_ASSERT_EQUAL(NONE, classify(0x12, RX_LORA, SX1276_IRQ_RX_DONE, true, 0));
+}
+
+void test_rx_mode_lost(void) {
+    uint8_t standby = SX1276_MODE_LONG_RANGE | SX1276_MODE_STANDBY;
+    TEST_ASSERT_EQUAL(RX_MODE_LOST, classify(0x12, standby, 0x00, false, 0));
+}
+
+void test_register_drift(void) {
+    TEST_ASSERT_EQUAL(REGISTERS, classify(0x12, RX_LORA, 0x00, false, 2));
+}
+
+// ============================================================
+// Escalation Tests
+// ============================================================
+
+void test_first_step_by_cause(void) {
+    TEST_ASSERT_EQUAL(REARM, firstStep(RX_MODE_LOST, 1000, 0, REARM));
+    TEST_ASSERT_EQUAL(REARM, firstStep(MISSED_IRQ, 1000, 0, REARM));
+    TEST_ASSERT_EQUAL(RELOAD, firstStep(REGISTERS, 1000, 0, REARM));
+    TEST_ASSERT_EQUAL(HARDWARE_RESET, firstStep(SPI_FAULT, 1000, 0, REARM));
+}
+
+void test_repeated_stall_escalates(void) {
+    // A re-arm two minutes ago did not hold
+    TEST_ASSERT_EQUAL(RELOAD, firstStep(RX_MODE_LOST, 200000, 80000, REARM));
+    TEST_ASSERT_EQUAL(HARDWARE_RESET, firstStep(RX_MODE_LOST, 300000, 200000, RELOAD));
+    TEST_ASSERT_EQUAL(HARDWARE_RESET, firstStep(RX_MODE_LOST, 400000, 300000, HARDWARE_RESET));
+}
+
+void test_old_recovery_does_not_escalate(void) {
+    TEST_ASSERT_EQUAL(REARM, firstStep(RX_MODE_LOST, 1000000, 100000, RELOAD));
+}
+
+void test_lower_previous_step_does_not_escalate(void) {
+    // A re-arm followed by register drift: reload is the cause's own step
+    TEST_ASSERT_EQUAL(RELOAD, firstStep(REGISTERS, 200000, 100000, REARM));
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    // Setup code before each test (if needed)
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_healthy_receiver);
+    RUN_TEST(test_spi_fault_on_dead_bus);
+    RUN_TEST(test_lora_mode_lost_after_brownout);
+    RUN_TEST(test_missed_irq);
+    RUN_TEST(test_rx_mode_lost);
+    RUN_TEST(test_register_drift);
+    RUN_TEST(test_first_step_by_cause);
+    RUN_TEST(test_repeated_stall_escalates);
+    RUN_TEST(test_old_recovery_does_not_escalate);
+    RUN_TEST(test_lower_previous_step_does_not_escalate);
+
+    return UNITY_END();
+}
@@ -0,0 +1,159 @@
+/**
+ * @file test_region.cpp
+ * @brief Tests for the LoRaWAN regional parameter lookups
+ *
+ * Tests datr parsing, the SF/BW <-> data rate mapping in the uplink and
+ * downlink ranges, the maximum PHYPayload per data rate (with and without
+ * the dwell-time limit) and the band check used for downlink validation.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstring>
+
+#include "lorawan_region.h"
+
+static const LoRaRegion* EU868;
+static const LoRaRegion* US915;
+static const LoRaRegion* AS923;
+
+// ============================================================
+// datr Parsing Tests
+// ============================================================
+
+void test_parse_datr_valid(void) {
+    uint8_t sf = 0;
+    uint16_t bw = 0;
+
+    TEST_ASSERT_TRUE(lorawanParseDatr("SF7BW125", sf, bw));
+    TEST_ASSERT_EQUAL_UINT8(7, sf);
+    TEST_ASSERT_EQUAL_UINT16(125, bw);
+
+    TEST_ASSERT_TRUE(lorawanParseDatr("SF12BW500", sf, bw));
+    TEST_ASSERT_EQUAL_UINT8(12, sf);
+    TEST_ASSERT_EQUAL_UINT16(500, bw);
+}
+
+void test_parse_datr_rejects_malformed(void) {
+    uint8_t sf = 9;
+    uint16_t bw = 250;
+
+    TEST_ASSERT_FALSE(lorawanParseDatr("", sf, bw));
+    TEST_ASSERT_FALSE(lorawanParseDatr("SF", sf, bw));
+    TEST_ASSERT_FALSE(lorawanParseDatr("SFBW125", sf, bw));
+    TEST_ASSERT_FALSE(lorawanParseDatr("SF7BW", sf, bw));
+    TEST_ASSERT_FALSE(lorawanParseDatr("SF7BW125x", sf, bw));
+    TEST_ASSERT_FALSE(lorawanParseDatr("SF13BW125", sf, bw));
+    TEST_ASSERT_FALSE(lorawanParseDatr("SF7BW1250", sf, bw));
+    TEST_ASSERT_FALSE(lorawanParseDatr("sf7bw125", sf, bw));
+    TEST_ASSERT_FALSE(lorawanParseDatr("50000", sf, bw));
+    TEST_ASSERT_FALSE(lorawanParseDatr(nullptr, sf, bw));
+
+    // Outputs untouched on failure
+    TEST_ASSERT_EQUAL_UINT8(9, sf);
+    TEST_ASSERT_EQUAL_UINT16(250, bw);
+}
+
+// ============================================================
+// Data Rate Mapping Tests
+// ============================================================
+
+void test_eu868_data_rates(void) {
+    TEST_ASSERT_EQUAL_INT8(0, lorawanFindDataRate(EU868, 12, 125, false));
+    TEST_ASSERT_EQUAL_INT8(5, lorawanFindDataRate(EU868, 7, 125, false));
+    TEST_ASSERT_EQUAL_INT8(6, lorawanFindDataRate(EU868, 7, 250, true));
+    TEST_ASSERT_EQUAL_INT8(-1, lorawanFindDataRate(EU868, 7, 500, true));
+}
+
+void test_us915_uplink_and_downlink_ranges(void) {
+    // SF10/125 is uplink DR0 but not a downlink rate
+    TEST_ASSERT_EQUAL_INT8(0, lorawanFindDataRate(US915, 10, 125, false));
+    TEST_ASSERT_EQUAL_INT8(-1, lorawanFindDataRate(US915, 10, 125, true));
+
+    // SF12/500 is RX2 (DR8), downlink only
+    TEST_ASSERT_EQUAL_INT8(8, lorawanFindDataRate(US915, 12, 500, true));
+    TEST_ASSERT_EQUAL_INT8(-1, lorawanFindDataRate(US915, 12, 500, false));
+
+    // SF8/500: uplink DR4, downlink DR12
+    TEST_ASSERT_EQUAL_INT8(4, lorawanFindDataRate(US915, 8, 500, false));
+    TEST_ASSERT_EQUAL_INT8(12, lorawanFindDataRate(US915, 8, 500, true));
+
+    // No SF11/SF12 uplinks at 125 kHz
+    TEST_ASSERT_EQUAL_INT8(-1, lorawanFindDataRate(US915, 12, 125, false));
+}
+
+// ============================================================
+// Payload Size Tests
+// ============================================================
+
+void test_max_payload_includes_mhdr_and_mic(void) {
+    TEST_ASSERT_EQUAL_UINT16(64, lorawanMaxPhyPayload(EU868, 0, false));
+    TEST_ASSERT_EQUAL_UINT16(235, lorawanMaxPhyPayload(EU868, 5, false));
+    TEST_ASSERT_EQUAL_UINT16(66, lorawanMaxPhyPayload(US915, 8, false));
+}
+
+void test_dwell_limit_shrinks_payload(void) {
+    TEST_ASSERT_EQUAL_UINT16(128, lorawanMaxPhyPayload(AS923, 2, false));
+    TEST_ASSERT_EQUAL_UINT16(24, lorawanMaxPhyPayload(AS923, 2, true));
+
+    // SF12/SF11 cannot meet 400 ms at all
+    TEST_ASSERT_EQUAL_UINT16(0, lorawanMaxPhyPayload(AS923, 0, true));
+    TEST_ASSERT_EQUAL_UINT16(0, lorawanMaxPhyPayload(AS923, 1, true));
+}
+
+void test_rfu_data_rate_has_no_payload(void) {
+    TEST_ASSERT_EQUAL_UINT16(0, lorawanMaxPhyPayload(US915, 7, false));
+    TEST_ASSERT_EQUAL_UINT16(0, lorawanMaxPhyPayload(US915, 16, false));
+}
+
+void test_region_lookup(void) {
+    TEST_ASSERT_NOT_NULL(EU868);
+    TEST_ASSERT_NOT_NULL(US915);
+    TEST_ASSERT_NOT_NULL(AS923);
+    TEST_ASSERT_EQUAL_STRING("US915", US915->name);
+    TEST_ASSERT_NULL(lorawanRegionFind("XX000"));
+    TEST_ASSERT_TRUE(lorawanRegionDefault() == US915);
+}
+
+// ============================================================
+// Band Tests
+// ============================================================
+
+void test_band_edges(void) {
+    TEST_ASSERT_TRUE(lorawanRegionContains(EU868, 869525000));
+    TEST_ASSERT_TRUE(lorawanRegionContains(EU868, 863000000));
+    TEST_ASSERT_FALSE(lorawanRegionContains(EU868, 870000001));
+    TEST_ASSERT_FALSE(lorawanRegionContains(EU868, 915200000));
+    TEST_ASSERT_TRUE(lorawanRegionContains(US915, 923300000));
+    TEST_ASSERT_FALSE(lorawanRegionContains(AS923, 902300000));
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    EU868 = lorawanRegionFind("EU868");
+    US915 = lorawanRegionFind("US915");
+    AS923 = lorawanRegionFind("AS923");
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_region_lookup);
+    RUN_TEST(test_parse_datr_valid);
+    RUN_TEST(test_parse_datr_rejects_malformed);
+    RUN_TEST(test_eu868_data_rates);
+    RUN_TEST(test_us915_uplink_and_downlink_ranges);
+    RUN_TEST(test_max_payload_includes_mhdr_and_mic);
+    RUN_TEST(test_dwell_limit_shrinks_payload);
+    RUN_TEST(test_rfu_data_rate_has_no_payload);
+    RUN_TEST(test_band_edges);
+
+    return UNITY_END();
+}
@@ -0,0 +1,205 @@
+/**
+ * @file test_response_cache.cpp
+ * @brief Tests for the config GET response cache
+ *
+ * Tests version-keyed hits and misses, If-None-Match matching, and that
+ * cached bodies stay within the byte budget by evicting the least
+ * recently used ones.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// Constants (mirror values from src/response_cache.h)
+#define RESPONSE_CACHE_BUDGET   4096
+#define ENDPOINT_COUNT          6
+
+enum Result { NOT_MODIFIED, HIT, MISS };
+
+/**
+ * Mirrors ResponseCache (bodies as std::string, no HTTP)
+ */
+struct Cache {
+    struct Entry {
+        bool valid;
+        uint32_t version;
+        uint32_t lastUsed;
+        std::string body;
+    };
+
+    Entry entries[ENDPOINT_COUNT];
+    uint32_t bootId;
+    uint32_t useCounter;
+    uint32_t bytes;
+    uint32_t evictions;
+    uint32_t tooLarge;
+
+    void reset() {
+        for (uint8_t i = 0; i < ENDPOINT_COUNT; i++) {
+            entries[i].valid = false;
+            entries[i].body.clear();
+        }
+        bootId = 0x1234ABCD;
+        useCounter = bytes = evictions = tooLarge = 0;
+    }
+
+    std::string etag(uint32_t version) const {
+        char tag[24];
+        snprintf(tag, sizeof(tag), "\"%08x-%x\"", bootId, version);
+        return tag;
+    }
+
+    Result serve(uint8_t endpoint, uint32_t version, const char* ifNoneMatch = nullptr) {
+        if (ifNoneMatch && std::string(ifNoneMatch).find(etag(version)) != std::string::npos) {
+            return NOT_MODIFIED;
+        }
+        Entry& entry = entries[endpoint];
+        if (entry.valid && entry.version == version) {
+            entry.lastUsed = ++useCounter;
+            return HIT;
+        }
+        return MISS;
+    }
+
+    void drop(Entry& entry) {
+        if (!entry.valid) return;
+        bytes -= entry.body.size();
+        entry.body.clear();
+        entry.valid = false;
+    }
+
+    bool makeRoom(size_t length) {
+        if (length > RESPONSE_CACHE_BUDGET) {
+            tooLarge++;
+            return false;
+        }
+        while (bytes + length > RESPONSE_CACHE_BUDGET) {
+            Entry* oldest = nullptr;
+            for (uint8_t i = 0; i < ENDPOINT_COUNT; i++) {
+                if (entries[i].valid && (!oldest || entries[i].lastUsed < oldest->lastUsed)) {
+                    oldest = &entries[i];
+                }
+            }
+            if (!oldest) break;
+            drop(*oldest);
+            evictions++;
+        }
+        return true;
+    }
+
+    void send(uint8_t endpoint, uint32_t version, size_t length) {
+        Entry& entry = entries[endpoint];
+        drop(entry);
+        if (makeRoom(length)) {
+            entry.body.assign(length, 'x');
+            entry.valid = true;
+            entry.version = version;
+            entry.lastUsed = ++useCounter;
+            bytes += length;
+        }
+    }
+};
+
+static Cache cache;
+
+// ============================================================
+// Version Tests
+// ============================================================
+
+void test_hit_until_version_changes(void) {
+    TEST_ASSERT_EQUAL(MISS, cache.serve(0, 5));
+    cache.send(0, 5, 300);
+    TEST_ASSERT_EQUAL(HIT, cache.serve(0, 5));
+    TEST_ASSERT_EQUAL(MISS, cache.serve(0, 6));
+
+    // Rebuilt body replaces the old one
+    cache.send(0, 6, 320);
+    TEST_ASSERT_EQUAL_UINT32(320, cache.bytes);
+    TEST_ASSERT_EQUAL(HIT, cache.serve(0, 6));
+}
+
+void test_endpoints_are_independent(void) {
+    cache.send(0, 1, 100);
+    cache.send(1, 1, 100);
+    TEST_ASSERT_EQUAL(HIT, cache.serve(1, 1));
+    TEST_ASSERT_EQUAL(MISS, cache.serve(2, 1));
+}
+
+// ============================================================
+// ETag Tests
+// ============================================================
+
+void test_matching_etag_is_not_modified(void) {
+    std::string tag = cache.etag(7);
+    TEST_ASSERT_EQUAL_STRING("\"1234abcd-7\"", tag.c_str());
+
+    // No cached body needed for a 304
+    TEST_ASSERT_EQUAL(NOT_MODIFIED, cache.serve(0, 7, tag.c_str()));
+    TEST_ASSERT_EQUAL(MISS, cache.serve(0, 8, tag.c_str()));
+}
+
+void test_etag_found_in_list(void) {
+    std::string header = "\"00000000-1\", " + cache.etag(3);
+    TEST_ASSERT_EQUAL(NOT_MODIFIED, cache.serve(0, 3, header.c_str()));
+}
+
+void test_etag_from_previous_boot_misses(void) {
+    std::string tag = cache.etag(2);
+    cache.bootId = 0x55AA55AA;
+    TEST_ASSERT_EQUAL(MISS, cache.serve(0, 2, tag.c_str()));
+}
+
+// ============================================================
+// Budget Tests
+// ============================================================
+
+void test_lru_eviction_keeps_budget(void) {
+    cache.send(0, 1, 1500);
+    cache.send(1, 1, 1500);
+    cache.serve(0, 1);                  // 1 is now least recently used
+    cache.send(2, 1, 1500);
+
+    TEST_ASSERT_EQUAL_UINT32(1, cache.evictions);
+    TEST_ASSERT_TRUE(cache.bytes <= RESPONSE_CACHE_BUDGET);
+    TEST_ASSERT_EQUAL(HIT, cache.serve(0, 1));
+    TEST_ASSERT_EQUAL(MISS, cache.serve(1, 1));
+    TEST_ASSERT_EQUAL(HIT, cache.serve(2, 1));
+}
+
+void test_body_over_budget_not_cached(void) {
+    cache.send(0, 1, 1000);
+    cache.send(1, 1, RESPONSE_CACHE_BUDGET + 1);
+    TEST_ASSERT_EQUAL_UINT32(1, cache.tooLarge);
+    TEST_ASSERT_EQUAL_UINT32(0, cache.evictions);
+    TEST_ASSERT_EQUAL(MISS, cache.serve(1, 1));
+    TEST_ASSERT_EQUAL(HIT, cache.serve(0, 1));
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    cache.reset();
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_hit_until_version_changes);
+    RUN_TEST(test_endpoints_are_independent);
+    RUN_TEST(test_matching_etag_is_not_modified);
+    RUN_TEST(test_etag_found_in_list);
+    RUN_TEST(test_etag_from_previous_boot_misses);
+    RUN_TEST(test_lru_eviction_keeps_budget);
+    RUN_TEST(test_body_over_budget_not_cached);
+
+    return UNITY_END();
+}
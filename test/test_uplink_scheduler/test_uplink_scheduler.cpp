@@ -0,0 +1,255 @@
+/**
+ * @file test_uplink_scheduler.cpp
+ * @brief Tests for the uplink priority queue
+ *
+ * Tests the per-class FIFOs over the shared frame pool: earliest-deadline
+ * selection across classes, dropping frames whose RX window has passed
+ * and which frame is pushed out when the pool is full.
+ */
+
+#include <unity.h>
+#include <cstdint>
+#include <cstring>
+
+// Constants (mirror values from src/uplink_scheduler.h)
+#define UPLINK_QUEUE_SIZE           16
+#define UPLINK_SERVER_MARGIN_MS     400
+#define UPLINK_JOIN_WINDOW_MS       6000
+#define UPLINK_CONFIRMED_WINDOW_MS  2000
+#define UPLINK_DATA_MAX_AGE_MS      30000
+
+enum Class : uint8_t { JOIN = 0, CONFIRMED, UNCONFIRMED, OTHER, CLASS_COUNT };
+
+static uint32_t windowUs(uint8_t cls) {
+    switch (cls) {
+        case JOIN:      return (UPLINK_JOIN_WINDOW_MS - UPLINK_SERVER_MARGIN_MS) * 1000UL;
+        case CONFIRMED: return (UPLINK_CONFIRMED_WINDOW_MS - UPLINK_SERVER_MARGIN_MS) * 1000UL;
+        default:        return UPLINK_DATA_MAX_AGE_MS * 1000UL;
+    }
+}
+
+/**
+ * Mirrors UplinkScheduler (frames reduced to their RX timestamp and an id)
+ */
+struct Scheduler {
+    struct Frame {
+        uint32_t timestamp;
+        uint16_t id;
+    };
+    struct Queue {
+        uint8_t slots[UPLINK_QUEUE_SIZE];
+        uint8_t head;
+        uint8_t count;
+    };
+
+    Frame pool[UPLINK_QUEUE_SIZE];
+    uint32_t freeMask;
+    Queue queues[CLASS_COUNT];
+    uint8_t depth;
+    uint32_t stale[CLASS_COUNT];
+    uint32_t overflow[CLASS_COUNT];
+
+    void reset() {
+        memset(this, 0, sizeof(*this));
+        freeMask = (1UL << UPLINK_QUEUE_SIZE) - 1;
+    }
+
+    uint8_t peek(uint8_t cls) const { return queues[cls].slots[queues[cls].head]; }
+
+    void push(uint8_t cls, uint8_t index) {
+        Queue& q = queues[cls];
+        q.slots[(q.head + q.count) % UPLINK_QUEUE_SIZE] = index;
+        q.count++;
+        depth++;
+    }
+
+    uint8_t pop(uint8_t cls) {
+        Queue& q = queues[cls];
+        uint8_t index = q.slots[q.head];
+        q.head = (q.head + 1) % UPLINK_QUEUE_SIZE;
+        q.count--;
+        depth--;
+        return index;
+    }
+
+    bool enqueue(uint8_t cls, uint32_t timestamp, uint16_t id) {
+        if (freeMask == 0) {
+            int8_t victim = -1;
+            for (int8_t c = CLASS_COUNT - 1; c >= (int8_t)cls; c--) {
+                if (queues[c].count > 0) {
+                    victim = c;
+                    break;
+                }
+            }
+            if (victim < 0) {
+                overflow[cls]++;
+                return false;
+            }
+            freeMask |= 1UL << pop(victim);
+            overflow[victim]++;
+        }
+
+        uint8_t index = __builtin_ctz(freeMask);
+        freeMask &= ~(1UL << index);
+        pool[index].timestamp = timestamp;
+        pool[index].id = id;
+        push(cls, index);
+        return true;
+    }
+
+    void dropStale(uint32_t now) {
+        for (uint8_t c = 0; c < CLASS_COUNT; c++) {
+            while (queues[c].count > 0 && now - pool[peek(c)].timestamp > windowUs(c)) {
+                freeMask |= 1UL << pop(c);
+                stale[c]++;
+            }
+        }
+    }
+
+    int8_t selectNext(uint32_t now) const {
+        int8_t best = -1;
+        int32_t bestRemaining = 0;
+        for (uint8_t c = 0; c < CLASS_COUNT; c++) {
+            if (queues[c].count == 0) continue;
+            int32_t remaining = (int32_t)(windowUs(c) - (now - pool[peek(c)].timestamp));
+            if (best < 0 || remaining < bestRemaining) {
+                best = c;
+                bestRemaining = remaining;
+            }
+        }
+        return best;
+    }
+
+    // Next frame id in forwarding order (0 when empty)
+    uint16_t forward(uint32_t now) {
+        dropStale(now);
+        int8_t c = selectNext(now);
+        if (c < 0) return 0;
+        uint8_t index = pop(c);
+        freeMask |= 1UL << index;
+        return pool[index].id;
+    }
+};
+
+static Scheduler sched;
+
+// ============================================================
+// Ordering Tests
+// ============================================================
+
+void test_join_and_confirmed_overtake_telemetry(void) {
+    sched.enqueue(UNCONFIRMED, 0, 1);
+    sched.enqueue(UNCONFIRMED, 1000, 2);
+    sched.enqueue(JOIN, 2000, 3);
+    sched.enqueue(CONFIRMED, 3000, 4);
+
+    // Confirmed deadline 3.0+1.6 s, join 2.0+5.6 s, unconfirmed 30 s
+    uint32_t now = 4000;
+    TEST_ASSERT_EQUAL_UINT16(4, sched.forward(now));
+    TEST_ASSERT_EQUAL_UINT16(3, sched.forward(now));
+    TEST_ASSERT_EQUAL_UINT16(1, sched.forward(now));
+    TEST_ASSERT_EQUAL_UINT16(2, sched.forward(now));
+    TEST_ASSERT_EQUAL_UINT16(0, sched.forward(now));
+}
+
+void test_earliest_deadline_across_classes(void) {
+    // A join close to its window goes before a fresh confirmed frame
+    sched.enqueue(JOIN, 0, 1);
+    sched.enqueue(CONFIRMED, 4500000, 2);
+
+    uint32_t now = 4600000;     // Join: 1.0 s left, confirmed: 1.5 s left
+    TEST_ASSERT_EQUAL_UINT16(1, sched.forward(now));
+    TEST_ASSERT_EQUAL_UINT16(2, sched.forward(now));
+}
+
+void test_fifo_within_class(void) {
+    for (uint16_t i = 1; i <= 5; i++) {
+        sched.enqueue(UNCONFIRMED, i * 100, i);
+    }
+    for (uint16_t i = 1; i <= 5; i++) {
+        TEST_ASSERT_EQUAL_UINT16(i, sched.forward(1000));
+    }
+}
+
+// ============================================================
+// Stale Frame Tests
+// ============================================================
+
+void test_missed_window_is_dropped(void) {
+    sched.enqueue(CONFIRMED, 0, 1);
+    sched.enqueue(JOIN, 0, 2);
+    sched.enqueue(UNCONFIRMED, 0, 3);
+
+    // 2 s later: confirmed window (1.6 s) passed, join (5.6 s) still open
+    TEST_ASSERT_EQUAL_UINT16(2, sched.forward(2000000));
+    TEST_ASSERT_EQUAL_UINT32(1, sched.stale[CONFIRMED]);
+    TEST_ASSERT_EQUAL_UINT16(3, sched.forward(2000000));
+}
+
+void test_stale_check_survives_micros_wrap(void) {
+    sched.enqueue(CONFIRMED, 0xFFFF0000, 1);
+    sched.dropStale(0x00010000);        // 131 ms later
+    TEST_ASSERT_EQUAL_UINT32(0, sched.stale[CONFIRMED]);
+    TEST_ASSERT_EQUAL_UINT8(1, sched.depth);
+}
+
+void test_unconfirmed_max_age(void) {
+    sched.enqueue(UNCONFIRMED, 0, 1);
+    sched.dropStale(UPLINK_DATA_MAX_AGE_MS * 1000UL + 1);
+    TEST_ASSERT_EQUAL_UINT32(1, sched.stale[UNCONFIRMED]);
+    TEST_ASSERT_EQUAL_UINT8(0, sched.depth);
+}
+
+// ============================================================
+// Overflow Tests
+// ============================================================
+
+void test_full_pool_pushes_out_lowest_class(void) {
+    for (uint16_t i = 0; i < UPLINK_QUEUE_SIZE; i++) {
+        sched.enqueue(i < 2 ? OTHER : UNCONFIRMED, i, i + 1);
+    }
+    TEST_ASSERT_TRUE(sched.enqueue(JOIN, 100, 99));
+    TEST_ASSERT_EQUAL_UINT32(1, sched.overflow[OTHER]);
+    TEST_ASSERT_EQUAL_UINT8(1, sched.queues[OTHER].count);
+    TEST_ASSERT_EQUAL_UINT16(99, sched.forward(200));
+}
+
+void test_full_pool_of_higher_classes_rejects(void) {
+    for (uint16_t i = 0; i < UPLINK_QUEUE_SIZE; i++) {
+        sched.enqueue(JOIN, i, i + 1);
+    }
+    TEST_ASSERT_FALSE(sched.enqueue(UNCONFIRMED, 100, 99));
+    TEST_ASSERT_EQUAL_UINT32(1, sched.overflow[UNCONFIRMED]);
+
+    // Same class: the oldest one makes room
+    TEST_ASSERT_TRUE(sched.enqueue(JOIN, 100, 100));
+    TEST_ASSERT_EQUAL_UINT32(1, sched.overflow[JOIN]);
+    TEST_ASSERT_EQUAL_UINT16(2, sched.forward(200));
+}
+
+// ============================================================
+// Test Runner
+// ============================================================
+
+void setUp(void) {
+    sched.reset();
+}
+
+void tearDown(void) {
+    // Cleanup code after each test (if needed)
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_join_and_confirmed_overtake_telemetry);
+    RUN_TEST(test_earliest_deadline_across_classes);
+    RUN_TEST(test_fifo_within_class);
+    RUN_TEST(test_missed_window_is_dropped);
+    RUN_TEST(test_stale_check_survives_micros_wrap);
+    RUN_TEST(test_unconfirmed_max_age);
+    RUN_TEST(test_full_pool_pushes_out_lowest_class);
+    RUN_TEST(test_full_pool_of_higher_classes_rejects);
+
+    return UNITY_END();
+}